@@ -0,0 +1,113 @@
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+#include "maths/bounds.h"
+
+namespace maths {
+
+namespace {
+
+// Vertices of a typical skinned mesh
+std::vector<Vector3f> MeshPoints(std::size_t count)
+{
+	std::mt19937 generator(31);
+	std::normal_distribution<float> position(0.0f, 1.0f);
+	std::vector<Vector3f> points;
+	points.reserve(count);
+	for (std::size_t i = 0; i < count; i++) {
+		points.emplace_back(position(generator) * 0.4f, position(generator) * 1.8f, position(generator) * 0.3f);
+	}
+	return points;
+}
+
+} // namespace
+
+void BM_AABB3Scalar(benchmark::State& state)
+{
+	const std::vector<Vector3f> points = MeshPoints(state.range(0));
+	for (auto _ : state) {
+		AABB3 aabb = AABB3::Empty();
+		for (const Vector3f& point : points) {
+			aabb = Expand(aabb, point);
+		}
+		benchmark::DoNotOptimize(aabb);
+	}
+	state.SetItemsProcessed(state.iterations() * points.size());
+}
+BENCHMARK(BM_AABB3Scalar)->Arg(10000)->Arg(100000);
+
+void BM_AABB3Simd(benchmark::State& state)
+{
+	const std::vector<Vector3f> points = MeshPoints(state.range(0));
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(ComputeAABB3(points));
+	}
+	state.SetItemsProcessed(state.iterations() * points.size());
+}
+BENCHMARK(BM_AABB3Simd)->Arg(10000)->Arg(100000);
+
+void BM_RitterSphere(benchmark::State& state)
+{
+	const std::vector<Vector3f> points = MeshPoints(state.range(0));
+	Sphere sphere;
+	for (auto _ : state) {
+		sphere = ComputeRitterSphere(points);
+		benchmark::DoNotOptimize(sphere);
+	}
+	state.counters["radius"] = sphere.radius();
+	state.SetItemsProcessed(state.iterations() * points.size());
+}
+BENCHMARK(BM_RitterSphere)->Arg(10000)->Arg(100000);
+
+void BM_BoundingSphere(benchmark::State& state)
+{
+	const std::vector<Vector3f> points = MeshPoints(state.range(0));
+	Sphere sphere;
+	for (auto _ : state) {
+		sphere = ComputeBoundingSphere(points);
+		benchmark::DoNotOptimize(sphere);
+	}
+	state.counters["radius"] = sphere.radius();
+	state.SetItemsProcessed(state.iterations() * points.size());
+}
+BENCHMARK(BM_BoundingSphere)->Arg(10000)->Arg(100000);
+
+void BM_OBB3(benchmark::State& state)
+{
+	const std::vector<Vector3f> points = MeshPoints(state.range(0));
+	OBB3 obb;
+	for (auto _ : state) {
+		obb = ComputeOBB3(points);
+		benchmark::DoNotOptimize(obb);
+	}
+	state.counters["volume"] = obb.volume();
+	state.SetItemsProcessed(state.iterations() * points.size());
+}
+BENCHMARK(BM_OBB3)->Arg(10000)->Arg(100000);
+
+} // namespace maths
@@ -0,0 +1,179 @@
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+#include "maths/bvh.h"
+
+namespace maths {
+
+namespace {
+
+std::vector<AABB3> BuildScene(std::size_t count)
+{
+	std::mt19937 generator(21);
+	std::uniform_real_distribution<float> position(-1000.0f, 1000.0f);
+	std::uniform_real_distribution<float> size(0.5f, 4.0f);
+	std::vector<AABB3> aabbs;
+	aabbs.reserve(count);
+	for (std::size_t i = 0; i < count; i++) {
+		const Vector3f min{ position(generator), position(generator) * 0.1f, position(generator) };
+		aabbs.emplace_back(min, min + Vector3f{ size(generator), size(generator), size(generator) });
+	}
+	return aabbs;
+}
+
+std::vector<Ray3> BuildRays(std::size_t count)
+{
+	std::mt19937 generator(22);
+	std::uniform_real_distribution<float> position(-1000.0f, 1000.0f);
+	std::vector<Ray3> rays;
+	rays.reserve(count);
+	for (std::size_t i = 0; i < count; i++) {
+		Vector3f origin{ position(generator), 0.0f, -1100.0f };
+		Vector3f direction{ position(generator) * 0.001f, position(generator) * 0.0001f, 1.0f };
+		rays.emplace_back(origin, direction);
+	}
+	return rays;
+}
+
+Bvh BuildTree(const std::vector<AABB3>& aabbs, bool linear)
+{
+	Bvh bvh;
+	if (linear) {
+		bvh.BuildLinear(aabbs);
+	} else {
+		bvh.Build(aabbs, 1);
+	}
+	return bvh;
+}
+
+} // namespace
+
+void BM_BvhBuildSah(benchmark::State& state)
+{
+	const std::vector<AABB3> aabbs = BuildScene(state.range(0));
+	Bvh bvh;
+	for (auto _ : state) {
+		bvh.Build(aabbs, 1);
+		benchmark::DoNotOptimize(bvh.nodes().data());
+	}
+	state.SetItemsProcessed(state.iterations() * aabbs.size());
+}
+BENCHMARK(BM_BvhBuildSah)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+void BM_BvhBuildLinear(benchmark::State& state)
+{
+	const std::vector<AABB3> aabbs = BuildScene(state.range(0));
+	Bvh bvh;
+	for (auto _ : state) {
+		bvh.BuildLinear(aabbs);
+		benchmark::DoNotOptimize(bvh.nodes().data());
+	}
+	state.SetItemsProcessed(state.iterations() * aabbs.size());
+}
+BENCHMARK(BM_BvhBuildLinear)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// Deforming scene: every box moves a little each frame
+std::vector<AABB3> JitterScene(const std::vector<AABB3>& aabbs, unsigned seed)
+{
+	std::mt19937 generator(seed);
+	std::uniform_real_distribution<float> step(-2.0f, 2.0f);
+	std::vector<AABB3> moved;
+	moved.reserve(aabbs.size());
+	for (const AABB3& aabb : aabbs) {
+		const Vector3f offset{ step(generator), step(generator), step(generator) };
+		moved.emplace_back(aabb.bottom_left() + offset, aabb.top_right() + offset);
+	}
+	return moved;
+}
+
+void BM_BvhRefit(benchmark::State& state)
+{
+	const std::vector<AABB3> aabbs = BuildScene(state.range(0));
+	const std::vector<AABB3> frames[2] = { JitterScene(aabbs, 1), JitterScene(aabbs, 2) };
+	Bvh bvh;
+	bvh.BuildLinear(aabbs);
+	int frame = 0;
+	for (auto _ : state) {
+		bvh.Refit(frames[frame ^= 1]);
+		benchmark::DoNotOptimize(bvh.nodes().data());
+	}
+	state.SetItemsProcessed(state.iterations() * aabbs.size());
+}
+BENCHMARK(BM_BvhRefit)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+void BM_BvhRefitAndRebuild(benchmark::State& state)
+{
+	const std::vector<AABB3> aabbs = BuildScene(state.range(0));
+	const std::vector<AABB3> frames[2] = { JitterScene(aabbs, 1), JitterScene(aabbs, 2) };
+	Bvh bvh;
+	bvh.BuildLinear(aabbs);
+	int frame = 0;
+	std::uint32_t rebuilt = 0;
+	for (auto _ : state) {
+		rebuilt += bvh.RefitAndRebuild(frames[frame ^= 1]);
+	}
+	state.counters["rebuilt"] = benchmark::Counter(rebuilt, benchmark::Counter::kAvgIterations);
+	state.counters["sah_cost"] = bvh.SahCost();
+	state.SetItemsProcessed(state.iterations() * aabbs.size());
+}
+BENCHMARK(BM_BvhRefitAndRebuild)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// Query quality of both builders on the same scene, arg 1 for the linear tree
+void BM_BvhRaycast(benchmark::State& state)
+{
+	const std::vector<AABB3> aabbs = BuildScene(1000000);
+	const Bvh bvh = BuildTree(aabbs, state.range(0) != 0);
+	const std::vector<Ray3> rays = BuildRays(1024);
+	for (auto _ : state) {
+		int hits = 0;
+		for (const Ray3& ray : rays) {
+			float distance;
+			hits += bvh.Raycast(aabbs, ray, distance) != Bvh::kInvalidItem;
+		}
+		benchmark::DoNotOptimize(hits);
+	}
+	state.SetItemsProcessed(state.iterations() * rays.size());
+}
+BENCHMARK(BM_BvhRaycast)->Arg(0)->Arg(1)->ArgNames({ "linear" });
+
+void BM_BvhSphereQuery(benchmark::State& state)
+{
+	const std::vector<AABB3> aabbs = BuildScene(1000000);
+	const Bvh bvh = BuildTree(aabbs, state.range(0) != 0);
+	std::mt19937 generator(23);
+	std::uniform_real_distribution<float> position(-1000.0f, 1000.0f);
+	std::vector<std::uint32_t> result;
+	for (auto _ : state) {
+		result.clear();
+		bvh.QuerySphere(aabbs, Sphere{ 30.0f, Vector3f{ position(generator), 0.0f, position(generator) } }, result);
+		benchmark::DoNotOptimize(result.data());
+	}
+}
+BENCHMARK(BM_BvhSphereQuery)->Arg(0)->Arg(1)->ArgNames({ "linear" });
+
+} // namespace maths
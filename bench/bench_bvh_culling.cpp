@@ -0,0 +1,102 @@
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+#include "maths/bvh.h"
+
+namespace maths {
+
+namespace {
+
+// Static scene of 500k objects spread around the camera
+const std::vector<AABB3>& CullingScene()
+{
+	static const std::vector<AABB3> aabbs = [] {
+		std::mt19937 generator(5);
+		std::uniform_real_distribution<float> position(-1000.0f, 1000.0f);
+		std::uniform_real_distribution<float> size(0.5f, 4.0f);
+		std::vector<AABB3> result;
+		result.reserve(500000);
+		for (int i = 0; i < 500000; i++) {
+			const Vector3f min{ position(generator), position(generator) * 0.1f, position(generator) };
+			result.emplace_back(min, min + Vector3f{ size(generator), size(generator), size(generator) });
+		}
+		return result;
+	}();
+	return aabbs;
+}
+
+Frustum CullingFrustum()
+{
+	Vector3f up{ 0.0f, 1.0f, 0.0f };
+	Vector3f direction{ 0.0f, 0.0f, 1.0f };
+	Vector3f right = Vector3f::Cross(up, direction);
+	Frustum frustum;
+	frustum.calculate_frustum(direction, Vector3f{}, right, up, 0.1f, 500.0f,
+		degree_t(60.0f), degree_t(60.0f));
+	return frustum;
+}
+
+} // namespace
+
+void BM_CullBruteForce(benchmark::State& state)
+{
+	const std::vector<AABB3>& aabbs = CullingScene();
+	const Frustum frustum = CullingFrustum();
+	std::vector<std::uint32_t> visible;
+	for (auto _ : state) {
+		visible.clear();
+		for (std::uint32_t i = 0; i < aabbs.size(); i++) {
+			if (frustum.contains(aabbs[i])) {
+				visible.push_back(i);
+			}
+		}
+		benchmark::DoNotOptimize(visible.data());
+	}
+	state.counters["visible"] = static_cast<double>(visible.size());
+}
+BENCHMARK(BM_CullBruteForce)->Unit(benchmark::kMillisecond);
+
+void BM_CullBvh(benchmark::State& state)
+{
+	const std::vector<AABB3>& aabbs = CullingScene();
+	const Frustum frustum = CullingFrustum();
+	Bvh bvh;
+	bvh.Build(aabbs, static_cast<std::uint32_t>(state.range(0)));
+	BvhCullCache cache;
+	std::vector<std::uint32_t> visible;
+	for (auto _ : state) {
+		visible.clear();
+		bvh.CullFrustum(frustum, cache, visible);
+		benchmark::DoNotOptimize(visible.data());
+	}
+	state.counters["visible"] = static_cast<double>(visible.size());
+}
+BENCHMARK(BM_CullBvh)->Arg(1)->Arg(4)->Unit(benchmark::kMillisecond);
+
+} // namespace maths
@@ -0,0 +1,127 @@
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+#include "maths/collision_world2.h"
+
+namespace maths {
+
+namespace {
+
+constexpr std::size_t kWorldProxies = 2000;
+
+struct MovingProxy {
+	Vector2f center;
+	Vector2f velocity;
+	float half_size;
+	bool circle;
+};
+
+std::vector<MovingProxy> BuildMovingProxies()
+{
+	std::mt19937 generator(50);
+	std::uniform_real_distribution<float> position(-200.0f, 200.0f);
+	std::uniform_real_distribution<float> velocity(-0.3f, 0.3f);
+	std::uniform_real_distribution<float> size(0.5f, 2.0f);
+	std::vector<MovingProxy> proxies;
+	for (std::size_t i = 0; i < kWorldProxies; i++) {
+		proxies.push_back({ { position(generator), position(generator) },
+			{ velocity(generator), velocity(generator) }, size(generator), i % 2 == 0 });
+	}
+	return proxies;
+}
+
+AABB2 MovingProxyAABB(const MovingProxy& proxy)
+{
+	const Vector2f half{ proxy.half_size, proxy.half_size };
+	return { proxy.center - half, proxy.center + half };
+}
+
+} // namespace
+
+// One server tick: every proxy moves then the world steps
+void BM_CollisionWorld2Step(benchmark::State& state)
+{
+	std::vector<MovingProxy> proxies = BuildMovingProxies();
+	CollisionWorld2 world;
+	std::vector<CollisionWorld2::Handle> handles;
+	for (const MovingProxy& proxy : proxies) {
+		handles.push_back(proxy.circle ? world.Add(Circle(proxy.half_size, proxy.center))
+			: world.Add(MovingProxyAABB(proxy)));
+	}
+	world.Step();
+	std::size_t events = 0;
+	for (auto _ : state) {
+		for (std::size_t i = 0; i < proxies.size(); i++) {
+			MovingProxy& proxy = proxies[i];
+			proxy.center += proxy.velocity;
+			if (proxy.circle) {
+				world.Move(handles[i], Circle(proxy.half_size, proxy.center));
+			} else {
+				world.Move(handles[i], MovingProxyAABB(proxy));
+			}
+		}
+		world.Step();
+		events += world.begin_events().size() + world.end_events().size();
+	}
+	benchmark::DoNotOptimize(events);
+	state.counters["bytes"] = static_cast<double>(world.memory_usage());
+	state.SetItemsProcessed(state.iterations() * kWorldProxies);
+}
+BENCHMARK(BM_CollisionWorld2Step);
+
+// Every pair through the exact tests, the only option before the world
+void BM_CollisionWorld2BruteForce(benchmark::State& state)
+{
+	std::vector<MovingProxy> proxies = BuildMovingProxies();
+	for (auto _ : state) {
+		std::size_t pairs = 0;
+		for (MovingProxy& proxy : proxies) {
+			proxy.center += proxy.velocity;
+		}
+		for (std::size_t i = 0; i < proxies.size(); i++) {
+			for (std::size_t j = i + 1; j < proxies.size(); j++) {
+				const MovingProxy& a = proxies[i];
+				const MovingProxy& b = proxies[j];
+				if (a.circle && b.circle) {
+					pairs += OverlapCircle(Circle(a.half_size, a.center), Circle(b.half_size, b.center));
+				} else if (!a.circle && !b.circle) {
+					pairs += Overlap(MovingProxyAABB(a), MovingProxyAABB(b));
+				} else {
+					const MovingProxy& box = a.circle ? b : a;
+					const MovingProxy& circle = a.circle ? a : b;
+					pairs += AABBOverlapCircle(MovingProxyAABB(box), Circle(circle.half_size, circle.center));
+				}
+			}
+		}
+		benchmark::DoNotOptimize(pairs);
+	}
+	state.SetItemsProcessed(state.iterations() * kWorldProxies);
+}
+BENCHMARK(BM_CollisionWorld2BruteForce);
+
+} // namespace maths
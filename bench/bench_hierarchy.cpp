@@ -0,0 +1,164 @@
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "maths/hierarchy.h"
+
+namespace maths {
+
+namespace {
+
+constexpr std::size_t kHierarchyNodes = 131072;
+
+struct BenchHierarchy {
+	std::vector<std::uint32_t> parents;
+	std::vector<Matrix4f> local;
+	std::vector<Quaternion> rotations;
+	std::vector<Vector3f> translations;
+	std::vector<Vector3f> scales;
+	HierarchyLevels levels;
+};
+
+// Breadth first order as scene graphs usually keep it: 16 roots, then
+// every level twice as wide as the previous one with random parents in it
+const BenchHierarchy& GetBenchHierarchy()
+{
+	static const BenchHierarchy hierarchy = [] {
+		BenchHierarchy result;
+		std::mt19937 generator(41);
+		std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+		std::size_t level_begin = 0, level_end = 16;
+		for (std::size_t i = 0; i < kHierarchyNodes; i++) {
+			if (i == 2 * level_end) {
+				level_begin = level_end;
+				level_end = i;
+			}
+			result.parents.push_back(i < 16 ? kNoParent
+				: static_cast<std::uint32_t>(level_begin + generator() % (level_end - level_begin)));
+			const Quaternion rotation = Quaternion(value(generator), value(generator), value(generator),
+				value(generator)).Normalized();
+			const Vector3f translation{ value(generator), value(generator), value(generator) };
+			const Vector3f scale{ 1.0f, 1.0f, 1.0f };
+			result.rotations.push_back(rotation);
+			result.translations.push_back(translation);
+			result.scales.push_back(scale);
+		}
+		// Same transforms as matrices
+		result.local.resize(kHierarchyNodes);
+		UpdateHierarchy(std::vector<std::uint32_t>(kHierarchyNodes, kNoParent), result.rotations,
+			result.translations, result.scales, result.local);
+		result.levels.Build(result.parents);
+		return result;
+	}();
+	return hierarchy;
+}
+
+// Wall time of the benchmark loop, for the nodes per millisecond counter
+class NodesPerMillisecond {
+public:
+	explicit NodesPerMillisecond(benchmark::State& state) : state_(state), start_(std::chrono::steady_clock::now()) {}
+	~NodesPerMillisecond() {
+		const double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_).count();
+		state_.SetItemsProcessed(state_.iterations() * kHierarchyNodes);
+		state_.counters["nodes_per_ms"] = static_cast<double>(state_.iterations() * kHierarchyNodes) / milliseconds;
+	}
+
+private:
+	benchmark::State& state_;
+	std::chrono::steady_clock::time_point start_;
+};
+
+} // namespace
+
+// Previous update: Matrix4f::operator* per node
+void BM_HierarchyOperator(benchmark::State& state)
+{
+	const BenchHierarchy& hierarchy = GetBenchHierarchy();
+	std::vector<Matrix4f> world(kHierarchyNodes);
+	const NodesPerMillisecond counter(state);
+	for (auto _ : state) {
+		for (std::size_t i = 0; i < kHierarchyNodes; i++) {
+			const std::uint32_t parent = hierarchy.parents[i];
+			world[i] = parent == kNoParent ? hierarchy.local[i] : world[parent] * hierarchy.local[i];
+		}
+		benchmark::DoNotOptimize(world.data());
+	}
+}
+BENCHMARK(BM_HierarchyOperator);
+
+void BM_HierarchyMatrices(benchmark::State& state)
+{
+	const BenchHierarchy& hierarchy = GetBenchHierarchy();
+	std::vector<Matrix4f> world(kHierarchyNodes);
+	const NodesPerMillisecond counter(state);
+	for (auto _ : state) {
+		UpdateHierarchy(hierarchy.parents, hierarchy.local, world);
+		benchmark::DoNotOptimize(world.data());
+	}
+}
+BENCHMARK(BM_HierarchyMatrices);
+
+void BM_HierarchyTrs(benchmark::State& state)
+{
+	const BenchHierarchy& hierarchy = GetBenchHierarchy();
+	std::vector<Matrix4f> world(kHierarchyNodes);
+	const NodesPerMillisecond counter(state);
+	for (auto _ : state) {
+		UpdateHierarchy(hierarchy.parents, hierarchy.rotations, hierarchy.translations, hierarchy.scales, world);
+		benchmark::DoNotOptimize(world.data());
+	}
+}
+BENCHMARK(BM_HierarchyTrs);
+
+void BM_HierarchyMatricesParallel(benchmark::State& state)
+{
+	const BenchHierarchy& hierarchy = GetBenchHierarchy();
+	std::vector<Matrix4f> world(kHierarchyNodes);
+	const NodesPerMillisecond counter(state);
+	for (auto _ : state) {
+		UpdateHierarchy(hierarchy.levels, hierarchy.parents, hierarchy.local, world);
+		benchmark::DoNotOptimize(world.data());
+	}
+}
+BENCHMARK(BM_HierarchyMatricesParallel);
+
+void BM_HierarchyTrsParallel(benchmark::State& state)
+{
+	const BenchHierarchy& hierarchy = GetBenchHierarchy();
+	std::vector<Matrix4f> world(kHierarchyNodes);
+	const NodesPerMillisecond counter(state);
+	for (auto _ : state) {
+		UpdateHierarchy(hierarchy.levels, hierarchy.parents, hierarchy.rotations, hierarchy.translations,
+			hierarchy.scales, world);
+		benchmark::DoNotOptimize(world.data());
+	}
+}
+BENCHMARK(BM_HierarchyTrsParallel);
+
+} // namespace maths
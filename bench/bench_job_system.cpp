@@ -0,0 +1,213 @@
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <map>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "maths/batch.h"
+
+namespace maths {
+
+// One pool per thread count, kept alive between benchmark runs
+JobSystem& PoolWithThreads(std::size_t thread_count)
+{
+	static std::map<std::size_t, std::unique_ptr<JobSystem>> pools;
+	auto& pool = pools[thread_count];
+	if (!pool) {
+		pool = std::make_unique<JobSystem>(thread_count);
+	}
+	return *pool;
+}
+
+std::vector<AABB3> RandomAABBs(std::size_t count)
+{
+	std::mt19937 generator(42);
+	std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+	std::uniform_real_distribution<float> size(0.1f, 2.0f);
+	std::vector<AABB3> aabbs;
+	aabbs.reserve(count);
+	for (std::size_t i = 0; i < count; i++) {
+		const Vector3f min{ position(generator), position(generator), position(generator) };
+		aabbs.emplace_back(min, min + Vector3f{ size(generator), size(generator), size(generator) });
+	}
+	return aabbs;
+}
+
+// Registers thread counts from 1 to every hardware thread
+void ThreadCounts(benchmark::internal::Benchmark* benchmark)
+{
+	const int max_threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+	for (int threads = 1; threads <= max_threads; threads *= 2) {
+		benchmark->Arg(threads);
+	}
+	if ((max_threads & (max_threads - 1)) != 0) {
+		benchmark->Arg(max_threads);
+	}
+	benchmark->UseRealTime();
+}
+
+void BM_TransformBatch(benchmark::State& state)
+{
+	JobSystem& jobs = PoolWithThreads(state.range(0));
+	std::vector<Vector4f> in(1 << 20, Vector4f{ 1.0f, 2.0f, 3.0f, 1.0f });
+	std::vector<Vector4f> out(in.size());
+	const Matrix4f matrix = Matrix4f::scalingMatrix(Vector3f{ 2.0f, 2.0f, 2.0f });
+	for (auto _ : state) {
+		TransformBatch(matrix, in, out, jobs);
+		benchmark::DoNotOptimize(out.data());
+	}
+	state.SetItemsProcessed(state.iterations() * in.size());
+}
+BENCHMARK(BM_TransformBatch)->Apply(ThreadCounts);
+
+// Local bounds and world matrices of the objects of a frame
+struct MovingObjects {
+	std::vector<AABB3> local;
+	std::vector<Matrix4f> matrices;
+	std::vector<AABB3> world;
+};
+
+MovingObjects RandomObjects(std::size_t count)
+{
+	std::mt19937 generator(43);
+	std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+	MovingObjects objects;
+	objects.local = RandomAABBs(count);
+	objects.world.resize(count);
+	for (std::size_t i = 0; i < count; i++) {
+		objects.matrices.emplace_back(Vector4f{ value(generator), value(generator), value(generator), 0.0f },
+			Vector4f{ value(generator), value(generator), value(generator), 0.0f },
+			Vector4f{ value(generator), value(generator), value(generator), 0.0f },
+			Vector4f{ value(generator) * 100.0f, value(generator) * 100.0f, value(generator) * 100.0f, 1.0f });
+	}
+	return objects;
+}
+
+// Baseline: the 8 corners through Matrix4f::operator* and a min/max
+void BM_AABB3TransformCorners(benchmark::State& state)
+{
+	MovingObjects objects = RandomObjects(1 << 18);
+	for (auto _ : state) {
+		for (std::size_t i = 0; i < objects.local.size(); i++) {
+			const Vector3f min = objects.local[i].bottom_left(), max = objects.local[i].top_right();
+			AABB3 world = AABB3::Empty();
+			for (int corner = 0; corner < 8; corner++) {
+				const Vector4f point = objects.matrices[i] * Vector4f{ corner & 1 ? max.x : min.x,
+					corner & 2 ? max.y : min.y, corner & 4 ? max.z : min.z, 1.0f };
+				world = Expand(world, Vector3f{ point.x, point.y, point.z });
+			}
+			objects.world[i] = world;
+		}
+		benchmark::DoNotOptimize(objects.world.data());
+	}
+	state.SetItemsProcessed(state.iterations() * objects.local.size());
+}
+BENCHMARK(BM_AABB3TransformCorners);
+
+void BM_AABB3Transformed(benchmark::State& state)
+{
+	MovingObjects objects = RandomObjects(1 << 18);
+	for (auto _ : state) {
+		for (std::size_t i = 0; i < objects.local.size(); i++) {
+			objects.world[i] = objects.local[i].Transformed(objects.matrices[i]);
+		}
+		benchmark::DoNotOptimize(objects.world.data());
+	}
+	state.SetItemsProcessed(state.iterations() * objects.local.size());
+}
+BENCHMARK(BM_AABB3Transformed);
+
+void BM_AABB3TransformBatch(benchmark::State& state)
+{
+	JobSystem& jobs = PoolWithThreads(state.range(0));
+	MovingObjects objects = RandomObjects(1 << 18);
+	for (auto _ : state) {
+		TransformBatch(objects.matrices, objects.local, objects.world, jobs);
+		benchmark::DoNotOptimize(objects.world.data());
+	}
+	state.SetItemsProcessed(state.iterations() * objects.local.size());
+}
+BENCHMARK(BM_AABB3TransformBatch)->Apply(ThreadCounts);
+
+void BM_CullBatch(benchmark::State& state)
+{
+	JobSystem& jobs = PoolWithThreads(state.range(0));
+	const std::vector<AABB3> aabbs = RandomAABBs(1 << 18);
+	Vector3f up{ 0.0f, 1.0f, 0.0f };
+	Vector3f direction{ 0.0f, 0.0f, 1.0f };
+	Vector3f right = Vector3f::Cross(up, direction);
+	Frustum frustum;
+	frustum.calculate_frustum(direction, Vector3f{}, right, up, 0.1f, 100.0f,
+		degree_t(60.0f), degree_t(60.0f));
+	std::vector<std::uint32_t> visible;
+	for (auto _ : state) {
+		visible.clear();
+		CullBatch(frustum, aabbs, visible, jobs);
+		benchmark::DoNotOptimize(visible.data());
+	}
+	state.SetItemsProcessed(state.iterations() * aabbs.size());
+}
+BENCHMARK(BM_CullBatch)->Apply(ThreadCounts);
+
+void BM_IntersectBatch(benchmark::State& state)
+{
+	JobSystem& jobs = PoolWithThreads(state.range(0));
+	const std::vector<AABB3> aabbs = RandomAABBs(256);
+	std::vector<Ray3> rays;
+	std::mt19937 generator(7);
+	std::uniform_real_distribution<float> coordinate(-1.0f, 1.0f);
+	for (int i = 0; i < 4096; i++) {
+		Vector3f origin{};
+		Vector3f direction{ coordinate(generator), coordinate(generator), coordinate(generator) };
+		rays.emplace_back(origin, direction);
+	}
+	std::vector<std::uint8_t> hits(rays.size());
+	for (auto _ : state) {
+		IntersectBatch(rays, aabbs, hits, jobs);
+		benchmark::DoNotOptimize(hits.data());
+	}
+	state.SetItemsProcessed(state.iterations() * rays.size() * aabbs.size());
+}
+BENCHMARK(BM_IntersectBatch)->Apply(ThreadCounts);
+
+void BM_FindOverlappingPairs(benchmark::State& state)
+{
+	JobSystem& jobs = PoolWithThreads(state.range(0));
+	const std::vector<AABB3> aabbs = RandomAABBs(1 << 16);
+	std::vector<std::pair<std::uint32_t, std::uint32_t>> pairs;
+	for (auto _ : state) {
+		pairs.clear();
+		FindOverlappingPairs(aabbs, pairs, jobs);
+		benchmark::DoNotOptimize(pairs.data());
+	}
+	state.SetItemsProcessed(state.iterations() * aabbs.size());
+}
+BENCHMARK(BM_FindOverlappingPairs)->Apply(ThreadCounts);
+
+} // namespace maths
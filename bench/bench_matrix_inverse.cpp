@@ -0,0 +1,182 @@
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+#include "maths/matrix2.h"
+#include "maths/matrix3.h"
+#include "maths/matrix4.h"
+#include "maths/transform3.h"
+
+namespace maths {
+
+namespace {
+
+constexpr std::size_t kInverseCount = 4096;
+
+std::vector<Matrix3f> RandomMatrices3()
+{
+	std::mt19937 generator(8);
+	std::uniform_real_distribution<float> value(-2.0f, 2.0f);
+	std::vector<Matrix3f> matrices;
+	for (std::size_t i = 0; i < kInverseCount; i++) {
+		matrices.emplace_back(Vector3f(value(generator), value(generator), value(generator)),
+			Vector3f(value(generator), value(generator), value(generator)),
+			Vector3f(value(generator), value(generator), value(generator)));
+	}
+	return matrices;
+}
+
+// Half the objects with a uniform scale
+std::vector<Matrix4f> RandomWorldMatrices()
+{
+	std::mt19937 generator(9);
+	std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+	std::vector<Matrix4f> world;
+	for (std::size_t i = 0; i < kInverseCount; i++) {
+		const float scale = 1.5f + value(generator);
+		const Quaternion rotation = Quaternion(value(generator), value(generator), value(generator), value(generator)).Normalized();
+		world.push_back(Transform3(Vector3f{ value(generator), value(generator), value(generator) }, rotation,
+			i % 2 == 0 ? Vector3f{ scale, scale, scale } : Vector3f{ scale, 1.0f, 2.0f }).ToMatrix4f());
+	}
+	return world;
+}
+
+} // namespace
+
+// Previous route: cofactor determinant and adjoint
+void BM_Matrix3fAdjointInverse(benchmark::State& state)
+{
+	const std::vector<Matrix3f> matrices = RandomMatrices3();
+	std::vector<Matrix3f> inverses(kInverseCount);
+	for (auto _ : state) {
+		for (std::size_t i = 0; i < kInverseCount; i++) {
+			const Matrix3f& m = matrices[i];
+			const float det = m[0][0] * m.cofactor(0, 0) + m[0][1] * m.cofactor(1, 0) + m[0][2] * m.cofactor(2, 0);
+			inverses[i] = m.adjoint();
+			inverses[i] *= 1.0f / det;
+		}
+		benchmark::DoNotOptimize(inverses.data());
+	}
+	state.SetItemsProcessed(state.iterations() * kInverseCount);
+}
+BENCHMARK(BM_Matrix3fAdjointInverse);
+
+void BM_Matrix3fTryInverse(benchmark::State& state)
+{
+	const std::vector<Matrix3f> matrices = RandomMatrices3();
+	std::vector<Matrix3f> inverses(kInverseCount);
+	for (auto _ : state) {
+		for (std::size_t i = 0; i < kInverseCount; i++) {
+			benchmark::DoNotOptimize(matrices[i].TryInverse(inverses[i]));
+		}
+		benchmark::DoNotOptimize(inverses.data());
+	}
+	state.SetItemsProcessed(state.iterations() * kInverseCount);
+}
+BENCHMARK(BM_Matrix3fTryInverse);
+
+void BM_Matrix3fInverseBatch(benchmark::State& state)
+{
+	const std::vector<Matrix3f> matrices = RandomMatrices3();
+	std::vector<Matrix3f> inverses(kInverseCount);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(InverseBatch(matrices, inverses));
+		benchmark::DoNotOptimize(inverses.data());
+	}
+	state.SetItemsProcessed(state.iterations() * kInverseCount);
+}
+BENCHMARK(BM_Matrix3fInverseBatch);
+
+void BM_Matrix2fInverseBatch(benchmark::State& state)
+{
+	std::vector<Matrix2f> matrices;
+	for (const Matrix3f& matrix : RandomMatrices3()) {
+		matrices.emplace_back(Vector2f(matrix[0][0], matrix[0][1]), Vector2f(matrix[1][0], matrix[1][1]));
+	}
+	std::vector<Matrix2f> inverses(kInverseCount);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(InverseBatch(matrices, inverses));
+		benchmark::DoNotOptimize(inverses.data());
+	}
+	state.SetItemsProcessed(state.iterations() * kInverseCount);
+}
+BENCHMARK(BM_Matrix2fInverseBatch);
+
+// Runs Matrix3f::determinant in every cofactor
+void BM_Matrix4fInverse(benchmark::State& state)
+{
+	const Matrix4f matrix(Vector4f(2.0f, 0.5f, 0.0f, 0.0f), Vector4f(0.1f, 1.5f, 0.3f, 0.0f),
+		Vector4f(0.0f, 0.2f, 3.0f, 0.0f), Vector4f(1.0f, 2.0f, 3.0f, 1.0f));
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(matrix.Inverse());
+	}
+}
+BENCHMARK(BM_Matrix4fInverse);
+
+// Previous route: full 4x4 inverse then transpose
+void BM_NormalMatrixInverseTranspose(benchmark::State& state)
+{
+	const std::vector<Matrix4f> world = RandomWorldMatrices();
+	std::vector<Matrix4f> normals(kInverseCount);
+	for (auto _ : state) {
+		for (std::size_t i = 0; i < kInverseCount; i++) {
+			normals[i] = world[i].Inverse().Transpose();
+		}
+		benchmark::DoNotOptimize(normals.data());
+	}
+	state.SetItemsProcessed(state.iterations() * kInverseCount);
+}
+BENCHMARK(BM_NormalMatrixInverseTranspose);
+
+void BM_NormalMatrix(benchmark::State& state)
+{
+	const std::vector<Matrix4f> world = RandomWorldMatrices();
+	std::vector<Matrix3f> normals(kInverseCount);
+	for (auto _ : state) {
+		for (std::size_t i = 0; i < kInverseCount; i++) {
+			benchmark::DoNotOptimize(NormalMatrix(world[i], normals[i]));
+		}
+		benchmark::DoNotOptimize(normals.data());
+	}
+	state.SetItemsProcessed(state.iterations() * kInverseCount);
+}
+BENCHMARK(BM_NormalMatrix);
+
+void BM_NormalMatrixBatch(benchmark::State& state)
+{
+	const std::vector<Matrix4f> world = RandomWorldMatrices();
+	std::vector<Matrix3f> normals(kInverseCount);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(NormalMatrixBatch(world, normals));
+		benchmark::DoNotOptimize(normals.data());
+	}
+	state.SetItemsProcessed(state.iterations() * kInverseCount);
+}
+BENCHMARK(BM_NormalMatrixBatch);
+
+} // namespace maths
@@ -0,0 +1,131 @@
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "maths/job_system.h"
+#include "maths/mesh_bvh.h"
+
+namespace maths {
+
+namespace {
+
+// Bumpy height field of size * size quads, two triangles each
+void BuildTerrain(int size, std::vector<Vector3f>& vertices, std::vector<std::uint32_t>& indices)
+{
+	for (int y = 0; y <= size; y++) {
+		for (int x = 0; x <= size; x++) {
+			const float fx = static_cast<float>(x), fy = static_cast<float>(y);
+			vertices.emplace_back(fx, 4.0f * std::sin(fx * 0.11f) * std::cos(fy * 0.07f), fy);
+		}
+	}
+	for (int y = 0; y < size; y++) {
+		for (int x = 0; x < size; x++) {
+			const std::uint32_t first = y * (size + 1) + x;
+			const std::uint32_t above = first + size + 1;
+			indices.insert(indices.end(), { first, above, first + 1, first + 1, above, above + 1 });
+		}
+	}
+}
+
+std::vector<Ray3> BuildTerrainRays(int size, std::size_t count)
+{
+	std::mt19937 generator(24);
+	std::uniform_real_distribution<float> position(0.0f, static_cast<float>(size));
+	std::vector<Ray3> rays;
+	rays.reserve(count);
+	for (std::size_t i = 0; i < count; i++) {
+		Vector3f origin{ position(generator), 50.0f, position(generator) };
+		Vector3f direction = Vector3f{ position(generator), 0.0f, position(generator) } - origin;
+		rays.emplace_back(origin, direction);
+	}
+	return rays;
+}
+
+MeshBvh BuildTerrainBvh(int size, std::uint32_t max_leaf_size)
+{
+	std::vector<Vector3f> vertices;
+	std::vector<std::uint32_t> indices;
+	BuildTerrain(size, vertices, indices);
+	MeshBvh mesh;
+	mesh.Build(vertices, indices, max_leaf_size);
+	return mesh;
+}
+
+} // namespace
+
+void BM_MeshBvhClosestHit(benchmark::State& state)
+{
+	const MeshBvh mesh = BuildTerrainBvh(512, static_cast<std::uint32_t>(state.range(0)));
+	const std::vector<Ray3> rays = BuildTerrainRays(512, 4096);
+	for (auto _ : state) {
+		int hits = 0;
+		for (const Ray3& ray : rays) {
+			MeshHit hit;
+			hits += mesh.ClosestHit(ray, hit);
+		}
+		benchmark::DoNotOptimize(hits);
+	}
+	state.SetItemsProcessed(state.iterations() * rays.size());
+}
+BENCHMARK(BM_MeshBvhClosestHit)->Arg(4)->Arg(8)->ArgNames({ "leaf" });
+
+void BM_MeshBvhAnyHit(benchmark::State& state)
+{
+	const MeshBvh mesh = BuildTerrainBvh(512, static_cast<std::uint32_t>(state.range(0)));
+	const std::vector<Ray3> rays = BuildTerrainRays(512, 4096);
+	for (auto _ : state) {
+		int hits = 0;
+		for (const Ray3& ray : rays) {
+			hits += mesh.AnyHit(ray);
+		}
+		benchmark::DoNotOptimize(hits);
+	}
+	state.SetItemsProcessed(state.iterations() * rays.size());
+}
+BENCHMARK(BM_MeshBvhAnyHit)->Arg(4)->Arg(8)->ArgNames({ "leaf" });
+
+void BM_MeshBvhClosestHitParallel(benchmark::State& state)
+{
+	const MeshBvh mesh = BuildTerrainBvh(512, 4);
+	const std::vector<Ray3> rays = BuildTerrainRays(512, 65536);
+	std::vector<MeshHit> hits(rays.size());
+	JobSystem& jobs = JobSystem::Default();
+	for (auto _ : state) {
+		jobs.ParallelFor(0, rays.size(), [&](std::size_t begin, std::size_t end) {
+			for (std::size_t i = begin; i < end; i++) {
+				mesh.ClosestHit(rays[i], hits[i]);
+			}
+		}, 1024);
+		benchmark::DoNotOptimize(hits.data());
+	}
+	state.SetItemsProcessed(state.iterations() * rays.size());
+}
+BENCHMARK(BM_MeshBvhClosestHitParallel);
+
+} // namespace maths
@@ -0,0 +1,106 @@
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+#include "maths/vector3.h"
+
+namespace maths {
+
+namespace {
+
+constexpr std::size_t kNormalizeCount = 4096;
+
+std::vector<Vector3f> BuildDirections()
+{
+	std::mt19937 generator(48);
+	std::uniform_real_distribution<float> value(-10.0f, 10.0f);
+	std::vector<Vector3f> directions;
+	for (std::size_t i = 0; i < kNormalizeCount; i++) {
+		directions.emplace_back(value(generator), value(generator), value(generator));
+	}
+	return directions;
+}
+
+} // namespace
+
+// std::sqrt, a zero check and three divisions per vector
+void BM_Vector3fNormalized(benchmark::State& state)
+{
+	const std::vector<Vector3f> in = BuildDirections();
+	std::vector<Vector3f> out(kNormalizeCount);
+	for (auto _ : state) {
+		for (std::size_t i = 0; i < kNormalizeCount; i++) {
+			out[i] = in[i].Normalized();
+		}
+		benchmark::DoNotOptimize(out.data());
+	}
+	state.SetItemsProcessed(state.iterations() * kNormalizeCount);
+}
+BENCHMARK(BM_Vector3fNormalized);
+
+void BM_Vector3fNormalizedFast(benchmark::State& state)
+{
+	const std::vector<Vector3f> in = BuildDirections();
+	std::vector<Vector3f> out(kNormalizeCount);
+	for (auto _ : state) {
+		for (std::size_t i = 0; i < kNormalizeCount; i++) {
+			out[i] = in[i].NormalizedFast();
+		}
+		benchmark::DoNotOptimize(out.data());
+	}
+	state.SetItemsProcessed(state.iterations() * kNormalizeCount);
+}
+BENCHMARK(BM_Vector3fNormalizedFast);
+
+void BM_Vector3fNormalizeSafe(benchmark::State& state)
+{
+	const std::vector<Vector3f> in = BuildDirections();
+	std::vector<Vector3f> out(kNormalizeCount);
+	for (auto _ : state) {
+		for (std::size_t i = 0; i < kNormalizeCount; i++) {
+			out[i] = in[i];
+			out[i].NormalizeSafe();
+		}
+		benchmark::DoNotOptimize(out.data());
+	}
+	state.SetItemsProcessed(state.iterations() * kNormalizeCount);
+}
+BENCHMARK(BM_Vector3fNormalizeSafe);
+
+void BM_Vector3fNormalizeBatch(benchmark::State& state)
+{
+	const std::vector<Vector3f> in = BuildDirections();
+	std::vector<Vector3f> out(kNormalizeCount);
+	for (auto _ : state) {
+		NormalizeBatch(in, out);
+		benchmark::DoNotOptimize(out.data());
+	}
+	state.SetItemsProcessed(state.iterations() * kNormalizeCount);
+}
+BENCHMARK(BM_Vector3fNormalizeBatch);
+
+} // namespace maths
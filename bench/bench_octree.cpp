@@ -0,0 +1,179 @@
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+#include "maths/octree.h"
+
+namespace maths {
+
+namespace {
+
+constexpr float kWorldHalfSize = 1000.0f;
+
+std::vector<AABB3> OctreeScene(std::size_t count)
+{
+	std::mt19937 generator(9);
+	std::uniform_real_distribution<float> position(-kWorldHalfSize, kWorldHalfSize - 5.0f);
+	std::uniform_real_distribution<float> size(0.5f, 4.0f);
+	std::vector<AABB3> aabbs;
+	aabbs.reserve(count);
+	for (std::size_t i = 0; i < count; i++) {
+		const Vector3f min{ position(generator), position(generator), position(generator) };
+		aabbs.emplace_back(min, min + Vector3f{ size(generator), size(generator), size(generator) });
+	}
+	return aabbs;
+}
+
+Octree BuildOctree(const std::vector<AABB3>& aabbs)
+{
+	const Vector3f half{ kWorldHalfSize, kWorldHalfSize, kWorldHalfSize };
+	Octree octree(AABB3{ half * -1.0f, half });
+	for (const AABB3& aabb : aabbs) {
+		octree.Insert(aabb);
+	}
+	return octree;
+}
+
+} // namespace
+
+void BM_SphereQueryBruteForce(benchmark::State& state)
+{
+	const std::vector<AABB3> aabbs = OctreeScene(state.range(0));
+	const Sphere sphere{ 50.0f, Vector3f{ 100.0f, 0.0f, -200.0f } };
+	std::vector<std::uint32_t> result;
+	for (auto _ : state) {
+		result.clear();
+		for (std::uint32_t i = 0; i < aabbs.size(); i++) {
+			if (AABBOverlapSphere(aabbs[i], sphere)) {
+				result.push_back(i);
+			}
+		}
+		benchmark::DoNotOptimize(result.data());
+	}
+}
+BENCHMARK(BM_SphereQueryBruteForce)->Arg(10000)->Arg(100000);
+
+void BM_SphereQueryOctree(benchmark::State& state)
+{
+	const Octree octree = BuildOctree(OctreeScene(state.range(0)));
+	const Sphere sphere{ 50.0f, Vector3f{ 100.0f, 0.0f, -200.0f } };
+	std::vector<Octree::Handle> result;
+	for (auto _ : state) {
+		result.clear();
+		octree.QuerySphere(sphere, result);
+		benchmark::DoNotOptimize(result.data());
+	}
+}
+BENCHMARK(BM_SphereQueryOctree)->Arg(10000)->Arg(100000);
+
+void BM_FrustumQueryBruteForce(benchmark::State& state)
+{
+	const std::vector<AABB3> aabbs = OctreeScene(state.range(0));
+	Vector3f up{ 0.0f, 1.0f, 0.0f };
+	Vector3f direction{ 0.0f, 0.0f, 1.0f };
+	Vector3f right = Vector3f::Cross(up, direction);
+	Frustum frustum;
+	frustum.calculate_frustum(direction, Vector3f{}, right, up, 0.1f, 300.0f,
+		degree_t(60.0f), degree_t(60.0f));
+	std::vector<std::uint32_t> result;
+	for (auto _ : state) {
+		result.clear();
+		for (std::uint32_t i = 0; i < aabbs.size(); i++) {
+			if (frustum.contains(aabbs[i])) {
+				result.push_back(i);
+			}
+		}
+		benchmark::DoNotOptimize(result.data());
+	}
+}
+BENCHMARK(BM_FrustumQueryBruteForce)->Arg(100000);
+
+void BM_FrustumQueryOctree(benchmark::State& state)
+{
+	const Octree octree = BuildOctree(OctreeScene(state.range(0)));
+	Vector3f up{ 0.0f, 1.0f, 0.0f };
+	Vector3f direction{ 0.0f, 0.0f, 1.0f };
+	Vector3f right = Vector3f::Cross(up, direction);
+	Frustum frustum;
+	frustum.calculate_frustum(direction, Vector3f{}, right, up, 0.1f, 300.0f,
+		degree_t(60.0f), degree_t(60.0f));
+	std::vector<Octree::Handle> result;
+	for (auto _ : state) {
+		result.clear();
+		octree.QueryFrustum(frustum, result);
+		benchmark::DoNotOptimize(result.data());
+	}
+}
+BENCHMARK(BM_FrustumQueryOctree)->Arg(100000);
+
+void BM_RaycastBruteForce(benchmark::State& state)
+{
+	const std::vector<AABB3> aabbs = OctreeScene(state.range(0));
+	Vector3f origin{ -900.0f, -900.0f, -900.0f };
+	Vector3f direction{ 1.0f, 1.0f, 1.0f };
+	for (auto _ : state) {
+		Ray3 ray{ origin, direction };
+		int hits = 0;
+		for (const AABB3& aabb : aabbs) {
+			hits += ray.IntersectAABB3(aabb);
+		}
+		benchmark::DoNotOptimize(hits);
+	}
+}
+BENCHMARK(BM_RaycastBruteForce)->Arg(100000);
+
+void BM_RaycastOctree(benchmark::State& state)
+{
+	const Octree octree = BuildOctree(OctreeScene(state.range(0)));
+	Vector3f origin{ -900.0f, -900.0f, -900.0f };
+	Vector3f direction{ 1.0f, 1.0f, 1.0f };
+	const Ray3 ray{ origin, direction };
+	for (auto _ : state) {
+		float distance;
+		benchmark::DoNotOptimize(octree.Raycast(ray, distance));
+	}
+}
+BENCHMARK(BM_RaycastOctree)->Arg(100000);
+
+void BM_OctreeMove(benchmark::State& state)
+{
+	const std::vector<AABB3> aabbs = OctreeScene(state.range(0));
+	Octree octree = BuildOctree(aabbs);
+	const Vector3f step{ 0.5f, 0.0f, -0.25f };
+	float offset = 0.0f;
+	for (auto _ : state) {
+		offset = offset > 10.0f ? -10.0f : offset + 1.0f;
+		for (Octree::Handle i = 0; i < aabbs.size(); i++) {
+			octree.Move(i, AABB3{ aabbs[i].bottom_left() + step * offset, aabbs[i].top_right() + step * offset });
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * aabbs.size());
+}
+BENCHMARK(BM_OctreeMove)->Arg(100000);
+
+} // namespace maths
@@ -0,0 +1,74 @@
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <benchmark/benchmark.h>
+
+#include "maths/projection.h"
+
+namespace maths {
+
+// Cofactor inverse of the built matrix, what cameras did before
+void BM_PerspectiveGenericInverse(benchmark::State& state)
+{
+	float near_plane = 0.1f;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(near_plane);
+		const Matrix4f projection = Perspective(radian_t(1.0f), 1.78f, near_plane, 1000.0f);
+		benchmark::DoNotOptimize(projection.Inverse());
+	}
+}
+BENCHMARK(BM_PerspectiveGenericInverse);
+
+void BM_PerspectiveAnalyticInverse(benchmark::State& state)
+{
+	float near_plane = 0.1f;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(near_plane);
+		benchmark::DoNotOptimize(PerspectiveInverse(radian_t(1.0f), 1.78f, near_plane, 1000.0f));
+	}
+}
+BENCHMARK(BM_PerspectiveAnalyticInverse);
+
+void BM_LookAtGenericInverse(benchmark::State& state)
+{
+	Vector3f eye{ 3.0f, 2.0f, -5.0f };
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(eye);
+		const Matrix4f view = LookAt(eye, Vector3f{ 0.0f, 0.0f, 0.0f }, Vector3f{ 0.0f, 1.0f, 0.0f });
+		benchmark::DoNotOptimize(view.Inverse());
+	}
+}
+BENCHMARK(BM_LookAtGenericInverse);
+
+void BM_LookAtAnalyticInverse(benchmark::State& state)
+{
+	Vector3f eye{ 3.0f, 2.0f, -5.0f };
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(eye);
+		benchmark::DoNotOptimize(LookAtInverse(eye, Vector3f{ 0.0f, 0.0f, 0.0f }, Vector3f{ 0.0f, 1.0f, 0.0f }));
+	}
+}
+BENCHMARK(BM_LookAtAnalyticInverse);
+
+} // namespace maths
@@ -0,0 +1,138 @@
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+#include "maths/ray2.h"
+
+namespace maths {
+
+namespace {
+
+constexpr std::size_t kLineOfSightRays = 1024;
+constexpr std::size_t kLineOfSightObstacles = 1024;
+
+struct LineOfSightScene {
+	std::vector<Ray2> rays;
+	std::vector<Circle> circles;
+	std::vector<AABB2> aabbs;
+	std::vector<float> center_x, center_y, radius;
+	std::vector<float> min_x, min_y, max_x, max_y;
+};
+
+LineOfSightScene BuildLineOfSightScene()
+{
+	std::mt19937 generator(49);
+	std::uniform_real_distribution<float> position(-500.0f, 500.0f);
+	std::uniform_real_distribution<float> size(0.5f, 5.0f);
+	LineOfSightScene scene;
+	for (std::size_t i = 0; i < kLineOfSightObstacles; i++) {
+		const Vector2f center{ position(generator), position(generator) };
+		const float r = size(generator);
+		const Vector2f half{ size(generator), size(generator) };
+		scene.circles.emplace_back(r, center);
+		scene.aabbs.emplace_back(center - half, center + half);
+		scene.center_x.push_back(center.x);
+		scene.center_y.push_back(center.y);
+		scene.radius.push_back(r);
+		scene.min_x.push_back(center.x - half.x);
+		scene.min_y.push_back(center.y - half.y);
+		scene.max_x.push_back(center.x + half.x);
+		scene.max_y.push_back(center.y + half.y);
+	}
+	for (std::size_t i = 0; i < kLineOfSightRays; i++) {
+		Vector2f origin{ position(generator), position(generator) };
+		Vector2f direction{ position(generator), position(generator) };
+		scene.rays.emplace_back(origin, direction);
+	}
+	return scene;
+}
+
+} // namespace
+
+// Previous approach: every pair through the member tests, which only report
+// whether something was hit
+void BM_Ray2CirclePairs(benchmark::State& state)
+{
+	const LineOfSightScene scene = BuildLineOfSightScene();
+	for (auto _ : state) {
+		std::size_t hits = 0;
+		for (const Ray2& query : scene.rays) {
+			Ray2 ray = query;
+			for (const Circle& circle : scene.circles) {
+				hits += ray.IntersectCircle(circle);
+			}
+		}
+		benchmark::DoNotOptimize(hits);
+	}
+	state.SetItemsProcessed(state.iterations() * kLineOfSightRays * kLineOfSightObstacles);
+}
+BENCHMARK(BM_Ray2CirclePairs);
+
+void BM_Ray2CircleNearestBatch(benchmark::State& state)
+{
+	const LineOfSightScene scene = BuildLineOfSightScene();
+	const CircleSoA circles{ scene.center_x, scene.center_y, scene.radius };
+	std::vector<Ray2Hit> hits(kLineOfSightRays);
+	for (auto _ : state) {
+		IntersectNearestBatch(scene.rays, circles, hits);
+		benchmark::DoNotOptimize(hits.data());
+	}
+	state.SetItemsProcessed(state.iterations() * kLineOfSightRays * kLineOfSightObstacles);
+}
+BENCHMARK(BM_Ray2CircleNearestBatch);
+
+void BM_Ray2AABB2Pairs(benchmark::State& state)
+{
+	const LineOfSightScene scene = BuildLineOfSightScene();
+	for (auto _ : state) {
+		std::size_t hits = 0;
+		for (const Ray2& query : scene.rays) {
+			Ray2 ray = query;
+			for (const AABB2& aabb : scene.aabbs) {
+				hits += ray.IntersectAABB2(aabb);
+			}
+		}
+		benchmark::DoNotOptimize(hits);
+	}
+	state.SetItemsProcessed(state.iterations() * kLineOfSightRays * kLineOfSightObstacles);
+}
+BENCHMARK(BM_Ray2AABB2Pairs);
+
+void BM_Ray2AABB2NearestBatch(benchmark::State& state)
+{
+	const LineOfSightScene scene = BuildLineOfSightScene();
+	const AABB2SoA aabbs{ scene.min_x, scene.min_y, scene.max_x, scene.max_y };
+	std::vector<Ray2Hit> hits(kLineOfSightRays);
+	for (auto _ : state) {
+		IntersectNearestBatch(scene.rays, aabbs, hits);
+		benchmark::DoNotOptimize(hits.data());
+	}
+	state.SetItemsProcessed(state.iterations() * kLineOfSightRays * kLineOfSightObstacles);
+}
+BENCHMARK(BM_Ray2AABB2NearestBatch);
+
+} // namespace maths
@@ -0,0 +1,127 @@
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <vector>
+
+#include "maths/scene_file.h"
+
+namespace maths {
+
+namespace {
+
+constexpr std::size_t kSceneFileBoxes = 1000000;
+
+std::vector<AABB3> SceneFileBenchBoxes()
+{
+	std::mt19937 generator(31);
+	std::uniform_real_distribution<float> position(-1000.0f, 1000.0f);
+	std::uniform_real_distribution<float> size(0.5f, 4.0f);
+	std::vector<AABB3> aabbs;
+	aabbs.reserve(kSceneFileBoxes);
+	for (std::size_t i = 0; i < kSceneFileBoxes; i++) {
+		const Vector3f min{ position(generator), position(generator) * 0.1f, position(generator) };
+		aabbs.emplace_back(min, min + Vector3f{ size(generator), size(generator), size(generator) });
+	}
+	return aabbs;
+}
+
+// Scene of 1M AABB3 with their BVH written once, and the same boxes as a
+// raw array for the rebuild at load baseline
+const std::string& SceneFileBenchPath()
+{
+	static const std::string path = [] {
+		const std::filesystem::path directory = std::filesystem::temp_directory_path();
+		const std::vector<AABB3> aabbs = SceneFileBenchBoxes();
+		Bvh bvh;
+		bvh.BuildLinear(aabbs);
+		SceneWriter writer;
+		writer.Add(aabbs);
+		writer.Add(bvh);
+		writer.Write((directory / "bench_scene.bin").string());
+		std::ofstream raw(directory / "bench_scene_boxes.bin", std::ios::binary | std::ios::trunc);
+		raw.write(reinterpret_cast<const char*>(aabbs.data()), aabbs.size() * sizeof(AABB3));
+		return (directory / "bench_scene.bin").string();
+	}();
+	return path;
+}
+
+// First query after loading, touches the pages on the path to one leaf
+std::uint32_t SceneFileFirstRaycast(const BvhView& bvh, std::span<const AABB3> aabbs)
+{
+	Vector3f origin{ 10.0f, 0.0f, -1100.0f };
+	Vector3f direction{ 0.0f, 0.0f, 1.0f };
+	float distance;
+	return bvh.Raycast(aabbs, Ray3(origin, direction), distance);
+}
+
+} // namespace
+
+void BM_SceneFileMap(benchmark::State& state)
+{
+	const std::string& path = SceneFileBenchPath();
+	for (auto _ : state) {
+		SceneFile scene;
+		scene.Open(path);
+		benchmark::DoNotOptimize(SceneFileFirstRaycast(scene.bvh(), scene.aabbs()));
+	}
+}
+BENCHMARK(BM_SceneFileMap)->Unit(benchmark::kMillisecond);
+
+void BM_SceneFileMapValidate(benchmark::State& state)
+{
+	const std::string& path = SceneFileBenchPath();
+	for (auto _ : state) {
+		SceneFile scene;
+		scene.Open(path, true);
+		benchmark::DoNotOptimize(SceneFileFirstRaycast(scene.bvh(), scene.aabbs()));
+	}
+}
+BENCHMARK(BM_SceneFileMapValidate)->Unit(benchmark::kMillisecond);
+
+// Previous startup: read the boxes, then build the tree
+void BM_SceneFileReadAndBuild(benchmark::State& state)
+{
+	SceneFileBenchPath();
+	const std::filesystem::path raw_path = std::filesystem::temp_directory_path() / "bench_scene_boxes.bin";
+	for (auto _ : state) {
+		std::vector<AABB3> aabbs(kSceneFileBoxes);
+		std::ifstream raw(raw_path, std::ios::binary);
+		raw.read(reinterpret_cast<char*>(aabbs.data()), aabbs.size() * sizeof(AABB3));
+		Bvh bvh;
+		if (state.range(0) != 0) {
+			bvh.BuildLinear(aabbs);
+		} else {
+			bvh.Build(aabbs, 1);
+		}
+		benchmark::DoNotOptimize(SceneFileFirstRaycast(bvh.view(), aabbs));
+	}
+}
+BENCHMARK(BM_SceneFileReadAndBuild)->Arg(0)->Arg(1)->ArgNames({ "linear" })->Unit(benchmark::kMillisecond)->Iterations(1);
+
+} // namespace maths
@@ -0,0 +1,163 @@
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+#include "maths/skinning.h"
+#include "maths/transform3.h"
+
+namespace maths {
+
+namespace {
+
+constexpr std::size_t kSkinVertices = 65536;
+constexpr std::size_t kSkinBones = 64;
+
+struct SkinningScene {
+	std::vector<Matrix4f> palette;
+	std::vector<DualQuaternion> dual_palette;
+	std::vector<Vector4f> positions, normals;
+	std::vector<float> px, py, pz, nx, ny, nz;
+	std::vector<BoneInfluences> influences;
+	std::vector<float> out_px, out_py, out_pz, out_nx, out_ny, out_nz;
+
+	SkinningInput input() const { return { px, py, pz, nx, ny, nz, influences }; }
+	SkinningOutput output() { return { out_px, out_py, out_pz, out_nx, out_ny, out_nz }; }
+};
+
+SkinningScene BuildSkinningScene()
+{
+	std::mt19937 generator(17);
+	std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+	std::uniform_int_distribution<int> bone(0, kSkinBones - 1);
+	SkinningScene scene;
+	for (std::size_t b = 0; b < kSkinBones; b++) {
+		const Transform3 transform(Vector3f{ value(generator), value(generator), value(generator) },
+			Quaternion(value(generator), value(generator), value(generator), value(generator)).Normalized(),
+			Vector3f{ 1.0f, 1.0f, 1.0f });
+		scene.palette.push_back(transform.ToMatrix4f());
+	}
+	scene.dual_palette.resize(kSkinBones);
+	BuildDualQuaternionPalette(scene.palette, scene.dual_palette);
+	for (std::size_t i = 0; i < kSkinVertices; i++) {
+		const Vector3f position{ value(generator), value(generator), value(generator) };
+		const Vector3f normal = Vector3f{ value(generator), value(generator), 1.0f }.Normalized();
+		scene.positions.emplace_back(position.x, position.y, position.z, 1.0f);
+		scene.normals.emplace_back(normal.x, normal.y, normal.z, 0.0f);
+		scene.px.push_back(position.x);
+		scene.py.push_back(position.y);
+		scene.pz.push_back(position.z);
+		scene.nx.push_back(normal.x);
+		scene.ny.push_back(normal.y);
+		scene.nz.push_back(normal.z);
+		BoneInfluences influence;
+		// Neighbouring vertices share bones, like a real mesh
+		const int first_bone = static_cast<int>(i * kSkinBones / kSkinVertices);
+		for (std::size_t k = 0; k < kMaxBoneInfluences; k++) {
+			influence.bones[k] = static_cast<std::uint16_t>((first_bone + (k == 0 ? 0 : bone(generator) % 4)) % kSkinBones);
+			influence.weights[k] = 0.25f;
+		}
+		scene.influences.push_back(influence);
+	}
+	for (std::vector<float>* stream : { &scene.out_px, &scene.out_py, &scene.out_pz, &scene.out_nx, &scene.out_ny, &scene.out_nz }) {
+		stream->resize(kSkinVertices);
+	}
+	return scene;
+}
+
+} // namespace
+
+// Previous approach: four weighted Matrix4f * Vector4f per vertex
+void BM_SkinMatrixVector(benchmark::State& state)
+{
+	SkinningScene scene = BuildSkinningScene();
+	std::vector<Vector4f> positions(kSkinVertices), normals(kSkinVertices);
+	for (auto _ : state) {
+		for (std::size_t i = 0; i < kSkinVertices; i++) {
+			const BoneInfluences& influence = scene.influences[i];
+			Vector4f position(0.0f, 0.0f, 0.0f, 0.0f);
+			Vector4f normal(0.0f, 0.0f, 0.0f, 0.0f);
+			for (std::size_t k = 0; k < kMaxBoneInfluences; k++) {
+				const Matrix4f& bone = scene.palette[influence.bones[k]];
+				position += bone * scene.positions[i] * influence.weights[k];
+				normal += bone * scene.normals[i] * influence.weights[k];
+			}
+			positions[i] = position;
+			normals[i] = normal / normal.Magnitude();
+		}
+		benchmark::DoNotOptimize(positions.data());
+		benchmark::DoNotOptimize(normals.data());
+	}
+	state.SetItemsProcessed(state.iterations() * kSkinVertices);
+}
+BENCHMARK(BM_SkinMatrixVector);
+
+void BM_SkinLinearBlend(benchmark::State& state)
+{
+	SkinningScene scene = BuildSkinningScene();
+	for (auto _ : state) {
+		SkinLinearBlend(scene.palette, scene.input(), scene.output());
+		benchmark::DoNotOptimize(scene.out_px.data());
+	}
+	state.SetItemsProcessed(state.iterations() * kSkinVertices);
+}
+BENCHMARK(BM_SkinLinearBlend);
+
+void BM_SkinLinearBlendParallel(benchmark::State& state)
+{
+	SkinningScene scene = BuildSkinningScene();
+	for (auto _ : state) {
+		SkinLinearBlend(scene.palette, scene.input(), scene.output(), JobSystem::Default());
+		benchmark::DoNotOptimize(scene.out_px.data());
+	}
+	state.SetItemsProcessed(state.iterations() * kSkinVertices);
+}
+BENCHMARK(BM_SkinLinearBlendParallel)->UseRealTime();
+
+void BM_SkinDualQuaternion(benchmark::State& state)
+{
+	SkinningScene scene = BuildSkinningScene();
+	for (auto _ : state) {
+		SkinDualQuaternion(scene.dual_palette, scene.input(), scene.output());
+		benchmark::DoNotOptimize(scene.out_px.data());
+	}
+	state.SetItemsProcessed(state.iterations() * kSkinVertices);
+}
+BENCHMARK(BM_SkinDualQuaternion);
+
+void BM_SkinDualQuaternionParallel(benchmark::State& state)
+{
+	SkinningScene scene = BuildSkinningScene();
+	for (auto _ : state) {
+		SkinDualQuaternion(scene.dual_palette, scene.input(), scene.output(), JobSystem::Default());
+		benchmark::DoNotOptimize(scene.out_px.data());
+	}
+	state.SetItemsProcessed(state.iterations() * kSkinVertices);
+}
+BENCHMARK(BM_SkinDualQuaternionParallel)->UseRealTime();
+
+} // namespace maths
@@ -0,0 +1,128 @@
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "maths/octree.h"
+#include "maths/spatial_sort.h"
+
+namespace maths {
+
+namespace {
+
+constexpr float kWorldHalfSize = 1000.0f;
+
+std::vector<Sphere> SortScene(std::size_t count)
+{
+	std::mt19937 generator(11);
+	std::uniform_real_distribution<float> position(-kWorldHalfSize, kWorldHalfSize);
+	std::vector<Sphere> spheres;
+	spheres.reserve(count);
+	for (std::size_t i = 0; i < count; i++) {
+		spheres.emplace_back(2.0f, Vector3f{ position(generator), position(generator), position(generator) });
+	}
+	return spheres;
+}
+
+std::vector<std::uint64_t> RandomKeys(std::size_t count)
+{
+	std::mt19937_64 generator(12);
+	std::vector<std::uint64_t> keys(count);
+	for (std::uint64_t& key : keys) {
+		key = generator() >> 1;
+	}
+	return keys;
+}
+
+} // namespace
+
+void BM_SortIndicesStd(benchmark::State& state)
+{
+	const std::vector<std::uint64_t> keys = RandomKeys(state.range(0));
+	std::vector<std::uint32_t> order(keys.size());
+	for (auto _ : state) {
+		std::iota(order.begin(), order.end(), 0u);
+		std::stable_sort(order.begin(), order.end(),
+			[&keys](std::uint32_t a, std::uint32_t b) { return keys[a] < keys[b]; });
+		benchmark::DoNotOptimize(order.data());
+	}
+	state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK(BM_SortIndicesStd)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+void BM_SortIndicesRadix(benchmark::State& state)
+{
+	const std::vector<std::uint64_t> keys = RandomKeys(state.range(0));
+	std::vector<std::uint32_t> order;
+	for (auto _ : state) {
+		RadixSortIndices(keys, order);
+		benchmark::DoNotOptimize(order.data());
+	}
+	state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK(BM_SortIndicesRadix)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// Sphere queries that read back the shapes they return. With the input in
+// curve order the octree handles of one query are close in memory.
+void BM_QueryLocality(benchmark::State& state)
+{
+	std::vector<Sphere> spheres = SortScene(1000000);
+	if (state.range(0) != 0) {
+		SpatialSort(std::span<Sphere>(spheres), SpaceFillingCurve::kHilbert);
+	}
+	const Vector3f half{ kWorldHalfSize, kWorldHalfSize, kWorldHalfSize };
+	Octree octree(AABB3{ half * -1.0f, half });
+	for (const Sphere& sphere : spheres) {
+		const Vector3f extent{ sphere.radius(), sphere.radius(), sphere.radius() };
+		octree.Insert(AABB3{ sphere.center() - extent, sphere.center() + extent });
+	}
+
+	std::mt19937 generator(13);
+	std::uniform_real_distribution<float> position(-kWorldHalfSize, kWorldHalfSize);
+	std::vector<Octree::Handle> result;
+	double index_delta = 0.0;
+	std::size_t touched = 0;
+	for (auto _ : state) {
+		result.clear();
+		octree.QuerySphere(Sphere{ 60.0f, Vector3f{ position(generator), position(generator), position(generator) } }, result);
+		std::sort(result.begin(), result.end());
+		float radius_sum = 0.0f;
+		for (std::size_t i = 0; i < result.size(); i++) {
+			radius_sum += spheres[result[i]].radius();
+			if (i > 0) {
+				index_delta += result[i] - result[i - 1];
+			}
+		}
+		touched += result.size();
+		benchmark::DoNotOptimize(radius_sum);
+	}
+	state.counters["mean_index_delta"] = touched > 0 ? index_delta / static_cast<double>(touched) : 0.0;
+}
+BENCHMARK(BM_QueryLocality)->Arg(0)->Arg(1)->ArgNames({ "sorted" });
+
+} // namespace maths
@@ -0,0 +1,138 @@
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+#include "maths/transform3.h"
+
+namespace maths {
+
+namespace {
+
+constexpr std::size_t kBakeCount = 65536;
+
+std::vector<Transform3> BuildTransforms()
+{
+	std::mt19937 generator(51);
+	std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+	std::vector<Transform3> transforms;
+	for (std::size_t i = 0; i < kBakeCount; i++) {
+		transforms.emplace_back(Vector3f{ value(generator), value(generator), value(generator) },
+			Quaternion(value(generator), value(generator), value(generator), value(generator)).Normalized(),
+			Vector3f{ 1.0f, 1.0f + 0.1f * value(generator), 1.0f });
+	}
+	return transforms;
+}
+
+// Imported node matrices, one in eight with a shear
+std::vector<Matrix4f> BuildImportedMatrices()
+{
+	std::vector<Matrix4f> matrices;
+	int i = 0;
+	for (const Transform3& transform : BuildTransforms()) {
+		Matrix4f matrix = transform.ToMatrix4f();
+		if (i++ % 8 == 0) {
+			matrix[1] += matrix[0] * 0.2f;
+		}
+		matrices.push_back(matrix);
+	}
+	return matrices;
+}
+
+} // namespace
+
+// Previous bake: three 4x4 products, with a single axis rotation
+void BM_BakeMatrixProducts(benchmark::State& state)
+{
+	const std::vector<Transform3> transforms = BuildTransforms();
+	std::vector<Matrix4f> matrices(kBakeCount);
+	for (auto _ : state) {
+		for (std::size_t i = 0; i < kBakeCount; i++) {
+			const Transform3& transform = transforms[i];
+			matrices[i] = Matrix4f::translationMatrix(transform.translation)
+				* Matrix4f::rotationMatrix(radian_t(transform.rotation.w), 'z')
+				* Matrix4f::scalingMatrix(transform.scale);
+		}
+		benchmark::DoNotOptimize(matrices.data());
+	}
+	state.SetItemsProcessed(state.iterations() * kBakeCount);
+}
+BENCHMARK(BM_BakeMatrixProducts);
+
+void BM_BakeToMatrix4f(benchmark::State& state)
+{
+	const std::vector<Transform3> transforms = BuildTransforms();
+	std::vector<Matrix4f> matrices(kBakeCount);
+	for (auto _ : state) {
+		for (std::size_t i = 0; i < kBakeCount; i++) {
+			matrices[i] = transforms[i].ToMatrix4f();
+		}
+		benchmark::DoNotOptimize(matrices.data());
+	}
+	state.SetItemsProcessed(state.iterations() * kBakeCount);
+}
+BENCHMARK(BM_BakeToMatrix4f);
+
+void BM_BakeBatch(benchmark::State& state)
+{
+	const std::vector<Transform3> transforms = BuildTransforms();
+	std::vector<Matrix4f> matrices(kBakeCount);
+	for (auto _ : state) {
+		ToMatrix4fBatch(transforms, matrices);
+		benchmark::DoNotOptimize(matrices.data());
+	}
+	state.SetItemsProcessed(state.iterations() * kBakeCount);
+}
+BENCHMARK(BM_BakeBatch);
+
+void BM_Decompose(benchmark::State& state)
+{
+	const std::vector<Matrix4f> matrices = BuildImportedMatrices();
+	std::vector<Transform3> transforms(kBakeCount);
+	for (auto _ : state) {
+		for (std::size_t i = 0; i < kBakeCount; i++) {
+			benchmark::DoNotOptimize(Decompose(matrices[i], transforms[i]));
+		}
+		benchmark::DoNotOptimize(transforms.data());
+	}
+	state.SetItemsProcessed(state.iterations() * kBakeCount);
+}
+BENCHMARK(BM_Decompose);
+
+void BM_DecomposeBatch(benchmark::State& state)
+{
+	const std::vector<Matrix4f> matrices = BuildImportedMatrices();
+	std::vector<Transform3> transforms(kBakeCount);
+	for (auto _ : state) {
+		DecomposeBatch(matrices, transforms);
+		benchmark::DoNotOptimize(transforms.data());
+	}
+	state.SetItemsProcessed(state.iterations() * kBakeCount);
+}
+BENCHMARK(BM_DecomposeBatch)->UseRealTime();
+
+} // namespace maths
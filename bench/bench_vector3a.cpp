@@ -0,0 +1,110 @@
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+#include "maths/vector3a.h"
+
+namespace maths {
+
+namespace {
+
+constexpr std::size_t kVectorCount = 4096;
+
+std::vector<Vector3f> BuildVectors(unsigned seed)
+{
+	std::mt19937 generator(seed);
+	std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+	std::vector<Vector3f> vectors;
+	for (std::size_t i = 0; i < kVectorCount; i++) {
+		vectors.emplace_back(value(generator), value(generator), value(generator));
+	}
+	return vectors;
+}
+
+} // namespace
+
+// Face normal and its facing term, the inner loop of culling and shading
+void BM_Vector3fCrossNormalizeDot(benchmark::State& state)
+{
+	const std::vector<Vector3f> a = BuildVectors(1);
+	const std::vector<Vector3f> b = BuildVectors(2);
+	std::vector<Vector3f> normals(kVectorCount);
+	for (auto _ : state) {
+		float facing = 0.0f;
+		for (std::size_t i = 0; i < kVectorCount; i++) {
+			normals[i] = a[i].Cross(b[i]).Normalized();
+			facing += normals[i].Dot(a[i]);
+		}
+		benchmark::DoNotOptimize(normals.data());
+		benchmark::DoNotOptimize(facing);
+	}
+	state.SetItemsProcessed(state.iterations() * kVectorCount);
+}
+BENCHMARK(BM_Vector3fCrossNormalizeDot);
+
+void BM_Vector3fACrossNormalizeDot(benchmark::State& state)
+{
+	std::vector<Vector3fA> a;
+	std::vector<Vector3fA> b;
+	for (const Vector3f& v : BuildVectors(1)) a.emplace_back(v);
+	for (const Vector3f& v : BuildVectors(2)) b.emplace_back(v);
+	std::vector<Vector3fA> normals(kVectorCount);
+	for (auto _ : state) {
+		float facing = 0.0f;
+		for (std::size_t i = 0; i < kVectorCount; i++) {
+			normals[i] = a[i].Cross(b[i]).Normalized();
+			facing += normals[i].Dot(a[i]);
+		}
+		benchmark::DoNotOptimize(normals.data());
+		benchmark::DoNotOptimize(facing);
+	}
+	state.SetItemsProcessed(state.iterations() * kVectorCount);
+}
+BENCHMARK(BM_Vector3fACrossNormalizeDot);
+
+// Converting at the loop boundary, as hot paths on Vector3f storage would
+void BM_Vector3fAConverted(benchmark::State& state)
+{
+	const std::vector<Vector3f> a = BuildVectors(1);
+	const std::vector<Vector3f> b = BuildVectors(2);
+	std::vector<Vector3f> normals(kVectorCount);
+	for (auto _ : state) {
+		float facing = 0.0f;
+		for (std::size_t i = 0; i < kVectorCount; i++) {
+			const Vector3fA aa(a[i]);
+			const Vector3fA normal = aa.Cross(Vector3fA(b[i])).Normalized();
+			facing += normal.Dot(aa);
+			normals[i] = normal.ToVector3f();
+		}
+		benchmark::DoNotOptimize(normals.data());
+		benchmark::DoNotOptimize(facing);
+	}
+	state.SetItemsProcessed(state.iterations() * kVectorCount);
+}
+BENCHMARK(BM_Vector3fAConverted);
+
+} // namespace maths
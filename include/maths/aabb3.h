@@ -28,6 +28,8 @@ SOFTWARE.
 
 namespace maths {
 
+class Matrix4f;
+
 // Class that creates an AABB3
 class AABB3 {
 public:
@@ -45,12 +47,29 @@ public:
 
 	Vector3f bottom_left() const { return bottom_left_; }
 	Vector3f top_right() const { return top_right_; }
+
+	// AABB of the box moved by an affine matrix (translation in column 3),
+	// from the transformed center and the extent through |matrix| (Arvo)
+	AABB3 Transformed(const Matrix4f& matrix) const;
+
+	// Inverted box containing nothing, the identity of Union and Expand
+	static AABB3 Empty();
+	bool IsEmpty() const {
+		return bottom_left_.x > top_right_.x || bottom_left_.y > top_right_.y || bottom_left_.z > top_right_.z;
+	}
 	
 private:
 	Vector3f bottom_left_ = {};
 	Vector3f top_right_ = {};
 };
 
+// Smallest AABB containing both boxes
+AABB3 Union(const AABB3& a, const AABB3& b);
+// Smallest AABB containing the box and the point
+AABB3 Expand(const AABB3& aabb, const Vector3f& point);
+// Box grown by margin on every side
+AABB3 Expand(const AABB3& aabb, float margin);
+
 // To find out if two AABB is are touching each other
 bool Overlap(const AABB3& a, const AABB3& b);
 // To find out if one AABB is contained in the other
@@ -0,0 +1,81 @@
+#pragma once
+
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "maths/aabb3.h"
+#include "maths/frustum.h"
+#include "maths/job_system.h"
+#include "maths/matrix4.h"
+#include "maths/ray3.h"
+#include "maths/sphere.h"
+
+namespace maths {
+
+// Batched geometry queries split over a JobSystem.
+// Outputs are always written in input order, whatever the thread count.
+
+// out[i] = matrix * in[i], only min(in.size(), out.size()) elements are written
+void TransformBatch(const Matrix4f& matrix, std::span<const Vector4f> in,
+	std::span<Vector4f> out, JobSystem& jobs = JobSystem::Default());
+
+// world[i] = local[i].Transformed(matrices[i]), the world bounds of every
+// object in one SIMD pass. Only the common size of the spans is written.
+void TransformBatch(std::span<const Matrix4f> matrices, std::span<const AABB3> local,
+	std::span<AABB3> world, JobSystem& jobs = JobSystem::Default());
+
+// world[i] = local[i].Transformed(matrix)
+void TransformBatch(const Matrix4f& matrix, std::span<const AABB3> local,
+	std::span<AABB3> world, JobSystem& jobs = JobSystem::Default());
+
+// Appends to visible the indices of the AABBs contained in the frustum
+void CullBatch(const Frustum& frustum, std::span<const AABB3> aabbs,
+	std::vector<std::uint32_t>& visible, JobSystem& jobs = JobSystem::Default());
+
+// Appends to visible the indices of the spheres at least partially inside
+// every plane of the frustum, tested with Frustum::ContainsBatch
+void CullBatch(const Frustum& frustum, std::span<const Sphere> spheres,
+	std::vector<std::uint32_t>& visible, JobSystem& jobs = JobSystem::Default());
+
+// hits[i] is 1 if rays[i] intersects at least one of the AABBs
+void IntersectBatch(std::span<const Ray3> rays, std::span<const AABB3> aabbs,
+	std::span<std::uint8_t> hits, JobSystem& jobs = JobSystem::Default());
+
+// hits[i] is 1 if rays[i] intersects at least one of the spheres
+void IntersectBatch(std::span<const Ray3> rays, std::span<const Sphere> spheres,
+	std::span<std::uint8_t> hits, JobSystem& jobs = JobSystem::Default());
+
+// Broadphase: sort and sweep along x, returns every (i, j) with i < j whose
+// bounds touch. Unlike Overlap, a box contained in another is reported too.
+// Pairs are sorted by i then j.
+void FindOverlappingPairs(std::span<const AABB3> aabbs,
+	std::vector<std::pair<std::uint32_t, std::uint32_t>>& pairs,
+	JobSystem& jobs = JobSystem::Default());
+
+} // namespace maths
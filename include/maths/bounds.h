@@ -0,0 +1,57 @@
+#pragma once
+
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <span>
+
+#include "maths/aabb3.h"
+#include "maths/obb3.h"
+#include "maths/sphere.h"
+#include "maths/vector3.h"
+
+namespace maths {
+
+// Bounding volumes fitted to point clouds, used on mesh import and on every
+// skinned bounds update. An empty span gives an empty AABB3, a zero sphere
+// and a zero OBB3.
+
+// Tight AABB, min/max reduction four floats at a time
+AABB3 ComputeAABB3(std::span<const Vector3f> points);
+
+// Ritter's sphere: the two far points found from an arbitrary one give the
+// initial sphere, which grows over the points. Up to ~20% over optimal.
+Sphere ComputeRitterSphere(std::span<const Vector3f> points);
+
+// EPOS-14 sphere (Larsson 2008): minimal sphere of the extremal points
+// along 7 directions, grown over the points like Ritter's. The smallest of
+// this and ComputeRitterSphere is returned, usually within a few percent
+// of the minimal sphere.
+Sphere ComputeBoundingSphere(std::span<const Vector3f> points);
+
+// OBB along the principal axes of the point covariance. Falls back to the
+// AABB when it is smaller, as PCA can do worse on symmetric shapes.
+OBB3 ComputeOBB3(std::span<const Vector3f> points);
+
+}  // namespace maths
@@ -0,0 +1,180 @@
+#pragma once
+
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <span>
+#include <vector>
+
+#include "maths/aabb3.h"
+#include "maths/frustum.h"
+#include "maths/job_system.h"
+#include "maths/ray3.h"
+#include "maths/sphere.h"
+
+namespace maths {
+
+// Node of a Bvh, 32 bytes so two siblings share a cache line
+struct BvhNode {
+	AABB3 bounds;
+	// Inner node: index of the left child, the right child is first + 1.
+	// Leaf: index of its first item in Bvh::items().
+	std::uint32_t first = 0;
+	// Number of items of a leaf, 0 for an inner node
+	std::uint32_t count = 0;
+
+	bool IsLeaf() const { return count != 0; }
+};
+
+// Culling state of one view kept between frames: the plane that rejected
+// each node last time, tested first on the next frame.
+struct BvhCullCache {
+	std::vector<std::uint8_t> last_plane;
+};
+
+// Read-only queries over flattened Bvh nodes and items stored elsewhere,
+// such as a Bvh or a mapped SceneFile. The root is at index 0 and the two
+// children of an inner node are adjacent, but may be stored before their
+// parent (Bvh::BuildLinear).
+class BvhView {
+public:
+	using LeafVisitor = std::function<void(std::span<const std::uint32_t> items)>;
+
+	BvhView() = default;
+	BvhView(std::span<const BvhNode> nodes, std::span<const std::uint32_t> items)
+		: nodes_(nodes), items_(items) {}
+
+	// See Bvh
+	void CullFrustum(const Frustum& frustum, BvhCullCache& cache,
+		const LeafVisitor& visitor) const;
+	void CullFrustum(const Frustum& frustum, BvhCullCache& cache,
+		std::vector<std::uint32_t>& visible) const;
+	void QuerySphere(std::span<const AABB3> aabbs, const Sphere& sphere,
+		std::vector<std::uint32_t>& result) const;
+	std::uint32_t Raycast(std::span<const AABB3> aabbs, const Ray3& ray, float& distance,
+		float max_distance = std::numeric_limits<float>::infinity()) const;
+
+	std::span<const BvhNode> nodes() const { return nodes_; }
+	std::span<const std::uint32_t> items() const { return items_; }
+	bool empty() const { return nodes_.empty(); }
+
+	static constexpr std::uint32_t kInvalidItem = 0xFFFFFFFF;
+
+private:
+	std::span<const BvhNode> nodes_;
+	std::span<const std::uint32_t> items_;
+};
+
+// Bounding volume hierarchy over AABB3, nodes stored in a flat array with
+// the root at index 0.
+class Bvh {
+public:
+	using LeafVisitor = BvhView::LeafVisitor;
+
+	Bvh() = default;
+
+	// Top-down build with a binned surface area heuristic.
+	// Items are identified by their index in aabbs.
+	void Build(std::span<const AABB3> aabbs, std::uint32_t max_leaf_size = 4);
+
+	// Linear BVH build (Karras 2012) for scenes rebuilt every frame: the
+	// centroids are sorted along a 30 bit Morton curve, every inner node is
+	// emitted independently from the sorted codes, then the bounds are
+	// refitted bottom-up. One item per leaf, lower quality than Build.
+	void BuildLinear(std::span<const AABB3> aabbs, JobSystem& jobs = JobSystem::Default());
+
+	// Hierarchical frustum culling: a plane mask is passed down so children
+	// of nodes fully inside a plane skip it, and the cache remembers the
+	// rejecting plane per node. Every visible leaf is given to visitor.
+	void CullFrustum(const Frustum& frustum, BvhCullCache& cache,
+		const LeafVisitor& visitor) const;
+
+	// Same as above, appending the items of the visible leaves to visible
+	void CullFrustum(const Frustum& frustum, BvhCullCache& cache,
+		std::vector<std::uint32_t>& visible) const;
+
+	// Updates every bound from aabbs, keeping the topology, for items that
+	// move or deform. The subtrees below the top levels are refitted in
+	// parallel, then the top levels on the calling thread.
+	void Refit(std::span<const AABB3> aabbs, JobSystem& jobs = JobSystem::Default());
+
+	// Refit, then rebuilds with the SAH only the subtrees whose cost grew by
+	// more than max_drift times their cost after their last (re)build.
+	// Returns the number of rebuilt subtrees.
+	std::uint32_t RefitAndRebuild(std::span<const AABB3> aabbs, float max_drift = 1.5f,
+		JobSystem& jobs = JobSystem::Default());
+
+	// Surface area heuristic cost of the tree: expected number of node visits
+	// plus item tests of a ray hitting the root, lower is better.
+	float SahCost() const;
+
+	// Exact queries: aabbs must be the boxes the tree was built from.
+	// Appends the items whose AABB overlaps the sphere.
+	void QuerySphere(std::span<const AABB3> aabbs, const Sphere& sphere,
+		std::vector<std::uint32_t>& result) const;
+
+	// Closest item whose AABB is hit by the ray within max_distance, children
+	// visited front to back. Returns kInvalidItem on miss.
+	std::uint32_t Raycast(std::span<const AABB3> aabbs, const Ray3& ray, float& distance,
+		float max_distance = std::numeric_limits<float>::infinity()) const;
+
+	BvhView view() const { return { nodes_, items_ }; }
+	const std::vector<BvhNode>& nodes() const { return nodes_; }
+	// Item indices referenced by the leaves
+	const std::vector<std::uint32_t>& items() const { return items_; }
+	bool empty() const { return nodes_.empty(); }
+
+	static constexpr std::uint32_t kInvalidItem = BvhView::kInvalidItem;
+
+private:
+	// Binned SAH split of the leaf root and everything below it
+	void Subdivide(std::span<const AABB3> aabbs, std::span<const Vector3f> centers,
+		std::uint32_t root);
+	// Cuts the tree in about kRefitSubtrees subtrees and stores their costs
+	void UpdateSubtrees();
+	void RefitSubtree(std::span<const AABB3> aabbs, std::uint32_t root,
+		std::vector<std::uint32_t>& order);
+	// SAH cost relative to the area of root, so it does not change when the
+	// subtree only translates or scales
+	float SubtreeCost(std::uint32_t root) const;
+	// Drops the nodes left behind by partial rebuilds
+	void Compact();
+
+	static constexpr std::size_t kRefitSubtrees = 64;
+
+	std::vector<BvhNode> nodes_;
+	std::vector<std::uint32_t> items_;
+	std::uint32_t max_leaf_size_ = 4;
+	// Nodes above the refit subtrees, parents before children
+	std::vector<std::uint32_t> top_nodes_;
+	std::vector<std::uint32_t> subtree_roots_;
+	std::vector<float> subtree_costs_;
+	// Nodes no longer reachable after partial rebuilds
+	std::size_t dead_nodes_ = 0;
+};
+
+} // namespace maths
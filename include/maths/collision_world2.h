@@ -0,0 +1,115 @@
+#pragma once
+
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+#include "maths/aabb2.h"
+#include "maths/circle.h"
+
+namespace maths {
+
+// Two proxies touching after a Step, a < b
+struct CollisionPair2 {
+	std::uint32_t a = 0;
+	std::uint32_t b = 0;
+};
+
+// 2D collision world of AABB2 and Circle proxies addressed by handles.
+// Step sorts the proxy bounds along x incrementally (sweep and prune: an
+// insertion sort is close to linear when proxies move a little between
+// frames), tests the pairs whose bounds touch with the exact tests of
+// contact2 and reports the pairs that began or ended since the last Step.
+// Buffers only grow, so once warmed up a Step does not allocate.
+class CollisionWorld2 {
+public:
+	using Handle = std::uint32_t;
+	static constexpr Handle kInvalidHandle = std::numeric_limits<Handle>::max();
+
+	Handle Add(const AABB2& aabb);
+	Handle Add(const Circle& circle);
+	// The pairs of the proxy are reported as ended by the next Step, the
+	// handle is only reused after that.
+	void Remove(Handle handle);
+	// The shape of a proxy may change kind when it moves
+	void Move(Handle handle, const AABB2& aabb);
+	void Move(Handle handle, const Circle& circle);
+
+	// Updates the broadphase and the overlapping pairs, O(proxies + swaps
+	// in the sort + pairs)
+	void Step();
+
+	// Pairs touching at the last Step, sorted by a then b
+	std::span<const CollisionPair2> overlaps() const { return pairs_; }
+	// Pairs that started or stopped touching during the last Step, sorted
+	std::span<const CollisionPair2> begin_events() const { return begin_events_; }
+	std::span<const CollisionPair2> end_events() const { return end_events_; }
+
+	// Preallocates the buffers to skip the warmup
+	void Reserve(std::size_t proxy_count, std::size_t pair_count);
+
+	bool valid(Handle handle) const { return handle < proxies_.size() && proxies_[handle].kind != Kind::kRemoved; }
+	std::size_t size() const { return proxy_count_; }
+	// Bytes held by the buffers of the world
+	std::size_t memory_usage() const;
+
+private:
+	enum class Kind : std::uint8_t { kAABB2, kCircle, kRemoved };
+
+	struct Proxy {
+		AABB2 bounds;
+		// Only meaningful for circles
+		Circle circle;
+		Kind kind = Kind::kRemoved;
+	};
+
+	// Min or max x of a proxy, the lowest bit of the key is 1 for max
+	struct Endpoint {
+		float value = 0.0f;
+		std::uint32_t key = 0;
+	};
+
+	Handle Allocate();
+	bool Touch(const Proxy& a, const Proxy& b) const;
+
+	std::vector<Proxy> proxies_;
+	std::vector<Handle> free_handles_;
+	// Removed since the last Step, freed once their end events are out
+	std::vector<Handle> removed_handles_;
+	std::vector<Endpoint> endpoints_;
+	std::vector<Handle> active_;
+	std::vector<CollisionPair2> pairs_;
+	std::vector<CollisionPair2> previous_pairs_;
+	std::vector<CollisionPair2> begin_events_;
+	std::vector<CollisionPair2> end_events_;
+	std::size_t proxy_count_ = 0;
+	// Added since the last Step, their endpoints are not sorted yet
+	std::size_t added_count_ = 0;
+};
+
+} // namespace maths
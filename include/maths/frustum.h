@@ -23,30 +23,94 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 #include <array>
+#include <cstdint>
+#include <limits>
+#include <span>
 
 #include "maths/matrix4.h"
 #include "maths/sphere.h"
 #include "maths/aabb3.h"
 #include "maths/plane.h"
+#include "maths/large_world.h"
 
 namespace maths {
+
+// Frustum planes in (normal, d) form laid out as structure of arrays, padded
+// to 8 planes so two 4-wide registers hold them all. The padding planes
+// have a zero normal and a positive d, so every point is inside them.
+struct FrustumPlanesSoA {
+	static constexpr std::size_t kCount = 8;
+	alignas(16) std::array<float, kCount> normal_x{};
+	alignas(16) std::array<float, kCount> normal_y{};
+	alignas(16) std::array<float, kCount> normal_z{};
+	alignas(16) std::array<float, kCount> d{};
+};
+
+// Depth range of clip space, OpenGL uses [-1, 1] and Direct3D/Vulkan [0, 1]
+enum class ClipDepth { kNegativeOneToOne, kZeroToOne };
 	
 class Frustum {
 public:
+	// Bit i set means plane i still has to be tested
+	using PlaneMask = std::uint8_t;
+	static constexpr PlaneMask kAllPlanes = 0x3F;
+	static constexpr std::uint8_t kNoPlane = 0xFF;
+
 	Frustum() = default;
+	// Extract the six planes from a view-projection matrix (Gribb/Hartmann).
+	// Planes are normalized and point inside, in the space the matrix
+	// transforms from (world space for a view-projection matrix).
+	explicit Frustum(const Matrix4f& view_projection,
+		ClipDepth depth = ClipDepth::kNegativeOneToOne);
+	// Frustum from planes pointing inside, in the order near, far, left,
+	// right, top, bottom
+	explicit Frustum(const std::array<Plane, 6>& planes);
 	// Calculate frustum from the given informations from the camera each time it is called
 	void calculate_frustum(Vector3f direction, Vector3f position, Vector3f right, 
 		Vector3f up, float near_plane_distance, float far_plane_distance, 
 		degree_t fov_x, radian_t fov_y);
-	// Check if a sphere is inside the frustum
-	bool contains(const Sphere& sphere);
+	// Check if a sphere is at least partially inside every plane
+	bool contains(const Sphere& sphere) const;
 	// Check if a AABB is inside the frustum
-	bool contains(const AABB3& aabb);
+	bool contains(const AABB3& aabb) const;
 	// Check if a point is inside the frustum
-	bool contains(const Vector3f& point);
+	bool contains(const Vector3f& point) const;
+	// Large world variants: the frustum is built relative to origin_shift
+	// (usually the camera world position) and the world space shapes are
+	// rebased in double before the float tests.
+	bool contains(const Sphered& sphere, const Vector3d& origin_shift) const;
+	bool contains(const AABB3d& aabb, const Vector3d& origin_shift) const;
+	bool contains(const Vector3d& point, const Vector3d& origin_shift) const;
+
+	// Hierarchical culling test of an AABB against the planes left in mask.
+	// last_plane is tested first (temporal coherence) and receives the plane
+	// rejecting the box. Returns false if the box is outside, otherwise
+	// clears from mask the planes the box is fully inside of, so children
+	// of a bounding hierarchy can skip them.
+	bool ClassifyAABB(const AABB3& aabb, PlaneMask& mask, std::uint8_t& last_plane) const;
+
+	// Batch tests on the SoA planes, result[i] is 1 when the shape is at
+	// least partially inside every plane, the same as contains.
+	void ContainsBatch(std::span<const Sphere> spheres, std::span<std::uint8_t> result) const;
+	void ContainsBatch(std::span<const AABB3> aabbs, std::span<std::uint8_t> result) const;
+
+	// Same volume seen through a rigid transform (rotation and translation),
+	// e.g. a view space frustum moved to world space by the camera matrix
+	Frustum Transformed(const Matrix4f& rigid) const;
+
+	// Stand-in for a plane the projection does not have (infinite far plane):
+	// zero normal and the largest d, so every point is far inside and
+	// contains(const Sphere&) never rejects on it.
+	static Plane OpenPlane() { return Plane{ Vector3f{}, std::numeric_limits<float>::max() }; }
+
+	const Plane& plane(std::size_t index) const { return planes_[index]; }
+	const FrustumPlanesSoA& planes_soa() const { return planes_soa_; }
 	
 private:
+	void UpdatePlanesSoA();
+
 	std::array<Plane, 6> planes_;
+	FrustumPlanesSoA planes_soa_;
 	enum Planes {NEAR, FAR, LEFT, RIGHT, TOP, BOTTOM};
 };
 	
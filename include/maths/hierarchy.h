@@ -0,0 +1,82 @@
+#pragma once
+
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "maths/job_system.h"
+#include "maths/matrix4.h"
+#include "maths/quaternion.h"
+#include "maths/vector3.h"
+
+namespace maths {
+
+// Transform hierarchy (scene graph) update: world[i] = world[parents[i]] *
+// local[i], or local[i] for roots. Nodes are sorted topologically, every
+// parent index is lower than its children's. Only the common size of the
+// spans is updated, the nodes before it form a complete hierarchy.
+constexpr std::uint32_t kNoParent = 0xFFFFFFFF;
+
+// Nodes of a hierarchy grouped by depth for the parallel update: a level
+// only reads the world matrices of the levels above it.
+class HierarchyLevels {
+public:
+	void Build(std::span<const std::uint32_t> parents);
+
+	std::size_t node_count() const { return nodes_.size(); }
+	std::size_t level_count() const { return level_begin_.empty() ? 0 : level_begin_.size() - 1; }
+	// Nodes of one level in increasing index order
+	std::span<const std::uint32_t> level(std::size_t index) const {
+		return std::span(nodes_).subspan(level_begin_[index], level_begin_[index + 1] - level_begin_[index]);
+	}
+
+private:
+	std::vector<std::uint32_t> nodes_;
+	std::vector<std::uint32_t> level_begin_;
+};
+
+// Sequential update, one pass in index order with SIMD 4x4 multiplies
+void UpdateHierarchy(std::span<const std::uint32_t> parents, std::span<const Matrix4f> local,
+	std::span<Matrix4f> world);
+
+// Same with local = translation * rotation * scale, the local matrices are
+// never stored
+void UpdateHierarchy(std::span<const std::uint32_t> parents, std::span<const Quaternion> rotations,
+	std::span<const Vector3f> translations, std::span<const Vector3f> scales, std::span<Matrix4f> world);
+
+// Parallel update, level after level with the nodes of a level split over
+// jobs. levels must be built from parents. Levels are contiguous, and read
+// memory in order, when the nodes are sorted breadth first. Runs the
+// sequential update on a single thread.
+void UpdateHierarchy(const HierarchyLevels& levels, std::span<const std::uint32_t> parents,
+	std::span<const Matrix4f> local, std::span<Matrix4f> world, JobSystem& jobs = JobSystem::Default());
+
+void UpdateHierarchy(const HierarchyLevels& levels, std::span<const std::uint32_t> parents,
+	std::span<const Quaternion> rotations, std::span<const Vector3f> translations,
+	std::span<const Vector3f> scales, std::span<Matrix4f> world, JobSystem& jobs = JobSystem::Default());
+
+} // namespace maths
@@ -0,0 +1,143 @@
+#pragma once
+
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Define MATHS_INSTRUMENTATION (CMake option of the same name) to count the
+// intersection tests below. Without it the macros expand to nothing, or to
+// the tested result, and the hot paths are unchanged.
+//  - MATHS_COUNT(counter) counts one call of a test
+//  - MATHS_COUNT_HIT(counter, result) counts a positive result and yields it
+//  - MATHS_COUNT_EXIT(counter, step) records at which step a test returned
+//  - MATHS_SCOPED_TIMER("name") times the enclosing scope
+#ifdef MATHS_INSTRUMENTATION
+#define MATHS_INSTRUMENTATION_CONCAT_(a, b) a##b
+#define MATHS_INSTRUMENTATION_CONCAT(a, b) MATHS_INSTRUMENTATION_CONCAT_(a, b)
+#define MATHS_COUNT(counter) ::maths::InstrumentCount(::maths::InstrumentCounter::counter)
+#define MATHS_COUNT_HIT(counter, result) ::maths::InstrumentHit(::maths::InstrumentCounter::counter, (result))
+#define MATHS_COUNT_EXIT(counter, step) ::maths::InstrumentExit(::maths::InstrumentCounter::counter, (step))
+#define MATHS_SCOPED_TIMER(name) \
+	const ::maths::ScopedTimer MATHS_INSTRUMENTATION_CONCAT(maths_scoped_timer_, __LINE__)(name)
+#else
+#define MATHS_COUNT(counter) ((void)0)
+#define MATHS_COUNT_HIT(counter, result) (result)
+#define MATHS_COUNT_EXIT(counter, step) ((void)0)
+#define MATHS_SCOPED_TIMER(name) ((void)0)
+#endif
+
+namespace maths {
+
+enum class InstrumentCounter : std::uint8_t {
+	// Frustum::contains, plane tests are the Plane::Distance evaluations
+	kFrustumSphere,
+	kFrustumAABB,
+	kFrustumPoint,
+	kFrustumPlane,
+	// Ray3::Intersect*, SlabRay::Intersect and WatertightRay::Intersect
+	kRaySphere,
+	kRayAABB,
+	kRayPlane,
+	kRaySlab,
+	kRayTriangle,
+	// contact2
+	kOverlapAABB2,
+	kContainAABB2,
+	kOverlapCircle,
+	kContainCircle,
+	kAABB2Circle,
+	// contact3
+	kOverlapAABB3,
+	kContainAABB3,
+	kOverlapSphere,
+	kContainSphere,
+	kAABB3Sphere,
+	kMatrix4fInverse,
+	kCount,
+};
+
+constexpr std::size_t kInstrumentCounterCount = static_cast<std::size_t>(InstrumentCounter::kCount);
+// Exit steps past the last bucket are added to it
+constexpr std::size_t kInstrumentExitBuckets = 8;
+
+struct CounterStats {
+	std::uint64_t calls = 0;
+	std::uint64_t hits = 0;
+	std::array<std::uint64_t, kInstrumentExitBuckets> exits{};
+};
+
+struct TimerStats {
+	std::string name;
+	std::uint64_t calls = 0;
+	std::uint64_t nanoseconds = 0;
+};
+
+// Sum over every thread, including the ones that have exited
+struct InstrumentationSnapshot {
+	std::array<CounterStats, kInstrumentCounterCount> counters;
+	std::vector<TimerStats> timers;
+
+	const CounterStats& operator[](InstrumentCounter counter) const {
+		return counters[static_cast<std::size_t>(counter)];
+	}
+};
+
+const char* ToString(InstrumentCounter counter);
+
+// Counters are per thread, written without atomic read-modify-write, and
+// summed on demand
+void InstrumentCount(InstrumentCounter counter);
+bool InstrumentHit(InstrumentCounter counter, bool result);
+void InstrumentExit(InstrumentCounter counter, std::uint32_t step);
+void InstrumentTime(const char* name, std::uint64_t nanoseconds);
+
+InstrumentationSnapshot TakeInstrumentationSnapshot();
+// Zeroes every counter and timer, while no other thread is counting
+void ResetInstrumentation();
+// One line per counter used: calls, hits, hit rate and exit steps, then the
+// timers. Empty when nothing was counted, as without MATHS_INSTRUMENTATION.
+std::string InstrumentationReport();
+
+// Adds the lifetime of the scope to the timer name, a string literal
+class ScopedTimer {
+public:
+	explicit ScopedTimer(const char* name) : name_(name), start_(std::chrono::steady_clock::now()) {}
+	~ScopedTimer() {
+		InstrumentTime(name_, static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now() - start_).count()));
+	}
+	ScopedTimer(const ScopedTimer&) = delete;
+	ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+	const char* name_;
+	std::chrono::steady_clock::time_point start_;
+};
+
+} // namespace maths
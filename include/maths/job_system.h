@@ -0,0 +1,129 @@
+#pragma once
+
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace maths {
+
+// Small work-stealing thread pool used by the batch APIs.
+// Every worker owns a queue, pops its own work from the back and steals
+// from the front of the others when it runs dry.
+class JobSystem {
+public:
+	using RangeFunction = std::function<void(std::size_t begin, std::size_t end)>;
+
+	// thread_count includes the calling thread, 0 uses every hardware thread.
+	explicit JobSystem(std::size_t thread_count = 0);
+	~JobSystem();
+
+	JobSystem(const JobSystem&) = delete;
+	JobSystem& operator=(const JobSystem&) = delete;
+
+	std::size_t thread_count() const { return workers_.size() + 1; }
+
+	// Chunk size giving about kChunksPerThread chunks per thread, but never
+	// less than min_grain elements so small ranges are not split for nothing.
+	std::size_t GrainSize(std::size_t count, std::size_t min_grain = kMinGrainSize) const;
+
+	// Splits [begin, end) in chunks of grain_size elements (0 uses GrainSize)
+	// and calls func(chunk_begin, chunk_end) on every thread. The calling
+	// thread takes part and the function returns once all chunks are done.
+	void ParallelFor(std::size_t begin, std::size_t end, const RangeFunction& func,
+		std::size_t grain_size = 0);
+
+	// Deterministic gather: func(begin, end, local) appends the results of a
+	// chunk to local, then the chunks are concatenated in index order so the
+	// output does not depend on the number of threads or on scheduling.
+	template<typename T, typename Func>
+	void ParallelCollect(std::size_t count, std::vector<T>& out, Func func,
+		std::size_t grain_size = 0);
+
+	// Shared pool using every hardware thread
+	static JobSystem& Default();
+
+	static constexpr std::size_t kMinGrainSize = 64;
+	static constexpr std::size_t kChunksPerThread = 4;
+
+private:
+	struct Task {
+		const RangeFunction* func = nullptr;
+		std::size_t begin = 0;
+		std::size_t end = 0;
+		std::atomic<std::size_t>* remaining = nullptr;
+	};
+
+	struct Queue {
+		std::mutex mutex;
+		std::deque<Task> tasks;
+	};
+
+	void WorkerLoop(std::size_t index);
+	bool TryPop(std::size_t index, Task& task);
+	static void Run(const Task& task);
+
+	std::vector<std::thread> workers_;
+	// Queue 0 belongs to the threads calling ParallelFor, others to workers
+	std::vector<std::unique_ptr<Queue>> queues_;
+	std::atomic<std::size_t> queued_ = 0;
+	std::mutex sleep_mutex_;
+	std::condition_variable wake_;
+	bool stop_ = false;
+};
+
+template<typename T, typename Func>
+void JobSystem::ParallelCollect(std::size_t count, std::vector<T>& out, Func func,
+	std::size_t grain_size)
+{
+	out.clear();
+	if (count == 0) {
+		return;
+	}
+	const std::size_t grain = grain_size == 0 ? GrainSize(count) : grain_size;
+	const std::size_t chunk_count = (count + grain - 1) / grain;
+	std::vector<std::vector<T>> chunks(chunk_count);
+	ParallelFor(0, count, [&](std::size_t begin, std::size_t end) {
+		func(begin, end, chunks[begin / grain]);
+	}, grain);
+
+	std::size_t total = 0;
+	for (const std::vector<T>& chunk : chunks) {
+		total += chunk.size();
+	}
+	out.reserve(total);
+	for (std::vector<T>& chunk : chunks) {
+		out.insert(out.end(), chunk.begin(), chunk.end());
+	}
+}
+
+} // namespace maths
@@ -0,0 +1,107 @@
+#pragma once
+
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <cstddef>
+#include <span>
+
+#include "maths/aabb3.h"
+#include "maths/sphere.h"
+#include "maths/vector3d.h"
+
+namespace maths {
+
+// AABB3 with double precision world bounds
+class AABB3d {
+public:
+	AABB3d() = default;
+	AABB3d(Vector3d bottom_left, Vector3d top_right) :
+		bottom_left_(bottom_left), top_right_(top_right) {}
+
+	Vector3d center() const {
+		return { (bottom_left_ + top_right_) / 2.0 };
+	}
+
+	Vector3d bottom_left() const { return bottom_left_; }
+	Vector3d top_right() const { return top_right_; }
+
+	// Returns the float AABB3 of these bounds seen from the given origin
+	AABB3 RelativeTo(const Vector3d& origin) const {
+		return { bottom_left_.RelativeTo(origin), top_right_.RelativeTo(origin) };
+	}
+
+private:
+	Vector3d bottom_left_ = {};
+	Vector3d top_right_ = {};
+};
+
+// Sphere with a double precision world center
+class Sphered {
+public:
+	Sphered() = default;
+	Sphered(float radius, Vector3d center) : center_(center), radius_(radius) {}
+
+	Vector3d center() const { return center_; }
+	float radius() const { return radius_; }
+
+	// Returns the float Sphere seen from the given origin
+	Sphere RelativeTo(const Vector3d& origin) const {
+		return { radius_, center_.RelativeTo(origin) };
+	}
+
+private:
+	Vector3d center_ = {};
+	float radius_ = {};
+};
+
+// Structure of arrays of double precision world positions
+struct Vector3dSoA {
+	std::span<const double> x;
+	std::span<const double> y;
+	std::span<const double> z;
+};
+
+// Structure of arrays receiving the float offsets of a rebase
+struct Vector3fSoA {
+	std::span<float> x;
+	std::span<float> y;
+	std::span<float> z;
+};
+
+// Camera-relative rebasing: converts world positions into float offsets
+// from origin in one pass, so culling and ray tests can stay in float.
+// Only min(world.size(), local.size()) elements are written.
+void RebaseToOrigin(std::span<const Vector3d> world, const Vector3d& origin,
+	std::span<Vector3f> local);
+void RebaseToOrigin(std::span<const AABB3d> world, const Vector3d& origin,
+	std::span<AABB3> local);
+void RebaseToOrigin(std::span<const Sphered> world, const Vector3d& origin,
+	std::span<Sphere> local);
+// SoA version of the rebase, the loop is branch free and vectorizes to
+// packed double subtraction and double to float conversion.
+void RebaseToOrigin(const Vector3dSoA& world, const Vector3d& origin,
+	const Vector3fSoA& local);
+
+} // namespace maths
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cmath>
+#include <limits>
 
 namespace maths {
 
@@ -10,4 +11,20 @@ inline bool Equal(float a, float b, float epsilon = 0.0000001f) {
 	
 	return std::abs(a - b) < epsilon;
 }
+
+//Squared magnitudes at or below this are zero vectors for the safe and batch normalizations,
+//the square of the default epsilon of Equal.
+constexpr float kZeroSqrMagnitude = 0.0000001f * 0.0000001f;
+
+//Determinants at or below this fraction of the product of the column lengths are singular. The product
+//bounds the absolute determinant, so the test does not depend on the scale of the matrix.
+constexpr float kSingularRatio = 0.0000001f;
+
+//This function returns true if a matrix with this determinant and product of column lengths is singular.
+//Determinants whose reciprocal overflows are singular too.
+inline bool IsSingular(float determinant, float column_length_product) {
+
+	const float kAbsDet = std::abs(determinant);
+	return !(kAbsDet > kSingularRatio * column_length_product) || kAbsDet < std::numeric_limits<float>::min();
+}
 }
\ No newline at end of file
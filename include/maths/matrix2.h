@@ -23,6 +23,8 @@ SOFTWARE.
 */
 
 #include <array>
+#include <cstdint>
+#include <span>
 
 #include "maths/vector2.h"
 
@@ -67,6 +69,11 @@ public:
 	//This function returns the inverse matrix of the 2x2 matrix
     Matrix2f Inverse() const;
 
+	//This function writes the inverse matrix and returns true, or returns false if the matrix is singular.
+	//The test is relative (IsSingular in maths_utils.h), so uniformly scaled matrices invert at any scale.
+	//Unlike Inverse, whose off-diagonal elements are swapped, M * inverse is the identity.
+    bool TryInverse(Matrix2f& inverse) const;
+
 	//This function transposes the 2x2 matrix 
     Matrix2f Transpose() const;
 
@@ -80,4 +87,11 @@ private:
 
     std::array<Vector2f, 2> matrix_ {};
 };
+
+//This function inverts four matrices per SIMD pass, singular matrices are copied unchanged.
+//invertible[i] receives TryInverse's result when not empty. Only the common size of the spans is written.
+//Returns true if every matrix was invertible.
+bool InverseBatch(std::span<const Matrix2f> matrices, std::span<Matrix2f> inverses,
+	std::span<std::uint8_t> invertible = {});
+
 }//namespace maths
\ No newline at end of file
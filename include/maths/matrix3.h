@@ -23,6 +23,8 @@ SOFTWARE.
 */
 
 #include <array>
+#include <cstdint>
+#include <span>
 
 #include "maths/vector2.h"
 #include "maths/vector3.h"
@@ -68,9 +70,13 @@ public:
     //This function returns the determinant(float) of the 3x3 matrix.
     float determinant() const;
 
-    //This function returns the inverse matrix of the 3x3 matrix.
+    //This function returns the inverse matrix of the 3x3 matrix, or the matrix itself if it is singular.
     Matrix3f Inverse() const;
 
+    //This function writes the inverse matrix and returns true, or returns false if the matrix is singular.
+    //The test is relative (IsSingular in maths_utils.h), so uniformly scaled matrices invert at any scale.
+    bool TryInverse(Matrix3f& inverse) const;
+
     //This function transposes the 3x3 matrix.
     Matrix3f Transpose() const;
 
@@ -96,5 +102,21 @@ private:
 
     std::array<Vector3f, 3> matrix_ {};
 };
+
+//This function computes the eigen decomposition of a symmetric 3x3 matrix with cyclic Jacobi rotations.
+//The eigenvectors are the columns of vectors, sorted by decreasing eigenvalue, and form a rotation.
+void SymmetricEigen(const Matrix3f& matrix, Vector3f& values, Matrix3f& vectors);
+
+//This function computes the polar decomposition matrix = rotation * stretch with scaled Newton iterations.
+//rotation is orthogonal (a reflection when the determinant is negative) and stretch is symmetric, it holds
+//the scale and shear. Returns false if the matrix is singular, relative to its column lengths like TryInverse,
+//so small but well conditioned matrices decompose.
+bool PolarDecomposition(const Matrix3f& matrix, Matrix3f& rotation, Matrix3f& stretch);
+
+//This function inverts four matrices per SIMD pass, singular matrices are copied unchanged.
+//invertible[i] receives TryInverse's result when not empty. Only the common size of the spans is written.
+//Returns true if every matrix was invertible.
+bool InverseBatch(std::span<const Matrix3f> matrices, std::span<Matrix3f> inverses,
+	std::span<std::uint8_t> invertible = {});
 	
 }//namespace maths
\ No newline at end of file
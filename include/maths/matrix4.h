@@ -23,7 +23,10 @@ SOFTWARE.
 */
 
 #include <array>
+#include <cstdint>
+#include <span>
 
+#include "maths/matrix3.h"
 #include "maths/vector3.h"
 #include "maths/vector4.h"
 
@@ -97,6 +100,28 @@ private:
     std::array<Vector4f, 4> matrix_ {};
 };
 	
+//How the normal matrix of a world matrix was obtained
+enum class NormalMatrixKind : std::uint8_t {
+    //Orthogonal columns of equal length, the upper 3x3 divided by the squared scale.
+    //Its rotation part can be used as is for normals that are renormalized.
+    kUniformScale,
+    //Inverse transpose through the cofactors
+    kGeneral,
+    //Determinant zero relative to the column lengths (IsSingular), the cofactor matrix is
+    //written: it still maps normals of a flattened object correctly, up to their length
+    kSingular
+};
+
+//This function writes the normal matrix, the inverse transpose of the upper 3x3 of world,
+//computed directly as the cofactor matrix over the determinant.
+NormalMatrixKind NormalMatrix(const Matrix4f& world, Matrix3f& normal);
+
+//This function computes the normal matrices of four world matrices per SIMD pass.
+//kinds[i] receives the kind of normals[i] when not empty. Only the common size of the spans is written.
+//Returns true if no matrix was singular.
+bool NormalMatrixBatch(std::span<const Matrix4f> world, std::span<Matrix3f> normals,
+    std::span<NormalMatrixKind> kinds = {});
+	
 }//namespace maths
 
 
@@ -0,0 +1,93 @@
+#pragma once
+
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+#include "maths/bvh.h"
+#include "maths/ray3.h"
+#include "maths/vector3.h"
+
+namespace maths {
+
+// Closest hit of a ray on a mesh, the point is
+// a * (1 - u - v) + b * u + c * v for the vertices of triangle.
+struct MeshHit {
+	std::uint32_t triangle = 0xFFFFFFFF;
+	float distance = 0.0f;
+	float u = 0.0f;
+	float v = 0.0f;
+};
+
+// BVH over an indexed triangle mesh for exact ray queries such as picking
+// or occlusion. The leaf triangles are copied in packets of four and tested
+// together with the watertight ray test, so the mesh buffers are not needed
+// after Build.
+class MeshBvh {
+public:
+	static constexpr std::uint32_t kInvalidTriangle = 0xFFFFFFFF;
+
+	// Triangle i is made of the vertices at indices[3i], [3i + 1] and [3i + 2].
+	// Leaves of up to max_leaf_size triangles, tested one packet at a time.
+	void Build(std::span<const Vector3f> vertices, std::span<const std::uint32_t> indices,
+		std::uint32_t max_leaf_size = 4);
+
+	// Nearest triangle hit in (0, max_distance], children visited front to back
+	bool ClosestHit(const Ray3& ray, MeshHit& hit,
+		float max_distance = std::numeric_limits<float>::infinity()) const;
+
+	// True as soon as any triangle is hit in (0, max_distance], for occlusion
+	bool AnyHit(const Ray3& ray, float max_distance = std::numeric_limits<float>::infinity()) const;
+
+	std::size_t triangle_count() const { return triangle_count_; }
+	const Bvh& bvh() const { return bvh_; }
+	bool empty() const { return bvh_.empty(); }
+
+private:
+	// Four triangles in structure of arrays, a[axis][lane]. Unused lanes are
+	// degenerate and never hit.
+	struct alignas(16) TrianglePacket {
+		float a[3][4];
+		float b[3][4];
+		float c[3][4];
+		std::uint32_t triangle[4];
+	};
+
+	// Four triangle tests at once, returns the mask of the lanes hit in
+	// (0, max_distance] and their distances and barycentrics
+	static int IntersectPacket(const WatertightRay& ray, const TrianglePacket& packet,
+		float max_distance, float (&distance)[4], float (&u)[4], float (&v)[4]);
+
+	Bvh bvh_;
+	std::vector<TrianglePacket> packets_;
+	// First packet of every leaf, indexed like the BVH nodes
+	std::vector<std::uint32_t> leaf_packets_;
+	std::size_t triangle_count_ = 0;
+};
+
+} // namespace maths
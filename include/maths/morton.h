@@ -0,0 +1,72 @@
+#pragma once
+
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <cstdint>
+
+#include "maths/aabb2.h"
+#include "maths/aabb3.h"
+#include "maths/vector2.h"
+#include "maths/vector3.h"
+
+// BMI2 pdep/pext spread the bits in one instruction, MSVC only enables
+// them with /arch:AVX2. Define MATHS_NO_SIMD to force the portable code.
+#if !defined(MATHS_NO_SIMD) && (defined(__BMI2__) || defined(__AVX2__))
+#define MATHS_BMI2 1
+#include <immintrin.h>
+#endif
+
+namespace maths {
+
+// Morton (Z-order) and Hilbert curve keys, used to sort geometry so that
+// objects close in space are close in memory.
+
+// Interleave integer coordinates, bit 0 of the code is bit 0 of x.
+// 32-bit codes keep 16 bits per axis in 2D and 10 in 3D,
+// 64-bit codes keep 32 bits per axis in 2D and 21 in 3D.
+std::uint32_t MortonEncode32(std::uint32_t x, std::uint32_t y);
+std::uint32_t MortonEncode32(std::uint32_t x, std::uint32_t y, std::uint32_t z);
+std::uint64_t MortonEncode64(std::uint32_t x, std::uint32_t y);
+std::uint64_t MortonEncode64(std::uint32_t x, std::uint32_t y, std::uint32_t z);
+void MortonDecode32(std::uint32_t code, std::uint32_t& x, std::uint32_t& y, std::uint32_t& z);
+void MortonDecode64(std::uint64_t code, std::uint32_t& x, std::uint32_t& y, std::uint32_t& z);
+
+// Hilbert index of integer coordinates using bits bits per axis. bits is
+// clamped to [1, 32] in 2D and [1, 21] in 3D for 64-bit codes, the higher
+// bits of the coordinates are ignored.
+std::uint64_t HilbertEncode(std::uint32_t x, std::uint32_t y, int bits);
+std::uint64_t HilbertEncode(std::uint32_t x, std::uint32_t y, std::uint32_t z, int bits);
+
+// Keys of a point quantized in bounds, points outside are clamped
+std::uint32_t Morton32(const Vector2f& point, const AABB2& bounds);
+std::uint32_t Morton32(const Vector3f& point, const AABB3& bounds);
+std::uint64_t Morton64(const Vector2f& point, const AABB2& bounds);
+std::uint64_t Morton64(const Vector3f& point, const AABB3& bounds);
+std::uint32_t Hilbert32(const Vector2f& point, const AABB2& bounds);
+std::uint32_t Hilbert32(const Vector3f& point, const AABB3& bounds);
+std::uint64_t Hilbert64(const Vector2f& point, const AABB2& bounds);
+std::uint64_t Hilbert64(const Vector3f& point, const AABB3& bounds);
+
+} // namespace maths
@@ -0,0 +1,73 @@
+#pragma once
+
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <cmath>
+#include <cstddef>
+
+#include "maths/aabb3.h"
+#include "maths/matrix3.h"
+#include "maths/vector3.h"
+
+namespace maths {
+
+// Oriented bounding box: a center, three orthonormal axes stored as the
+// columns of a rotation matrix, and the half size along each axis.
+class OBB3 {
+public:
+	OBB3() = default;
+	OBB3(const Vector3f& center, const Matrix3f& axes, const Vector3f& half_extents) :
+		center_(center), axes_(axes), half_extents_(half_extents) {}
+	// Same volume as the AABB, with the world axes
+	explicit OBB3(const AABB3& aabb) :
+		center_(aabb.center()), axes_(Matrix3f::identity()), half_extents_(aabb.extent()) {}
+
+	Vector3f center() const { return center_; }
+	const Matrix3f& axes() const { return axes_; }
+	Vector3f axis(std::size_t index) const { return axes_[index]; }
+	Vector3f half_extents() const { return half_extents_; }
+
+	float volume() const {
+		return 8.0f * half_extents_.x * half_extents_.y * half_extents_.z;
+	}
+
+	// Return true if the point is inside the box or less than epsilon away
+	bool Contains(const Vector3f& point, float epsilon = 0.0f) const {
+		const Vector3f offset = point - center_;
+		for (std::size_t i = 0; i < 3; i++) {
+			if (std::abs(offset.Dot(axes_[i])) > half_extents_[i] + epsilon) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+private:
+	Vector3f center_ = {};
+	Matrix3f axes_ = Matrix3f::identity();
+	Vector3f half_extents_ = {};
+};
+
+}  // namespace maths
@@ -0,0 +1,117 @@
+#pragma once
+
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "maths/aabb3.h"
+#include "maths/frustum.h"
+#include "maths/ray3.h"
+#include "maths/sphere.h"
+
+namespace maths {
+
+// Loose octree over AABB3 for scenes with a lot of insert/remove churn.
+// Nodes live in a flat pool and are addressed by the Morton code of their
+// cell: the 3 bits of each level give the child to take from the root.
+// A node's loose bounds are its cell grown by the looseness factor, so an
+// object is stored in one node only, chosen from its center and size.
+class Octree {
+public:
+	using Handle = std::uint32_t;
+	static constexpr Handle kInvalidHandle = std::numeric_limits<Handle>::max();
+	static constexpr int kMaxDepth = 10;
+
+	// world_bounds is grown to a cube, max_depth is clamped to kMaxDepth.
+	// looseness must be greater than 1, 2 is the usual choice.
+	explicit Octree(const AABB3& world_bounds, int max_depth = 8, float looseness = 2.0f);
+
+	Handle Insert(const AABB3& bounds);
+	void Remove(Handle handle);
+	// Only relinks the object when it leaves the cell of its node
+	void Move(Handle handle, const AABB3& bounds);
+
+	// Appends the objects overlapping the sphere (AABBOverlapSphere)
+	void QuerySphere(const Sphere& sphere, std::vector<Handle>& result) const;
+	// Appends the objects inside the frustum, passing plane masks down
+	void QueryFrustum(const Frustum& frustum, std::vector<Handle>& result) const;
+	// Closest object whose bounds the ray hits, children are visited front
+	// to back so farther nodes are skipped. Returns kInvalidHandle on miss,
+	// distance is along Ray3::direction() as in Ray3::PointInRay.
+	Handle Raycast(const Ray3& ray, float& distance,
+		float max_distance = std::numeric_limits<float>::infinity()) const;
+	// Appends every object hit by the ray, sorted by distance
+	void QueryRay(const Ray3& ray, std::vector<std::pair<Handle, float>>& result) const;
+
+	const AABB3& bounds(Handle handle) const { return objects_[handle].bounds; }
+	std::size_t size() const { return object_count_; }
+	std::size_t node_count() const { return nodes_.size() - free_nodes_.size(); }
+
+private:
+	static constexpr std::uint32_t kNone = std::numeric_limits<std::uint32_t>::max();
+
+	struct Node {
+		Vector3f center;
+		float half_size = 0.0f;
+		// Locational code: a leading 1 bit followed by 3 bits per level
+		std::uint32_t code = 1;
+		std::uint32_t parent = kNone;
+		std::uint32_t first_object = kNone;
+		std::uint32_t depth = 0;
+		std::array<std::uint32_t, 8> children;
+	};
+
+	struct Object {
+		AABB3 bounds;
+		std::uint32_t node = kNone;
+		std::uint32_t previous = kNone;
+		std::uint32_t next = kNone;
+	};
+
+	AABB3 LooseBounds(const Node& node) const;
+	// Locational code of the node the bounds belong to
+	std::uint32_t TargetCode(const AABB3& bounds) const;
+	std::uint32_t FindOrCreateNode(std::uint32_t code);
+	void Link(Handle handle, std::uint32_t node);
+	void Unlink(Handle handle);
+	void Prune(std::uint32_t node);
+	void CollectSubtree(std::uint32_t node, std::vector<Handle>& result) const;
+
+	Vector3f world_min_;
+	float world_size_ = 0.0f;
+	int max_depth_ = 0;
+	float looseness_ = 2.0f;
+	std::vector<Node> nodes_;
+	std::vector<std::uint32_t> free_nodes_;
+	std::vector<Object> objects_;
+	std::vector<Handle> free_objects_;
+	std::size_t object_count_ = 0;
+};
+
+} // namespace maths
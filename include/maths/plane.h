@@ -23,22 +23,34 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 
+#include <cstdint>
+#include <span>
+
+#include "maths/aabb3.h"
+#include "maths/sphere.h"
 #include "maths/vector3.h"
 
 namespace maths
 {
+
+// Side of a plane, kStraddle also covers shapes lying on the plane
+enum class PlaneSide : std::uint8_t { kFront, kBack, kStraddle };
 	
+// Plane stored as a unit normal and an offset: Dot(normal, p) + d = 0
 class Plane {
 
 public:
 	Plane() = default;
 	Plane(const Vector3f& point, const Vector3f& normal)
-	: point_(point), normal_(normal) {}
+	: normal_(normal), d_(-Vector3f::Dot(normal, point)) {}
+	Plane(const Vector3f& normal, float d)
+	: normal_(normal), d_(d) {}
 	Plane(Vector3f a, Vector3f b, Vector3f c)
-	: point_(a), normal_(CalculateNormalFromPoints(a,b,c)) {}
+	: normal_(CalculateNormalFromPoints(a,b,c)), d_(-Vector3f::Dot(normal_, a)) {}
 
-	float Distance( const Vector3f& point) const {
-		return {Vector3f::Dot(point - point_, normal_) };
+	// Signed distance, positive on the side the normal points to
+	float Distance(const Vector3f& point) const {
+		return normal_.x * point.x + normal_.y * point.y + normal_.z * point.z + d_;
 	}
 
 	// calculate the normal of the plane based on the three points
@@ -47,12 +59,28 @@ public:
 		Vector3f v_b = c - b;
 		return { Vector3f::Cross(v_a,v_b).Normalized() };
 	}
+
+	// Side of a point, points closer than epsilon are on the plane (kStraddle)
+	PlaneSide Classify(const Vector3f& point, float epsilon = 0.0f) const;
+	PlaneSide Classify(const AABB3& aabb) const;
+	PlaneSide Classify(const Sphere& sphere) const;
+
+	// Signed distances of a SoA point array, writes
+	// min(x.size(), y.size(), z.size(), distances.size()) values.
+	void DistanceBatch(std::span<const float> x, std::span<const float> y,
+		std::span<const float> z, std::span<float> distances) const;
+	// Side of every point of a SoA array, returns the side of the whole set:
+	// kFront or kBack if all points are on that side, kStraddle otherwise.
+	PlaneSide ClassifyBatch(std::span<const float> x, std::span<const float> y,
+		std::span<const float> z, std::span<PlaneSide> sides, float epsilon = 0.0f) const;
 	
-	Vector3f point() const { return { point_ }; }
-	Vector3f normal() const { return { normal_ }; }
+	// Point of the plane closest to the origin
+	Vector3f point() const { return { normal_ * -d_ }; }
+	Vector3f normal() const { return normal_; }
+	float d() const { return d_; }
 private:
-	Vector3f point_;
 	Vector3f normal_;
+	float d_ = 0.0f;
 	};
 
-} // namespace maths
\ No newline at end of file
+} // namespace maths
@@ -0,0 +1,67 @@
+#pragma once
+
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "maths/angle.h"
+#include "maths/frustum.h"
+#include "maths/matrix4.h"
+#include "maths/vector3.h"
+
+namespace maths {
+
+// Camera matrices for a right handed view space looking down -z with y up,
+// as in OpenGL. Every builder has a closed form inverse, cheaper and more
+// accurate than Matrix4f::Inverse, and a frustum in view space built from
+// the same parameters. Frustum::Transformed(LookAtInverse(...)) moves it
+// to world space.
+
+// fov_y is the full vertical angle, aspect the width over the height
+Matrix4f Perspective(radian_t fov_y, float aspect, float near_plane, float far_plane,
+	ClipDepth depth = ClipDepth::kNegativeOneToOne);
+Matrix4f PerspectiveInverse(radian_t fov_y, float aspect, float near_plane, float far_plane,
+	ClipDepth depth = ClipDepth::kNegativeOneToOne);
+Frustum PerspectiveFrustum(radian_t fov_y, float aspect, float near_plane, float far_plane);
+
+// Reverse Z with an infinite far plane: depth is 1 on the near plane and
+// tends to 0 at infinity, in a [0, 1] clip range. Float precision is highest
+// near 0, which evens out the depth precision over the distance. The far
+// plane of the frustum accepts every point.
+Matrix4f PerspectiveReverseZ(radian_t fov_y, float aspect, float near_plane);
+Matrix4f PerspectiveReverseZInverse(radian_t fov_y, float aspect, float near_plane);
+Frustum PerspectiveReverseZFrustum(radian_t fov_y, float aspect, float near_plane);
+
+// Box [left, right] x [bottom, top] x [-far_plane, -near_plane] of view space
+Matrix4f Orthographic(float left, float right, float bottom, float top, float near_plane, float far_plane,
+	ClipDepth depth = ClipDepth::kNegativeOneToOne);
+Matrix4f OrthographicInverse(float left, float right, float bottom, float top, float near_plane,
+	float far_plane, ClipDepth depth = ClipDepth::kNegativeOneToOne);
+Frustum OrthographicFrustum(float left, float right, float bottom, float top, float near_plane, float far_plane);
+
+// World to view matrix of a camera at eye looking at target, up must not be
+// parallel to the view direction
+Matrix4f LookAt(const Vector3f& eye, const Vector3f& target, const Vector3f& up);
+// View to world matrix, the camera transform
+Matrix4f LookAtInverse(const Vector3f& eye, const Vector3f& target, const Vector3f& up);
+
+} // namespace maths
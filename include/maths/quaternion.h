@@ -0,0 +1,88 @@
+#pragma once
+
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "maths/angle.h"
+#include "maths/matrix4.h"
+#include "maths/vector3.h"
+
+namespace maths {
+
+/**
+ *  \brief Quaternion w + xi + yj + zk, unit length when used as a rotation.
+ *  Defaults to the identity rotation.
+ */
+class Quaternion {
+public:
+    float x = 0.0f;
+    float y = 0.0f;
+    float z = 0.0f;
+    float w = 1.0f;
+
+    Quaternion() = default;
+
+    Quaternion(float x, float y, float z, float w);
+
+    // Rotation of angle around axis, which must be unit length
+    static Quaternion FromAxisAngle(const Vector3f& axis, radian_t angle);
+
+    // Rotation of the upper 3x3 of matrix, which must be orthonormal with a
+    // determinant of 1
+    static Quaternion FromRotationMatrix(const Matrix4f& matrix);
+
+    static Quaternion Identity();
+
+    // Hamilton product, rotates by rhs then by this
+    Quaternion operator*(const Quaternion& rhs) const;
+
+    Quaternion operator*(float scalar) const;
+
+    Quaternion operator+(const Quaternion& rhs) const;
+
+    Quaternion operator-() const;
+
+    bool operator==(const Quaternion& rhs) const;
+
+    // Inverse rotation of a unit quaternion
+    Quaternion Conjugate() const;
+
+    float Dot(const Quaternion& rhs) const;
+
+    float Magnitude() const;
+
+    Quaternion Normalized() const;
+
+    // Rotates v, the quaternion must be unit length
+    Vector3f Rotate(const Vector3f& v) const;
+
+    // Normalized linear interpolation along the shortest arc, cheap but not
+    // constant speed
+    static Quaternion Nlerp(const Quaternion& a, const Quaternion& b, float t);
+
+    // Spherical interpolation along the shortest arc at constant speed
+    static Quaternion Slerp(const Quaternion& a, const Quaternion& b, float t);
+};
+
+} // namespace maths
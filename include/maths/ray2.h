@@ -23,8 +23,13 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 
+#include <cstdint>
+#include <limits>
+#include <span>
+
 #include "maths/circle.h"
 #include "maths/aabb2.h"
+#include "maths/job_system.h"
 
 namespace maths {
 
@@ -58,4 +63,49 @@ private:
     Vector2f hit_position_;
 };
 
+// Circles as structure of arrays, circle i is element i of every span.
+// Only the common size of the spans is tested.
+struct CircleSoA {
+    std::span<const float> center_x;
+    std::span<const float> center_y;
+    std::span<const float> radius;
+};
+
+// AABB2s as structure of arrays, box i is element i of every span.
+// Only the common size of the spans is tested.
+struct AABB2SoA {
+    std::span<const float> min_x;
+    std::span<const float> min_y;
+    std::span<const float> max_x;
+    std::span<const float> max_y;
+};
+
+constexpr std::uint32_t kNoRay2Hit = 0xFFFFFFFF;
+
+// Nearest obstacle along a ray, the hit point is ray.PointInRay(t).
+// index is kNoRay2Hit and t is the max_t of the query when nothing is hit.
+struct Ray2Hit {
+    std::uint32_t index = kNoRay2Hit;
+    float t = std::numeric_limits<float>::infinity();
+};
+
+// Nearest obstacle hit with 0 <= t < max_t, four obstacles per SIMD pass.
+// t is in units of direction(), like PointInRay, and is 0 when the origin
+// is inside the obstacle. Equal distances return the lowest index. The
+// direction must not be zero; the ray itself is not modified.
+Ray2Hit IntersectNearest(const Ray2& ray, const CircleSoA& circles,
+    float max_t = std::numeric_limits<float>::infinity());
+Ray2Hit IntersectNearest(const Ray2& ray, const AABB2SoA& aabbs,
+    float max_t = std::numeric_limits<float>::infinity());
+
+// hits[i] = IntersectNearest(rays[i], ...). Each chunk of rays walks the
+// obstacles in tiles that stay in L1 while every ray of the chunk is tested.
+// Only min(rays.size(), hits.size()) results are written.
+void IntersectNearestBatch(std::span<const Ray2> rays, const CircleSoA& circles,
+    std::span<Ray2Hit> hits, float max_t = std::numeric_limits<float>::infinity(),
+    JobSystem& jobs = JobSystem::Default());
+void IntersectNearestBatch(std::span<const Ray2> rays, const AABB2SoA& aabbs,
+    std::span<Ray2Hit> hits, float max_t = std::numeric_limits<float>::infinity(),
+    JobSystem& jobs = JobSystem::Default());
+
 } // namespace maths
@@ -26,13 +26,26 @@ SOFTWARE.
 #include "maths/sphere.h"
 #include "maths/aabb3.h"
 #include "maths/plane.h"
+#include "maths/large_world.h"
 
 namespace maths {
 	
+// Ray triangle hit: distance along the direction and barycentrics, the
+// point is a * (1 - u - v) + b * u + c * v.
+struct TriangleHit {
+	float distance = 0.0f;
+	float u = 0.0f;
+	float v = 0.0f;
+};
+
 class Ray3 {
 public:
 	Ray3() = default;
 	Ray3(Vector3f& origin, Vector3f& direction) : origin_(origin), direction_(direction) {}
+	// Large world ray: the double precision origin is stored relative to
+	// origin_shift, which must then be given to the world space intersections.
+	Ray3(const Vector3d& origin, const Vector3f& direction, const Vector3d& origin_shift)
+		: origin_(origin.RelativeTo(origin_shift)), direction_(direction) {}
 
 	// Return a point along the ray from a given value
 	Vector3f PointInRay(float value) const {
@@ -49,6 +62,13 @@ public:
 	bool IntersectAABB3(const AABB3& aabb);
 	// Return true if ray intersect a plane
 	bool IntersectPlane(const Plane& plane);
+	// Return true if ray intersect the triangle abc, see WatertightRay
+	bool IntersectTriangle(const Vector3f& a, const Vector3f& b, const Vector3f& c,
+		TriangleHit& hit) const;
+	// Return true if ray intersect a world space sphere, see large world constructor
+	bool IntersectSphere(const Sphered& sphere, const Vector3d& origin_shift);
+	// Return true if ray intersect a world space AABB, see large world constructor
+	bool IntersectAABB3(const AABB3d& aabb, const Vector3d& origin_shift);
 
 private:
 	Vector3f origin_ = {};
@@ -57,4 +77,39 @@ private:
 	Vector3f hit_position_;
 };
 
+// Ray with its inverse direction computed once, for many AABB3 slab tests
+// during a hierarchy traversal.
+struct SlabRay {
+	SlabRay() = default;
+	explicit SlabRay(const Ray3& ray);
+
+	// Entry distance of the ray in the AABB, false on miss or past max_distance
+	bool Intersect(const AABB3& aabb, float max_distance, float& distance) const;
+
+	Vector3f origin;
+	Vector3f inverse_direction;
+};
+
+// Ray prepared for the watertight triangle test of Woop, Benthin and Wald
+// (2013): vertices are translated to the origin and sheared so the ray runs
+// along +z, then the 2D edge functions decide. Rays hitting a shared edge or
+// vertex hit at least one of the triangles, with no gap between them.
+struct WatertightRay {
+	WatertightRay() = default;
+	explicit WatertightRay(const Ray3& ray);
+
+	// Hit of a triangle, either winding, in (0, max_distance]
+	bool Intersect(const Vector3f& a, const Vector3f& b, const Vector3f& c,
+		float max_distance, TriangleHit& hit) const;
+
+	Vector3f origin;
+	// Axes permutation, kz is the largest direction component
+	int kx = 0;
+	int ky = 1;
+	int kz = 2;
+	float shear_x = 0.0f;
+	float shear_y = 0.0f;
+	float shear_z = 1.0f;
+};
+
 } // namespace maths
\ No newline at end of file
@@ -0,0 +1,165 @@
+#pragma once
+
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "maths/aabb3.h"
+#include "maths/bvh.h"
+#include "maths/matrix4.h"
+#include "maths/plane.h"
+#include "maths/sphere.h"
+
+namespace maths {
+
+// Binary scene file, loaded by mapping it in memory and reading the
+// sections in place, without parsing or copies. Little-endian layout:
+//  - SceneFileHeader
+//  - section_count SceneSectionEntry
+//  - the sections, each aligned on kSceneSectionAlignment bytes and stored
+//    as a packed array of its element type
+// Several sections of one type are told apart by a user tag.
+enum class SceneSectionType : std::uint32_t {
+	kAABB3 = 1,
+	kSphere = 2,
+	kPlane = 3,
+	kMatrix4f = 4,
+	kBvhNodes = 5,
+	kBvhItems = 6,
+};
+
+struct SceneFileHeader {
+	std::uint32_t magic = 0;
+	std::uint32_t version = 0;
+	// kSceneEndianTag written in the byte order of the file
+	std::uint32_t endian_tag = 0;
+	std::uint32_t section_count = 0;
+	std::uint64_t file_size = 0;
+};
+
+struct SceneSectionEntry {
+	SceneSectionType type = SceneSectionType::kAABB3;
+	std::uint32_t tag = 0;
+	// sizeof the element when written, checked against the reader's
+	std::uint32_t element_size = 0;
+	std::uint32_t reserved = 0;
+	std::uint64_t offset = 0;
+	std::uint64_t count = 0;
+};
+
+constexpr std::uint32_t kSceneFileMagic = 0x53525047; // "GPRS"
+constexpr std::uint32_t kSceneFileVersion = 1;
+constexpr std::uint32_t kSceneEndianTag = 0x01020304;
+constexpr std::size_t kSceneSectionAlignment = 64;
+
+enum class SceneFileError {
+	kNone,
+	kOpenFailed,
+	kTruncated,
+	kBadMagic,
+	kBadVersion,
+	kBadEndianness,
+	kBadSection,
+	kMisaligned,
+	// Only found when validating the contents
+	kBadBvh,
+	kBadAABB3,
+};
+
+const char* ToString(SceneFileError error);
+
+// Checks the header and the section table, so every section can be read in
+// place. With validate_contents the BVH topology, item indices and AABB3
+// are checked too, which touches every page of those sections.
+SceneFileError ValidateSceneFile(std::span<const std::byte> data, bool validate_contents = false);
+
+// Collects the sections of a scene file, then writes them in one go
+class SceneWriter {
+public:
+	void Add(std::span<const AABB3> aabbs, std::uint32_t tag = 0);
+	void Add(std::span<const Sphere> spheres, std::uint32_t tag = 0);
+	void Add(std::span<const Plane> planes, std::uint32_t tag = 0);
+	void Add(std::span<const Matrix4f> matrices, std::uint32_t tag = 0);
+	// Nodes and items, their AABB3 should be added with the same tag
+	void Add(const Bvh& bvh, std::uint32_t tag = 0);
+
+	std::vector<std::byte> Serialize() const;
+	bool Write(const std::string& path) const;
+
+private:
+	struct Section {
+		SceneSectionType type;
+		std::uint32_t tag;
+		std::uint32_t element_size;
+		std::uint64_t count;
+		std::vector<std::byte> bytes;
+	};
+
+	void AddSection(SceneSectionType type, std::uint32_t tag, std::uint32_t element_size,
+		std::uint64_t count, const void* data);
+
+	std::vector<Section> sections_;
+};
+
+// Scene file mapped read-only in memory, or a view of a buffer. The spans
+// returned point in the mapping and are valid until Close. Missing sections
+// are empty.
+class SceneFile {
+public:
+	SceneFile() = default;
+	~SceneFile();
+	SceneFile(SceneFile&& other) noexcept;
+	SceneFile& operator=(SceneFile&& other) noexcept;
+	SceneFile(const SceneFile&) = delete;
+	SceneFile& operator=(const SceneFile&) = delete;
+
+	SceneFileError Open(const std::string& path, bool validate_contents = false);
+	// data must outlive the SceneFile, and be aligned like new allocations
+	SceneFileError View(std::span<const std::byte> data, bool validate_contents = false);
+	void Close();
+
+	std::span<const AABB3> aabbs(std::uint32_t tag = 0) const;
+	std::span<const Sphere> spheres(std::uint32_t tag = 0) const;
+	std::span<const Plane> planes(std::uint32_t tag = 0) const;
+	std::span<const Matrix4f> matrices(std::uint32_t tag = 0) const;
+	BvhView bvh(std::uint32_t tag = 0) const;
+
+	std::span<const std::byte> data() const { return data_; }
+	bool is_open() const { return !data_.empty(); }
+
+private:
+	template<typename T>
+	std::span<const T> Section(SceneSectionType type, std::uint32_t tag) const;
+
+	std::span<const std::byte> data_;
+	// Set when data_ is a mapping owned by this object
+	void* mapping_ = nullptr;
+};
+
+} // namespace maths
@@ -0,0 +1,254 @@
+#pragma once
+
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+// Define MATHS_NO_SIMD to force the portable code paths
+#if !defined(MATHS_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define MATHS_SIMD_SSE 1
+#include <emmintrin.h>
+#endif
+
+namespace maths {
+
+/**
+ *  \brief Four packed floats mapped to one SSE register.
+ *
+ *  Falls back to plain arrays on other targets, which compilers
+ *  usually vectorize themselves. Comparisons return lane masks (all bits
+ *  set when true) to be used with Select, And and MoveMask.
+ */
+class Float4 {
+public:
+    static constexpr std::size_t kWidth = 4;
+
+    Float4() = default;
+
+#if MATHS_SIMD_SSE
+    explicit Float4(float value) : value_(_mm_set1_ps(value)) {}
+    Float4(float x, float y, float z, float w) : value_(_mm_setr_ps(x, y, z, w)) {}
+    explicit Float4(__m128 value) : value_(value) {}
+
+    static Float4 Load(const float* data) { return Float4(_mm_loadu_ps(data)); }
+    static Float4 LoadAligned(const float* data) { return Float4(_mm_load_ps(data)); }
+    void Store(float* data) const { _mm_storeu_ps(data, value_); }
+    void StoreAligned(float* data) const { _mm_store_ps(data, value_); }
+    // Three floats in x, y and z with w cleared, never reading past data[2]
+    static Float4 Load3(const float* data) {
+        const __m128 xy = _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(data)));
+        return Float4(_mm_movelh_ps(xy, _mm_load_ss(data + 2)));
+    }
+    void Store3(float* data) const {
+        _mm_store_sd(reinterpret_cast<double*>(data), _mm_castps_pd(value_));
+        _mm_store_ss(data + 2, _mm_movehl_ps(value_, value_));
+    }
+
+    float operator[](std::size_t lane) const {
+        alignas(16) float lanes[4];
+        _mm_store_ps(lanes, value_);
+        return lanes[lane];
+    }
+    // Lane 0 straight from the register
+    float First() const { return _mm_cvtss_f32(value_); }
+
+    Float4 operator+(Float4 rhs) const { return Float4(_mm_add_ps(value_, rhs.value_)); }
+    Float4 operator-(Float4 rhs) const { return Float4(_mm_sub_ps(value_, rhs.value_)); }
+    Float4 operator*(Float4 rhs) const { return Float4(_mm_mul_ps(value_, rhs.value_)); }
+    Float4 operator/(Float4 rhs) const { return Float4(_mm_div_ps(value_, rhs.value_)); }
+    Float4 operator-() const { return Float4(_mm_xor_ps(value_, _mm_set1_ps(-0.0f))); }
+
+    Float4 operator==(Float4 rhs) const { return Float4(_mm_cmpeq_ps(value_, rhs.value_)); }
+    Float4 operator<(Float4 rhs) const { return Float4(_mm_cmplt_ps(value_, rhs.value_)); }
+    Float4 operator<=(Float4 rhs) const { return Float4(_mm_cmple_ps(value_, rhs.value_)); }
+    Float4 operator>(Float4 rhs) const { return Float4(_mm_cmpgt_ps(value_, rhs.value_)); }
+    Float4 operator>=(Float4 rhs) const { return Float4(_mm_cmpge_ps(value_, rhs.value_)); }
+    Float4 operator&(Float4 rhs) const { return Float4(_mm_and_ps(value_, rhs.value_)); }
+    Float4 operator|(Float4 rhs) const { return Float4(_mm_or_ps(value_, rhs.value_)); }
+
+    // Bit i is set when lane i of a mask is true
+    int MoveMask() const { return _mm_movemask_ps(value_); }
+
+    // Transposes the 4x4 matrix whose rows are a, b, c and d
+    static void Transpose(Float4& a, Float4& b, Float4& c, Float4& d) {
+        _MM_TRANSPOSE4_PS(a.value_, b.value_, c.value_, d.value_);
+    }
+
+    // Lane i of the result is lane Ii of a
+    template<int I0, int I1, int I2, int I3>
+    static Float4 Shuffle(Float4 a) {
+        return Float4(_mm_shuffle_ps(a.value_, a.value_, _MM_SHUFFLE(I3, I2, I1, I0)));
+    }
+
+    static Float4 Min(Float4 a, Float4 b) { return Float4(_mm_min_ps(a.value_, b.value_)); }
+    static Float4 Max(Float4 a, Float4 b) { return Float4(_mm_max_ps(a.value_, b.value_)); }
+    static Float4 Abs(Float4 a) { return Float4(_mm_andnot_ps(_mm_set1_ps(-0.0f), a.value_)); }
+    static Float4 Sqrt(Float4 a) { return Float4(_mm_sqrt_ps(a.value_)); }
+    // Hardware estimate, about 12 bits of precision
+    static Float4 RsqrtEstimate(Float4 a) { return Float4(_mm_rsqrt_ps(a.value_)); }
+    // Lanes of a where mask is true, of b elsewhere
+    static Float4 Select(Float4 mask, Float4 a, Float4 b) {
+        return Float4(_mm_or_ps(_mm_and_ps(mask.value_, a.value_),
+                                _mm_andnot_ps(mask.value_, b.value_)));
+    }
+
+    __m128 value() const { return value_; }
+
+private:
+    __m128 value_;
+#else
+    explicit Float4(float value) : lanes_{value, value, value, value} {}
+    Float4(float x, float y, float z, float w) : lanes_{x, y, z, w} {}
+
+    static Float4 Load(const float* data) { return {data[0], data[1], data[2], data[3]}; }
+    static Float4 LoadAligned(const float* data) { return Load(data); }
+    void Store(float* data) const {
+        for (std::size_t i = 0; i < kWidth; i++) data[i] = lanes_[i];
+    }
+    void StoreAligned(float* data) const { Store(data); }
+    static Float4 Load3(const float* data) { return {data[0], data[1], data[2], 0.0f}; }
+    void Store3(float* data) const {
+        for (std::size_t i = 0; i < 3; i++) data[i] = lanes_[i];
+    }
+
+    float operator[](std::size_t lane) const { return lanes_[lane]; }
+    float First() const { return lanes_[0]; }
+
+    Float4 operator+(Float4 rhs) const { return Apply(rhs, [](float a, float b) { return a + b; }); }
+    Float4 operator-(Float4 rhs) const { return Apply(rhs, [](float a, float b) { return a - b; }); }
+    Float4 operator*(Float4 rhs) const { return Apply(rhs, [](float a, float b) { return a * b; }); }
+    Float4 operator/(Float4 rhs) const { return Apply(rhs, [](float a, float b) { return a / b; }); }
+    Float4 operator-() const { return Float4(0.0f) - *this; }
+
+    Float4 operator==(Float4 rhs) const { return Apply(rhs, [](float a, float b) { return Mask(a == b); }); }
+    Float4 operator<(Float4 rhs) const { return Apply(rhs, [](float a, float b) { return Mask(a < b); }); }
+    Float4 operator<=(Float4 rhs) const { return Apply(rhs, [](float a, float b) { return Mask(a <= b); }); }
+    Float4 operator>(Float4 rhs) const { return Apply(rhs, [](float a, float b) { return Mask(a > b); }); }
+    Float4 operator>=(Float4 rhs) const { return Apply(rhs, [](float a, float b) { return Mask(a >= b); }); }
+    Float4 operator&(Float4 rhs) const { return Bits(rhs, [](std::uint32_t a, std::uint32_t b) { return a & b; }); }
+    Float4 operator|(Float4 rhs) const { return Bits(rhs, [](std::uint32_t a, std::uint32_t b) { return a | b; }); }
+
+    int MoveMask() const {
+        int mask = 0;
+        for (std::size_t i = 0; i < kWidth; i++) {
+            mask |= static_cast<int>(std::bit_cast<std::uint32_t>(lanes_[i]) >> 31) << i;
+        }
+        return mask;
+    }
+
+    static void Transpose(Float4& a, Float4& b, Float4& c, Float4& d) {
+        Float4* rows[4] = {&a, &b, &c, &d};
+        for (std::size_t i = 0; i < kWidth; i++) {
+            for (std::size_t j = i + 1; j < kWidth; j++) {
+                std::swap(rows[i]->lanes_[j], rows[j]->lanes_[i]);
+            }
+        }
+    }
+
+    template<int I0, int I1, int I2, int I3>
+    static Float4 Shuffle(Float4 a) { return {a.lanes_[I0], a.lanes_[I1], a.lanes_[I2], a.lanes_[I3]}; }
+
+    static Float4 Min(Float4 a, Float4 b) { return a.Apply(b, [](float x, float y) { return x < y ? x : y; }); }
+    static Float4 Max(Float4 a, Float4 b) { return a.Apply(b, [](float x, float y) { return x > y ? x : y; }); }
+    static Float4 Abs(Float4 a) { return a.Apply(a, [](float x, float) { return std::abs(x); }); }
+    static Float4 Sqrt(Float4 a) { return a.Apply(a, [](float x, float) { return std::sqrt(x); }); }
+    static Float4 RsqrtEstimate(Float4 a) { return a.Apply(a, [](float x, float) { return 1.0f / std::sqrt(x); }); }
+    static Float4 Select(Float4 mask, Float4 a, Float4 b) {
+        Float4 result;
+        for (std::size_t i = 0; i < kWidth; i++) {
+            result.lanes_[i] = std::bit_cast<std::uint32_t>(mask.lanes_[i]) != 0 ? a.lanes_[i] : b.lanes_[i];
+        }
+        return result;
+    }
+
+private:
+    static float Mask(bool value) { return std::bit_cast<float>(value ? 0xFFFFFFFFu : 0u); }
+
+    template<typename Op>
+    Float4 Apply(Float4 rhs, Op op) const {
+        Float4 result;
+        for (std::size_t i = 0; i < kWidth; i++) result.lanes_[i] = op(lanes_[i], rhs.lanes_[i]);
+        return result;
+    }
+
+    template<typename Op>
+    Float4 Bits(Float4 rhs, Op op) const {
+        Float4 result;
+        for (std::size_t i = 0; i < kWidth; i++) {
+            result.lanes_[i] = std::bit_cast<float>(op(std::bit_cast<std::uint32_t>(lanes_[i]),
+                                                       std::bit_cast<std::uint32_t>(rhs.lanes_[i])));
+        }
+        return result;
+    }
+
+    float lanes_[4];
+#endif
+
+public:
+    // a * b + c
+    static Float4 MulAdd(Float4 a, Float4 b, Float4 c) { return a * b + c; }
+    static Float4 Zero() { return Float4(0.0f); }
+    // RsqrtEstimate refined by one Newton-Raphson step. On SSE the estimate
+    // has a relative error below 1.5 * 2^-12, the result below 2^-21.
+    static Float4 Rsqrt(Float4 a) {
+        const Float4 estimate = RsqrtEstimate(a);
+        return estimate * (Float4(1.5f) - Float4(0.5f) * a * estimate * estimate);
+    }
+};
+
+// 1 / sqrt(x), within 2^-21 relative error. Zero gives NaN with SSE (the
+// Newton-Raphson step multiplies 0 by infinity), infinity on the fallback.
+inline float ReciprocalSqrt(float x) {
+#if MATHS_SIMD_SSE
+    return Float4::Rsqrt(Float4(_mm_set_ss(x))).First();
+#else
+    return 1.0f / std::sqrt(x);
+#endif
+}
+
+// out = lhs * rhs for column-major 4x4 matrices stored as 16 packed floats,
+// one column per register. out may alias lhs or rhs.
+inline void MultiplyMatrix4(const float* lhs, const float* rhs, float* out) {
+    const Float4 c0 = Float4::Load(lhs);
+    const Float4 c1 = Float4::Load(lhs + 4);
+    const Float4 c2 = Float4::Load(lhs + 8);
+    const Float4 c3 = Float4::Load(lhs + 12);
+    Float4 result[4];
+    for (int j = 0; j < 4; j++) {
+        const float* column = rhs + 4 * j;
+        result[j] = c0 * Float4(column[0]) + c1 * Float4(column[1]) + c2 * Float4(column[2])
+            + c3 * Float4(column[3]);
+    }
+    for (int j = 0; j < 4; j++) {
+        result[j].Store(out + 4 * j);
+    }
+}
+
+} // namespace maths
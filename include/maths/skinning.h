@@ -0,0 +1,104 @@
+#pragma once
+
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include <cstdint>
+#include <span>
+
+#include "maths/job_system.h"
+#include "maths/matrix4.h"
+#include "maths/quaternion.h"
+#include "maths/vector3.h"
+
+namespace maths {
+
+// Vertex skinning: every vertex follows up to four bones of a palette,
+// palette[b] = bone_world[b] * inverse_bind[b] moving the bind pose to the
+// current pose of the bone.
+constexpr std::size_t kMaxBoneInfluences = 4;
+
+// Bones of one vertex. Weights sum to 1, unused slots have a zero weight
+// and bone indices must be lower than the palette size.
+struct BoneInfluences {
+	std::uint16_t bones[kMaxBoneInfluences] = {};
+	float weights[kMaxBoneInfluences] = {};
+};
+
+// Bind pose vertices in structure of arrays, one stream per component.
+// Normals are skinned only when nx is not empty.
+struct SkinningInput {
+	std::span<const float> px, py, pz;
+	std::span<const float> nx, ny, nz;
+	std::span<const BoneInfluences> influences;
+};
+
+// Skinned streams, written for the vertices of the input
+struct SkinningOutput {
+	std::span<float> px, py, pz;
+	std::span<float> nx, ny, nz;
+};
+
+/**
+ *  \brief Rigid transform real + e * dual, rotating by real then
+ *  translating by 2 * dual * conjugate(real).
+ */
+struct DualQuaternion {
+	Quaternion real;
+	Quaternion dual{ 0.0f, 0.0f, 0.0f, 0.0f };
+
+	static DualQuaternion FromRigid(const Quaternion& rotation, const Vector3f& translation);
+
+	// Rotation and translation of matrix, scale and shear are dropped
+	static DualQuaternion FromMatrix(const Matrix4f& matrix);
+
+	Vector3f TransformPoint(const Vector3f& point) const;
+};
+
+// palette[b] = bone_world[b] * inverse_bind[b] for the common size of the spans
+void BuildSkinningPalette(std::span<const Matrix4f> bone_world, std::span<const Matrix4f> inverse_bind,
+	std::span<Matrix4f> palette);
+
+// Rigid part of every palette matrix for dual quaternion skinning
+void BuildDualQuaternionPalette(std::span<const Matrix4f> palette, std::span<DualQuaternion> dual_palette);
+
+// Linear blend skinning, the palette matrices are blended with the weights
+// of each vertex then applied. Normals go through the blended matrix and are
+// renormalized, exact for rigid bones and uniform scales. Four vertices per
+// SIMD pass.
+void SkinLinearBlend(std::span<const Matrix4f> palette, const SkinningInput& input, const SkinningOutput& output);
+
+// Same with the vertices split in chunks over jobs
+void SkinLinearBlend(std::span<const Matrix4f> palette, const SkinningInput& input, const SkinningOutput& output,
+	JobSystem& jobs);
+
+// Dual quaternion skinning, the bone transforms are blended as dual
+// quaternions, which keeps volume around twisting joints where linear blend
+// collapses. Bones must be rigid.
+void SkinDualQuaternion(std::span<const DualQuaternion> palette, const SkinningInput& input,
+	const SkinningOutput& output);
+
+void SkinDualQuaternion(std::span<const DualQuaternion> palette, const SkinningInput& input,
+	const SkinningOutput& output, JobSystem& jobs);
+
+} // namespace maths
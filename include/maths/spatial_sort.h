@@ -0,0 +1,63 @@
+#pragma once
+
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "maths/aabb3.h"
+#include "maths/circle.h"
+#include "maths/job_system.h"
+#include "maths/sphere.h"
+
+namespace maths {
+
+enum class SpaceFillingCurve { kMorton, kHilbert };
+
+// Stable LSD radix sort on 8-bit digits, histograms and scatters are split
+// over the jobs. order receives the permutation: order[i] is the index in
+// keys of the i-th smallest key. Digits shared by every key are skipped.
+void RadixSortIndices(std::span<const std::uint32_t> keys, std::vector<std::uint32_t>& order,
+	JobSystem& jobs = JobSystem::Default());
+void RadixSortIndices(std::span<const std::uint64_t> keys, std::vector<std::uint32_t>& order,
+	JobSystem& jobs = JobSystem::Default());
+
+// 64-bit curve keys of the centers, quantized in the bounds of all centers
+void SpatialKeys(std::span<const AABB3> aabbs, SpaceFillingCurve curve, std::vector<std::uint64_t>& keys);
+void SpatialKeys(std::span<const Sphere> spheres, SpaceFillingCurve curve, std::vector<std::uint64_t>& keys);
+void SpatialKeys(std::span<const Circle> circles, SpaceFillingCurve curve, std::vector<std::uint64_t>& keys);
+
+// Reorders the shapes along the curve so neighbours in space are
+// neighbours in memory. If order is given it receives the permutation
+// (new index i holds the shape previously at order[i]).
+void SpatialSort(std::span<AABB3> aabbs, SpaceFillingCurve curve = SpaceFillingCurve::kMorton,
+	std::vector<std::uint32_t>* order = nullptr, JobSystem& jobs = JobSystem::Default());
+void SpatialSort(std::span<Sphere> spheres, SpaceFillingCurve curve = SpaceFillingCurve::kMorton,
+	std::vector<std::uint32_t>* order = nullptr, JobSystem& jobs = JobSystem::Default());
+void SpatialSort(std::span<Circle> circles, SpaceFillingCurve curve = SpaceFillingCurve::kMorton,
+	std::vector<std::uint32_t>* order = nullptr, JobSystem& jobs = JobSystem::Default());
+
+} // namespace maths
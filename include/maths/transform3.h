@@ -0,0 +1,106 @@
+#pragma once
+
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <cstdint>
+#include <span>
+
+#include "maths/job_system.h"
+#include "maths/matrix4.h"
+#include "maths/quaternion.h"
+#include "maths/vector3.h"
+
+namespace maths {
+
+/**
+ *  \brief Translation, rotation and scale applied in the order scale,
+ *  rotation then translation, 40 bytes instead of the 64 of a Matrix4f.
+ *
+ *  Compose and Inverse are exact for uniform scales. With non uniform
+ *  scales the product of rotated scales may contain shear, which is dropped.
+ */
+class Transform3 {
+public:
+    Vector3f translation{ 0.0f, 0.0f, 0.0f };
+    Quaternion rotation;
+    Vector3f scale{ 1.0f, 1.0f, 1.0f };
+
+    Transform3() = default;
+
+    Transform3(const Vector3f& translation, const Quaternion& rotation, const Vector3f& scale)
+        : translation(translation), rotation(rotation), scale(scale) {}
+
+    static Transform3 Identity() { return {}; }
+
+    // Transform applying child first then this, like Matrix4f products
+    Transform3 operator*(const Transform3& child) const;
+
+    Transform3 Inverse() const;
+
+    Vector3f TransformPoint(const Vector3f& point) const;
+
+    // Scale and rotation without the translation
+    Vector3f TransformDirection(const Vector3f& direction) const;
+
+    // Single pass bake without intermediate matrices
+    Matrix4f ToMatrix4f() const;
+
+    // Translations and scales interpolated linearly, rotations with Nlerp
+    static Transform3 Lerp(const Transform3& a, const Transform3& b, float t);
+
+    // Same with Slerp for the rotations
+    static Transform3 Slerp(const Transform3& a, const Transform3& b, float t);
+};
+
+// How Decompose split a matrix
+enum class DecomposeStatus : std::uint8_t {
+    // Orthogonal columns, ToMatrix4f gives the matrix back
+    kExact,
+    // Shear, dropped through a polar decomposition: the rotation is the
+    // closest one and the scale the diagonal of the stretch
+    kSheared,
+    // A zero scale or determinant, the rotation is the identity
+    kSingular,
+};
+
+// Splits an affine matrix into translation, rotation and scale. A negative
+// determinant (mirror) is stored as a negative x scale with a proper rotation.
+DecomposeStatus Decompose(const Matrix4f& matrix, Transform3& transform);
+
+// transforms[i] = Decompose(matrices[i]) split over jobs, statuses[i]
+// receives the status when not empty. Only the common size of the spans is
+// written.
+void DecomposeBatch(std::span<const Matrix4f> matrices, std::span<Transform3> transforms,
+    std::span<DecomposeStatus> statuses = {}, JobSystem& jobs = JobSystem::Default());
+
+// Column-major translation * rotation * scale matrix written to 16 floats
+void ComposeTrs(const Quaternion& rotation, const Vector3f& translation, const Vector3f& scale, float* out);
+
+// matrices[i] = transforms[i].ToMatrix4f(), four transforms per SIMD pass.
+// Only the common size of the spans is written.
+void ToMatrix4fBatch(std::span<const Transform3> transforms, std::span<Matrix4f> matrices,
+    JobSystem& jobs = JobSystem::Default());
+
+} // namespace maths
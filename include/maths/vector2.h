@@ -24,6 +24,8 @@ SOFTWARE.
 
 #pragma once
 
+#include <span>
+
 #include "maths/vector3.h"
 #include "maths/angle.h"
 
@@ -92,6 +94,13 @@ public:
 
     void Normalize();
 
+    // Same error bound and zero handling as Vector3f::NormalizedFast.
+    Vector2f NormalizedFast() const;
+
+    // Fast normalization that leaves zero vectors untouched and returns
+    // false for them instead of dividing by zero.
+    bool NormalizeSafe();
+
     Vector2f Lerp(Vector2f v2, float t) const;
 
     static Vector2f Lerp(Vector2f v1, Vector2f v2, float t);
@@ -102,4 +111,8 @@ public:
 
     static Vector2f Rotation(Vector2f v1, radian_t angle);
 };
+
+// out[i] = in[i].NormalizedFast() four vectors at a time, zero vectors stay
+// zero. Only the common size of the spans is written, in may alias out.
+void NormalizeBatch(std::span<const Vector2f> in, std::span<Vector2f> out);
 } // namespace maths
@@ -23,6 +23,8 @@ SOFTWARE.
 */
 
 #pragma once
+#include <span>
+
 #include "maths/angle.h"
 
 namespace maths {
@@ -101,6 +103,15 @@ public:
 
     void Normalize();
 
+    // Normalized through the hardware reciprocal square root and one Newton
+    // step, relative error below 2^-21 (about 5e-7) on SSE. No zero check,
+    // a zero vector gives NaN.
+    Vector3f NormalizedFast() const;
+
+    // Fast normalization that leaves zero vectors untouched and returns
+    // false for them instead of dividing by zero.
+    bool NormalizeSafe();
+
     // The function Lerp linearly interpolates between two points.
     Vector3f Lerp(const Vector3f& v2, float t) const;
 
@@ -109,4 +120,8 @@ public:
     // The function Slerp spherically interpolates between two vectors.
     Vector3f Slerp(Vector3f& v2, float t) const;
 };
+
+// out[i] = in[i].NormalizedFast() four vectors at a time, zero vectors stay
+// zero. Only the common size of the spans is written, in may alias out.
+void NormalizeBatch(std::span<const Vector3f> in, std::span<Vector3f> out);
 } // namespace maths
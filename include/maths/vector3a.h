@@ -0,0 +1,120 @@
+#pragma once
+
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "maths/simd.h"
+#include "maths/vector3.h"
+
+namespace maths {
+/**
+ *  \brief 3D vector padded to 16 bytes so it fits one SIMD register.
+ *
+ *  Same operations as Vector3f, computed on a Float4 whose w lane is
+ *  ignored (kept at zero by the constructors). Convert to and from Vector3f
+ *  at the boundary of hot loops; storage and APIs stay on Vector3f.
+ */
+class alignas(16) Vector3fA {
+public:
+    Vector3fA() : value_(Float4::Zero()) {}
+
+    Vector3fA(float x, float y, float z) : value_(x, y, z, 0.0f) {}
+
+    explicit Vector3fA(const Vector3f& v) : value_(Float4::Load3(v.coord)) {}
+
+    explicit Vector3fA(Float4 value) : value_(value) {}
+
+    Vector3f ToVector3f() const {
+        Vector3f v;
+        value_.Store3(v.coord);
+        return v;
+    }
+
+    float x() const { return value_.First(); }
+    float y() const { return Float4::Shuffle<1, 1, 1, 1>(value_).First(); }
+    float z() const { return Float4::Shuffle<2, 2, 2, 2>(value_).First(); }
+
+    Float4 value() const { return value_; }
+
+    Vector3fA operator+(const Vector3fA& rhs) const { return Vector3fA(value_ + rhs.value_); }
+    Vector3fA& operator+=(const Vector3fA& rhs) { value_ = value_ + rhs.value_; return *this; }
+    Vector3fA operator-(const Vector3fA& rhs) const { return Vector3fA(value_ - rhs.value_); }
+    Vector3fA& operator-=(const Vector3fA& rhs) { value_ = value_ - rhs.value_; return *this; }
+    Vector3fA operator-() const { return Vector3fA(-value_); }
+    Vector3fA operator*(float scalar) const { return Vector3fA(value_ * Float4(scalar)); }
+    Vector3fA& operator*=(float scalar) { value_ = value_ * Float4(scalar); return *this; }
+    Vector3fA operator/(float scalar) const { return Vector3fA(value_ / Float4(scalar)); }
+    Vector3fA& operator/=(float scalar) { value_ = value_ / Float4(scalar); return *this; }
+
+    // Exact comparison of x, y and z, like Vector3f
+    bool operator==(const Vector3fA& rhs) const { return ((value_ == rhs.value_).MoveMask() & 0x7) == 0x7; }
+    bool operator!=(const Vector3fA& rhs) const { return !(*this == rhs); }
+
+    float Dot(const Vector3fA& v2) const { return DotSplat(v2).First(); }
+
+    static float Dot(const Vector3fA& v1, const Vector3fA& v2) { return v1.Dot(v2); }
+
+    // a x b = (a * b.yzx - a.yzx * b).yzx, three shuffles instead of six
+    Vector3fA Cross(const Vector3fA& v2) const {
+        const Float4 a_yzx = Float4::Shuffle<1, 2, 0, 3>(value_);
+        const Float4 b_yzx = Float4::Shuffle<1, 2, 0, 3>(v2.value_);
+        const Float4 c = value_ * b_yzx - a_yzx * v2.value_;
+        return Vector3fA(Float4::Shuffle<1, 2, 0, 3>(c));
+    }
+
+    static Vector3fA Cross(const Vector3fA& v1, const Vector3fA& v2) { return v1.Cross(v2); }
+
+    float Magnitude() const { return Float4::Sqrt(DotSplat(*this)).First(); }
+
+    float SqrMagnitude() const { return Dot(*this); }
+
+    // Reciprocal square root estimate refined by one Newton-Raphson step,
+    // relative error below 2^-21 on SSE. A zero vector gives NaN.
+    Vector3fA Normalized() const { return Vector3fA(value_ * Float4::Rsqrt(DotSplat(*this))); }
+
+    void Normalize() { *this = Normalized(); }
+
+    Vector3fA Lerp(const Vector3fA& v2, float t) const {
+        return Vector3fA(Float4::MulAdd(v2.value_ - value_, Float4(t), value_));
+    }
+
+    static Vector3fA Lerp(const Vector3fA& v1, const Vector3fA& v2, float t) { return v1.Lerp(v2, t); }
+
+    static Vector3fA Min(const Vector3fA& v1, const Vector3fA& v2) { return Vector3fA(Float4::Min(v1.value_, v2.value_)); }
+
+    static Vector3fA Max(const Vector3fA& v1, const Vector3fA& v2) { return Vector3fA(Float4::Max(v1.value_, v2.value_)); }
+
+private:
+    // Dot product of x, y and z broadcast to every lane, w never read
+    Float4 DotSplat(const Vector3fA& v2) const {
+        const Float4 m = value_ * v2.value_;
+        return Float4::Shuffle<0, 0, 0, 0>(m) + Float4::Shuffle<1, 1, 1, 1>(m) + Float4::Shuffle<2, 2, 2, 2>(m);
+    }
+
+    Float4 value_;
+};
+
+static_assert(sizeof(Vector3fA) == 16);
+static_assert(alignof(Vector3fA) == 16);
+} // namespace maths
@@ -0,0 +1,87 @@
+#pragma once
+
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "maths/vector3.h"
+
+namespace maths {
+/**
+ *  \brief Class used to represent a 3D position in double precision.
+ *
+ *  Used for world positions far from the origin. Hot paths should rebase
+ *  them around a camera or origin shift and work on Vector3f offsets.
+ */
+class Vector3d {
+public:
+    double x = 0.0;
+    double y = 0.0;
+    double z = 0.0;
+
+    Vector3d() = default;
+
+    Vector3d(double x, double y, double z) : x(x), y(y), z(z) {}
+
+    explicit Vector3d(const Vector3f& v) : x(v.x), y(v.y), z(v.z) {}
+
+    Vector3d operator+(const Vector3d& rhs) const;
+
+    Vector3d& operator+=(const Vector3d& rhs);
+
+    Vector3d operator-(const Vector3d& rhs) const;
+
+    Vector3d& operator-=(const Vector3d& rhs);
+
+    Vector3d operator*(double scalar) const;
+
+    Vector3d operator/(double scalar) const;
+
+    bool operator==(const Vector3d& rhs) const;
+
+    bool operator!=(const Vector3d& rhs) const;
+
+    // This function does the Dot product of two vectors.
+    static double Dot(const Vector3d& v1, const Vector3d& v2);
+
+    // This function calculates the norm.
+    double Magnitude() const;
+
+    // This function calculates the squared length of a vector.
+    double SqrMagnitude() const;
+
+    // Returns the float offset of this position from the given origin.
+    // The subtraction is done in double so the result keeps full precision.
+    Vector3f RelativeTo(const Vector3d& origin) const {
+        return {static_cast<float>(x - origin.x),
+                static_cast<float>(y - origin.y),
+                static_cast<float>(z - origin.z)};
+    }
+
+    // Returns the position rounded to single precision.
+    Vector3f ToVector3f() const {
+        return {static_cast<float>(x), static_cast<float>(y),
+                static_cast<float>(z)};
+    }
+};
+} // namespace maths
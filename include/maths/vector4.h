@@ -23,6 +23,8 @@ SOFTWARE.
 */
 
 #pragma once
+#include <span>
+
 #include "maths/angle.h"
 
 namespace maths {
@@ -93,9 +95,20 @@ public:
 
     void Normalize();
 
+    // Same error bound and zero handling as Vector3f::NormalizedFast.
+    Vector4f NormalizedFast() const;
+
+    // Fast normalization that leaves zero vectors untouched and returns
+    // false for them instead of dividing by zero.
+    bool NormalizeSafe();
+
     // The function Lerp linearly interpolates between two points.
     Vector4f Lerp(const Vector4f& v2, float t) const;
 
     static Vector4f Lerp(const Vector4f& v1, const Vector4f& v2, float t);
 };
+
+// out[i] = in[i].NormalizedFast() four vectors at a time, zero vectors stay
+// zero. Only the common size of the spans is written, in may alias out.
+void NormalizeBatch(std::span<const Vector4f> in, std::span<Vector4f> out);
 } // namespace maths
@@ -24,6 +24,63 @@ SOFTWARE.
 
 #include "maths/aabb3.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "maths/matrix4.h"
+
 namespace maths {
 
+AABB3 AABB3::Transformed(const Matrix4f& matrix) const
+{
+	if (IsEmpty()) {
+		return *this;
+	}
+	const float center[3] = { (bottom_left_.x + top_right_.x) * 0.5f, (bottom_left_.y + top_right_.y) * 0.5f,
+		(bottom_left_.z + top_right_.z) * 0.5f };
+	const float extent[3] = { (top_right_.x - bottom_left_.x) * 0.5f, (top_right_.y - bottom_left_.y) * 0.5f,
+		(top_right_.z - bottom_left_.z) * 0.5f };
+	float new_center[3];
+	float new_extent[3];
+	for (int row = 0; row < 3; row++) {
+		new_center[row] = matrix[3][row];
+		new_extent[row] = 0.0f;
+		for (int column = 0; column < 3; column++) {
+			new_center[row] += matrix[column][row] * center[column];
+			new_extent[row] += std::abs(matrix[column][row]) * extent[column];
+		}
+	}
+	return { Vector3f{ new_center[0] - new_extent[0], new_center[1] - new_extent[1], new_center[2] - new_extent[2] },
+		Vector3f{ new_center[0] + new_extent[0], new_center[1] + new_extent[1], new_center[2] + new_extent[2] } };
+}
+
+AABB3 AABB3::Empty()
+{
+	constexpr float kInfinity = std::numeric_limits<float>::infinity();
+	return { Vector3f{ kInfinity, kInfinity, kInfinity },
+		Vector3f{ -kInfinity, -kInfinity, -kInfinity } };
+}
+
+AABB3 Union(const AABB3& a, const AABB3& b)
+{
+	const Vector3f a_min = a.bottom_left(), a_max = a.top_right();
+	const Vector3f b_min = b.bottom_left(), b_max = b.top_right();
+	return { Vector3f{ std::min(a_min.x, b_min.x), std::min(a_min.y, b_min.y), std::min(a_min.z, b_min.z) },
+		Vector3f{ std::max(a_max.x, b_max.x), std::max(a_max.y, b_max.y), std::max(a_max.z, b_max.z) } };
+}
+
+AABB3 Expand(const AABB3& aabb, const Vector3f& point)
+{
+	const Vector3f min = aabb.bottom_left(), max = aabb.top_right();
+	return { Vector3f{ std::min(min.x, point.x), std::min(min.y, point.y), std::min(min.z, point.z) },
+		Vector3f{ std::max(max.x, point.x), std::max(max.y, point.y), std::max(max.z, point.z) } };
+}
+
+AABB3 Expand(const AABB3& aabb, float margin)
+{
+	const Vector3f offset{ margin, margin, margin };
+	return { aabb.bottom_left() - offset, aabb.top_right() + offset };
+}
+
 }  // namespace maths
@@ -0,0 +1,204 @@
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "maths/batch.h"
+
+#include <algorithm>
+#include <numeric>
+
+#include "maths/simd.h"
+
+namespace maths {
+
+namespace {
+
+static_assert(sizeof(Matrix4f) == 16 * sizeof(float), "Matrix4f columns are loaded as packed floats");
+
+// Matrix columns kept in registers for Arvo's AABB transform
+struct AABB3Transformer {
+	explicit AABB3Transformer(const Matrix4f& matrix)
+	{
+		const float* data = reinterpret_cast<const float*>(&matrix);
+		for (int i = 0; i < 3; i++) {
+			columns[i] = Float4::Load(data + 4 * i);
+			abs_columns[i] = Float4::Abs(columns[i]);
+		}
+		translation = Float4::Load(data + 12);
+	}
+
+	AABB3 operator()(const AABB3& aabb) const
+	{
+		if (aabb.IsEmpty()) {
+			return aabb;
+		}
+		const Vector3f min = aabb.bottom_left(), max = aabb.top_right();
+		Float4 center = translation;
+		Float4 extent = Float4::Zero();
+		center = Float4::MulAdd(columns[0], Float4((min.x + max.x) * 0.5f), center);
+		center = Float4::MulAdd(columns[1], Float4((min.y + max.y) * 0.5f), center);
+		center = Float4::MulAdd(columns[2], Float4((min.z + max.z) * 0.5f), center);
+		extent = Float4::MulAdd(abs_columns[0], Float4((max.x - min.x) * 0.5f), extent);
+		extent = Float4::MulAdd(abs_columns[1], Float4((max.y - min.y) * 0.5f), extent);
+		extent = Float4::MulAdd(abs_columns[2], Float4((max.z - min.z) * 0.5f), extent);
+		const Float4 low = center - extent;
+		const Float4 high = center + extent;
+		return { Vector3f{ low[0], low[1], low[2] }, Vector3f{ high[0], high[1], high[2] } };
+	}
+
+	Float4 columns[3];
+	Float4 abs_columns[3];
+	Float4 translation;
+};
+
+} // namespace
+
+void TransformBatch(const Matrix4f& matrix, std::span<const Vector4f> in,
+	std::span<Vector4f> out, JobSystem& jobs)
+{
+	const std::size_t count = std::min(in.size(), out.size());
+	jobs.ParallelFor(0, count, [&](std::size_t begin, std::size_t end) {
+		for (std::size_t i = begin; i < end; i++) {
+			out[i] = matrix * in[i];
+		}
+	});
+}
+
+void TransformBatch(std::span<const Matrix4f> matrices, std::span<const AABB3> local,
+	std::span<AABB3> world, JobSystem& jobs)
+{
+	const std::size_t count = std::min({ matrices.size(), local.size(), world.size() });
+	jobs.ParallelFor(0, count, [&](std::size_t begin, std::size_t end) {
+		for (std::size_t i = begin; i < end; i++) {
+			world[i] = AABB3Transformer(matrices[i])(local[i]);
+		}
+	});
+}
+
+void TransformBatch(const Matrix4f& matrix, std::span<const AABB3> local,
+	std::span<AABB3> world, JobSystem& jobs)
+{
+	const std::size_t count = std::min(local.size(), world.size());
+	const AABB3Transformer transform(matrix);
+	jobs.ParallelFor(0, count, [&](std::size_t begin, std::size_t end) {
+		for (std::size_t i = begin; i < end; i++) {
+			world[i] = transform(local[i]);
+		}
+	});
+}
+
+void CullBatch(const Frustum& frustum, std::span<const AABB3> aabbs,
+	std::vector<std::uint32_t>& visible, JobSystem& jobs)
+{
+	std::vector<std::uint32_t> result;
+	jobs.ParallelCollect(aabbs.size(), result,
+		[&](std::size_t begin, std::size_t end, std::vector<std::uint32_t>& local) {
+			for (std::size_t i = begin; i < end; i++) {
+				if (frustum.contains(aabbs[i])) {
+					local.push_back(static_cast<std::uint32_t>(i));
+				}
+			}
+		});
+	visible.insert(visible.end(), result.begin(), result.end());
+}
+
+void CullBatch(const Frustum& frustum, std::span<const Sphere> spheres,
+	std::vector<std::uint32_t>& visible, JobSystem& jobs)
+{
+	std::vector<std::uint32_t> result;
+	// SIMD plane tests per chunk, every plane is tested before accepting
+	jobs.ParallelCollect(spheres.size(), result,
+		[&](std::size_t begin, std::size_t end, std::vector<std::uint32_t>& local) {
+			std::vector<std::uint8_t> inside(end - begin);
+			frustum.ContainsBatch(spheres.subspan(begin, end - begin), inside);
+			for (std::size_t i = begin; i < end; i++) {
+				if (inside[i - begin]) {
+					local.push_back(static_cast<std::uint32_t>(i));
+				}
+			}
+		});
+	visible.insert(visible.end(), result.begin(), result.end());
+}
+
+void IntersectBatch(std::span<const Ray3> rays, std::span<const AABB3> aabbs,
+	std::span<std::uint8_t> hits, JobSystem& jobs)
+{
+	const std::size_t count = std::min(rays.size(), hits.size());
+	// A ray against all the AABBs is already a lot of work, keep chunks small
+	const std::size_t grain = std::max<std::size_t>(1, jobs.GrainSize(count, 1));
+	jobs.ParallelFor(0, count, [&](std::size_t begin, std::size_t end) {
+		for (std::size_t i = begin; i < end; i++) {
+			Ray3 ray = rays[i];
+			hits[i] = std::any_of(aabbs.begin(), aabbs.end(),
+				[&ray](const AABB3& aabb) { return ray.IntersectAABB3(aabb); });
+		}
+	}, grain);
+}
+
+void IntersectBatch(std::span<const Ray3> rays, std::span<const Sphere> spheres,
+	std::span<std::uint8_t> hits, JobSystem& jobs)
+{
+	const std::size_t count = std::min(rays.size(), hits.size());
+	const std::size_t grain = std::max<std::size_t>(1, jobs.GrainSize(count, 1));
+	jobs.ParallelFor(0, count, [&](std::size_t begin, std::size_t end) {
+		for (std::size_t i = begin; i < end; i++) {
+			Ray3 ray = rays[i];
+			hits[i] = std::any_of(spheres.begin(), spheres.end(),
+				[&ray](const Sphere& sphere) { return ray.IntersectSphere(sphere); });
+		}
+	}, grain);
+}
+
+void FindOverlappingPairs(std::span<const AABB3> aabbs,
+	std::vector<std::pair<std::uint32_t, std::uint32_t>>& pairs, JobSystem& jobs)
+{
+	using Pair = std::pair<std::uint32_t, std::uint32_t>;
+	std::vector<std::uint32_t> order(aabbs.size());
+	std::iota(order.begin(), order.end(), 0u);
+	std::sort(order.begin(), order.end(), [&aabbs](std::uint32_t a, std::uint32_t b) {
+		return aabbs[a].bottom_left().x < aabbs[b].bottom_left().x;
+	});
+
+	std::vector<Pair> result;
+	jobs.ParallelCollect(order.size(), result,
+		[&](std::size_t begin, std::size_t end, std::vector<Pair>& local) {
+			for (std::size_t i = begin; i < end; i++) {
+				const AABB3& a = aabbs[order[i]];
+				for (std::size_t j = i + 1; j < order.size(); j++) {
+					const AABB3& b = aabbs[order[j]];
+					// Sorted on min x, nothing further can touch a
+					if (b.bottom_left().x > a.top_right().x) {
+						break;
+					}
+					if (b.bottom_left().y <= a.top_right().y && a.bottom_left().y <= b.top_right().y &&
+						b.bottom_left().z <= a.top_right().z && a.bottom_left().z <= b.top_right().z) {
+						local.emplace_back(std::min(order[i], order[j]), std::max(order[i], order[j]));
+					}
+				}
+			}
+		});
+	std::sort(result.begin(), result.end());
+	pairs.insert(pairs.end(), result.begin(), result.end());
+}
+
+} // namespace maths
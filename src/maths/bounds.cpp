@@ -0,0 +1,325 @@
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "maths/bounds.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+#include "maths/simd.h"
+
+namespace maths {
+
+namespace {
+
+static_assert(sizeof(Vector3f) == 3 * sizeof(float), "Vector3f spans are read as packed floats");
+
+// Relative slack of the containment tests of the exact sphere solver
+constexpr float kSphereEpsilon = 1e-5f;
+
+bool Encloses(const Sphere& sphere, const Vector3f& point)
+{
+	if (sphere.radius() < 0.0f) {
+		return false;
+	}
+	const float radius = sphere.radius() * (1.0f + kSphereEpsilon) + kSphereEpsilon;
+	return (point - sphere.center()).SqrMagnitude() <= radius * radius;
+}
+
+Sphere SphereFromPair(const Vector3f& a, const Vector3f& b)
+{
+	return { (a - b).Magnitude() * 0.5f, (a + b) * 0.5f };
+}
+
+// Smallest of the pair spheres enclosing every point, for degenerate supports
+Sphere SphereFromPairs(const Vector3f* points, int count)
+{
+	Sphere best{ -1.0f, Vector3f{} };
+	for (int i = 0; i < count; i++) {
+		for (int j = i + 1; j < count; j++) {
+			const Sphere sphere = SphereFromPair(points[i], points[j]);
+			if (best.radius() >= 0.0f && sphere.radius() >= best.radius()) {
+				continue;
+			}
+			if (std::all_of(points, points + count, [&sphere](const Vector3f& p) { return Encloses(sphere, p); })) {
+				best = sphere;
+			}
+		}
+	}
+	return best;
+}
+
+Sphere Circumsphere(const Vector3f& a, const Vector3f& b, const Vector3f& c)
+{
+	const Vector3f ac = a - c, bc = b - c;
+	const Vector3f normal = Vector3f::Cross(ac, bc);
+	const float denominator = 2.0f * normal.SqrMagnitude();
+	if (denominator <= std::numeric_limits<float>::epsilon() * ac.SqrMagnitude() * bc.SqrMagnitude()) {
+		const Vector3f points[3] = { a, b, c };
+		return SphereFromPairs(points, 3);
+	}
+	const Vector3f offset = Vector3f::Cross(bc * ac.SqrMagnitude() - ac * bc.SqrMagnitude(), normal) / denominator;
+	return { offset.Magnitude(), c + offset };
+}
+
+Sphere Circumsphere(const Vector3f& a, const Vector3f& b, const Vector3f& c, const Vector3f& d)
+{
+	const Vector3f r1 = b - a, r2 = c - a, r3 = d - a;
+	const float determinant = r1.Dot(Vector3f::Cross(r2, r3));
+	const float scale = r1.Magnitude() * r2.Magnitude() * r3.Magnitude();
+	if (std::abs(determinant) <= 1e-6f * scale) {
+		// Coplanar: smallest triangle sphere holding the fourth point
+		const Vector3f points[4] = { a, b, c, d };
+		Sphere best{ -1.0f, Vector3f{} };
+		for (int skip = 0; skip < 4; skip++) {
+			Vector3f triangle[3];
+			for (int i = 0, j = 0; i < 4; i++) {
+				if (i != skip) triangle[j++] = points[i];
+			}
+			const Sphere sphere = Circumsphere(triangle[0], triangle[1], triangle[2]);
+			if (Encloses(sphere, points[skip]) && (best.radius() < 0.0f || sphere.radius() < best.radius())) {
+				best = sphere;
+			}
+		}
+		return best;
+	}
+	const Vector3f offset = (Vector3f::Cross(r2, r3) * r1.SqrMagnitude() + Vector3f::Cross(r3, r1) * r2.SqrMagnitude()
+		+ Vector3f::Cross(r1, r2) * r3.SqrMagnitude()) / (2.0f * determinant);
+	return { offset.Magnitude(), a + offset };
+}
+
+Sphere SphereFromSupport(const Vector3f* support, int count)
+{
+	switch (count) {
+	case 0: return { -1.0f, Vector3f{} };
+	case 1: return { 0.0f, support[0] };
+	case 2: return SphereFromPair(support[0], support[1]);
+	case 3: return Circumsphere(support[0], support[1], support[2]);
+	default: return Circumsphere(support[0], support[1], support[2], support[3]);
+	}
+}
+
+// Welzl's minimal enclosing sphere, only used on a handful of points
+Sphere MinimalSphere(const Vector3f* points, int count, Vector3f* support, int support_count)
+{
+	Sphere sphere = SphereFromSupport(support, support_count);
+	if (support_count == 4) {
+		return sphere;
+	}
+	for (int i = 0; i < count; i++) {
+		if (!Encloses(sphere, points[i])) {
+			support[support_count] = points[i];
+			sphere = MinimalSphere(points, i, support, support_count + 1);
+		}
+	}
+	return sphere;
+}
+
+// Ritter's growth pass: each point outside moves the far side of the sphere
+// just enough to reach it
+Sphere GrowSphere(std::span<const Vector3f> points, const Sphere& sphere)
+{
+	float cx = sphere.center().x, cy = sphere.center().y, cz = sphere.center().z;
+	float radius = sphere.radius();
+	float radius_sq = radius * radius;
+	for (const Vector3f& point : points) {
+		const float dx = point.x - cx, dy = point.y - cy, dz = point.z - cz;
+		const float distance_sq = dx * dx + dy * dy + dz * dz;
+		if (distance_sq > radius_sq) {
+			const float distance = std::sqrt(distance_sq);
+			const float new_radius = (radius + distance) * 0.5f;
+			const float k = (new_radius - radius) / distance;
+			cx += dx * k;
+			cy += dy * k;
+			cz += dz * k;
+			radius = new_radius;
+			radius_sq = radius * radius;
+		}
+	}
+	return { radius, Vector3f{ cx, cy, cz } };
+}
+
+std::size_t Farthest(std::span<const Vector3f> points, const Vector3f& from)
+{
+	std::size_t best = 0;
+	float best_distance = -1.0f;
+	for (std::size_t i = 0; i < points.size(); i++) {
+		const float dx = points[i].x - from.x, dy = points[i].y - from.y, dz = points[i].z - from.z;
+		const float distance = dx * dx + dy * dy + dz * dz;
+		if (distance > best_distance) {
+			best_distance = distance;
+			best = i;
+		}
+	}
+	return best;
+}
+
+} // namespace
+
+AABB3 ComputeAABB3(std::span<const Vector3f> points)
+{
+	AABB3 result = AABB3::Empty();
+	std::size_t i = 0;
+	if (points.size() >= 4) {
+		// Four points are three registers: x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3
+		const float* data = points[0].coord;
+		Float4 min0 = Float4::Load(data), min1 = Float4::Load(data + 4), min2 = Float4::Load(data + 8);
+		Float4 max0 = min0, max1 = min1, max2 = min2;
+		for (i = 4; i + 4 <= points.size(); i += 4) {
+			const float* block = data + 3 * i;
+			const Float4 a = Float4::Load(block), b = Float4::Load(block + 4), c = Float4::Load(block + 8);
+			min0 = Float4::Min(min0, a);
+			min1 = Float4::Min(min1, b);
+			min2 = Float4::Min(min2, c);
+			max0 = Float4::Max(max0, a);
+			max1 = Float4::Max(max1, b);
+			max2 = Float4::Max(max2, c);
+		}
+		auto reduce = [](Float4 r0, Float4 r1, Float4 r2, auto op) {
+			return Vector3f{ op(op(r0[0], r0[3]), op(r1[2], r2[1])),
+				op(op(r0[1], r1[0]), op(r1[3], r2[2])),
+				op(op(r0[2], r1[1]), op(r2[0], r2[3])) };
+		};
+		result = AABB3{ reduce(min0, min1, min2, [](float a, float b) { return std::min(a, b); }),
+			reduce(max0, max1, max2, [](float a, float b) { return std::max(a, b); }) };
+	}
+	for (; i < points.size(); i++) {
+		result = Expand(result, points[i]);
+	}
+	return result;
+}
+
+Sphere ComputeRitterSphere(std::span<const Vector3f> points)
+{
+	if (points.empty()) {
+		return {};
+	}
+	const Vector3f& a = points[Farthest(points, points[0])];
+	const Vector3f& b = points[Farthest(points, a)];
+	return GrowSphere(points, SphereFromPair(a, b));
+}
+
+Sphere ComputeBoundingSphere(std::span<const Vector3f> points)
+{
+	if (points.empty()) {
+		return {};
+	}
+
+	// Extremal points along the 3 axes and the 4 cube diagonals
+	constexpr int kDirections = 7;
+	constexpr float kDirection[kDirections][3] = {
+		{ 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 }, { 1, 1, 1 }, { 1, 1, -1 }, { 1, -1, 1 }, { 1, -1, -1 } };
+	std::array<float, kDirections> min_projection, max_projection;
+	std::array<std::size_t, kDirections> min_index{}, max_index{};
+	min_projection.fill(std::numeric_limits<float>::infinity());
+	max_projection.fill(-std::numeric_limits<float>::infinity());
+	for (std::size_t i = 0; i < points.size(); i++) {
+		for (int d = 0; d < kDirections; d++) {
+			const float projection = points[i].x * kDirection[d][0] + points[i].y * kDirection[d][1]
+				+ points[i].z * kDirection[d][2];
+			if (projection < min_projection[d]) {
+				min_projection[d] = projection;
+				min_index[d] = i;
+			}
+			if (projection > max_projection[d]) {
+				max_projection[d] = projection;
+				max_index[d] = i;
+			}
+		}
+	}
+	Vector3f extremal[2 * kDirections];
+	for (int d = 0; d < kDirections; d++) {
+		extremal[2 * d] = points[min_index[d]];
+		extremal[2 * d + 1] = points[max_index[d]];
+	}
+	Vector3f support[4];
+	const Sphere epos = GrowSphere(points, MinimalSphere(extremal, 2 * kDirections, support, 0));
+	const Sphere ritter = ComputeRitterSphere(points);
+	return epos.radius() <= ritter.radius() ? epos : ritter;
+}
+
+OBB3 ComputeOBB3(std::span<const Vector3f> points)
+{
+	if (points.empty()) {
+		return {};
+	}
+
+	double mean[3] = {};
+	for (const Vector3f& point : points) {
+		mean[0] += point.x;
+		mean[1] += point.y;
+		mean[2] += point.z;
+	}
+	for (double& value : mean) {
+		value /= static_cast<double>(points.size());
+	}
+	double covariance[3][3] = {};
+	for (const Vector3f& point : points) {
+		const double d[3] = { point.x - mean[0], point.y - mean[1], point.z - mean[2] };
+		for (int i = 0; i < 3; i++) {
+			for (int j = i; j < 3; j++) {
+				covariance[i][j] += d[i] * d[j];
+			}
+		}
+	}
+	Matrix3f matrix;
+	for (int i = 0; i < 3; i++) {
+		for (int j = i; j < 3; j++) {
+			const float value = static_cast<float>(covariance[i][j] / static_cast<double>(points.size()));
+			matrix[i][j] = value;
+			matrix[j][i] = value;
+		}
+	}
+	Vector3f eigenvalues;
+	Matrix3f axes;
+	SymmetricEigen(matrix, eigenvalues, axes);
+
+	// Extent of the points along each principal axis
+	float min[3], max[3];
+	for (int axis = 0; axis < 3; axis++) {
+		min[axis] = std::numeric_limits<float>::infinity();
+		max[axis] = -std::numeric_limits<float>::infinity();
+	}
+	for (const Vector3f& point : points) {
+		for (int axis = 0; axis < 3; axis++) {
+			const Vector3f& direction = axes[axis];
+			const float projection = point.x * direction.x + point.y * direction.y + point.z * direction.z;
+			min[axis] = std::min(min[axis], projection);
+			max[axis] = std::max(max[axis], projection);
+		}
+	}
+	Vector3f center;
+	Vector3f half_extents;
+	for (int axis = 0; axis < 3; axis++) {
+		center += axes[axis] * ((min[axis] + max[axis]) * 0.5f);
+		half_extents[axis] = (max[axis] - min[axis]) * 0.5f;
+	}
+	const OBB3 obb{ center, axes, half_extents };
+	const OBB3 aabb{ ComputeAABB3(points) };
+	return aabb.volume() <= obb.volume() ? aabb : obb;
+}
+
+}  // namespace maths
@@ -0,0 +1,704 @@
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "maths/bvh.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+#include "maths/morton.h"
+#include "maths/spatial_sort.h"
+
+namespace maths {
+
+namespace {
+
+constexpr int kBinCount = 16;
+constexpr float kInfinity = std::numeric_limits<float>::infinity();
+
+float HalfSurfaceArea(const AABB3& aabb)
+{
+	const Vector3f size = aabb.top_right() - aabb.bottom_left();
+	if (size.x < 0.0f) {
+		return 0.0f;
+	}
+	return size.x * size.y + size.y * size.z + size.z * size.x;
+}
+
+struct Bin {
+	AABB3 bounds = AABB3::Empty();
+	std::uint32_t count = 0;
+};
+
+// Bin of a center offset, clamped to [0, kBinCount - 1] so that rounding
+// or a NaN can never index outside the bins
+int BinIndex(float offset, float scale)
+{
+	const float bin = offset * scale;
+	if (!(bin > 0.0f)) {
+		return 0;
+	}
+	return bin >= kBinCount - 1 ? kBinCount - 1 : static_cast<int>(bin);
+}
+
+} // namespace
+
+void Bvh::Build(std::span<const AABB3> aabbs, std::uint32_t max_leaf_size)
+{
+	nodes_.clear();
+	items_.resize(aabbs.size());
+	std::iota(items_.begin(), items_.end(), 0u);
+	dead_nodes_ = 0;
+	if (aabbs.empty()) {
+		UpdateSubtrees();
+		return;
+	}
+	max_leaf_size_ = std::max(max_leaf_size, 1u);
+
+	std::vector<Vector3f> centers(aabbs.size());
+	for (std::size_t i = 0; i < aabbs.size(); i++) {
+		centers[i] = aabbs[i].center();
+	}
+
+	nodes_.reserve(2 * aabbs.size());
+	nodes_.push_back({ {}, 0, static_cast<std::uint32_t>(aabbs.size()) });
+	Subdivide(aabbs, centers, 0);
+	UpdateSubtrees();
+}
+
+void Bvh::Subdivide(std::span<const AABB3> aabbs, std::span<const Vector3f> centers,
+	std::uint32_t root)
+{
+	std::vector<std::uint32_t> stack{ root };
+	while (!stack.empty()) {
+		const std::uint32_t node_index = stack.back();
+		stack.pop_back();
+		const std::uint32_t first = nodes_[node_index].first;
+		const std::uint32_t count = nodes_[node_index].count;
+
+		AABB3 bounds = AABB3::Empty();
+		AABB3 center_bounds = AABB3::Empty();
+		for (std::uint32_t i = first; i < first + count; i++) {
+			bounds = Union(bounds, aabbs[items_[i]]);
+			center_bounds = Expand(center_bounds, centers[items_[i]]);
+		}
+		nodes_[node_index].bounds = bounds;
+		if (count <= max_leaf_size_) {
+			continue;
+		}
+
+		// Find the best split plane among the bins of every axis
+		const Vector3f center_min = center_bounds.bottom_left();
+		const Vector3f center_size = center_bounds.top_right() - center_min;
+		float best_cost = kInfinity;
+		int best_axis = -1;
+		int best_split = 0;
+		for (int axis = 0; axis < 3; axis++) {
+			// A denormal range overflows the scale, treat it as flat
+			const float scale = kBinCount / center_size[axis];
+			if (!(center_size[axis] > 0.0f) || !std::isfinite(scale)) {
+				continue;
+			}
+			std::array<Bin, kBinCount> bins;
+			for (std::uint32_t i = first; i < first + count; i++) {
+				const int bin = BinIndex(centers[items_[i]][axis] - center_min[axis], scale);
+				bins[bin].bounds = Union(bins[bin].bounds, aabbs[items_[i]]);
+				bins[bin].count++;
+			}
+			// Sweep from the right to get the cost of every right side
+			std::array<float, kBinCount> right_cost{};
+			AABB3 right_bounds = AABB3::Empty();
+			std::uint32_t right_count = 0;
+			for (int bin = kBinCount - 1; bin > 0; bin--) {
+				right_bounds = Union(right_bounds, bins[bin].bounds);
+				right_count += bins[bin].count;
+				right_cost[bin] = right_count * HalfSurfaceArea(right_bounds);
+			}
+			AABB3 left_bounds = AABB3::Empty();
+			std::uint32_t left_count = 0;
+			for (int split = 1; split < kBinCount; split++) {
+				left_bounds = Union(left_bounds, bins[split - 1].bounds);
+				left_count += bins[split - 1].count;
+				const float cost = left_count * HalfSurfaceArea(left_bounds) + right_cost[split];
+				if (left_count != 0 && left_count != count && cost < best_cost) {
+					best_cost = cost;
+					best_axis = axis;
+					best_split = split;
+				}
+			}
+		}
+
+		std::uint32_t middle;
+		if (best_axis == -1) {
+			// All centers at the same place, split in the middle
+			middle = first + count / 2;
+		} else {
+			const float scale = kBinCount / center_size[best_axis];
+			const auto it = std::partition(items_.begin() + first, items_.begin() + first + count,
+				[&](std::uint32_t item) {
+					const int bin = BinIndex(centers[item][best_axis] - center_min[best_axis], scale);
+					return bin < best_split;
+				});
+			middle = static_cast<std::uint32_t>(it - items_.begin());
+		}
+
+		const std::uint32_t left = static_cast<std::uint32_t>(nodes_.size());
+		nodes_.push_back({ {}, first, middle - first });
+		nodes_.push_back({ {}, middle, first + count - middle });
+		nodes_[node_index].first = left;
+		nodes_[node_index].count = 0;
+		stack.push_back(left + 1);
+		stack.push_back(left);
+	}
+}
+
+void Bvh::BuildLinear(std::span<const AABB3> aabbs, JobSystem& jobs)
+{
+	const std::size_t count = aabbs.size();
+	nodes_.clear();
+	items_.clear();
+	dead_nodes_ = 0;
+	max_leaf_size_ = 1;
+	if (count <= 1) {
+		if (count == 1) {
+			nodes_.push_back({ aabbs[0], 0, 1 });
+			items_.push_back(0);
+		}
+		UpdateSubtrees();
+		return;
+	}
+
+	// Centroid bounds reduced per chunk. The hot loops of the build work on
+	// raw components, twice the centers are compared to skip the halving.
+	std::vector<std::array<float, 6>> partial_bounds;
+	jobs.ParallelCollect(count, partial_bounds,
+		[&](std::size_t begin, std::size_t end, std::vector<std::array<float, 6>>& local) {
+			std::array<float, 6> bounds{ kInfinity, kInfinity, kInfinity, -kInfinity, -kInfinity, -kInfinity };
+			for (std::size_t i = begin; i < end; i++) {
+				const Vector3f min = aabbs[i].bottom_left(), max = aabbs[i].top_right();
+				const float center[3] = { min.x + max.x, min.y + max.y, min.z + max.z };
+				for (int axis = 0; axis < 3; axis++) {
+					bounds[axis] = std::min(bounds[axis], center[axis]);
+					bounds[axis + 3] = std::max(bounds[axis + 3], center[axis]);
+				}
+			}
+			local.push_back(bounds);
+		});
+	std::array<float, 6> center_bounds = partial_bounds[0];
+	for (const std::array<float, 6>& bounds : partial_bounds) {
+		for (int axis = 0; axis < 3; axis++) {
+			center_bounds[axis] = std::min(center_bounds[axis], bounds[axis]);
+			center_bounds[axis + 3] = std::max(center_bounds[axis + 3], bounds[axis + 3]);
+		}
+	}
+
+	// 30 bit codes keep the radix sort at four passes, equal codes are
+	// handled by the index tie break below
+	constexpr float kMaxCell = 1023.0f;
+	std::array<float, 3> scale;
+	for (int axis = 0; axis < 3; axis++) {
+		const float range = center_bounds[axis + 3] - center_bounds[axis];
+		scale[axis] = range > 0.0f ? kMaxCell / range : 0.0f;
+	}
+	std::vector<std::uint32_t> codes(count);
+	jobs.ParallelFor(0, count, [&](std::size_t begin, std::size_t end) {
+		for (std::size_t i = begin; i < end; i++) {
+			const Vector3f min = aabbs[i].bottom_left(), max = aabbs[i].top_right();
+			const float center[3] = { min.x + max.x, min.y + max.y, min.z + max.z };
+			std::uint32_t cell[3];
+			for (int axis = 0; axis < 3; axis++) {
+				cell[axis] = static_cast<std::uint32_t>(
+					std::clamp((center[axis] - center_bounds[axis]) * scale[axis], 0.0f, kMaxCell));
+			}
+			codes[i] = MortonEncode32(cell[0], cell[1], cell[2]);
+		}
+	});
+	RadixSortIndices(codes, items_, jobs);
+	std::vector<std::uint32_t> sorted_codes(count);
+	jobs.ParallelFor(0, count, [&](std::size_t begin, std::size_t end) {
+		for (std::size_t i = begin; i < end; i++) {
+			sorted_codes[i] = codes[items_[i]];
+		}
+	});
+
+	// Length of the common prefix of two sorted keys, the index breaks ties
+	// between equal codes so every key is unique.
+	const auto delta = [&sorted_codes, count](std::int64_t i, std::int64_t j) {
+		if (j < 0 || j >= static_cast<std::int64_t>(count)) {
+			return -1;
+		}
+		const std::uint32_t difference = sorted_codes[i] ^ sorted_codes[j];
+		if (difference == 0) {
+			return 32 + std::countl_zero(static_cast<std::uint32_t>(i ^ j));
+		}
+		return std::countl_zero(difference);
+	};
+
+	// Inner node k of the Karras tree has its two children at 2k + 1 and
+	// 2k + 2, and is itself stored in the child slot its parent gives it
+	// (the root is at 0). Leaves point to a single sorted item.
+	const std::size_t inner_count = count - 1;
+	nodes_.resize(2 * count - 1);
+	std::vector<std::uint32_t> inner_slot(inner_count);
+	inner_slot[0] = 0;
+	nodes_[0] = { {}, 1, 0 };
+	jobs.ParallelFor(0, inner_count, [&](std::size_t begin, std::size_t end) {
+		for (std::size_t node = begin; node < end; node++) {
+			const std::int64_t i = static_cast<std::int64_t>(node);
+			// Direction of the range from the neighbour with the longest prefix
+			const int direction = delta(i, i + 1) > delta(i, i - 1) ? 1 : -1;
+			const int delta_min = delta(i, i - direction);
+			std::int64_t length_max = 2;
+			while (delta(i, i + length_max * direction) > delta_min) {
+				length_max *= 2;
+			}
+			std::int64_t length = 0;
+			for (std::int64_t step = length_max / 2; step >= 1; step /= 2) {
+				if (delta(i, i + (length + step) * direction) > delta_min) {
+					length += step;
+				}
+			}
+			const std::int64_t j = i + length * direction;
+
+			// Split at the highest differing bit of the range
+			const int delta_node = delta(i, j);
+			std::int64_t split = 0;
+			std::int64_t step = length;
+			do {
+				step = (step + 1) / 2;
+				if (delta(i, i + (split + step) * direction) > delta_node) {
+					split += step;
+				}
+			} while (step > 1);
+			const std::int64_t gamma = i + split * direction + std::min(direction, 0);
+
+			const std::uint32_t left_slot = static_cast<std::uint32_t>(2 * node + 1);
+			if (std::min(i, j) == gamma) {
+				nodes_[left_slot] = { aabbs[items_[gamma]], static_cast<std::uint32_t>(gamma), 1 };
+			} else {
+				nodes_[left_slot] = { {}, static_cast<std::uint32_t>(2 * gamma + 1), 0 };
+				inner_slot[gamma] = left_slot;
+			}
+			if (std::max(i, j) == gamma + 1) {
+				nodes_[left_slot + 1] = { aabbs[items_[gamma + 1]], static_cast<std::uint32_t>(gamma + 1), 1 };
+			} else {
+				nodes_[left_slot + 1] = { {}, static_cast<std::uint32_t>(2 * gamma + 3), 0 };
+				inner_slot[gamma + 1] = left_slot + 1;
+			}
+		}
+	});
+
+	// Bottom-up refit: every leaf climbs towards the root and the second
+	// thread reaching a node merges its children, the first one stops.
+	std::vector<std::atomic<std::uint32_t>> visits(inner_count);
+	jobs.ParallelFor(1, nodes_.size(), [&](std::size_t begin, std::size_t end) {
+		for (std::size_t slot = begin; slot < end; slot++) {
+			if (!nodes_[slot].IsLeaf()) {
+				continue;
+			}
+			std::size_t inner = (slot - 1) / 2;
+			while (visits[inner].fetch_add(1, std::memory_order_acq_rel) == 1) {
+				BvhNode& node = nodes_[inner_slot[inner]];
+				node.bounds = Union(nodes_[node.first].bounds, nodes_[node.first + 1].bounds);
+				if (inner == 0) {
+					break;
+				}
+				inner = (inner_slot[inner] - 1) / 2;
+			}
+		}
+	});
+	UpdateSubtrees();
+}
+
+void Bvh::Refit(std::span<const AABB3> aabbs, JobSystem& jobs)
+{
+	if (nodes_.empty()) {
+		return;
+	}
+	jobs.ParallelFor(0, subtree_roots_.size(), [&](std::size_t begin, std::size_t end) {
+		std::vector<std::uint32_t> order;
+		for (std::size_t i = begin; i < end; i++) {
+			RefitSubtree(aabbs, subtree_roots_[i], order);
+		}
+	}, 1);
+	for (auto it = top_nodes_.rbegin(); it != top_nodes_.rend(); ++it) {
+		BvhNode& node = nodes_[*it];
+		node.bounds = Union(nodes_[node.first].bounds, nodes_[node.first + 1].bounds);
+	}
+}
+
+std::uint32_t Bvh::RefitAndRebuild(std::span<const AABB3> aabbs, float max_drift, JobSystem& jobs)
+{
+	Refit(aabbs, jobs);
+	std::vector<float> costs(subtree_roots_.size());
+	jobs.ParallelFor(0, subtree_roots_.size(), [&](std::size_t begin, std::size_t end) {
+		for (std::size_t i = begin; i < end; i++) {
+			costs[i] = SubtreeCost(subtree_roots_[i]);
+		}
+	}, 1);
+
+	std::uint32_t rebuilt = 0;
+	std::vector<Vector3f> centers;
+	std::vector<std::uint32_t> stack;
+	for (std::size_t i = 0; i < subtree_roots_.size(); i++) {
+		const std::uint32_t root = subtree_roots_[i];
+		if (nodes_[root].IsLeaf() || costs[i] <= subtree_costs_[i] * max_drift) {
+			continue;
+		}
+
+		// The items of a subtree are contiguous in items_
+		std::uint32_t first = std::numeric_limits<std::uint32_t>::max();
+		std::uint32_t count = 0;
+		std::size_t subtree_size = 0;
+		stack.assign(1, root);
+		while (!stack.empty()) {
+			const BvhNode& node = nodes_[stack.back()];
+			stack.pop_back();
+			subtree_size++;
+			if (node.IsLeaf()) {
+				first = std::min(first, node.first);
+				count += node.count;
+			} else {
+				stack.push_back(node.first);
+				stack.push_back(node.first + 1);
+			}
+		}
+		if (centers.empty()) {
+			centers.resize(aabbs.size());
+		}
+		for (std::uint32_t item = first; item < first + count; item++) {
+			centers[items_[item]] = aabbs[items_[item]].center();
+		}
+
+		// The new nodes go to the end of the array, the old ones are dropped
+		dead_nodes_ += subtree_size - 1;
+		nodes_[root].first = first;
+		nodes_[root].count = count;
+		Subdivide(aabbs, centers, root);
+		subtree_costs_[i] = SubtreeCost(root);
+		rebuilt++;
+	}
+	if (dead_nodes_ > nodes_.size() / 4) {
+		Compact();
+	}
+	return rebuilt;
+}
+
+float Bvh::SahCost() const
+{
+	return nodes_.empty() ? 0.0f : SubtreeCost(0);
+}
+
+void Bvh::UpdateSubtrees()
+{
+	top_nodes_.clear();
+	subtree_roots_.clear();
+	subtree_costs_.clear();
+	if (nodes_.empty()) {
+		return;
+	}
+
+	// Expand the tree level by level until there are enough subtrees
+	std::vector<std::uint32_t> frontier{ 0 };
+	std::vector<std::uint32_t> next;
+	while (frontier.size() < kRefitSubtrees) {
+		next.clear();
+		for (const std::uint32_t index : frontier) {
+			const BvhNode& node = nodes_[index];
+			if (node.IsLeaf()) {
+				next.push_back(index);
+			} else {
+				top_nodes_.push_back(index);
+				next.push_back(node.first);
+				next.push_back(node.first + 1);
+			}
+		}
+		if (next.size() == frontier.size()) {
+			break;
+		}
+		frontier.swap(next);
+	}
+	subtree_roots_ = frontier;
+	subtree_costs_.resize(subtree_roots_.size());
+	for (std::size_t i = 0; i < subtree_roots_.size(); i++) {
+		subtree_costs_[i] = SubtreeCost(subtree_roots_[i]);
+	}
+}
+
+void Bvh::RefitSubtree(std::span<const AABB3> aabbs, std::uint32_t root,
+	std::vector<std::uint32_t>& order)
+{
+	// Breadth first order has parents before children, walk it backwards
+	order.assign(1, root);
+	for (std::size_t i = 0; i < order.size(); i++) {
+		const BvhNode& node = nodes_[order[i]];
+		if (!node.IsLeaf()) {
+			order.push_back(node.first);
+			order.push_back(node.first + 1);
+		}
+	}
+	for (auto it = order.rbegin(); it != order.rend(); ++it) {
+		BvhNode& node = nodes_[*it];
+		if (node.IsLeaf()) {
+			AABB3 bounds = aabbs[items_[node.first]];
+			for (std::uint32_t i = node.first + 1; i < node.first + node.count; i++) {
+				bounds = Union(bounds, aabbs[items_[i]]);
+			}
+			node.bounds = bounds;
+		} else {
+			node.bounds = Union(nodes_[node.first].bounds, nodes_[node.first + 1].bounds);
+		}
+	}
+}
+
+float Bvh::SubtreeCost(std::uint32_t root) const
+{
+	const float root_area = HalfSurfaceArea(nodes_[root].bounds);
+	if (root_area <= 0.0f) {
+		return 0.0f;
+	}
+	// Unit cost for a node visit and for an item test
+	float cost = 0.0f;
+	std::vector<std::uint32_t> stack{ root };
+	while (!stack.empty()) {
+		const BvhNode& node = nodes_[stack.back()];
+		stack.pop_back();
+		if (node.IsLeaf()) {
+			cost += HalfSurfaceArea(node.bounds) * static_cast<float>(node.count);
+		} else {
+			cost += HalfSurfaceArea(node.bounds);
+			stack.push_back(node.first);
+			stack.push_back(node.first + 1);
+		}
+	}
+	return cost / root_area;
+}
+
+void Bvh::Compact()
+{
+	// Depth first copy of the reachable nodes, siblings stay side by side
+	std::vector<BvhNode> compacted;
+	compacted.reserve(nodes_.size() - dead_nodes_);
+	std::vector<std::uint32_t> remap(nodes_.size(), kInvalidItem);
+	compacted.push_back(nodes_[0]);
+	remap[0] = 0;
+	std::vector<std::uint32_t> stack{ 0 };
+	while (!stack.empty()) {
+		const std::uint32_t index = stack.back();
+		stack.pop_back();
+		if (compacted[index].IsLeaf()) {
+			continue;
+		}
+		const std::uint32_t old_first = compacted[index].first;
+		const std::uint32_t first = static_cast<std::uint32_t>(compacted.size());
+		compacted.push_back(nodes_[old_first]);
+		compacted.push_back(nodes_[old_first + 1]);
+		remap[old_first] = first;
+		remap[old_first + 1] = first + 1;
+		compacted[index].first = first;
+		stack.push_back(first + 1);
+		stack.push_back(first);
+	}
+	nodes_.swap(compacted);
+	dead_nodes_ = 0;
+	for (std::uint32_t& index : top_nodes_) {
+		index = remap[index];
+	}
+	for (std::uint32_t& index : subtree_roots_) {
+		index = remap[index];
+	}
+}
+
+void BvhView::QuerySphere(std::span<const AABB3> aabbs, const Sphere& sphere,
+	std::vector<std::uint32_t>& result) const
+{
+	if (nodes_.empty()) {
+		return;
+	}
+	std::vector<std::uint32_t> stack{ 0 };
+	while (!stack.empty()) {
+		const BvhNode& node = nodes_[stack.back()];
+		stack.pop_back();
+		if (!AABBOverlapSphere(node.bounds, sphere)) {
+			continue;
+		}
+		if (!node.IsLeaf()) {
+			stack.push_back(node.first + 1);
+			stack.push_back(node.first);
+			continue;
+		}
+		for (std::uint32_t i = node.first; i < node.first + node.count; i++) {
+			if (node.count == 1 || AABBOverlapSphere(aabbs[items_[i]], sphere)) {
+				result.push_back(items_[i]);
+			}
+		}
+	}
+}
+
+std::uint32_t BvhView::Raycast(std::span<const AABB3> aabbs, const Ray3& ray, float& distance,
+	float max_distance) const
+{
+	std::uint32_t best = kInvalidItem;
+	float best_distance = max_distance;
+	float root_distance;
+	const SlabRay slab_ray(ray);
+	if (nodes_.empty() || !slab_ray.Intersect(nodes_[0].bounds, best_distance, root_distance)) {
+		return kInvalidItem;
+	}
+
+	struct Entry {
+		std::uint32_t node;
+		float distance;
+	};
+	std::vector<Entry> stack{ { 0, root_distance } };
+	while (!stack.empty()) {
+		const Entry entry = stack.back();
+		stack.pop_back();
+		if (entry.distance > best_distance) {
+			continue;
+		}
+		const BvhNode& node = nodes_[entry.node];
+		if (node.IsLeaf()) {
+			// Leaf bounds are exact for single items, test each one otherwise
+			for (std::uint32_t i = node.first; i < node.first + node.count; i++) {
+				float item_distance = entry.distance;
+				if ((node.count == 1 || slab_ray.Intersect(aabbs[items_[i]], best_distance, item_distance))
+					&& (item_distance < best_distance || best == kInvalidItem)) {
+					best_distance = item_distance;
+					best = items_[i];
+				}
+			}
+			continue;
+		}
+
+		// Push the nearest child last so it is visited first
+		float left_distance, right_distance;
+		const bool left_hit = slab_ray.Intersect(nodes_[node.first].bounds, best_distance, left_distance);
+		const bool right_hit = slab_ray.Intersect(nodes_[node.first + 1].bounds, best_distance, right_distance);
+		if (left_hit && right_hit && left_distance < right_distance) {
+			stack.push_back({ node.first + 1, right_distance });
+			stack.push_back({ node.first, left_distance });
+		} else {
+			if (left_hit) {
+				stack.push_back({ node.first, left_distance });
+			}
+			if (right_hit) {
+				stack.push_back({ node.first + 1, right_distance });
+			}
+		}
+	}
+	distance = best_distance;
+	return best;
+}
+
+void BvhView::CullFrustum(const Frustum& frustum, BvhCullCache& cache,
+	const LeafVisitor& visitor) const
+{
+	if (nodes_.empty()) {
+		return;
+	}
+	if (cache.last_plane.size() != nodes_.size()) {
+		cache.last_plane.assign(nodes_.size(), Frustum::kNoPlane);
+	}
+
+	struct Entry {
+		std::uint32_t node;
+		Frustum::PlaneMask mask;
+	};
+	std::vector<Entry> stack;
+	stack.reserve(64);
+	stack.push_back({ 0, Frustum::kAllPlanes });
+	std::vector<std::uint32_t> subtree;
+	while (!stack.empty()) {
+		const Entry entry = stack.back();
+		stack.pop_back();
+		const BvhNode& node = nodes_[entry.node];
+		Frustum::PlaneMask mask = entry.mask;
+		if (mask != 0 && !frustum.ClassifyAABB(node.bounds, mask, cache.last_plane[entry.node])) {
+			continue;
+		}
+
+		if (node.IsLeaf()) {
+			visitor(std::span<const std::uint32_t>(items_.data() + node.first, node.count));
+			continue;
+		}
+		if (mask == 0) {
+			// Fully inside: stream every leaf of the subtree without tests
+			subtree.push_back(node.first);
+			subtree.push_back(node.first + 1);
+			while (!subtree.empty()) {
+				const BvhNode& child = nodes_[subtree.back()];
+				subtree.pop_back();
+				if (child.IsLeaf()) {
+					visitor(std::span<const std::uint32_t>(items_.data() + child.first, child.count));
+				} else {
+					subtree.push_back(child.first);
+					subtree.push_back(child.first + 1);
+				}
+			}
+			continue;
+		}
+		stack.push_back({ node.first + 1, mask });
+		stack.push_back({ node.first, mask });
+	}
+}
+
+void BvhView::CullFrustum(const Frustum& frustum, BvhCullCache& cache,
+	std::vector<std::uint32_t>& visible) const
+{
+	CullFrustum(frustum, cache, [&visible](std::span<const std::uint32_t> items) {
+		visible.insert(visible.end(), items.begin(), items.end());
+	});
+}
+
+void Bvh::QuerySphere(std::span<const AABB3> aabbs, const Sphere& sphere,
+	std::vector<std::uint32_t>& result) const
+{
+	view().QuerySphere(aabbs, sphere, result);
+}
+
+std::uint32_t Bvh::Raycast(std::span<const AABB3> aabbs, const Ray3& ray, float& distance,
+	float max_distance) const
+{
+	return view().Raycast(aabbs, ray, distance, max_distance);
+}
+
+void Bvh::CullFrustum(const Frustum& frustum, BvhCullCache& cache,
+	const LeafVisitor& visitor) const
+{
+	view().CullFrustum(frustum, cache, visitor);
+}
+
+void Bvh::CullFrustum(const Frustum& frustum, BvhCullCache& cache,
+	std::vector<std::uint32_t>& visible) const
+{
+	view().CullFrustum(frustum, cache, visible);
+}
+
+} // namespace maths
@@ -0,0 +1,217 @@
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "maths/collision_world2.h"
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+namespace maths {
+
+namespace {
+
+// Pairs are only compared as (a, b) keys
+bool PairLess(const CollisionPair2& lhs, const CollisionPair2& rhs)
+{
+	return lhs.a < rhs.a || (lhs.a == rhs.a && lhs.b < rhs.b);
+}
+
+AABB2 CircleBounds(const Circle& circle)
+{
+	const Vector2f half{ circle.radius(), circle.radius() };
+	return { circle.center() - half, circle.center() + half };
+}
+
+} // namespace
+
+CollisionWorld2::Handle CollisionWorld2::Allocate()
+{
+	Handle handle;
+	if (free_handles_.empty()) {
+		handle = static_cast<Handle>(proxies_.size());
+		proxies_.emplace_back();
+	} else {
+		handle = free_handles_.back();
+		free_handles_.pop_back();
+	}
+	// Values are refreshed by Step, the new endpoints are sorted there
+	endpoints_.push_back({ 0.0f, handle << 1 });
+	endpoints_.push_back({ 0.0f, (handle << 1) | 1 });
+	proxy_count_++;
+	added_count_++;
+	return handle;
+}
+
+CollisionWorld2::Handle CollisionWorld2::Add(const AABB2& aabb)
+{
+	const Handle handle = Allocate();
+	proxies_[handle].bounds = aabb;
+	proxies_[handle].kind = Kind::kAABB2;
+	return handle;
+}
+
+CollisionWorld2::Handle CollisionWorld2::Add(const Circle& circle)
+{
+	const Handle handle = Allocate();
+	proxies_[handle].bounds = CircleBounds(circle);
+	proxies_[handle].circle = circle;
+	proxies_[handle].kind = Kind::kCircle;
+	return handle;
+}
+
+void CollisionWorld2::Remove(Handle handle)
+{
+	if (!valid(handle)) {
+		return;
+	}
+	proxies_[handle].kind = Kind::kRemoved;
+	removed_handles_.push_back(handle);
+	proxy_count_--;
+}
+
+void CollisionWorld2::Move(Handle handle, const AABB2& aabb)
+{
+	if (!valid(handle)) {
+		return;
+	}
+	proxies_[handle].bounds = aabb;
+	proxies_[handle].kind = Kind::kAABB2;
+}
+
+void CollisionWorld2::Move(Handle handle, const Circle& circle)
+{
+	if (!valid(handle)) {
+		return;
+	}
+	proxies_[handle].bounds = CircleBounds(circle);
+	proxies_[handle].circle = circle;
+	proxies_[handle].kind = Kind::kCircle;
+}
+
+bool CollisionWorld2::Touch(const Proxy& a, const Proxy& b) const
+{
+	// Overlap and OverlapCircle exclude containment, which still touches
+	if (a.kind == Kind::kAABB2 && b.kind == Kind::kAABB2) {
+		return Overlap(a.bounds, b.bounds) || Contain(a.bounds, b.bounds) || Contain(b.bounds, a.bounds);
+	}
+	if (a.kind == Kind::kCircle && b.kind == Kind::kCircle) {
+		return OverlapCircle(a.circle, b.circle) || ContainCircle(a.circle, b.circle)
+			|| ContainCircle(b.circle, a.circle);
+	}
+	return a.kind == Kind::kAABB2 ? AABBOverlapCircle(a.bounds, b.circle) : AABBOverlapCircle(b.bounds, a.circle);
+}
+
+void CollisionWorld2::Step()
+{
+	// Drop the endpoints of removed proxies and refresh the others
+	std::size_t kept = 0;
+	for (const Endpoint& endpoint : endpoints_) {
+		const Proxy& proxy = proxies_[endpoint.key >> 1];
+		if (proxy.kind == Kind::kRemoved) {
+			continue;
+		}
+		const float value = (endpoint.key & 1) ? proxy.bounds.top_right().x : proxy.bounds.bottom_left().x;
+		endpoints_[kept++] = { value, endpoint.key };
+	}
+	endpoints_.resize(kept);
+
+	// Mins sort before maxes at equal x so that touching bounds are tested
+	auto less = [](const Endpoint& lhs, const Endpoint& rhs) {
+		return lhs.value < rhs.value || (lhs.value == rhs.value && (lhs.key & 1) < (rhs.key & 1));
+	};
+	if (added_count_ * 8 > proxy_count_) {
+		// Many new proxies appended in any order, cheaper to sort everything
+		std::sort(endpoints_.begin(), endpoints_.end(), less);
+	} else {
+		// Nearly sorted since the last Step, insertion sort is close to linear
+		for (std::size_t i = 1; i < endpoints_.size(); i++) {
+			const Endpoint endpoint = endpoints_[i];
+			std::size_t j = i;
+			for (; j > 0 && less(endpoint, endpoints_[j - 1]); j--) {
+				endpoints_[j] = endpoints_[j - 1];
+			}
+			endpoints_[j] = endpoint;
+		}
+	}
+	added_count_ = 0;
+
+	// Sweep along x, the proxies whose x intervals are open are active
+	std::swap(pairs_, previous_pairs_);
+	pairs_.clear();
+	active_.clear();
+	for (const Endpoint& endpoint : endpoints_) {
+		const Handle handle = endpoint.key >> 1;
+		if (endpoint.key & 1) {
+			const auto it = std::find(active_.begin(), active_.end(), handle);
+			*it = active_.back();
+			active_.pop_back();
+			continue;
+		}
+		const Proxy& proxy = proxies_[handle];
+		for (const Handle other_handle : active_) {
+			const Proxy& other = proxies_[other_handle];
+			if (other.bounds.bottom_left().y <= proxy.bounds.top_right().y
+				&& proxy.bounds.bottom_left().y <= other.bounds.top_right().y && Touch(proxy, other)) {
+				pairs_.push_back({ std::min(handle, other_handle), std::max(handle, other_handle) });
+			}
+		}
+		active_.push_back(handle);
+	}
+	std::sort(pairs_.begin(), pairs_.end(), PairLess);
+
+	begin_events_.clear();
+	end_events_.clear();
+	std::set_difference(pairs_.begin(), pairs_.end(), previous_pairs_.begin(), previous_pairs_.end(),
+		std::back_inserter(begin_events_), PairLess);
+	std::set_difference(previous_pairs_.begin(), previous_pairs_.end(), pairs_.begin(), pairs_.end(),
+		std::back_inserter(end_events_), PairLess);
+
+	// The end events of removed proxies are out, their handles can be reused
+	free_handles_.insert(free_handles_.end(), removed_handles_.begin(), removed_handles_.end());
+	removed_handles_.clear();
+}
+
+void CollisionWorld2::Reserve(std::size_t proxy_count, std::size_t pair_count)
+{
+	proxies_.reserve(proxy_count);
+	free_handles_.reserve(proxy_count);
+	removed_handles_.reserve(proxy_count);
+	endpoints_.reserve(2 * proxy_count);
+	active_.reserve(proxy_count);
+	pairs_.reserve(pair_count);
+	previous_pairs_.reserve(pair_count);
+	begin_events_.reserve(pair_count);
+	end_events_.reserve(pair_count);
+}
+
+std::size_t CollisionWorld2::memory_usage() const
+{
+	return sizeof(*this) + proxies_.capacity() * sizeof(Proxy)
+		+ (free_handles_.capacity() + removed_handles_.capacity() + active_.capacity()) * sizeof(Handle)
+		+ endpoints_.capacity() * sizeof(Endpoint)
+		+ (pairs_.capacity() + previous_pairs_.capacity() + begin_events_.capacity() + end_events_.capacity())
+		* sizeof(CollisionPair2);
+}
+
+} // namespace maths
@@ -24,43 +24,55 @@ SOFTWARE.
 
 #include "maths/aabb2.h"
 #include "maths/circle.h"
+#include "maths/instrumentation.h"
 #include <algorithm>
 
 namespace maths {
 
 bool Overlap(const AABB2& a, const AABB2& b) {
+    MATHS_COUNT(kOverlapAABB2);
     const Vector2f v1 = b.bottom_left() - a.top_right();
     const Vector2f v2 = a.bottom_left() - b.top_right();
 
-    if (Contain(a, b) || Contain(b, a)) return false;
-    return !(v1.x > 0 || v2.x > 0 || v1.y > 0 || v2.y > 0);
+    if (Contain(a, b) || Contain(b, a)) {
+        MATHS_COUNT_EXIT(kOverlapAABB2, 0);
+        return false;
+    }
+    return MATHS_COUNT_HIT(kOverlapAABB2, !(v1.x > 0 || v2.x > 0 || v1.y > 0 || v2.y > 0));
 }
 
 bool Contain(const AABB2& a, const AABB2& b) {
+    MATHS_COUNT(kContainAABB2);
     const Vector2f v1 = b.bottom_left() - a.bottom_left();
     const Vector2f v2 = a.top_right() - b.top_right();
 
-    return (v1.x > 0 && v1.y > 0 && v2.x > 0 && v2.y > 0);
+    return MATHS_COUNT_HIT(kContainAABB2, (v1.x > 0 && v1.y > 0 && v2.x > 0 && v2.y > 0));
 }
 
 bool OverlapCircle(const Circle& a, const Circle& b) {
+    MATHS_COUNT(kOverlapCircle);
     const Vector2f d = b.center() - a.center();
     const float r1 = b.radius() + a.radius();
     const float r2 = d.Magnitude();
 
-    if (ContainCircle(a, b) || ContainCircle(b, a)) return false;
-    return (r1 > r2);
+    if (ContainCircle(a, b) || ContainCircle(b, a)) {
+        MATHS_COUNT_EXIT(kOverlapCircle, 0);
+        return false;
+    }
+    return MATHS_COUNT_HIT(kOverlapCircle, (r1 > r2));
 }
 
 bool ContainCircle(const Circle& a, const Circle& b) {
+    MATHS_COUNT(kContainCircle);
     const Vector2f d = b.center() - a.center();
     const float r1 = d.Magnitude() + b.radius();
     const float r2 = a.radius();
 
-    return (r1 < r2);
+    return MATHS_COUNT_HIT(kContainCircle, (r1 < r2));
 }
 
 bool AABBOverlapCircle(const AABB2& a, const Circle& b) {
+    MATHS_COUNT(kAABB2Circle);
     // Vector from a to b absolute
     Vector2f n = b.center() - a.center();
 
@@ -81,7 +93,7 @@ bool AABBOverlapCircle(const AABB2& a, const Circle& b) {
     float radius = b.radius();
     Vector2f difference = a.center() + closest;
     closest = difference - b.center();
-    return closest.SqrMagnitude() <= (radius * radius);
+    return MATHS_COUNT_HIT(kAABB2Circle, closest.SqrMagnitude() <= (radius * radius));
 }
 
 bool CircleContainAABB(const Circle& circle, const AABB2& aabb) {
@@ -23,6 +23,7 @@ SOFTWARE.
 */
 
 #include "maths/aabb3.h"
+#include "maths/instrumentation.h"
 #include "maths/sphere.h"
 #include "maths/vector3.h"
 #include <algorithm>
@@ -30,40 +31,51 @@ SOFTWARE.
 namespace maths {
 
 bool Overlap(const AABB3& a, const AABB3& b) {
+	MATHS_COUNT(kOverlapAABB3);
 	const Vector3f v1 = b.bottom_left() - a.top_right();
 	const Vector3f v2 = a.bottom_left() - b.top_right();
 
-	if (Contain(a, b) || Contain(b, a)) return false;
-	return !(v1.x > 0 || v2.x > 0 || v1.y > 0 || v2.y > 0 ||
-		v1.z > 0 || v2.z > 0);
+	if (Contain(a, b) || Contain(b, a)) {
+		MATHS_COUNT_EXIT(kOverlapAABB3, 0);
+		return false;
+	}
+	return MATHS_COUNT_HIT(kOverlapAABB3, !(v1.x > 0 || v2.x > 0 || v1.y > 0 || v2.y > 0 ||
+		v1.z > 0 || v2.z > 0));
 }
 
 bool Contain(const AABB3& a, const AABB3& b) {
+	MATHS_COUNT(kContainAABB3);
 	const Vector3f v1 = b.bottom_left() - a.bottom_left();
 	const Vector3f v2 = a.top_right() - b.top_right();
 
-	return (v1.x > 0 && v1.y > 0 && v1.z > 0 && v2.x > 0 
-		&& v2.y > 0 && v2.z > 0);
+	return MATHS_COUNT_HIT(kContainAABB3, (v1.x > 0 && v1.y > 0 && v1.z > 0 && v2.x > 0
+		&& v2.y > 0 && v2.z > 0));
 }
 
 bool OverlapSphere(const Sphere& a, const Sphere& b) {
+	MATHS_COUNT(kOverlapSphere);
 	const Vector3f d = b.center() - a.center();
 	const float v1 = b.radius() + a.radius();
 	const float v2 = d.Magnitude();
 
-	if (ContainSphere(a, b) || ContainSphere(b, a)) return false;
-	return (v1 > v2);
+	if (ContainSphere(a, b) || ContainSphere(b, a)) {
+		MATHS_COUNT_EXIT(kOverlapSphere, 0);
+		return false;
+	}
+	return MATHS_COUNT_HIT(kOverlapSphere, (v1 > v2));
 }
 
 bool ContainSphere(const Sphere& a, const Sphere& b) {
+	MATHS_COUNT(kContainSphere);
 	const Vector3f d = b.center() - a.center();
 	const float v1 = d.Magnitude() + b.radius();
 	const float v2 = a.radius();
 
-	return (v1 < v2);
+	return MATHS_COUNT_HIT(kContainSphere, (v1 < v2));
 }
 
 bool AABBOverlapSphere(const AABB3& a, const Sphere& b) {
+    MATHS_COUNT(kAABB3Sphere);
     // Vector from a to b absolute
     Vector3f n = b.center() - a.center();
 
@@ -85,7 +97,7 @@ bool AABBOverlapSphere(const AABB3& a, const Sphere& b) {
     Vector3f difference = a.center() + closest;
     closest = difference - b.center();
 
-    return closest.SqrMagnitude() <= radius *radius ;
+    return MATHS_COUNT_HIT(kAABB3Sphere, closest.SqrMagnitude() <= radius * radius);
 }
 
 bool SphereContainAABB(const Sphere& sphere, const AABB3& aabb) {
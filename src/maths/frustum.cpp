@@ -24,8 +24,51 @@ SOFTWARE.
 
 #include "maths/frustum.h"
 
+#include <algorithm>
+#include <cmath>
+
+#include "maths/instrumentation.h"
+#include "maths/simd.h"
+
 namespace maths {
+
+Frustum::Frustum(const Matrix4f& view_projection, ClipDepth depth)
+{
+	const Matrix4f& m = view_projection;
+	// Row i of the column-based matrix
+	auto row = [&m](int i) { return Vector4f(m[0][i], m[1][i], m[2][i], m[3][i]); };
+	const Vector4f row0 = row(0);
+	const Vector4f row1 = row(1);
+	const Vector4f row2 = row(2);
+	const Vector4f row3 = row(3);
+
+	std::array<Vector4f, 6> coefficients;
+	coefficients[LEFT] = row3 + row0;
+	coefficients[RIGHT] = row3 - row0;
+	coefficients[BOTTOM] = row3 + row1;
+	coefficients[TOP] = row3 - row1;
+	coefficients[NEAR] = depth == ClipDepth::kZeroToOne ? row2 : row3 + row2;
+	coefficients[FAR] = row3 - row2;
+
+	for (int i = 0; i < 6; i++) {
+		const Vector4f& c = coefficients[i];
+		const Vector3f normal{ c.x, c.y, c.z };
+		const float length = normal.Magnitude();
+		if (length <= 0.0f) {
+			// Degenerate plane (infinite far plane): everything is inside
+			planes_[i] = OpenPlane();
+			continue;
+		}
+		planes_[i] = Plane{ normal / length, c.w / length };
+	}
+	UpdatePlanesSoA();
+}
 	
+Frustum::Frustum(const std::array<Plane, 6>& planes) : planes_(planes)
+{
+	UpdatePlanesSoA();
+}
+
 void Frustum::calculate_frustum(Vector3f direction, Vector3f position, 
 	Vector3f right, Vector3f up, float near_plane_distance, 
 	float far_plane_distance, degree_t fov_x, radian_t fov_y)
@@ -55,26 +98,44 @@ void Frustum::calculate_frustum(Vector3f direction, Vector3f position,
 	planes_[LEFT] = Plane(ftl, fbl, nbl);
 	planes_[TOP] = Plane(ntr, ftr, ftl);
 	planes_[BOTTOM] = Plane(nbr, nbl, fbl);
+	UpdatePlanesSoA();
+}
+Frustum Frustum::Transformed(const Matrix4f& rigid) const
+{
+	// n' = R * n and d' = d - Dot(n', t) for points p' = R * p + t
+	const Vector3f translation{ rigid[3].x, rigid[3].y, rigid[3].z };
+	std::array<Plane, 6> planes;
+	for (int i = 0; i < 6; i++) {
+		const Vector3f n = planes_[i].normal();
+		const Vector3f normal{
+			rigid[0].x * n.x + rigid[1].x * n.y + rigid[2].x * n.z,
+			rigid[0].y * n.x + rigid[1].y * n.y + rigid[2].y * n.z,
+			rigid[0].z * n.x + rigid[1].z * n.y + rigid[2].z * n.z };
+		planes[i] = Plane{ normal, planes_[i].d() - Vector3f::Dot(normal, translation) };
+	}
+	return Frustum(planes);
 }
-bool Frustum::contains(const Sphere& sphere)
+
+bool Frustum::contains(const Sphere& sphere) const
 {
-	float distance;
+	MATHS_COUNT(kFrustumSphere);
+	// A sphere straddling a plane can still be outside another one, so
+	// every plane is tested like ContainsBatch
 	for (int i = 0; i < 6; i++) {
-		distance = planes_[i].Distance(sphere.center());
-		if (distance < -sphere.radius())
+		MATHS_COUNT(kFrustumPlane);
+		if (planes_[i].Distance(sphere.center()) < -sphere.radius())
 		{
+			MATHS_COUNT_EXIT(kFrustumSphere, i);
 			return false;
 		}
-		else if (distance < sphere.radius())
-		{
-			return true;
-		}
 	}
-	return true;
+	MATHS_COUNT_EXIT(kFrustumSphere, 6);
+	return MATHS_COUNT_HIT(kFrustumSphere, true);
 }
 
-bool Frustum::contains(const AABB3& aabb)
+bool Frustum::contains(const AABB3& aabb) const
 {
+	MATHS_COUNT(kFrustumAABB);
 	std::array<Vector3f, 8> aabbBounds;
 
 	aabbBounds[0] = aabb.bottom_left();
@@ -88,6 +149,7 @@ bool Frustum::contains(const AABB3& aabb)
 
 	for (int i = 0; i < 6; i++)
 	{
+		MATHS_COUNT(kFrustumPlane);
 		float min = planes_[i].Distance(aabbBounds[0]);
 		float max = min;
 		for (int j = 1; j < 8; j++)
@@ -97,22 +159,142 @@ bool Frustum::contains(const AABB3& aabb)
 			if (planes_[i].Distance(aabbBounds[j]) < min)
 				min = planes_[i].Distance(aabbBounds[j]);
 		}
-		if (max < 0.0f)
+		if (max < 0.0f) {
+			MATHS_COUNT_EXIT(kFrustumAABB, i);
 			return false;
+		}
 	}
-	return true;
+	MATHS_COUNT_EXIT(kFrustumAABB, 6);
+	return MATHS_COUNT_HIT(kFrustumAABB, true);
 }
 
-bool Frustum::contains( const Vector3f& point)
+bool Frustum::contains( const Vector3f& point) const
 {
+	MATHS_COUNT(kFrustumPoint);
 	for (int i = 0; i < 6; i++)
 	{
+		MATHS_COUNT(kFrustumPlane);
 		if (planes_[i].Distance(point) < 0.0f)
 		{
+			MATHS_COUNT_EXIT(kFrustumPoint, i);
+			return false;
+		}
+	}
+	MATHS_COUNT_EXIT(kFrustumPoint, 6);
+	return MATHS_COUNT_HIT(kFrustumPoint, true);
+}
+
+bool Frustum::contains(const Sphered& sphere, const Vector3d& origin_shift) const
+{
+	return contains(sphere.RelativeTo(origin_shift));
+}
+
+bool Frustum::contains(const AABB3d& aabb, const Vector3d& origin_shift) const
+{
+	return contains(aabb.RelativeTo(origin_shift));
+}
+
+bool Frustum::contains(const Vector3d& point, const Vector3d& origin_shift) const
+{
+	return contains(point.RelativeTo(origin_shift));
+}
+
+bool Frustum::ClassifyAABB(const AABB3& aabb, PlaneMask& mask, std::uint8_t& last_plane) const
+{
+	const Vector3f center = aabb.center();
+	const Vector3f extent = aabb.extent();
+	// Signed distance of the center and projected radius of the box on the normal
+	auto classify = [&](int i) {
+		const Vector3f normal = planes_[i].normal();
+		const float distance = planes_[i].Distance(center);
+		const float radius = extent.x * std::abs(normal.x) + extent.y * std::abs(normal.y)
+			+ extent.z * std::abs(normal.z);
+		if (distance + radius < 0.0f) {
+			return false;
+		}
+		if (distance - radius >= 0.0f) {
+			mask &= ~(1 << i);
+		}
+		return true;
+	};
+
+	if (last_plane < planes_.size() && (mask & (1 << last_plane)) != 0) {
+		if (!classify(last_plane)) {
+			return false;
+		}
+	}
+	for (int i = 0; i < 6; i++) {
+		if (i == last_plane || (mask & (1 << i)) == 0) {
+			continue;
+		}
+		if (!classify(i)) {
+			last_plane = static_cast<std::uint8_t>(i);
 			return false;
 		}
 	}
 	return true;
 }
 
+void Frustum::ContainsBatch(std::span<const Sphere> spheres, std::span<std::uint8_t> result) const
+{
+	const std::size_t count = std::min(spheres.size(), result.size());
+	const FrustumPlanesSoA& p = planes_soa_;
+	const Float4 nx0 = Float4::LoadAligned(&p.normal_x[0]), nx1 = Float4::LoadAligned(&p.normal_x[4]);
+	const Float4 ny0 = Float4::LoadAligned(&p.normal_y[0]), ny1 = Float4::LoadAligned(&p.normal_y[4]);
+	const Float4 nz0 = Float4::LoadAligned(&p.normal_z[0]), nz1 = Float4::LoadAligned(&p.normal_z[4]);
+	const Float4 d0 = Float4::LoadAligned(&p.d[0]), d1 = Float4::LoadAligned(&p.d[4]);
+	for (std::size_t i = 0; i < count; i++) {
+		const Vector3f center = spheres[i].center();
+		const Float4 x(center.x), y(center.y), z(center.z);
+		const Float4 radius(-spheres[i].radius());
+		const Float4 dist0 = Float4::MulAdd(nx0, x, Float4::MulAdd(ny0, y, Float4::MulAdd(nz0, z, d0)));
+		const Float4 dist1 = Float4::MulAdd(nx1, x, Float4::MulAdd(ny1, y, Float4::MulAdd(nz1, z, d1)));
+		result[i] = ((dist0 < radius) | (dist1 < radius)).MoveMask() == 0;
+	}
+}
+
+void Frustum::ContainsBatch(std::span<const AABB3> aabbs, std::span<std::uint8_t> result) const
+{
+	const std::size_t count = std::min(aabbs.size(), result.size());
+	const FrustumPlanesSoA& p = planes_soa_;
+	const Float4 nx0 = Float4::LoadAligned(&p.normal_x[0]), nx1 = Float4::LoadAligned(&p.normal_x[4]);
+	const Float4 ny0 = Float4::LoadAligned(&p.normal_y[0]), ny1 = Float4::LoadAligned(&p.normal_y[4]);
+	const Float4 nz0 = Float4::LoadAligned(&p.normal_z[0]), nz1 = Float4::LoadAligned(&p.normal_z[4]);
+	const Float4 d0 = Float4::LoadAligned(&p.d[0]), d1 = Float4::LoadAligned(&p.d[4]);
+	const Float4 ax0 = Float4::Abs(nx0), ax1 = Float4::Abs(nx1);
+	const Float4 ay0 = Float4::Abs(ny0), ay1 = Float4::Abs(ny1);
+	const Float4 az0 = Float4::Abs(nz0), az1 = Float4::Abs(nz1);
+	const Float4 zero = Float4::Zero();
+	for (std::size_t i = 0; i < count; i++) {
+		const Vector3f center = aabbs[i].center();
+		const Vector3f extent = aabbs[i].extent();
+		const Float4 x(center.x), y(center.y), z(center.z);
+		const Float4 ex(extent.x), ey(extent.y), ez(extent.z);
+		// Distance of the center plus projected radius of the box
+		const Float4 max0 = Float4::MulAdd(nx0, x, Float4::MulAdd(ny0, y, Float4::MulAdd(nz0, z, d0)))
+			+ Float4::MulAdd(ax0, ex, Float4::MulAdd(ay0, ey, az0 * ez));
+		const Float4 max1 = Float4::MulAdd(nx1, x, Float4::MulAdd(ny1, y, Float4::MulAdd(nz1, z, d1)))
+			+ Float4::MulAdd(ax1, ex, Float4::MulAdd(ay1, ey, az1 * ez));
+		result[i] = ((max0 < zero) | (max1 < zero)).MoveMask() == 0;
+	}
+}
+
+void Frustum::UpdatePlanesSoA()
+{
+	for (std::size_t i = 0; i < FrustumPlanesSoA::kCount; i++) {
+		if (i < planes_.size()) {
+			const Vector3f normal = planes_[i].normal();
+			planes_soa_.normal_x[i] = normal.x;
+			planes_soa_.normal_y[i] = normal.y;
+			planes_soa_.normal_z[i] = normal.z;
+			planes_soa_.d[i] = planes_[i].d();
+		} else {
+			planes_soa_.normal_x[i] = 0.0f;
+			planes_soa_.normal_y[i] = 0.0f;
+			planes_soa_.normal_z[i] = 0.0f;
+			planes_soa_.d[i] = 1.0f;
+		}
+	}
+}
+
 } // namespace maths
\ No newline at end of file
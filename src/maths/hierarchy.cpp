@@ -0,0 +1,179 @@
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "maths/hierarchy.h"
+
+#include <algorithm>
+
+#include "maths/simd.h"
+#include "maths/transform3.h"
+
+namespace maths {
+
+namespace {
+
+static_assert(sizeof(Matrix4f) == 16 * sizeof(float), "Matrix4f columns are loaded as packed floats");
+
+float* Data(Matrix4f& matrix)
+{
+	return reinterpret_cast<float*>(&matrix);
+}
+
+const float* Data(const Matrix4f& matrix)
+{
+	return reinterpret_cast<const float*>(&matrix);
+}
+
+// Updates the world matrix of one node from its local matrix
+struct MatrixNode {
+	void operator()(std::uint32_t i) const
+	{
+		const std::uint32_t parent = parents[i];
+		if (parent == kNoParent) {
+			world[i] = local[i];
+		} else {
+			MultiplyMatrix4(Data(world[parent]), Data(local[i]), Data(world[i]));
+		}
+	}
+
+	std::span<const std::uint32_t> parents;
+	std::span<const Matrix4f> local;
+	std::span<Matrix4f> world;
+};
+
+// Same, composing the local matrix on the stack
+struct TrsNode {
+	void operator()(std::uint32_t i) const
+	{
+		const std::uint32_t parent = parents[i];
+		if (parent == kNoParent) {
+			ComposeTrs(rotations[i], translations[i], scales[i], Data(world[i]));
+		} else {
+			alignas(16) float local[16];
+			ComposeTrs(rotations[i], translations[i], scales[i], local);
+			MultiplyMatrix4(Data(world[parent]), local, Data(world[i]));
+		}
+	}
+
+	std::span<const std::uint32_t> parents;
+	std::span<const Quaternion> rotations;
+	std::span<const Vector3f> translations;
+	std::span<const Vector3f> scales;
+	std::span<Matrix4f> world;
+};
+
+// Nodes below count, parents come before their children so they form a
+// complete hierarchy
+template<typename Node>
+void UpdateLevels(const HierarchyLevels& levels, const Node& node, std::size_t count, JobSystem& jobs)
+{
+	count = std::min(count, levels.node_count());
+	if (jobs.thread_count() == 1) {
+		for (std::uint32_t i = 0; i < count; i++) {
+			node(i);
+		}
+		return;
+	}
+	for (std::size_t l = 0; l < levels.level_count(); l++) {
+		// Levels are in increasing index order, cut at the first node past count
+		std::span<const std::uint32_t> level = levels.level(l);
+		level = level.first(static_cast<std::size_t>(
+			std::lower_bound(level.begin(), level.end(), count) - level.begin()));
+		const std::size_t grain = jobs.GrainSize(level.size(), 256);
+		if (level.size() <= grain) {
+			for (std::uint32_t i : level) {
+				node(i);
+			}
+			continue;
+		}
+		jobs.ParallelFor(0, level.size(), [&](std::size_t begin, std::size_t end) {
+			for (std::size_t k = begin; k < end; k++) {
+				node(level[k]);
+			}
+		}, grain);
+	}
+}
+
+} // namespace
+
+void HierarchyLevels::Build(std::span<const std::uint32_t> parents)
+{
+	// Depths in one pass since parents come first, then a counting sort
+	std::vector<std::uint32_t> depths(parents.size());
+	std::vector<std::uint32_t> counts;
+	for (std::size_t i = 0; i < parents.size(); i++) {
+		depths[i] = parents[i] == kNoParent ? 0 : depths[parents[i]] + 1;
+		if (depths[i] >= counts.size()) {
+			counts.resize(depths[i] + 1, 0);
+		}
+		counts[depths[i]]++;
+	}
+	level_begin_.assign(counts.size() + 1, 0);
+	for (std::size_t l = 0; l < counts.size(); l++) {
+		level_begin_[l + 1] = level_begin_[l] + counts[l];
+	}
+	nodes_.resize(parents.size());
+	std::vector<std::uint32_t> cursor(level_begin_.begin(), level_begin_.end() - 1);
+	for (std::size_t i = 0; i < parents.size(); i++) {
+		nodes_[cursor[depths[i]]++] = static_cast<std::uint32_t>(i);
+	}
+}
+
+void UpdateHierarchy(std::span<const std::uint32_t> parents, std::span<const Matrix4f> local,
+	std::span<Matrix4f> world)
+{
+	const MatrixNode node{ parents, local, world };
+	const std::size_t count = std::min({ parents.size(), local.size(), world.size() });
+	for (std::uint32_t i = 0; i < count; i++) {
+		node(i);
+	}
+}
+
+void UpdateHierarchy(std::span<const std::uint32_t> parents, std::span<const Quaternion> rotations,
+	std::span<const Vector3f> translations, std::span<const Vector3f> scales, std::span<Matrix4f> world)
+{
+	const TrsNode node{ parents, rotations, translations, scales, world };
+	const std::size_t count = std::min({ parents.size(), rotations.size(), translations.size(), scales.size(),
+		world.size() });
+	for (std::uint32_t i = 0; i < count; i++) {
+		node(i);
+	}
+}
+
+void UpdateHierarchy(const HierarchyLevels& levels, std::span<const std::uint32_t> parents,
+	std::span<const Matrix4f> local, std::span<Matrix4f> world, JobSystem& jobs)
+{
+	UpdateLevels(levels, MatrixNode{ parents, local, world },
+		std::min({ parents.size(), local.size(), world.size() }), jobs);
+}
+
+void UpdateHierarchy(const HierarchyLevels& levels, std::span<const std::uint32_t> parents,
+	std::span<const Quaternion> rotations, std::span<const Vector3f> translations,
+	std::span<const Vector3f> scales, std::span<Matrix4f> world, JobSystem& jobs)
+{
+	UpdateLevels(levels, TrsNode{ parents, rotations, translations, scales, world },
+		std::min({ parents.size(), rotations.size(), translations.size(), scales.size(), world.size() }), jobs);
+}
+
+} // namespace maths
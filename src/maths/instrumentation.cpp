@@ -0,0 +1,305 @@
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "maths/instrumentation.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+
+namespace maths {
+
+namespace {
+
+// Timers per thread, the last slot takes the ones past it
+constexpr std::size_t kMaxTimers = 32;
+
+// Only the owning thread writes, relaxed atomics let the snapshot read
+// while it counts
+using Count = std::atomic<std::uint64_t>;
+
+void Add(Count& count, std::uint64_t amount)
+{
+	count.store(count.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+struct ThreadCounter {
+	Count calls{ 0 };
+	Count hits{ 0 };
+	std::array<Count, kInstrumentExitBuckets> exits{};
+};
+
+struct ThreadTimer {
+	std::atomic<const char*> name{ nullptr };
+	Count calls{ 0 };
+	Count nanoseconds{ 0 };
+};
+
+struct ThreadCounters {
+	std::array<ThreadCounter, kInstrumentCounterCount> counters;
+	std::array<ThreadTimer, kMaxTimers> timers;
+};
+
+// Counters of the running threads, and the sum of the exited ones
+struct Registry {
+	std::mutex mutex;
+	std::vector<ThreadCounters*> threads;
+	ThreadCounters retired;
+};
+
+Registry& GetRegistry()
+{
+	static Registry registry;
+	return registry;
+}
+
+void Accumulate(const ThreadCounters& from, ThreadCounters& to)
+{
+	for (std::size_t i = 0; i < kInstrumentCounterCount; i++) {
+		Add(to.counters[i].calls, from.counters[i].calls.load(std::memory_order_relaxed));
+		Add(to.counters[i].hits, from.counters[i].hits.load(std::memory_order_relaxed));
+		for (std::size_t j = 0; j < kInstrumentExitBuckets; j++) {
+			Add(to.counters[i].exits[j], from.counters[i].exits[j].load(std::memory_order_relaxed));
+		}
+	}
+	for (const ThreadTimer& timer : from.timers) {
+		const char* name = timer.name.load(std::memory_order_acquire);
+		if (name == nullptr) {
+			break;
+		}
+		// Retired timers are looked up by content, literals may not be merged
+		for (ThreadTimer& target : to.timers) {
+			const char* target_name = target.name.load(std::memory_order_relaxed);
+			if (target_name == nullptr) {
+				target.name.store(name, std::memory_order_release);
+			} else if (std::strcmp(target_name, name) != 0 && &target != &to.timers.back()) {
+				continue;
+			}
+			Add(target.calls, timer.calls.load(std::memory_order_relaxed));
+			Add(target.nanoseconds, timer.nanoseconds.load(std::memory_order_relaxed));
+			break;
+		}
+	}
+}
+
+struct ThreadRegistration {
+	ThreadRegistration() {
+		Registry& registry = GetRegistry();
+		std::lock_guard lock(registry.mutex);
+		registry.threads.push_back(&counters);
+	}
+	~ThreadRegistration() {
+		Registry& registry = GetRegistry();
+		std::lock_guard lock(registry.mutex);
+		Accumulate(counters, registry.retired);
+		registry.threads.erase(std::find(registry.threads.begin(), registry.threads.end(), &counters));
+	}
+
+	ThreadCounters counters;
+};
+
+ThreadCounters& LocalCounters()
+{
+	thread_local ThreadRegistration registration;
+	return registration.counters;
+}
+
+ThreadCounter& LocalCounter(InstrumentCounter counter)
+{
+	return LocalCounters().counters[static_cast<std::size_t>(counter)];
+}
+
+} // namespace
+
+const char* ToString(InstrumentCounter counter)
+{
+	switch (counter) {
+	case InstrumentCounter::kFrustumSphere:
+		return "Frustum::contains(Sphere)";
+	case InstrumentCounter::kFrustumAABB:
+		return "Frustum::contains(AABB3)";
+	case InstrumentCounter::kFrustumPoint:
+		return "Frustum::contains(Vector3f)";
+	case InstrumentCounter::kFrustumPlane:
+		return "Frustum plane tests";
+	case InstrumentCounter::kRaySphere:
+		return "Ray3::IntersectSphere";
+	case InstrumentCounter::kRayAABB:
+		return "Ray3::IntersectAABB3";
+	case InstrumentCounter::kRayPlane:
+		return "Ray3::IntersectPlane";
+	case InstrumentCounter::kRaySlab:
+		return "SlabRay::Intersect";
+	case InstrumentCounter::kRayTriangle:
+		return "WatertightRay::Intersect";
+	case InstrumentCounter::kOverlapAABB2:
+		return "Overlap(AABB2)";
+	case InstrumentCounter::kContainAABB2:
+		return "Contain(AABB2)";
+	case InstrumentCounter::kOverlapCircle:
+		return "OverlapCircle";
+	case InstrumentCounter::kContainCircle:
+		return "ContainCircle";
+	case InstrumentCounter::kAABB2Circle:
+		return "AABBOverlapCircle";
+	case InstrumentCounter::kOverlapAABB3:
+		return "Overlap(AABB3)";
+	case InstrumentCounter::kContainAABB3:
+		return "Contain(AABB3)";
+	case InstrumentCounter::kOverlapSphere:
+		return "OverlapSphere";
+	case InstrumentCounter::kContainSphere:
+		return "ContainSphere";
+	case InstrumentCounter::kAABB3Sphere:
+		return "AABBOverlapSphere";
+	case InstrumentCounter::kMatrix4fInverse:
+		return "Matrix4f::Inverse";
+	case InstrumentCounter::kCount:
+		break;
+	}
+	return "unknown";
+}
+
+void InstrumentCount(InstrumentCounter counter)
+{
+	Add(LocalCounter(counter).calls, 1);
+}
+
+bool InstrumentHit(InstrumentCounter counter, bool result)
+{
+	if (result) {
+		Add(LocalCounter(counter).hits, 1);
+	}
+	return result;
+}
+
+void InstrumentExit(InstrumentCounter counter, std::uint32_t step)
+{
+	Add(LocalCounter(counter).exits[std::min<std::size_t>(step, kInstrumentExitBuckets - 1)], 1);
+}
+
+void InstrumentTime(const char* name, std::uint64_t nanoseconds)
+{
+	std::array<ThreadTimer, kMaxTimers>& timers = LocalCounters().timers;
+	for (ThreadTimer& timer : timers) {
+		const char* timer_name = timer.name.load(std::memory_order_relaxed);
+		if (timer_name == nullptr) {
+			timer.name.store(name, std::memory_order_release);
+		} else if (timer_name != name && &timer != &timers.back()) {
+			continue;
+		}
+		Add(timer.calls, 1);
+		Add(timer.nanoseconds, nanoseconds);
+		return;
+	}
+}
+
+InstrumentationSnapshot TakeInstrumentationSnapshot()
+{
+	ThreadCounters sum;
+	{
+		Registry& registry = GetRegistry();
+		std::lock_guard lock(registry.mutex);
+		Accumulate(registry.retired, sum);
+		for (const ThreadCounters* counters : registry.threads) {
+			Accumulate(*counters, sum);
+		}
+	}
+
+	InstrumentationSnapshot snapshot;
+	for (std::size_t i = 0; i < kInstrumentCounterCount; i++) {
+		snapshot.counters[i].calls = sum.counters[i].calls.load(std::memory_order_relaxed);
+		snapshot.counters[i].hits = sum.counters[i].hits.load(std::memory_order_relaxed);
+		for (std::size_t j = 0; j < kInstrumentExitBuckets; j++) {
+			snapshot.counters[i].exits[j] = sum.counters[i].exits[j].load(std::memory_order_relaxed);
+		}
+	}
+	for (const ThreadTimer& timer : sum.timers) {
+		const char* name = timer.name.load(std::memory_order_relaxed);
+		if (name != nullptr && timer.calls.load(std::memory_order_relaxed) != 0) {
+			snapshot.timers.push_back({ name, timer.calls.load(std::memory_order_relaxed),
+				timer.nanoseconds.load(std::memory_order_relaxed) });
+		}
+	}
+	return snapshot;
+}
+
+void ResetInstrumentation()
+{
+	auto reset = [](ThreadCounters& counters) {
+		for (ThreadCounter& counter : counters.counters) {
+			counter.calls.store(0, std::memory_order_relaxed);
+			counter.hits.store(0, std::memory_order_relaxed);
+			for (Count& exit : counter.exits) {
+				exit.store(0, std::memory_order_relaxed);
+			}
+		}
+		for (ThreadTimer& timer : counters.timers) {
+			timer.calls.store(0, std::memory_order_relaxed);
+			timer.nanoseconds.store(0, std::memory_order_relaxed);
+		}
+	};
+	Registry& registry = GetRegistry();
+	std::lock_guard lock(registry.mutex);
+	reset(registry.retired);
+	for (ThreadCounters* counters : registry.threads) {
+		reset(*counters);
+	}
+}
+
+std::string InstrumentationReport()
+{
+	const InstrumentationSnapshot snapshot = TakeInstrumentationSnapshot();
+	std::string report;
+	char line[256];
+	for (std::size_t i = 0; i < kInstrumentCounterCount; i++) {
+		const CounterStats& stats = snapshot.counters[i];
+		if (stats.calls == 0) {
+			continue;
+		}
+		std::snprintf(line, sizeof(line), "%-28s %12" PRIu64 " calls %12" PRIu64 " hits %6.2f%%",
+			ToString(static_cast<InstrumentCounter>(i)), stats.calls, stats.hits,
+			100.0 * static_cast<double>(stats.hits) / static_cast<double>(stats.calls));
+		report += line;
+		for (std::size_t step = 0; step < kInstrumentExitBuckets; step++) {
+			if (stats.exits[step] != 0) {
+				std::snprintf(line, sizeof(line), " exit%zu:%" PRIu64, step, stats.exits[step]);
+				report += line;
+			}
+		}
+		report += '\n';
+	}
+	for (const TimerStats& timer : snapshot.timers) {
+		std::snprintf(line, sizeof(line), "%-28s %12" PRIu64 " calls %12.3f ms %10.1f ns/call\n",
+			timer.name.c_str(), timer.calls, static_cast<double>(timer.nanoseconds) * 1e-6,
+			static_cast<double>(timer.nanoseconds) / static_cast<double>(timer.calls));
+		report += line;
+	}
+	return report;
+}
+
+} // namespace maths
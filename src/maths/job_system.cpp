@@ -0,0 +1,158 @@
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "maths/job_system.h"
+
+#include <algorithm>
+
+namespace maths {
+
+JobSystem::JobSystem(std::size_t thread_count)
+{
+	if (thread_count == 0) {
+		thread_count = std::max(1u, std::thread::hardware_concurrency());
+	}
+	for (std::size_t i = 0; i < thread_count; i++) {
+		queues_.push_back(std::make_unique<Queue>());
+	}
+	for (std::size_t i = 1; i < thread_count; i++) {
+		workers_.emplace_back([this, i] { WorkerLoop(i); });
+	}
+}
+
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock(sleep_mutex_);
+		stop_ = true;
+	}
+	wake_.notify_all();
+	for (std::thread& worker : workers_) {
+		worker.join();
+	}
+}
+
+std::size_t JobSystem::GrainSize(std::size_t count, std::size_t min_grain) const
+{
+	const std::size_t chunks = thread_count() * kChunksPerThread;
+	return std::max(std::max<std::size_t>(min_grain, 1), (count + chunks - 1) / chunks);
+}
+
+void JobSystem::ParallelFor(std::size_t begin, std::size_t end,
+	const RangeFunction& func, std::size_t grain_size)
+{
+	if (begin >= end) {
+		return;
+	}
+	const std::size_t count = end - begin;
+	const std::size_t grain = grain_size == 0 ? GrainSize(count) : grain_size;
+	if (workers_.empty() || count <= grain) {
+		func(begin, end);
+		return;
+	}
+
+	const std::size_t chunk_count = (count + grain - 1) / grain;
+	std::atomic<std::size_t> remaining = chunk_count;
+	// Deal the chunks round-robin so every worker starts with local work
+	for (std::size_t chunk = 0; chunk < chunk_count; chunk++) {
+		const std::size_t chunk_begin = begin + chunk * grain;
+		const Task task{ &func, chunk_begin, std::min(end, chunk_begin + grain), &remaining };
+		Queue& queue = *queues_[chunk % queues_.size()];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queue.tasks.push_back(task);
+	}
+	{
+		std::lock_guard<std::mutex> lock(sleep_mutex_);
+		queued_ += chunk_count;
+	}
+	wake_.notify_all();
+
+	// The calling thread helps until its own chunks are done, which also
+	// keeps nested ParallelFor calls from a worker deadlock free.
+	Task task;
+	while (remaining.load(std::memory_order_acquire) != 0) {
+		if (TryPop(0, task)) {
+			Run(task);
+		} else {
+			std::this_thread::yield();
+		}
+	}
+}
+
+JobSystem& JobSystem::Default()
+{
+	static JobSystem job_system;
+	return job_system;
+}
+
+void JobSystem::WorkerLoop(std::size_t index)
+{
+	Task task;
+	while (true) {
+		if (TryPop(index, task)) {
+			Run(task);
+			continue;
+		}
+		std::unique_lock<std::mutex> lock(sleep_mutex_);
+		wake_.wait(lock, [this] { return stop_ || queued_.load() != 0; });
+		if (stop_ && queued_.load() == 0) {
+			return;
+		}
+	}
+}
+
+bool JobSystem::TryPop(std::size_t index, Task& task)
+{
+	// Own queue first, newest chunk is the warmest in cache
+	{
+		Queue& own = *queues_[index];
+		std::lock_guard<std::mutex> lock(own.mutex);
+		if (!own.tasks.empty()) {
+			task = own.tasks.back();
+			own.tasks.pop_back();
+			queued_--;
+			return true;
+		}
+	}
+	// Steal the oldest chunk of the others
+	for (std::size_t i = 1; i < queues_.size(); i++) {
+		Queue& victim = *queues_[(index + i) % queues_.size()];
+		std::lock_guard<std::mutex> lock(victim.mutex);
+		if (!victim.tasks.empty()) {
+			task = victim.tasks.front();
+			victim.tasks.pop_front();
+			queued_--;
+			return true;
+		}
+	}
+	return false;
+}
+
+void JobSystem::Run(const Task& task)
+{
+	(*task.func)(task.begin, task.end);
+	task.remaining->fetch_sub(1, std::memory_order_release);
+}
+
+} // namespace maths
@@ -0,0 +1,80 @@
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "maths/large_world.h"
+
+#include <algorithm>
+
+namespace maths {
+
+void RebaseToOrigin(std::span<const Vector3d> world, const Vector3d& origin,
+	std::span<Vector3f> local)
+{
+	const std::size_t count = std::min(world.size(), local.size());
+	for (std::size_t i = 0; i < count; i++) {
+		local[i] = world[i].RelativeTo(origin);
+	}
+}
+
+void RebaseToOrigin(std::span<const AABB3d> world, const Vector3d& origin,
+	std::span<AABB3> local)
+{
+	const std::size_t count = std::min(world.size(), local.size());
+	for (std::size_t i = 0; i < count; i++) {
+		local[i] = world[i].RelativeTo(origin);
+	}
+}
+
+void RebaseToOrigin(std::span<const Sphered> world, const Vector3d& origin,
+	std::span<Sphere> local)
+{
+	const std::size_t count = std::min(world.size(), local.size());
+	for (std::size_t i = 0; i < count; i++) {
+		local[i] = world[i].RelativeTo(origin);
+	}
+}
+
+void RebaseToOrigin(const Vector3dSoA& world, const Vector3d& origin,
+	const Vector3fSoA& local)
+{
+	const std::size_t count = std::min({ world.x.size(), world.y.size(),
+		world.z.size(), local.x.size(), local.y.size(), local.z.size() });
+	const double* wx = world.x.data();
+	const double* wy = world.y.data();
+	const double* wz = world.z.data();
+	float* lx = local.x.data();
+	float* ly = local.y.data();
+	float* lz = local.z.data();
+	for (std::size_t i = 0; i < count; i++) {
+		lx[i] = static_cast<float>(wx[i] - origin.x);
+	}
+	for (std::size_t i = 0; i < count; i++) {
+		ly[i] = static_cast<float>(wy[i] - origin.y);
+	}
+	for (std::size_t i = 0; i < count; i++) {
+		lz[i] = static_cast<float>(wz[i] - origin.z);
+	}
+}
+
+} // namespace maths
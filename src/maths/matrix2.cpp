@@ -21,9 +21,20 @@ SOFTWARE.
 */
 
 #include "maths/matrix2.h"
+
+#include <algorithm>
+#include <limits>
+
 #include "maths/maths_utils.h"
+#include "maths/simd.h"
 
 namespace maths {
+
+namespace {
+
+static_assert(sizeof(Matrix2f) == 4 * sizeof(float), "Matrix2f spans are read as packed floats");
+
+}//namespace
 	
 Matrix2f::Matrix2f(const Vector2f& v1, const Vector2f& v2) {
 	
@@ -120,6 +131,22 @@ Matrix2f Matrix2f::Inverse() const {
 	
 	return inverse;
 }
+bool Matrix2f::TryInverse(Matrix2f& inverse) const {
+
+	const float kDet = determinant();
+
+	if (IsSingular(kDet, matrix_[0].Magnitude() * matrix_[1].Magnitude())) {
+
+		return false;
+	}
+
+	//Swap the diagonal and negate the other elements
+	const float kInverseDet = 1.0f / kDet;
+	inverse = Matrix2f(Vector2f(matrix_[1][1] * kInverseDet, -matrix_[0][1] * kInverseDet),
+					   Vector2f(-matrix_[1][0] * kInverseDet, matrix_[0][0] * kInverseDet));
+
+	return true;
+}
 Matrix2f Matrix2f::Transpose() const {
 	
 	return Matrix2f(Vector2f(matrix_[0][0], matrix_[1][0]), Vector2f(matrix_[0][1], matrix_[1][1]));
@@ -132,5 +159,72 @@ Matrix2f Matrix2f::identity() {
 	
 	return Matrix2f(Vector2f(1, 0), Vector2f(0, 1));
 }
+bool InverseBatch(std::span<const Matrix2f> matrices, std::span<Matrix2f> inverses,
+	std::span<std::uint8_t> invertible) {
+
+	std::size_t count = std::min(matrices.size(), inverses.size());
+	if (!invertible.empty()) {
+
+		count = std::min(count, invertible.size());
+	}
+	const float* in = reinterpret_cast<const float*>(matrices.data());
+	float* out = reinterpret_cast<float*>(inverses.data());
+	bool all_invertible = true;
+	std::size_t i = 0;
+
+	//Four matrices in structure of arrays, m[k] holds element k of each
+	for (; i + 4 <= count; i += 4) {
+
+		Float4 m[4];
+		for (int k = 0; k < 4; k++) {
+
+			m[k] = Float4::Load(in + 4 * (i + k));
+		}
+		Float4::Transpose(m[0], m[1], m[2], m[3]);
+
+		const Float4 det = m[0] * m[3] - m[2] * m[1];
+		//IsSingular on the column lengths
+		const Float4 lengths = Float4::Sqrt(m[0] * m[0] + m[1] * m[1]) * Float4::Sqrt(m[2] * m[2] + m[3] * m[3]);
+		const Float4 abs_det = Float4::Abs(det);
+		const Float4 mask = (abs_det > Float4(kSingularRatio) * lengths)
+			& (abs_det >= Float4(std::numeric_limits<float>::min()));
+		const Float4 inverse_det = Float4(1.0f) / det;
+		Float4 result[4] = { Float4::Select(mask, m[3] * inverse_det, m[0]),
+							 Float4::Select(mask, -m[1] * inverse_det, m[1]),
+							 Float4::Select(mask, -m[2] * inverse_det, m[2]),
+							 Float4::Select(mask, m[0] * inverse_det, m[3]) };
+		Float4::Transpose(result[0], result[1], result[2], result[3]);
+		for (int k = 0; k < 4; k++) {
+
+			result[k].Store(out + 4 * (i + k));
+		}
+
+		const int lanes = mask.MoveMask();
+		all_invertible &= lanes == 0xF;
+		if (!invertible.empty()) {
+
+			for (int k = 0; k < 4; k++) {
+
+				invertible[i + k] = (lanes >> k) & 1;
+			}
+		}
+	}
+	for (; i < count; i++) {
+
+		const Matrix2f matrix = matrices[i];
+		const bool kInvertible = matrix.TryInverse(inverses[i]);
+		if (!kInvertible) {
+
+			inverses[i] = matrix;
+		}
+		all_invertible &= kInvertible;
+		if (!invertible.empty()) {
+
+			invertible[i] = kInvertible;
+		}
+	}
+
+	return all_invertible;
+}
 	
 }//namespace maths
@@ -21,11 +21,31 @@ SOFTWARE.
 */
 
 #include "maths/matrix3.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 #include "maths/angle.h"
 #include "maths/matrix2.h"
 #include "maths/maths_utils.h"
+#include "maths/simd.h"
 
 namespace maths {
+
+namespace {
+
+static_assert(sizeof(Matrix3f) == 9 * sizeof(float), "Matrix3f spans are read as packed floats");
+
+constexpr int kMaxPolarIterations = 20;
+
+//Squared Frobenius norm, the sum of the squared elements
+float NormSq(const Matrix3f& matrix) {
+
+	return matrix[0].Dot(matrix[0]) + matrix[1].Dot(matrix[1]) + matrix[2].Dot(matrix[2]);
+}
+
+}//namespace
 	
 Matrix3f::Matrix3f(const Vector3f& v1, const Vector3f& v2, const Vector3f& v3) {
 	
@@ -157,31 +177,34 @@ float Matrix3f::cofactor(int row, int column) const {
 }
 float Matrix3f::determinant() const {
 	
-	const float kDet = matrix_[0][0] * cofactor(0, 0)
-					+ matrix_[0][1] * cofactor(1, 0)
-					+ matrix_[0][2] * cofactor(2, 0);
-	
-	return kDet;
+	//Triple product of the columns
+	return Vector3f::Dot(matrix_[0], Vector3f::Cross(matrix_[1], matrix_[2]));
 }
 Matrix3f Matrix3f::Inverse() const {
 
-	const float kDet = determinant();
-	
-	if(Equal(kDet, 0.0f)) {
-		
-		return *this;
-	}
+	Matrix3f inverse;
 
-	if (IsOrthogonal()) {
-		
-		return Transpose();
-	}
+	return TryInverse(inverse) ? inverse : *this;
+}
+bool Matrix3f::TryInverse(Matrix3f& inverse) const {
 
-	Matrix3f tmp_mat = adjoint();
+	//The rows of the inverse are the cross products of the other two columns over the determinant
+	const Vector3f kRow0 = Vector3f::Cross(matrix_[1], matrix_[2]);
+	const Vector3f kRow1 = Vector3f::Cross(matrix_[2], matrix_[0]);
+	const Vector3f kRow2 = Vector3f::Cross(matrix_[0], matrix_[1]);
+	const float kDet = Vector3f::Dot(matrix_[0], kRow0);
 
-	tmp_mat *= (1.0f / kDet);
+	if (IsSingular(kDet, matrix_[0].Magnitude() * matrix_[1].Magnitude() * matrix_[2].Magnitude())) {
 
-	return tmp_mat;
+		return false;
+	}
+
+	inverse = Matrix3f(Vector3f(kRow0.x, kRow1.x, kRow2.x),
+					   Vector3f(kRow0.y, kRow1.y, kRow2.y),
+					   Vector3f(kRow0.z, kRow1.z, kRow2.z));
+	inverse *= 1.0f / kDet;
+
+	return true;
 }
 Matrix3f Matrix3f::Transpose() const {
 	
@@ -225,5 +248,206 @@ Matrix3f Matrix3f::translationMatrix(Vector2f axisValues) {
 	
 	return Matrix3f(Vector3f(1, 0, axisValues.x), Vector3f(0, 1, axisValues.y), Vector3f(0, 0, 1));
 }
+void SymmetricEigen(const Matrix3f& matrix, Vector3f& values, Matrix3f& vectors) {
+
+	// Work in double, a[i][j] is row i and column j, v holds the eigenvectors as columns
+	double a[3][3];
+	double v[3][3] = { { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 } };
+	for (int i = 0; i < 3; i++) {
+
+		for (int j = 0; j < 3; j++) {
+
+			a[i][j] = matrix[j][i];
+		}
+	}
+
+	constexpr int kMaxSweeps = 32;
+	for (int sweep = 0; sweep < kMaxSweeps; sweep++) {
+
+		const double off_diagonal = std::abs(a[0][1]) + std::abs(a[0][2]) + std::abs(a[1][2]);
+		const double diagonal = std::abs(a[0][0]) + std::abs(a[1][1]) + std::abs(a[2][2]);
+		if (off_diagonal <= 1e-15 * diagonal || off_diagonal == 0.0) {
+			break;
+		}
+
+		for (int p = 0; p < 2; p++) {
+
+			for (int q = p + 1; q < 3; q++) {
+
+				if (a[p][q] == 0.0) {
+					continue;
+				}
+				// Rotation zeroing a[p][q]
+				const double theta = (a[q][q] - a[p][p]) / (2.0 * a[p][q]);
+				const double t = (theta >= 0.0 ? 1.0 : -1.0) / (std::abs(theta) + std::sqrt(theta * theta + 1.0));
+				const double c = 1.0 / std::sqrt(t * t + 1.0);
+				const double s = t * c;
+				for (int k = 0; k < 3; k++) {
+
+					const double a_kp = a[k][p];
+					const double a_kq = a[k][q];
+					a[k][p] = c * a_kp - s * a_kq;
+					a[k][q] = s * a_kp + c * a_kq;
+				}
+				for (int k = 0; k < 3; k++) {
+
+					const double a_pk = a[p][k];
+					const double a_qk = a[q][k];
+					a[p][k] = c * a_pk - s * a_qk;
+					a[q][k] = s * a_pk + c * a_qk;
+				}
+				for (int k = 0; k < 3; k++) {
+
+					const double v_kp = v[k][p];
+					const double v_kq = v[k][q];
+					v[k][p] = c * v_kp - s * v_kq;
+					v[k][q] = s * v_kp + c * v_kq;
+				}
+			}
+		}
+	}
+
+	std::array<int, 3> order = { 0, 1, 2 };
+	std::sort(order.begin(), order.end(), [&a](int lhs, int rhs) { return a[lhs][lhs] > a[rhs][rhs]; });
+	for (int i = 0; i < 3; i++) {
+
+		values[i] = static_cast<float>(a[order[i]][order[i]]);
+		vectors[i] = Vector3f(static_cast<float>(v[0][order[i]]), static_cast<float>(v[1][order[i]]),
+			static_cast<float>(v[2][order[i]]));
+	}
+	// Right-handed basis
+	vectors[2] = Vector3f::Cross(vectors[0], vectors[1]);
+}
+	
+bool PolarDecomposition(const Matrix3f& matrix, Matrix3f& rotation, Matrix3f& stretch) {
+
+	//Newton iteration X = (gamma * X + X^-T / gamma) / 2, the scaling gamma evens out the singular values
+	//so it converges in a few steps even for strong shears. The first step scales the iterate to about unit
+	//singular values, and TryInverse's singularity test is relative, so the matrix's own scale does not matter.
+	Matrix3f current = matrix;
+	for (int iteration = 0; iteration < kMaxPolarIterations; iteration++) {
+
+		Matrix3f inverse;
+		if (!current.TryInverse(inverse)) {
+
+			return false;
+		}
+		const float kGamma = std::sqrt(std::sqrt(NormSq(inverse) / NormSq(current)));
+		Matrix3f next = current;
+		next *= 0.5f * kGamma;
+		Matrix3f inverse_transpose = inverse.Transpose();
+		inverse_transpose *= 0.5f / kGamma;
+		next += inverse_transpose;
+
+		const float kChangeSq = NormSq(next - current);
+		current = next;
+		if (kChangeSq <= 1e-12f) {
+
+			break;
+		}
+	}
+	rotation = current;
+
+	//Rotation^T * matrix, made exactly symmetric
+	stretch = current.Transpose() * matrix;
+	for (int i = 0; i < 3; i++) {
+
+		for (int j = i + 1; j < 3; j++) {
+
+			const float kMean = 0.5f * (stretch[i][j] + stretch[j][i]);
+			stretch[i][j] = kMean;
+			stretch[j][i] = kMean;
+		}
+	}
+
+	return true;
+}
+bool InverseBatch(std::span<const Matrix3f> matrices, std::span<Matrix3f> inverses,
+	std::span<std::uint8_t> invertible) {
+
+	std::size_t count = std::min(matrices.size(), inverses.size());
+	if (!invertible.empty()) {
+
+		count = std::min(count, invertible.size());
+	}
+	const float* in = reinterpret_cast<const float*>(matrices.data());
+	float* out = reinterpret_cast<float*>(inverses.data());
+	bool all_invertible = true;
+	std::size_t i = 0;
+
+	//Four matrices in structure of arrays, e[k] holds element k of each, the same formulas as TryInverse
+	for (; i + 4 <= count; i += 4) {
+
+		const float* data = in + 9 * i;
+		Float4 e[9];
+		for (int k = 0; k < 4; k++) {
+
+			e[k] = Float4::Load(data + 9 * k);
+			e[4 + k] = Float4::Load(data + 9 * k + 4);
+		}
+		Float4::Transpose(e[0], e[1], e[2], e[3]);
+		Float4::Transpose(e[4], e[5], e[6], e[7]);
+		e[8] = Float4(data[8], data[17], data[26], data[35]);
+
+		const Float4 row0[3] = { e[4] * e[8] - e[5] * e[7], e[5] * e[6] - e[3] * e[8], e[3] * e[7] - e[4] * e[6] };
+		const Float4 row1[3] = { e[7] * e[2] - e[8] * e[1], e[8] * e[0] - e[6] * e[2], e[6] * e[1] - e[7] * e[0] };
+		const Float4 row2[3] = { e[1] * e[5] - e[2] * e[4], e[2] * e[3] - e[0] * e[5], e[0] * e[4] - e[1] * e[3] };
+		const Float4 det = e[0] * row0[0] + e[1] * row0[1] + e[2] * row0[2];
+		//IsSingular on the column lengths
+		const Float4 lengths = Float4::Sqrt(e[0] * e[0] + e[1] * e[1] + e[2] * e[2])
+			* Float4::Sqrt(e[3] * e[3] + e[4] * e[4] + e[5] * e[5])
+			* Float4::Sqrt(e[6] * e[6] + e[7] * e[7] + e[8] * e[8]);
+		const Float4 abs_det = Float4::Abs(det);
+		const Float4 mask = (abs_det > Float4(kSingularRatio) * lengths)
+			& (abs_det >= Float4(std::numeric_limits<float>::min()));
+		const Float4 inverse_det = Float4(1.0f) / det;
+
+		//Element 3 * column + row of the inverse is element column of row row
+		Float4 result[9];
+		for (int column = 0; column < 3; column++) {
+
+			result[3 * column] = Float4::Select(mask, row0[column] * inverse_det, e[3 * column]);
+			result[3 * column + 1] = Float4::Select(mask, row1[column] * inverse_det, e[3 * column + 1]);
+			result[3 * column + 2] = Float4::Select(mask, row2[column] * inverse_det, e[3 * column + 2]);
+		}
+		Float4::Transpose(result[0], result[1], result[2], result[3]);
+		Float4::Transpose(result[4], result[5], result[6], result[7]);
+		float last[4];
+		result[8].Store(last);
+		float* destination = out + 9 * i;
+		for (int k = 0; k < 4; k++) {
+
+			result[k].Store(destination + 9 * k);
+			result[4 + k].Store(destination + 9 * k + 4);
+			destination[9 * k + 8] = last[k];
+		}
+
+		const int lanes = mask.MoveMask();
+		all_invertible &= lanes == 0xF;
+		if (!invertible.empty()) {
+
+			for (int k = 0; k < 4; k++) {
+
+				invertible[i + k] = (lanes >> k) & 1;
+			}
+		}
+	}
+	for (; i < count; i++) {
+
+		const Matrix3f matrix = matrices[i];
+		const bool kInvertible = matrix.TryInverse(inverses[i]);
+		if (!kInvertible) {
+
+			inverses[i] = matrix;
+		}
+		all_invertible &= kInvertible;
+		if (!invertible.empty()) {
+
+			invertible[i] = kInvertible;
+		}
+	}
+
+	return all_invertible;
+}
 	
 }//namespace maths
@@ -20,13 +20,29 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "maths/instrumentation.h"
 #include "maths/matrix3.h"
 #include "maths/matrix4.h"
 #include "maths/maths_utils.h"
+#include "maths/simd.h"
 
 
 namespace maths
 {
+namespace {
+
+static_assert(sizeof(Matrix4f) == 16 * sizeof(float), "Matrix4f spans are read as packed floats");
+static_assert(sizeof(Matrix3f) == 9 * sizeof(float), "Matrix3f spans are written as packed floats");
+
+//Relative tolerance on the squared column lengths and their dot products
+constexpr float kUniformScaleTolerance = 0.0001f;
+
+}//namespace
+
 Matrix4f::Matrix4f(const Vector4f& v1, const Vector4f& v2, const Vector4f& v3, const Vector4f& v4) {
 	
 	matrix_[0] = v1;
@@ -168,21 +184,27 @@ float Matrix4f::determinant() const {
 }
 Matrix4f Matrix4f::Inverse() const {
 
+	MATHS_COUNT(kMatrix4fInverse);
+	MATHS_SCOPED_TIMER("Matrix4f::Inverse");
+
 	const float kDet = determinant();
 	
 	if(Equal(kDet, 0.0f)) {
 		
+		MATHS_COUNT_EXIT(kMatrix4fInverse, 0);
 		return *this;
 	}
 	
 	if (IsOrthogonal()) {
 		
+		MATHS_COUNT_EXIT(kMatrix4fInverse, 1);
 		return Transpose();
 	}
+	MATHS_COUNT_EXIT(kMatrix4fInverse, 2);
 	
 	Matrix4f tmp_mat = adjoint();
 
-	tmp_mat *= (1.0f / determinant());
+	tmp_mat *= (1.0f / kDet);
 
 	return tmp_mat;
 }
@@ -273,4 +295,144 @@ Matrix4f Matrix4f::translationMatrix(Vector3f axisValues) {
 					Vector4f(0, 0, 0, 1));
 }
 	
+NormalMatrixKind NormalMatrix(const Matrix4f& world, Matrix3f& normal) {
+
+	const Vector3f kColumn0(world[0].x, world[0].y, world[0].z);
+	const Vector3f kColumn1(world[1].x, world[1].y, world[1].z);
+	const Vector3f kColumn2(world[2].x, world[2].y, world[2].z);
+
+	//Rotation times a scale s: the inverse transpose is the matrix over s squared
+	const float kLengthSq0 = kColumn0.Dot(kColumn0);
+	const float kTolerance = kUniformScaleTolerance * kLengthSq0;
+	if (kLengthSq0 >= std::numeric_limits<float>::min()
+		&& std::abs(kColumn1.Dot(kColumn1) - kLengthSq0) <= kTolerance
+		&& std::abs(kColumn2.Dot(kColumn2) - kLengthSq0) <= kTolerance
+		&& std::abs(kColumn0.Dot(kColumn1)) <= kTolerance
+		&& std::abs(kColumn0.Dot(kColumn2)) <= kTolerance
+		&& std::abs(kColumn1.Dot(kColumn2)) <= kTolerance) {
+
+		const float kScaleSq = (kLengthSq0 + kColumn1.Dot(kColumn1) + kColumn2.Dot(kColumn2)) / 3.0f;
+		normal = Matrix3f(kColumn0, kColumn1, kColumn2);
+		normal *= 1.0f / kScaleSq;
+		return NormalMatrixKind::kUniformScale;
+	}
+
+	//The columns of the inverse transpose are the cross products of the other two columns over the determinant
+	const Vector3f kCofactor0 = Vector3f::Cross(kColumn1, kColumn2);
+	normal = Matrix3f(kCofactor0, Vector3f::Cross(kColumn2, kColumn0), Vector3f::Cross(kColumn0, kColumn1));
+	const float kDet = kColumn0.Dot(kCofactor0);
+	if (IsSingular(kDet, kColumn0.Magnitude() * kColumn1.Magnitude() * kColumn2.Magnitude())) {
+
+		return NormalMatrixKind::kSingular;
+	}
+	normal *= 1.0f / kDet;
+
+	return NormalMatrixKind::kGeneral;
+}
+bool NormalMatrixBatch(std::span<const Matrix4f> world, std::span<Matrix3f> normals,
+	std::span<NormalMatrixKind> kinds) {
+
+	std::size_t count = std::min(world.size(), normals.size());
+	if (!kinds.empty()) {
+
+		count = std::min(count, kinds.size());
+	}
+	const float* in = reinterpret_cast<const float*>(world.data());
+	float* out = reinterpret_cast<float*>(normals.data());
+	bool none_singular = true;
+	std::size_t i = 0;
+
+	//Four matrices in structure of arrays, the same formulas as NormalMatrix
+	for (; i + 4 <= count; i += 4) {
+
+		//c[column][axis] after the transposes, the w row is unused
+		Float4 c[3][4];
+		for (int column = 0; column < 3; column++) {
+
+			for (int k = 0; k < 4; k++) {
+
+				c[column][k] = Float4::Load(in + 16 * (i + k) + 4 * column);
+			}
+			Float4::Transpose(c[column][0], c[column][1], c[column][2], c[column][3]);
+		}
+		const auto dot = [&c](int a, int b) {
+			return c[a][0] * c[b][0] + c[a][1] * c[b][1] + c[a][2] * c[b][2];
+		};
+		const auto cross = [&c](int a, int b, int axis) {
+			const int next = (axis + 1) % 3;
+			const int last = (axis + 2) % 3;
+			return c[a][next] * c[b][last] - c[a][last] * c[b][next];
+		};
+
+		const Float4 length_sq0 = dot(0, 0);
+		const Float4 length_sq1 = dot(1, 1);
+		const Float4 length_sq2 = dot(2, 2);
+		const Float4 tolerance = Float4(kUniformScaleTolerance) * length_sq0;
+		const Float4 uniform = (length_sq0 >= Float4(std::numeric_limits<float>::min()))
+			& (Float4::Abs(length_sq1 - length_sq0) <= tolerance) & (Float4::Abs(length_sq2 - length_sq0) <= tolerance)
+			& (Float4::Abs(dot(0, 1)) <= tolerance) & (Float4::Abs(dot(0, 2)) <= tolerance)
+			& (Float4::Abs(dot(1, 2)) <= tolerance);
+		const Float4 inverse_scale_sq = Float4(3.0f) / (length_sq0 + length_sq1 + length_sq2);
+
+		Float4 cofactors[3][3];
+		for (int axis = 0; axis < 3; axis++) {
+
+			cofactors[0][axis] = cross(1, 2, axis);
+			cofactors[1][axis] = cross(2, 0, axis);
+			cofactors[2][axis] = cross(0, 1, axis);
+		}
+		const Float4 det = c[0][0] * cofactors[0][0] + c[0][1] * cofactors[0][1] + c[0][2] * cofactors[0][2];
+		//IsSingular on the column lengths
+		const Float4 abs_det = Float4::Abs(det);
+		const Float4 invertible = (abs_det > Float4(kSingularRatio) * Float4::Sqrt(length_sq0) * Float4::Sqrt(length_sq1)
+			* Float4::Sqrt(length_sq2)) & (abs_det >= Float4(std::numeric_limits<float>::min()));
+		const Float4 inverse_det = Float4::Select(invertible, Float4(1.0f) / det, Float4(1.0f));
+
+		//Element 3 * column + axis of the normal matrices
+		Float4 result[9];
+		for (int column = 0; column < 3; column++) {
+
+			for (int axis = 0; axis < 3; axis++) {
+
+				result[3 * column + axis] = Float4::Select(uniform, c[column][axis] * inverse_scale_sq,
+					cofactors[column][axis] * inverse_det);
+			}
+		}
+		Float4::Transpose(result[0], result[1], result[2], result[3]);
+		Float4::Transpose(result[4], result[5], result[6], result[7]);
+		float last[4];
+		result[8].Store(last);
+		float* destination = out + 9 * i;
+		for (int k = 0; k < 4; k++) {
+
+			result[k].Store(destination + 9 * k);
+			result[4 + k].Store(destination + 9 * k + 4);
+			destination[9 * k + 8] = last[k];
+		}
+
+		const int uniform_lanes = uniform.MoveMask();
+		const int invertible_lanes = invertible.MoveMask() | uniform_lanes;
+		none_singular &= invertible_lanes == 0xF;
+		if (!kinds.empty()) {
+
+			for (int k = 0; k < 4; k++) {
+
+				kinds[i + k] = (uniform_lanes >> k) & 1 ? NormalMatrixKind::kUniformScale
+					: (invertible_lanes >> k) & 1 ? NormalMatrixKind::kGeneral : NormalMatrixKind::kSingular;
+			}
+		}
+	}
+	for (; i < count; i++) {
+
+		const NormalMatrixKind kKind = NormalMatrix(world[i], normals[i]);
+		none_singular &= kKind != NormalMatrixKind::kSingular;
+		if (!kinds.empty()) {
+
+			kinds[i] = kKind;
+		}
+	}
+
+	return none_singular;
+}
+	
 }//namespace maths
\ No newline at end of file
@@ -0,0 +1,219 @@
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "maths/mesh_bvh.h"
+
+#include <algorithm>
+#include <bit>
+#include <vector>
+
+#include "maths/simd.h"
+
+namespace maths {
+
+int MeshBvh::IntersectPacket(const WatertightRay& ray, const TrianglePacket& packet,
+	float max_distance, float (&distance)[4], float (&u)[4], float (&v)[4])
+{
+	// Same steps as WatertightRay::Intersect on four lanes. Edge functions
+	// that round to zero count as inside, a ray on a shared edge may then hit
+	// both triangles but never none.
+	const Float4 origin_x(ray.origin.coord[ray.kx]), origin_y(ray.origin.coord[ray.ky]), origin_z(ray.origin.coord[ray.kz]);
+	const Float4 shear_x(ray.shear_x), shear_y(ray.shear_y), shear_z(ray.shear_z);
+	auto project = [&](const float (&vertex)[3][4], Float4& x, Float4& y, Float4& z) {
+		const Float4 relative_z = Float4::LoadAligned(vertex[ray.kz]) - origin_z;
+		x = Float4::LoadAligned(vertex[ray.kx]) - origin_x - shear_x * relative_z;
+		y = Float4::LoadAligned(vertex[ray.ky]) - origin_y - shear_y * relative_z;
+		z = shear_z * relative_z;
+	};
+	Float4 ax, ay, az, bx, by, bz, cx, cy, cz;
+	project(packet.a, ax, ay, az);
+	project(packet.b, bx, by, bz);
+	project(packet.c, cx, cy, cz);
+
+	const Float4 edge_u = cx * by - cy * bx;
+	const Float4 edge_v = ax * cy - ay * cx;
+	const Float4 edge_w = bx * ay - by * ax;
+	const Float4 zero = Float4::Zero();
+	const Float4 inside = ((edge_u >= zero) & (edge_v >= zero) & (edge_w >= zero))
+		| ((edge_u <= zero) & (edge_v <= zero) & (edge_w <= zero));
+	const Float4 determinant = edge_u + edge_v + edge_w;
+	const Float4 inverse_determinant = Float4(1.0f) / determinant;
+	const Float4 t = (edge_u * az + edge_v * bz + edge_w * cz) * inverse_determinant;
+	// Degenerate lanes give a zero determinant and a NaN or infinite t
+	const Float4 hit = inside & ((determinant > zero) | (determinant < zero))
+		& (t > zero) & (t <= Float4(max_distance));
+	const int mask = hit.MoveMask();
+	if (mask != 0) {
+		t.Store(distance);
+		(edge_v * inverse_determinant).Store(u);
+		(edge_w * inverse_determinant).Store(v);
+	}
+	return mask;
+}
+
+void MeshBvh::Build(std::span<const Vector3f> vertices, std::span<const std::uint32_t> indices,
+	std::uint32_t max_leaf_size)
+{
+	triangle_count_ = indices.size() / 3;
+	std::vector<AABB3> bounds(triangle_count_);
+	for (std::size_t i = 0; i < triangle_count_; i++) {
+		const Vector3f& a = vertices[indices[3 * i]];
+		bounds[i] = Expand(Expand(AABB3{ a, a }, vertices[indices[3 * i + 1]]), vertices[indices[3 * i + 2]]);
+	}
+	bvh_.Build(bounds, max_leaf_size);
+
+	// Copy the triangles of every leaf in packets, in leaf order
+	packets_.clear();
+	leaf_packets_.assign(bvh_.nodes().size(), 0);
+	for (std::size_t node_index = 0; node_index < bvh_.nodes().size(); node_index++) {
+		const BvhNode& node = bvh_.nodes()[node_index];
+		if (!node.IsLeaf()) {
+			continue;
+		}
+		leaf_packets_[node_index] = static_cast<std::uint32_t>(packets_.size());
+		for (std::uint32_t first = 0; first < node.count; first += 4) {
+			TrianglePacket packet{};
+			for (std::uint32_t lane = 0; lane < 4; lane++) {
+				if (first + lane >= node.count) {
+					packet.triangle[lane] = kInvalidTriangle;
+					continue;
+				}
+				const std::uint32_t triangle = bvh_.items()[node.first + first + lane];
+				packet.triangle[lane] = triangle;
+				const Vector3f& a = vertices[indices[3 * triangle]];
+				const Vector3f& b = vertices[indices[3 * triangle + 1]];
+				const Vector3f& c = vertices[indices[3 * triangle + 2]];
+				for (int axis = 0; axis < 3; axis++) {
+					packet.a[axis][lane] = a.coord[axis];
+					packet.b[axis][lane] = b.coord[axis];
+					packet.c[axis][lane] = c.coord[axis];
+				}
+			}
+			packets_.push_back(packet);
+		}
+	}
+}
+
+bool MeshBvh::ClosestHit(const Ray3& ray, MeshHit& hit, float max_distance) const
+{
+	const SlabRay slab_ray(ray);
+	const WatertightRay watertight_ray(ray);
+	const std::vector<BvhNode>& nodes = bvh_.nodes();
+	float root_distance;
+	if (nodes.empty() || !slab_ray.Intersect(nodes[0].bounds, max_distance, root_distance)) {
+		return false;
+	}
+
+	struct Entry {
+		std::uint32_t node;
+		float distance;
+	};
+	// The SAH build has no depth cap, a skewed mesh can go past any fixed size
+	std::vector<Entry> stack;
+	stack.reserve(64);
+	stack.push_back({ 0, root_distance });
+	float best_distance = max_distance;
+	bool found = false;
+	while (!stack.empty()) {
+		const Entry entry = stack.back();
+		stack.pop_back();
+		if (entry.distance > best_distance) {
+			continue;
+		}
+		const BvhNode& node = nodes[entry.node];
+		if (node.IsLeaf()) {
+			const std::uint32_t first = leaf_packets_[entry.node];
+			const std::uint32_t last = first + (node.count + 3) / 4;
+			for (std::uint32_t p = first; p < last; p++) {
+				float distance[4], u[4], v[4];
+				int mask = IntersectPacket(watertight_ray, packets_[p], best_distance, distance, u, v);
+				while (mask != 0) {
+					const int lane = std::countr_zero(static_cast<unsigned>(mask));
+					mask &= mask - 1;
+					if (distance[lane] <= best_distance) {
+						best_distance = distance[lane];
+						hit = { packets_[p].triangle[lane], distance[lane], u[lane], v[lane] };
+						found = true;
+					}
+				}
+			}
+			continue;
+		}
+
+		// Push the nearest child last so it is visited first
+		float left_distance, right_distance;
+		const bool left_hit = slab_ray.Intersect(nodes[node.first].bounds, best_distance, left_distance);
+		const bool right_hit = slab_ray.Intersect(nodes[node.first + 1].bounds, best_distance, right_distance);
+		if (left_hit && right_hit && left_distance < right_distance) {
+			stack.push_back({ node.first + 1, right_distance });
+			stack.push_back({ node.first, left_distance });
+		} else {
+			if (left_hit) {
+				stack.push_back({ node.first, left_distance });
+			}
+			if (right_hit) {
+				stack.push_back({ node.first + 1, right_distance });
+			}
+		}
+	}
+	return found;
+}
+
+bool MeshBvh::AnyHit(const Ray3& ray, float max_distance) const
+{
+	const SlabRay slab_ray(ray);
+	const WatertightRay watertight_ray(ray);
+	const std::vector<BvhNode>& nodes = bvh_.nodes();
+	if (nodes.empty()) {
+		return false;
+	}
+
+	std::vector<std::uint32_t> stack;
+	stack.reserve(64);
+	stack.push_back(0);
+	while (!stack.empty()) {
+		const BvhNode& node = nodes[stack.back()];
+		stack.pop_back();
+		float distance;
+		if (!slab_ray.Intersect(node.bounds, max_distance, distance)) {
+			continue;
+		}
+		if (!node.IsLeaf()) {
+			stack.push_back(node.first + 1);
+			stack.push_back(node.first);
+			continue;
+		}
+		const std::uint32_t first = leaf_packets_[&node - nodes.data()];
+		const std::uint32_t last = first + (node.count + 3) / 4;
+		for (std::uint32_t p = first; p < last; p++) {
+			float distances[4], u[4], v[4];
+			if (IntersectPacket(watertight_ray, packets_[p], max_distance, distances, u, v) != 0) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+} // namespace maths
@@ -0,0 +1,282 @@
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "maths/morton.h"
+
+#include <algorithm>
+
+namespace maths {
+
+namespace {
+
+#if !MATHS_BMI2
+std::uint32_t Spread2(std::uint32_t v)
+{
+	v &= 0x0000FFFF;
+	v = (v | (v << 8)) & 0x00FF00FF;
+	v = (v | (v << 4)) & 0x0F0F0F0F;
+	v = (v | (v << 2)) & 0x33333333;
+	v = (v | (v << 1)) & 0x55555555;
+	return v;
+}
+
+std::uint64_t Spread2(std::uint64_t v)
+{
+	v &= 0x00000000FFFFFFFF;
+	v = (v | (v << 16)) & 0x0000FFFF0000FFFF;
+	v = (v | (v << 8)) & 0x00FF00FF00FF00FF;
+	v = (v | (v << 4)) & 0x0F0F0F0F0F0F0F0F;
+	v = (v | (v << 2)) & 0x3333333333333333;
+	v = (v | (v << 1)) & 0x5555555555555555;
+	return v;
+}
+
+std::uint32_t Spread3(std::uint32_t v)
+{
+	v &= 0x000003FF;
+	v = (v | (v << 16)) & 0x030000FF;
+	v = (v | (v << 8)) & 0x0300F00F;
+	v = (v | (v << 4)) & 0x030C30C3;
+	v = (v | (v << 2)) & 0x09249249;
+	return v;
+}
+
+std::uint64_t Spread3(std::uint64_t v)
+{
+	v &= 0x00000000001FFFFF;
+	v = (v | (v << 32)) & 0x001F00000000FFFF;
+	v = (v | (v << 16)) & 0x001F0000FF0000FF;
+	v = (v | (v << 8)) & 0x100F00F00F00F00F;
+	v = (v | (v << 4)) & 0x10C30C30C30C30C3;
+	v = (v | (v << 2)) & 0x1249249249249249;
+	return v;
+}
+
+std::uint32_t Compact3(std::uint32_t v)
+{
+	v &= 0x09249249;
+	v = (v ^ (v >> 2)) & 0x030C30C3;
+	v = (v ^ (v >> 4)) & 0x0300F00F;
+	v = (v ^ (v >> 8)) & 0x030000FF;
+	v = (v ^ (v >> 16)) & 0x000003FF;
+	return v;
+}
+
+std::uint64_t Compact3(std::uint64_t v)
+{
+	v &= 0x1249249249249249;
+	v = (v ^ (v >> 2)) & 0x10C30C30C30C30C3;
+	v = (v ^ (v >> 4)) & 0x100F00F00F00F00F;
+	v = (v ^ (v >> 8)) & 0x001F0000FF0000FF;
+	v = (v ^ (v >> 16)) & 0x001F00000000FFFF;
+	v = (v ^ (v >> 32)) & 0x00000000001FFFFF;
+	return v;
+}
+#endif
+
+// Skilling's transform of the coordinates into the transposed Hilbert index
+template<int kDimensions>
+std::uint64_t HilbertFromAxes(std::uint32_t (&axes)[kDimensions], int bits)
+{
+	// The shifts need 1 to 32 bits, and the index has to fit 64 bits
+	bits = std::clamp(bits, 1, 64 / kDimensions);
+	const std::uint32_t highest = 1u << (bits - 1);
+	// Inverse undo
+	for (std::uint32_t q = highest; q > 1; q >>= 1) {
+		const std::uint32_t p = q - 1;
+		for (int i = 0; i < kDimensions; i++) {
+			if (axes[i] & q) {
+				axes[0] ^= p;
+			} else {
+				const std::uint32_t t = (axes[0] ^ axes[i]) & p;
+				axes[0] ^= t;
+				axes[i] ^= t;
+			}
+		}
+	}
+	// Gray encode
+	for (int i = 1; i < kDimensions; i++) {
+		axes[i] ^= axes[i - 1];
+	}
+	std::uint32_t t = 0;
+	for (std::uint32_t q = highest; q > 1; q >>= 1) {
+		if (axes[kDimensions - 1] & q) {
+			t ^= q - 1;
+		}
+	}
+	for (int i = 0; i < kDimensions; i++) {
+		axes[i] ^= t;
+	}
+
+	// Interleave the transposed bits, first axis most significant
+	std::uint64_t index = 0;
+	for (int bit = bits - 1; bit >= 0; bit--) {
+		for (int i = 0; i < kDimensions; i++) {
+			index = (index << 1) | ((axes[i] >> bit) & 1u);
+		}
+	}
+	return index;
+}
+
+// Maps coordinate from [min, max] to [0, 2^bits - 1]
+std::uint32_t Quantize(float coordinate, float min, float max, int bits)
+{
+	const double range = static_cast<double>(max) - min;
+	const double t = range > 0.0 ? (coordinate - static_cast<double>(min)) / range : 0.0;
+	const double cells = static_cast<double>((std::uint64_t{ 1 } << bits) - 1);
+	return static_cast<std::uint32_t>(std::clamp(t, 0.0, 1.0) * cells);
+}
+
+} // namespace
+
+std::uint32_t MortonEncode32(std::uint32_t x, std::uint32_t y)
+{
+#if MATHS_BMI2
+	return _pdep_u32(x, 0x55555555) | _pdep_u32(y, 0xAAAAAAAA);
+#else
+	return Spread2(x) | (Spread2(y) << 1);
+#endif
+}
+
+std::uint32_t MortonEncode32(std::uint32_t x, std::uint32_t y, std::uint32_t z)
+{
+#if MATHS_BMI2
+	return _pdep_u32(x, 0x09249249) | _pdep_u32(y, 0x12492492) | _pdep_u32(z, 0x24924924);
+#else
+	return Spread3(x) | (Spread3(y) << 1) | (Spread3(z) << 2);
+#endif
+}
+
+std::uint64_t MortonEncode64(std::uint32_t x, std::uint32_t y)
+{
+#if MATHS_BMI2
+	return _pdep_u64(x, 0x5555555555555555) | _pdep_u64(y, 0xAAAAAAAAAAAAAAAA);
+#else
+	return Spread2(std::uint64_t{ x }) | (Spread2(std::uint64_t{ y }) << 1);
+#endif
+}
+
+std::uint64_t MortonEncode64(std::uint32_t x, std::uint32_t y, std::uint32_t z)
+{
+#if MATHS_BMI2
+	return _pdep_u64(x, 0x1249249249249249) | _pdep_u64(y, 0x2492492492492492)
+		| _pdep_u64(z, 0x4924924924924924);
+#else
+	return Spread3(std::uint64_t{ x }) | (Spread3(std::uint64_t{ y }) << 1)
+		| (Spread3(std::uint64_t{ z }) << 2);
+#endif
+}
+
+void MortonDecode32(std::uint32_t code, std::uint32_t& x, std::uint32_t& y, std::uint32_t& z)
+{
+#if MATHS_BMI2
+	x = _pext_u32(code, 0x09249249);
+	y = _pext_u32(code, 0x12492492);
+	z = _pext_u32(code, 0x24924924);
+#else
+	x = Compact3(code);
+	y = Compact3(code >> 1);
+	z = Compact3(code >> 2);
+#endif
+}
+
+void MortonDecode64(std::uint64_t code, std::uint32_t& x, std::uint32_t& y, std::uint32_t& z)
+{
+#if MATHS_BMI2
+	x = static_cast<std::uint32_t>(_pext_u64(code, 0x1249249249249249));
+	y = static_cast<std::uint32_t>(_pext_u64(code, 0x2492492492492492));
+	z = static_cast<std::uint32_t>(_pext_u64(code, 0x4924924924924924));
+#else
+	x = static_cast<std::uint32_t>(Compact3(code));
+	y = static_cast<std::uint32_t>(Compact3(code >> 1));
+	z = static_cast<std::uint32_t>(Compact3(code >> 2));
+#endif
+}
+
+std::uint64_t HilbertEncode(std::uint32_t x, std::uint32_t y, int bits)
+{
+	std::uint32_t axes[2] = { x, y };
+	return HilbertFromAxes(axes, bits);
+}
+
+std::uint64_t HilbertEncode(std::uint32_t x, std::uint32_t y, std::uint32_t z, int bits)
+{
+	std::uint32_t axes[3] = { x, y, z };
+	return HilbertFromAxes(axes, bits);
+}
+
+std::uint32_t Morton32(const Vector2f& point, const AABB2& bounds)
+{
+	const Vector2f min = bounds.bottom_left(), max = bounds.top_right();
+	return MortonEncode32(Quantize(point.x, min.x, max.x, 16), Quantize(point.y, min.y, max.y, 16));
+}
+
+std::uint32_t Morton32(const Vector3f& point, const AABB3& bounds)
+{
+	const Vector3f min = bounds.bottom_left(), max = bounds.top_right();
+	return MortonEncode32(Quantize(point.x, min.x, max.x, 10), Quantize(point.y, min.y, max.y, 10),
+		Quantize(point.z, min.z, max.z, 10));
+}
+
+std::uint64_t Morton64(const Vector2f& point, const AABB2& bounds)
+{
+	const Vector2f min = bounds.bottom_left(), max = bounds.top_right();
+	return MortonEncode64(Quantize(point.x, min.x, max.x, 32), Quantize(point.y, min.y, max.y, 32));
+}
+
+std::uint64_t Morton64(const Vector3f& point, const AABB3& bounds)
+{
+	const Vector3f min = bounds.bottom_left(), max = bounds.top_right();
+	return MortonEncode64(Quantize(point.x, min.x, max.x, 21), Quantize(point.y, min.y, max.y, 21),
+		Quantize(point.z, min.z, max.z, 21));
+}
+
+std::uint32_t Hilbert32(const Vector2f& point, const AABB2& bounds)
+{
+	const Vector2f min = bounds.bottom_left(), max = bounds.top_right();
+	return static_cast<std::uint32_t>(HilbertEncode(Quantize(point.x, min.x, max.x, 16),
+		Quantize(point.y, min.y, max.y, 16), 16));
+}
+
+std::uint32_t Hilbert32(const Vector3f& point, const AABB3& bounds)
+{
+	const Vector3f min = bounds.bottom_left(), max = bounds.top_right();
+	return static_cast<std::uint32_t>(HilbertEncode(Quantize(point.x, min.x, max.x, 10),
+		Quantize(point.y, min.y, max.y, 10), Quantize(point.z, min.z, max.z, 10), 10));
+}
+
+std::uint64_t Hilbert64(const Vector2f& point, const AABB2& bounds)
+{
+	const Vector2f min = bounds.bottom_left(), max = bounds.top_right();
+	return HilbertEncode(Quantize(point.x, min.x, max.x, 32), Quantize(point.y, min.y, max.y, 32), 32);
+}
+
+std::uint64_t Hilbert64(const Vector3f& point, const AABB3& bounds)
+{
+	const Vector3f min = bounds.bottom_left(), max = bounds.top_right();
+	return HilbertEncode(Quantize(point.x, min.x, max.x, 21), Quantize(point.y, min.y, max.y, 21),
+		Quantize(point.z, min.z, max.z, 21), 21);
+}
+
+} // namespace maths
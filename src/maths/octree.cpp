@@ -0,0 +1,358 @@
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "maths/octree.h"
+
+#include <algorithm>
+#include <bit>
+
+#include "maths/morton.h"
+
+namespace maths {
+
+Octree::Octree(const AABB3& world_bounds, int max_depth, float looseness)
+	: max_depth_(std::clamp(max_depth, 0, kMaxDepth)), looseness_(std::max(looseness, 1.0f))
+{
+	const Vector3f size = world_bounds.top_right() - world_bounds.bottom_left();
+	world_size_ = std::max({ size.x, size.y, size.z });
+	const Vector3f half{ world_size_ / 2.0f, world_size_ / 2.0f, world_size_ / 2.0f };
+	world_min_ = world_bounds.center() - half;
+
+	Node root;
+	root.center = world_bounds.center();
+	root.half_size = world_size_ / 2.0f;
+	root.children.fill(kNone);
+	nodes_.push_back(root);
+}
+
+Octree::Handle Octree::Insert(const AABB3& bounds)
+{
+	Handle handle;
+	if (free_objects_.empty()) {
+		handle = static_cast<Handle>(objects_.size());
+		objects_.emplace_back();
+	} else {
+		handle = free_objects_.back();
+		free_objects_.pop_back();
+	}
+	objects_[handle].bounds = bounds;
+	Link(handle, FindOrCreateNode(TargetCode(bounds)));
+	object_count_++;
+	return handle;
+}
+
+void Octree::Remove(Handle handle)
+{
+	if (handle >= objects_.size() || objects_[handle].node == kNone) {
+		return;
+	}
+	const std::uint32_t node = objects_[handle].node;
+	Unlink(handle);
+	free_objects_.push_back(handle);
+	object_count_--;
+	Prune(node);
+}
+
+void Octree::Move(Handle handle, const AABB3& bounds)
+{
+	if (handle >= objects_.size() || objects_[handle].node == kNone) {
+		return;
+	}
+	Object& object = objects_[handle];
+	object.bounds = bounds;
+	const std::uint32_t code = TargetCode(bounds);
+	const std::uint32_t old_node = object.node;
+	if (nodes_[old_node].code == code) {
+		return;
+	}
+	Unlink(handle);
+	Link(handle, FindOrCreateNode(code));
+	Prune(old_node);
+}
+
+void Octree::QuerySphere(const Sphere& sphere, std::vector<Handle>& result) const
+{
+	std::vector<std::uint32_t> stack{ 0 };
+	while (!stack.empty()) {
+		const Node& node = nodes_[stack.back()];
+		stack.pop_back();
+		// Objects outside the world live in the root, never skip it
+		if (node.depth != 0 && !AABBOverlapSphere(LooseBounds(node), sphere)) {
+			continue;
+		}
+		for (std::uint32_t i = node.first_object; i != kNone; i = objects_[i].next) {
+			if (AABBOverlapSphere(objects_[i].bounds, sphere)) {
+				result.push_back(i);
+			}
+		}
+		for (const std::uint32_t child : node.children) {
+			if (child != kNone) {
+				stack.push_back(child);
+			}
+		}
+	}
+}
+
+void Octree::QueryFrustum(const Frustum& frustum, std::vector<Handle>& result) const
+{
+	struct Entry {
+		std::uint32_t node;
+		Frustum::PlaneMask mask;
+	};
+	std::vector<Entry> stack{ { 0, Frustum::kAllPlanes } };
+	while (!stack.empty()) {
+		const Entry entry = stack.back();
+		stack.pop_back();
+		const Node& node = nodes_[entry.node];
+		Frustum::PlaneMask mask = entry.mask;
+		std::uint8_t last_plane = Frustum::kNoPlane;
+		if (node.depth != 0 && !frustum.ClassifyAABB(LooseBounds(node), mask, last_plane)) {
+			continue;
+		}
+		if (mask == 0) {
+			CollectSubtree(entry.node, result);
+			continue;
+		}
+		for (std::uint32_t i = node.first_object; i != kNone; i = objects_[i].next) {
+			Frustum::PlaneMask object_mask = mask;
+			if (frustum.ClassifyAABB(objects_[i].bounds, object_mask, last_plane)) {
+				result.push_back(i);
+			}
+		}
+		for (const std::uint32_t child : node.children) {
+			if (child != kNone) {
+				stack.push_back({ child, mask });
+			}
+		}
+	}
+}
+
+Octree::Handle Octree::Raycast(const Ray3& ray, float& distance, float max_distance) const
+{
+	const SlabRay slab_ray(ray);
+	Handle best = kInvalidHandle;
+	float best_distance = max_distance;
+
+	struct Entry {
+		std::uint32_t node;
+		float distance;
+	};
+	std::vector<Entry> stack{ { 0, 0.0f } };
+	std::array<Entry, 8> children;
+	while (!stack.empty()) {
+		const Entry entry = stack.back();
+		stack.pop_back();
+		if (entry.distance > best_distance) {
+			continue;
+		}
+		const Node& node = nodes_[entry.node];
+		for (std::uint32_t i = node.first_object; i != kNone; i = objects_[i].next) {
+			float object_distance;
+			if (slab_ray.Intersect(objects_[i].bounds, best_distance, object_distance)
+				&& object_distance < best_distance) {
+				best_distance = object_distance;
+				best = i;
+			}
+		}
+
+		// Push the children hit by the ray, the nearest one on top. Insertion
+		// sort on the filled prefix, std::sort over the array trips -Warray-bounds
+		// at -O3.
+		std::size_t child_count = 0;
+		for (const std::uint32_t child : node.children) {
+			float child_distance;
+			if (child == kNone ||
+				!slab_ray.Intersect(LooseBounds(nodes_[child]), best_distance, child_distance)) {
+				continue;
+			}
+			std::size_t slot = child_count++;
+			for (; slot > 0 && children[slot - 1].distance < child_distance; slot--) {
+				children[slot] = children[slot - 1];
+			}
+			children[slot] = { child, child_distance };
+		}
+		stack.insert(stack.end(), children.begin(), children.begin() + child_count);
+	}
+	distance = best_distance;
+	return best;
+}
+
+void Octree::QueryRay(const Ray3& ray, std::vector<std::pair<Handle, float>>& result) const
+{
+	const SlabRay slab_ray(ray);
+	constexpr float kInfinity = std::numeric_limits<float>::infinity();
+	const std::size_t first = result.size();
+	std::vector<std::uint32_t> stack{ 0 };
+	while (!stack.empty()) {
+		const Node& node = nodes_[stack.back()];
+		stack.pop_back();
+		float distance;
+		for (std::uint32_t i = node.first_object; i != kNone; i = objects_[i].next) {
+			if (slab_ray.Intersect(objects_[i].bounds, kInfinity, distance)) {
+				result.emplace_back(i, distance);
+			}
+		}
+		for (const std::uint32_t child : node.children) {
+			if (child != kNone && slab_ray.Intersect(LooseBounds(nodes_[child]), kInfinity, distance)) {
+				stack.push_back(child);
+			}
+		}
+	}
+	std::sort(result.begin() + first, result.end(),
+		[](const auto& a, const auto& b) { return a.second < b.second; });
+}
+
+AABB3 Octree::LooseBounds(const Node& node) const
+{
+	const float half = node.half_size * looseness_;
+	const Vector3f extent{ half, half, half };
+	return { node.center - extent, node.center + extent };
+}
+
+std::uint32_t Octree::TargetCode(const AABB3& bounds) const
+{
+	const Vector3f min = bounds.bottom_left() - world_min_;
+	const Vector3f max = bounds.top_right() - world_min_;
+	if (min.x < 0.0f || min.y < 0.0f || min.z < 0.0f ||
+		max.x > world_size_ || max.y > world_size_ || max.z > world_size_) {
+		return 1;
+	}
+
+	// Deepest level whose loose cells still fit the object
+	const Vector3f extent = bounds.extent();
+	const float object_half = std::max({ extent.x, extent.y, extent.z });
+	const float fit = looseness_ - 1.0f;
+	int depth = 0;
+	float half_size = world_size_ / 2.0f;
+	while (depth < max_depth_ && object_half <= fit * half_size / 2.0f) {
+		depth++;
+		half_size /= 2.0f;
+	}
+
+	const Vector3f center = bounds.center() - world_min_;
+	const std::uint32_t cells = 1u << depth;
+	auto cell = [&](float coordinate) {
+		const auto index = static_cast<std::uint32_t>(coordinate / world_size_ * cells);
+		return std::min(index, cells - 1);
+	};
+	const std::uint32_t morton = MortonEncode32(cell(center.x), cell(center.y), cell(center.z));
+	return (1u << (3 * depth)) | morton;
+}
+
+std::uint32_t Octree::FindOrCreateNode(std::uint32_t code)
+{
+	const int depth = (std::bit_width(code) - 1) / 3;
+	std::uint32_t node = 0;
+	for (int level = depth - 1; level >= 0; level--) {
+		const std::uint32_t child = (code >> (3 * level)) & 7;
+		if (nodes_[node].children[child] == kNone) {
+			Node created;
+			const float half = nodes_[node].half_size / 2.0f;
+			created.center = nodes_[node].center + Vector3f{
+				(child & 1) ? half : -half, (child & 2) ? half : -half, (child & 4) ? half : -half };
+			created.half_size = half;
+			created.code = (nodes_[node].code << 3) | child;
+			created.parent = node;
+			created.depth = nodes_[node].depth + 1;
+			created.children.fill(kNone);
+
+			std::uint32_t index;
+			if (free_nodes_.empty()) {
+				index = static_cast<std::uint32_t>(nodes_.size());
+				nodes_.push_back(created);
+			} else {
+				index = free_nodes_.back();
+				free_nodes_.pop_back();
+				nodes_[index] = created;
+			}
+			nodes_[node].children[child] = index;
+		}
+		node = nodes_[node].children[child];
+	}
+	return node;
+}
+
+void Octree::Link(Handle handle, std::uint32_t node)
+{
+	Object& object = objects_[handle];
+	object.node = node;
+	object.previous = kNone;
+	object.next = nodes_[node].first_object;
+	if (object.next != kNone) {
+		objects_[object.next].previous = handle;
+	}
+	nodes_[node].first_object = handle;
+}
+
+void Octree::Unlink(Handle handle)
+{
+	Object& object = objects_[handle];
+	if (object.previous != kNone) {
+		objects_[object.previous].next = object.next;
+	} else {
+		nodes_[object.node].first_object = object.next;
+	}
+	if (object.next != kNone) {
+		objects_[object.next].previous = object.previous;
+	}
+	object.node = kNone;
+	object.previous = kNone;
+	object.next = kNone;
+}
+
+void Octree::Prune(std::uint32_t node)
+{
+	// Give back the empty leaves up to the first node still in use
+	while (node != 0) {
+		const Node& current = nodes_[node];
+		const bool has_children = std::any_of(current.children.begin(), current.children.end(),
+			[](std::uint32_t child) { return child != kNone; });
+		if (current.first_object != kNone || has_children) {
+			return;
+		}
+		const std::uint32_t parent = current.parent;
+		nodes_[parent].children[current.code & 7] = kNone;
+		free_nodes_.push_back(node);
+		node = parent;
+	}
+}
+
+void Octree::CollectSubtree(std::uint32_t node, std::vector<Handle>& result) const
+{
+	std::vector<std::uint32_t> stack{ node };
+	while (!stack.empty()) {
+		const Node& current = nodes_[stack.back()];
+		stack.pop_back();
+		for (std::uint32_t i = current.first_object; i != kNone; i = objects_[i].next) {
+			result.push_back(i);
+		}
+		for (const std::uint32_t child : current.children) {
+			if (child != kNone) {
+				stack.push_back(child);
+			}
+		}
+	}
+}
+
+} // namespace maths
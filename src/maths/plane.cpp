@@ -0,0 +1,127 @@
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "maths/plane.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "maths/simd.h"
+
+namespace maths {
+
+PlaneSide Plane::Classify(const Vector3f& point, float epsilon) const
+{
+	const float distance = Distance(point);
+	if (distance > epsilon) {
+		return PlaneSide::kFront;
+	}
+	if (distance < -epsilon) {
+		return PlaneSide::kBack;
+	}
+	return PlaneSide::kStraddle;
+}
+
+PlaneSide Plane::Classify(const AABB3& aabb) const
+{
+	const Vector3f extent = aabb.extent();
+	// Projection of the half extents on the normal
+	const float radius = extent.x * std::abs(normal_.x) + extent.y * std::abs(normal_.y)
+		+ extent.z * std::abs(normal_.z);
+	const float distance = Distance(aabb.center());
+	if (distance > radius) {
+		return PlaneSide::kFront;
+	}
+	if (distance < -radius) {
+		return PlaneSide::kBack;
+	}
+	return PlaneSide::kStraddle;
+}
+
+PlaneSide Plane::Classify(const Sphere& sphere) const
+{
+	const float distance = Distance(sphere.center());
+	if (distance > sphere.radius()) {
+		return PlaneSide::kFront;
+	}
+	if (distance < -sphere.radius()) {
+		return PlaneSide::kBack;
+	}
+	return PlaneSide::kStraddle;
+}
+
+void Plane::DistanceBatch(std::span<const float> x, std::span<const float> y,
+	std::span<const float> z, std::span<float> distances) const
+{
+	const std::size_t count = std::min({ x.size(), y.size(), z.size(), distances.size() });
+	const Float4 nx(normal_.x), ny(normal_.y), nz(normal_.z), d(d_);
+	std::size_t i = 0;
+	for (; i + Float4::kWidth <= count; i += Float4::kWidth) {
+		const Float4 distance = Float4::MulAdd(nx, Float4::Load(&x[i]),
+			Float4::MulAdd(ny, Float4::Load(&y[i]), Float4::MulAdd(nz, Float4::Load(&z[i]), d)));
+		distance.Store(&distances[i]);
+	}
+	for (; i < count; i++) {
+		distances[i] = Distance(Vector3f{ x[i], y[i], z[i] });
+	}
+}
+
+PlaneSide Plane::ClassifyBatch(std::span<const float> x, std::span<const float> y,
+	std::span<const float> z, std::span<PlaneSide> sides, float epsilon) const
+{
+	const std::size_t count = std::min({ x.size(), y.size(), z.size(), sides.size() });
+	const Float4 nx(normal_.x), ny(normal_.y), nz(normal_.z), d(d_);
+	const Float4 front_limit(epsilon), back_limit(-epsilon);
+	int front_count = 0;
+	int back_count = 0;
+	std::size_t i = 0;
+	for (; i + Float4::kWidth <= count; i += Float4::kWidth) {
+		const Float4 distance = Float4::MulAdd(nx, Float4::Load(&x[i]),
+			Float4::MulAdd(ny, Float4::Load(&y[i]), Float4::MulAdd(nz, Float4::Load(&z[i]), d)));
+		const int front = (distance > front_limit).MoveMask();
+		const int back = (distance < back_limit).MoveMask();
+		for (std::size_t lane = 0; lane < Float4::kWidth; lane++) {
+			const bool is_front = (front >> lane) & 1;
+			const bool is_back = (back >> lane) & 1;
+			sides[i + lane] = is_front ? PlaneSide::kFront : is_back ? PlaneSide::kBack : PlaneSide::kStraddle;
+			front_count += is_front;
+			back_count += is_back;
+		}
+	}
+	for (; i < count; i++) {
+		sides[i] = Classify(Vector3f{ x[i], y[i], z[i] }, epsilon);
+		front_count += sides[i] == PlaneSide::kFront;
+		back_count += sides[i] == PlaneSide::kBack;
+	}
+
+	if (count != 0 && front_count == static_cast<int>(count)) {
+		return PlaneSide::kFront;
+	}
+	if (count != 0 && back_count == static_cast<int>(count)) {
+		return PlaneSide::kBack;
+	}
+	return PlaneSide::kStraddle;
+}
+
+} // namespace maths
@@ -0,0 +1,210 @@
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "maths/projection.h"
+
+#include <cmath>
+
+namespace maths {
+
+namespace {
+
+// Depth row of a perspective projection: z_clip = a * z + b, w_clip = -z
+struct PerspectiveDepth {
+	float a;
+	float b;
+};
+
+PerspectiveDepth DepthTerms(float near_plane, float far_plane, ClipDepth depth)
+{
+	const float inverse_range = 1.0f / (near_plane - far_plane);
+	if (depth == ClipDepth::kZeroToOne) {
+		return { far_plane * inverse_range, far_plane * near_plane * inverse_range };
+	}
+	return { (far_plane + near_plane) * inverse_range, 2.0f * far_plane * near_plane * inverse_range };
+}
+
+Matrix4f PerspectiveMatrix(float scale_x, float scale_y, PerspectiveDepth terms)
+{
+	return { Vector4f(scale_x, 0.0f, 0.0f, 0.0f),
+		Vector4f(0.0f, scale_y, 0.0f, 0.0f),
+		Vector4f(0.0f, 0.0f, terms.a, -1.0f),
+		Vector4f(0.0f, 0.0f, terms.b, 0.0f) };
+}
+
+// z = -w_clip and w = (z_clip + a * w_clip) / b
+Matrix4f PerspectiveInverseMatrix(float scale_x, float scale_y, PerspectiveDepth terms)
+{
+	return { Vector4f(1.0f / scale_x, 0.0f, 0.0f, 0.0f),
+		Vector4f(0.0f, 1.0f / scale_y, 0.0f, 0.0f),
+		Vector4f(0.0f, 0.0f, 0.0f, 1.0f / terms.b),
+		Vector4f(0.0f, 0.0f, -1.0f, terms.a / terms.b) };
+}
+
+// Side planes through the eye, tan_x and tan_y are the slopes of the edges
+std::array<Plane, 6> PerspectivePlanes(float tan_x, float tan_y, float near_plane)
+{
+	const float side_x = 1.0f / std::sqrt(1.0f + tan_x * tan_x);
+	const float side_y = 1.0f / std::sqrt(1.0f + tan_y * tan_y);
+	std::array<Plane, 6> planes;
+	planes[0] = Plane{ Vector3f{ 0.0f, 0.0f, -1.0f }, -near_plane };
+	planes[2] = Plane{ Vector3f{ side_x, 0.0f, -tan_x * side_x }, 0.0f };
+	planes[3] = Plane{ Vector3f{ -side_x, 0.0f, -tan_x * side_x }, 0.0f };
+	planes[4] = Plane{ Vector3f{ 0.0f, -side_y, -tan_y * side_y }, 0.0f };
+	planes[5] = Plane{ Vector3f{ 0.0f, side_y, -tan_y * side_y }, 0.0f };
+	return planes;
+}
+
+// Clip coordinate = scale * view coordinate + offset on each axis
+struct OrthographicTerms {
+	Vector3f scale;
+	Vector3f offset;
+};
+
+OrthographicTerms OrthographicAxes(float left, float right, float bottom, float top, float near_plane,
+	float far_plane, ClipDepth depth)
+{
+	const float width = right - left;
+	const float height = top - bottom;
+	const float range = far_plane - near_plane;
+	OrthographicTerms terms{ Vector3f{ 2.0f / width, 2.0f / height, -2.0f / range },
+		Vector3f{ -(right + left) / width, -(top + bottom) / height, -(far_plane + near_plane) / range } };
+	if (depth == ClipDepth::kZeroToOne) {
+		terms.scale.z = -1.0f / range;
+		terms.offset.z = -near_plane / range;
+	}
+	return terms;
+}
+
+struct CameraBasis {
+	Vector3f side;
+	Vector3f up;
+	Vector3f forward;
+};
+
+CameraBasis LookAtBasis(const Vector3f& eye, const Vector3f& target, const Vector3f& up)
+{
+	const Vector3f forward = (target - eye).Normalized();
+	const Vector3f side = Vector3f::Cross(forward, up).Normalized();
+	return { side, Vector3f::Cross(side, forward), forward };
+}
+
+} // namespace
+
+Matrix4f Perspective(radian_t fov_y, float aspect, float near_plane, float far_plane, ClipDepth depth)
+{
+	const float scale_y = 1.0f / tan(fov_y * 0.5f);
+	return PerspectiveMatrix(scale_y / aspect, scale_y, DepthTerms(near_plane, far_plane, depth));
+}
+
+Matrix4f PerspectiveInverse(radian_t fov_y, float aspect, float near_plane, float far_plane, ClipDepth depth)
+{
+	const float scale_y = 1.0f / tan(fov_y * 0.5f);
+	return PerspectiveInverseMatrix(scale_y / aspect, scale_y, DepthTerms(near_plane, far_plane, depth));
+}
+
+Frustum PerspectiveFrustum(radian_t fov_y, float aspect, float near_plane, float far_plane)
+{
+	const float tan_y = tan(fov_y * 0.5f);
+	std::array<Plane, 6> planes = PerspectivePlanes(tan_y * aspect, tan_y, near_plane);
+	planes[1] = Plane{ Vector3f{ 0.0f, 0.0f, 1.0f }, far_plane };
+	return Frustum(planes);
+}
+
+Matrix4f PerspectiveReverseZ(radian_t fov_y, float aspect, float near_plane)
+{
+	// Limit of the [0, 1] projection with near and far swapped as far goes
+	// to infinity: z_clip = near_plane
+	const float scale_y = 1.0f / tan(fov_y * 0.5f);
+	return PerspectiveMatrix(scale_y / aspect, scale_y, { 0.0f, near_plane });
+}
+
+Matrix4f PerspectiveReverseZInverse(radian_t fov_y, float aspect, float near_plane)
+{
+	const float scale_y = 1.0f / tan(fov_y * 0.5f);
+	return PerspectiveInverseMatrix(scale_y / aspect, scale_y, { 0.0f, near_plane });
+}
+
+Frustum PerspectiveReverseZFrustum(radian_t fov_y, float aspect, float near_plane)
+{
+	const float tan_y = tan(fov_y * 0.5f);
+	std::array<Plane, 6> planes = PerspectivePlanes(tan_y * aspect, tan_y, near_plane);
+	// No far plane, like the degenerate planes of Frustum(const Matrix4f&)
+	planes[1] = Frustum::OpenPlane();
+	return Frustum(planes);
+}
+
+Matrix4f Orthographic(float left, float right, float bottom, float top, float near_plane, float far_plane,
+	ClipDepth depth)
+{
+	const OrthographicTerms terms = OrthographicAxes(left, right, bottom, top, near_plane, far_plane, depth);
+	return { Vector4f(terms.scale.x, 0.0f, 0.0f, 0.0f),
+		Vector4f(0.0f, terms.scale.y, 0.0f, 0.0f),
+		Vector4f(0.0f, 0.0f, terms.scale.z, 0.0f),
+		Vector4f(terms.offset.x, terms.offset.y, terms.offset.z, 1.0f) };
+}
+
+Matrix4f OrthographicInverse(float left, float right, float bottom, float top, float near_plane,
+	float far_plane, ClipDepth depth)
+{
+	const OrthographicTerms terms = OrthographicAxes(left, right, bottom, top, near_plane, far_plane, depth);
+	const Vector3f inverse_scale{ 1.0f / terms.scale.x, 1.0f / terms.scale.y, 1.0f / terms.scale.z };
+	return { Vector4f(inverse_scale.x, 0.0f, 0.0f, 0.0f),
+		Vector4f(0.0f, inverse_scale.y, 0.0f, 0.0f),
+		Vector4f(0.0f, 0.0f, inverse_scale.z, 0.0f),
+		Vector4f(-terms.offset.x * inverse_scale.x, -terms.offset.y * inverse_scale.y,
+			-terms.offset.z * inverse_scale.z, 1.0f) };
+}
+
+Frustum OrthographicFrustum(float left, float right, float bottom, float top, float near_plane, float far_plane)
+{
+	return Frustum(std::array<Plane, 6>{
+		Plane{ Vector3f{ 0.0f, 0.0f, -1.0f }, -near_plane },
+		Plane{ Vector3f{ 0.0f, 0.0f, 1.0f }, far_plane },
+		Plane{ Vector3f{ 1.0f, 0.0f, 0.0f }, -left },
+		Plane{ Vector3f{ -1.0f, 0.0f, 0.0f }, right },
+		Plane{ Vector3f{ 0.0f, -1.0f, 0.0f }, top },
+		Plane{ Vector3f{ 0.0f, 1.0f, 0.0f }, -bottom } });
+}
+
+Matrix4f LookAt(const Vector3f& eye, const Vector3f& target, const Vector3f& up)
+{
+	// Rows side, up and -forward, then the eye moved to the origin
+	const CameraBasis basis = LookAtBasis(eye, target, up);
+	return { Vector4f(basis.side.x, basis.up.x, -basis.forward.x, 0.0f),
+		Vector4f(basis.side.y, basis.up.y, -basis.forward.y, 0.0f),
+		Vector4f(basis.side.z, basis.up.z, -basis.forward.z, 0.0f),
+		Vector4f(-Vector3f::Dot(basis.side, eye), -Vector3f::Dot(basis.up, eye),
+			Vector3f::Dot(basis.forward, eye), 1.0f) };
+}
+
+Matrix4f LookAtInverse(const Vector3f& eye, const Vector3f& target, const Vector3f& up)
+{
+	const CameraBasis basis = LookAtBasis(eye, target, up);
+	return { Vector4f(basis.side.x, basis.side.y, basis.side.z, 0.0f),
+		Vector4f(basis.up.x, basis.up.y, basis.up.z, 0.0f),
+		Vector4f(-basis.forward.x, -basis.forward.y, -basis.forward.z, 0.0f),
+		Vector4f(eye.x, eye.y, eye.z, 1.0f) };
+}
+
+} // namespace maths
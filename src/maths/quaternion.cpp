@@ -0,0 +1,136 @@
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "maths/quaternion.h"
+
+#include <cmath>
+
+namespace maths {
+
+Quaternion::Quaternion(float x, float y, float z, float w)
+    : x(x),
+      y(y),
+      z(z),
+      w(w) {
+}
+
+Quaternion Quaternion::FromAxisAngle(const Vector3f& axis, radian_t angle) {
+    const float half_sin = sin(angle * 0.5f);
+    return {axis.x * half_sin, axis.y * half_sin, axis.z * half_sin, cos(angle * 0.5f)};
+}
+
+Quaternion Quaternion::FromRotationMatrix(const Matrix4f& matrix) {
+    // m[column][row], the largest of w, x, y, z is recovered from the
+    // diagonal first so the division never loses precision
+    const Matrix4f& m = matrix;
+    const float trace = m[0][0] + m[1][1] + m[2][2];
+    if (trace > 0.0f) {
+        const float s = 2.0f * std::sqrt(trace + 1.0f);
+        return {(m[1][2] - m[2][1]) / s, (m[2][0] - m[0][2]) / s, (m[0][1] - m[1][0]) / s, 0.25f * s};
+    }
+    if (m[0][0] > m[1][1] && m[0][0] > m[2][2]) {
+        const float s = 2.0f * std::sqrt(1.0f + m[0][0] - m[1][1] - m[2][2]);
+        return {0.25f * s, (m[1][0] + m[0][1]) / s, (m[2][0] + m[0][2]) / s, (m[1][2] - m[2][1]) / s};
+    }
+    if (m[1][1] > m[2][2]) {
+        const float s = 2.0f * std::sqrt(1.0f + m[1][1] - m[0][0] - m[2][2]);
+        return {(m[1][0] + m[0][1]) / s, 0.25f * s, (m[2][1] + m[1][2]) / s, (m[2][0] - m[0][2]) / s};
+    }
+    const float s = 2.0f * std::sqrt(1.0f + m[2][2] - m[0][0] - m[1][1]);
+    return {(m[2][0] + m[0][2]) / s, (m[2][1] + m[1][2]) / s, 0.25f * s, (m[0][1] - m[1][0]) / s};
+}
+
+Quaternion Quaternion::Identity() {
+    return {};
+}
+
+Quaternion Quaternion::operator*(const Quaternion& rhs) const {
+    return {w * rhs.x + x * rhs.w + y * rhs.z - z * rhs.y,
+            w * rhs.y - x * rhs.z + y * rhs.w + z * rhs.x,
+            w * rhs.z + x * rhs.y - y * rhs.x + z * rhs.w,
+            w * rhs.w - x * rhs.x - y * rhs.y - z * rhs.z};
+}
+
+Quaternion Quaternion::operator*(float scalar) const {
+    return {x * scalar, y * scalar, z * scalar, w * scalar};
+}
+
+Quaternion Quaternion::operator+(const Quaternion& rhs) const {
+    return {x + rhs.x, y + rhs.y, z + rhs.z, w + rhs.w};
+}
+
+Quaternion Quaternion::operator-() const {
+    return {-x, -y, -z, -w};
+}
+
+bool Quaternion::operator==(const Quaternion& rhs) const {
+    return x == rhs.x && y == rhs.y && z == rhs.z && w == rhs.w;
+}
+
+Quaternion Quaternion::Conjugate() const {
+    return {-x, -y, -z, w};
+}
+
+float Quaternion::Dot(const Quaternion& rhs) const {
+    return x * rhs.x + y * rhs.y + z * rhs.z + w * rhs.w;
+}
+
+float Quaternion::Magnitude() const {
+    return std::sqrt(Dot(*this));
+}
+
+Quaternion Quaternion::Normalized() const {
+    return *this * (1.0f / Magnitude());
+}
+
+Vector3f Quaternion::Rotate(const Vector3f& v) const {
+    // v + w * t + q x t with t = 2 * (q x v)
+    const float tx = 2.0f * (y * v.z - z * v.y);
+    const float ty = 2.0f * (z * v.x - x * v.z);
+    const float tz = 2.0f * (x * v.y - y * v.x);
+    return {v.x + w * tx + y * tz - z * ty,
+            v.y + w * ty + z * tx - x * tz,
+            v.z + w * tz + x * ty - y * tx};
+}
+
+Quaternion Quaternion::Nlerp(const Quaternion& a, const Quaternion& b, float t) {
+    // q and -q are the same rotation, take the closest one
+    const Quaternion target = a.Dot(b) < 0.0f ? -b : b;
+    return (a * (1.0f - t) + target * t).Normalized();
+}
+
+Quaternion Quaternion::Slerp(const Quaternion& a, const Quaternion& b, float t) {
+    float cos_angle = a.Dot(b);
+    const Quaternion target = cos_angle < 0.0f ? -b : b;
+    cos_angle = std::abs(cos_angle);
+    // Nearly parallel, the sine below would lose all precision
+    if (cos_angle > 0.9995f) {
+        return Nlerp(a, target, t);
+    }
+    const float angle = std::acos(cos_angle);
+    const float inverse_sin = 1.0f / std::sin(angle);
+    return a * (std::sin((1.0f - t) * angle) * inverse_sin) + target * (std::sin(t * angle) * inverse_sin);
+}
+
+} // namespace maths
@@ -23,8 +23,178 @@ SOFTWARE.
 */
 #include "maths/ray2.h"
 
+#include <algorithm>
+#include <bit>
+
+#include "maths/simd.h"
+
 namespace maths {
 
+namespace {
+
+// 256 obstacles of an AABB2SoA are 4 KB, a tile of rays reuses them from L1
+constexpr std::size_t kObstacleTile = 256;
+constexpr std::size_t kRayTile = 64;
+
+// Ray constants broadcast once per query instead of once per obstacle
+struct Ray2Lanes {
+    explicit Ray2Lanes(const Ray2& ray)
+        : origin_x(ray.origin().x), origin_y(ray.origin().y),
+          direction_x(ray.direction().x), direction_y(ray.direction().y),
+          inv_direction_x(1.0f / ray.direction().x), inv_direction_y(1.0f / ray.direction().y),
+          inv_sqr_length(1.0f / ray.direction().SqrMagnitude()) {}
+
+    Float4 origin_x;
+    Float4 origin_y;
+    Float4 direction_x;
+    Float4 direction_y;
+    Float4 inv_direction_x;
+    Float4 inv_direction_y;
+    Float4 inv_sqr_length;
+};
+
+// Running nearest hit of one ray, one candidate per lane. Indices are kept
+// as raw bits in float lanes and only ever moved by Select.
+class NearestLanes {
+public:
+    explicit NearestLanes(const Ray2Hit& hit)
+        : t_(hit.t), index_(std::bit_cast<float>(hit.index)) {}
+
+    Float4 t() const { return t_; }
+
+    void Update(Float4 mask, Float4 t, std::size_t first_index) {
+        if (mask.MoveMask() == 0) {
+            return;
+        }
+        const auto first = static_cast<std::uint32_t>(first_index);
+        const Float4 indices(std::bit_cast<float>(first), std::bit_cast<float>(first + 1),
+            std::bit_cast<float>(first + 2), std::bit_cast<float>(first + 3));
+        t_ = Float4::Select(mask, t, t_);
+        index_ = Float4::Select(mask, indices, index_);
+    }
+
+    // Lanes only move to strictly smaller t, so the lowest t then the lowest
+    // index wins whatever lane or tile it was found in.
+    void Reduce(Ray2Hit& hit) const {
+        alignas(16) float t[4];
+        alignas(16) float index[4];
+        t_.StoreAligned(t);
+        index_.StoreAligned(index);
+        for (std::size_t k = 0; k < 4; k++) {
+            const auto lane_index = std::bit_cast<std::uint32_t>(index[k]);
+            if (t[k] < hit.t || (t[k] == hit.t && lane_index < hit.index)) {
+                hit.t = t[k];
+                hit.index = lane_index;
+            }
+        }
+    }
+
+private:
+    Float4 t_;
+    Float4 index_;
+};
+
+// Lanes data[begin, begin + count), zero past count
+Float4 LoadObstacles(std::span<const float> data, std::size_t begin, std::size_t count) {
+    if (count >= 4) {
+        return Float4::Load(data.data() + begin);
+    }
+    alignas(16) float lanes[4] = {};
+    for (std::size_t k = 0; k < count; k++) {
+        lanes[k] = data[begin + k];
+    }
+    return Float4::LoadAligned(lanes);
+}
+
+// Mask of the lanes below count
+Float4 ValidLanes(std::size_t count) {
+    return Float4(0.0f, 1.0f, 2.0f, 3.0f) < Float4(static_cast<float>(count));
+}
+
+std::size_t ObstacleCount(const CircleSoA& circles) {
+    return std::min({ circles.center_x.size(), circles.center_y.size(), circles.radius.size() });
+}
+
+std::size_t ObstacleCount(const AABB2SoA& aabbs) {
+    return std::min({ aabbs.min_x.size(), aabbs.min_y.size(), aabbs.max_x.size(), aabbs.max_y.size() });
+}
+
+// Roots of |origin + t * direction - center|^2 = radius^2. Inside the
+// circle the entry root is negative and clamped to 0; outside, both roots
+// are behind the origin unless b < 0.
+void NearestObstacles(const Ray2Lanes& ray, const CircleSoA& circles,
+    std::size_t begin, std::size_t end, NearestLanes& nearest) {
+    const Float4 zero = Float4::Zero();
+    for (std::size_t i = begin; i < end; i += 4) {
+        const std::size_t count = end - i;
+        const Float4 mx = ray.origin_x - LoadObstacles(circles.center_x, i, count);
+        const Float4 my = ray.origin_y - LoadObstacles(circles.center_y, i, count);
+        const Float4 radius = LoadObstacles(circles.radius, i, count);
+        const Float4 b = mx * ray.direction_x + my * ray.direction_y;
+        const Float4 c = mx * mx + my * my - radius * radius;
+        // Discriminant divided by the squared direction length
+        const Float4 discriminant = b * b * ray.inv_sqr_length - c;
+        const Float4 entry = (-b * ray.inv_sqr_length)
+            - Float4::Sqrt(Float4::Max(discriminant, zero) * ray.inv_sqr_length);
+        const Float4 t = Float4::Max(entry, zero);
+        const Float4 hit = (discriminant >= zero) & ((c <= zero) | (b < zero))
+            & (t < nearest.t()) & ValidLanes(count);
+        nearest.Update(hit, t, i);
+    }
+}
+
+// Slab test with the reciprocal direction of the query
+void NearestObstacles(const Ray2Lanes& ray, const AABB2SoA& aabbs,
+    std::size_t begin, std::size_t end, NearestLanes& nearest) {
+    const Float4 zero = Float4::Zero();
+    for (std::size_t i = begin; i < end; i += 4) {
+        const std::size_t count = end - i;
+        const Float4 t1x = (LoadObstacles(aabbs.min_x, i, count) - ray.origin_x) * ray.inv_direction_x;
+        const Float4 t2x = (LoadObstacles(aabbs.max_x, i, count) - ray.origin_x) * ray.inv_direction_x;
+        const Float4 t1y = (LoadObstacles(aabbs.min_y, i, count) - ray.origin_y) * ray.inv_direction_y;
+        const Float4 t2y = (LoadObstacles(aabbs.max_y, i, count) - ray.origin_y) * ray.inv_direction_y;
+        const Float4 t_min = Float4::Max(Float4::Max(Float4::Min(t1x, t2x), Float4::Min(t1y, t2y)), zero);
+        const Float4 t_max = Float4::Min(Float4::Max(t1x, t2x), Float4::Max(t1y, t2y));
+        const Float4 hit = (t_min <= t_max) & (t_min < nearest.t()) & ValidLanes(count);
+        nearest.Update(hit, t_min, i);
+    }
+}
+
+template<typename Obstacles>
+Ray2Hit Nearest(const Ray2& ray, const Obstacles& obstacles, float max_t) {
+    Ray2Hit hit{ kNoRay2Hit, max_t };
+    NearestLanes nearest(hit);
+    NearestObstacles(Ray2Lanes(ray), obstacles, 0, ObstacleCount(obstacles), nearest);
+    nearest.Reduce(hit);
+    return hit;
+}
+
+template<typename Obstacles>
+void NearestBatch(std::span<const Ray2> rays, const Obstacles& obstacles,
+    std::span<Ray2Hit> hits, float max_t, JobSystem& jobs) {
+    const std::size_t count = std::min(rays.size(), hits.size());
+    const std::size_t obstacle_count = ObstacleCount(obstacles);
+    const std::size_t grain = std::max<std::size_t>(1, jobs.GrainSize(count, 1));
+    jobs.ParallelFor(0, count, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t ray_begin = begin; ray_begin < end; ray_begin += kRayTile) {
+            const std::size_t ray_end = std::min(end, ray_begin + kRayTile);
+            for (std::size_t r = ray_begin; r < ray_end; r++) {
+                hits[r] = Ray2Hit{ kNoRay2Hit, max_t };
+            }
+            for (std::size_t tile = 0; tile < obstacle_count; tile += kObstacleTile) {
+                const std::size_t tile_end = std::min(obstacle_count, tile + kObstacleTile);
+                for (std::size_t r = ray_begin; r < ray_end; r++) {
+                    NearestLanes nearest(hits[r]);
+                    NearestObstacles(Ray2Lanes(rays[r]), obstacles, tile, tile_end, nearest);
+                    nearest.Reduce(hits[r]);
+                }
+            }
+        }
+    }, grain);
+}
+
+} // namespace
+
 bool Ray2::IntersectCircle(const Circle& circle) {
     float distance;
     Vector2f v = circle.center() - origin();
@@ -105,4 +275,22 @@ bool Ray2::IntersectAABB2(const AABB2& aabb) {
     return true;
 }
 
+Ray2Hit IntersectNearest(const Ray2& ray, const CircleSoA& circles, float max_t) {
+    return Nearest(ray, circles, max_t);
+}
+
+Ray2Hit IntersectNearest(const Ray2& ray, const AABB2SoA& aabbs, float max_t) {
+    return Nearest(ray, aabbs, max_t);
+}
+
+void IntersectNearestBatch(std::span<const Ray2> rays, const CircleSoA& circles,
+    std::span<Ray2Hit> hits, float max_t, JobSystem& jobs) {
+    NearestBatch(rays, circles, hits, max_t, jobs);
+}
+
+void IntersectNearestBatch(std::span<const Ray2> rays, const AABB2SoA& aabbs,
+    std::span<Ray2Hit> hits, float max_t, JobSystem& jobs) {
+    NearestBatch(rays, aabbs, hits, max_t, jobs);
+}
+
 } // namespace maths
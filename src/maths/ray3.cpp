@@ -24,20 +24,30 @@ SOFTWARE.
 
 #include "maths/ray3.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#include "maths/instrumentation.h"
+
 namespace maths {
 
 bool Ray3::IntersectSphere(const Sphere& sphere) {
 
+    MATHS_COUNT(kRaySphere);
     const Vector3f v = sphere.center() - origin_;
     const float d = v.Dot(unit_direction_); // Distance to closest point to sphere center
     float distance;
     if (d < 0) {
+        MATHS_COUNT_EXIT(kRaySphere, 0);
         return false;
     }
 
     const float squaredDistance = v.Dot(v) - (d * d); // squared Distance between closest point to sphere center
     const float radius2 = sphere.radius() * sphere.radius();
     if (squaredDistance > radius2) {
+        MATHS_COUNT_EXIT(kRaySphere, 1);
         return false;
     }
 
@@ -60,16 +70,18 @@ bool Ray3::IntersectSphere(const Sphere& sphere) {
     }
 
     if (!hasHit) {
+        MATHS_COUNT_EXIT(kRaySphere, 2);
         return false;
     }
 
     // calculate the position where the ray hit
     hit_position_ = origin_ + unit_direction_ * distance;
-    return true;
+    return MATHS_COUNT_HIT(kRaySphere, true);
 }
 
 bool Ray3::IntersectAABB3(const AABB3& aabb) {
 
+    MATHS_COUNT(kRayAABB);
     const Vector3f lb = aabb.bottom_left();
     const Vector3f rt = aabb.top_right();
     Vector3f dirfrac;
@@ -93,11 +105,13 @@ bool Ray3::IntersectAABB3(const AABB3& aabb) {
 
     // if tmax < 0, ray is intersecting AABB, but the whole AABB is behind
     if (tmax < 0) {
+        MATHS_COUNT_EXIT(kRayAABB, 0);
         return false;
     }
 
     // if tmin > tmax, ray doesn't intersect AABB
     if (tmin > tmax) {
+        MATHS_COUNT_EXIT(kRayAABB, 1);
         return false;
     }
 
@@ -105,23 +119,118 @@ bool Ray3::IntersectAABB3(const AABB3& aabb) {
 
     // calculate the position where the ray hit
     hit_position_ = origin_ + direction_ * distance;
-    return true;
+    return MATHS_COUNT_HIT(kRayAABB, true);
 }
 
 bool Ray3::IntersectPlane(const Plane& plane) {
+    MATHS_COUNT(kRayPlane);
     const float s = direction_.Dot(plane.normal());
     if (s > 0) {
+        MATHS_COUNT_EXIT(kRayPlane, 0);
         return false;
     }
     const float distance = (plane.Distance(plane.point()) - origin_.Dot(
                           plane.normal())) / s;
     if (distance < 0) {
+        MATHS_COUNT_EXIT(kRayPlane, 1);
         return false;
     }
 
     // calculate the position where the ray hit
     hit_position_ = origin_ + (direction_ * distance);
-    return true;
+    return MATHS_COUNT_HIT(kRayPlane, true);
+}
+
+bool Ray3::IntersectTriangle(const Vector3f& a, const Vector3f& b, const Vector3f& c,
+                             TriangleHit& hit) const {
+    return WatertightRay(*this).Intersect(a, b, c, std::numeric_limits<float>::infinity(), hit);
+}
+
+bool Ray3::IntersectSphere(const Sphered& sphere, const Vector3d& origin_shift) {
+    return IntersectSphere(sphere.RelativeTo(origin_shift));
+}
+
+bool Ray3::IntersectAABB3(const AABB3d& aabb, const Vector3d& origin_shift) {
+    return IntersectAABB3(aabb.RelativeTo(origin_shift));
+}
+
+SlabRay::SlabRay(const Ray3& ray)
+    : origin(ray.origin()),
+      inverse_direction{ 1.0f / ray.direction().x, 1.0f / ray.direction().y, 1.0f / ray.direction().z } {}
+
+bool SlabRay::Intersect(const AABB3& aabb, float max_distance, float& distance) const {
+    MATHS_COUNT(kRaySlab);
+    // Raw coordinates, Vector3f::operator[] is not inlined
+    const Vector3f bottom_left = aabb.bottom_left();
+    const Vector3f top_right = aabb.top_right();
+    float t_min = 0.0f;
+    float t_max = max_distance;
+    for (int axis = 0; axis < 3; axis++) {
+        const float t1 = (bottom_left.coord[axis] - origin.coord[axis]) * inverse_direction.coord[axis];
+        const float t2 = (top_right.coord[axis] - origin.coord[axis]) * inverse_direction.coord[axis];
+        t_min = std::max(t_min, std::min(t1, t2));
+        t_max = std::min(t_max, std::max(t1, t2));
+    }
+    distance = t_min;
+    return MATHS_COUNT_HIT(kRaySlab, t_min <= t_max);
+}
+
+WatertightRay::WatertightRay(const Ray3& ray) : origin(ray.origin()) {
+    const Vector3f direction = ray.direction();
+    const float abs_direction[3] = { std::abs(direction.x), std::abs(direction.y), std::abs(direction.z) };
+    kz = abs_direction[0] > abs_direction[1] ? (abs_direction[0] > abs_direction[2] ? 0 : 2)
+                                             : (abs_direction[1] > abs_direction[2] ? 1 : 2);
+    kx = (kz + 1) % 3;
+    ky = (kx + 1) % 3;
+    // Keep the winding when looking down -z
+    if (direction[kz] < 0.0f) {
+        std::swap(kx, ky);
+    }
+    shear_x = direction[kx] / direction[kz];
+    shear_y = direction[ky] / direction[kz];
+    shear_z = 1.0f / direction[kz];
+}
+
+bool WatertightRay::Intersect(const Vector3f& a, const Vector3f& b, const Vector3f& c,
+                              float max_distance, TriangleHit& hit) const {
+    MATHS_COUNT(kRayTriangle);
+    const Vector3f va = a - origin, vb = b - origin, vc = c - origin;
+    const float ax = va[kx] - shear_x * va[kz], ay = va[ky] - shear_y * va[kz];
+    const float bx = vb[kx] - shear_x * vb[kz], by = vb[ky] - shear_y * vb[kz];
+    const float cx = vc[kx] - shear_x * vc[kz], cy = vc[ky] - shear_y * vc[kz];
+
+    // Scaled barycentrics, recomputed in double when exactly on an edge
+    float u = cx * by - cy * bx;
+    float v = ax * cy - ay * cx;
+    float w = bx * ay - by * ax;
+    if (u == 0.0f || v == 0.0f || w == 0.0f) {
+        u = static_cast<float>(static_cast<double>(cx) * by - static_cast<double>(cy) * bx);
+        v = static_cast<float>(static_cast<double>(ax) * cy - static_cast<double>(ay) * cx);
+        w = static_cast<float>(static_cast<double>(bx) * ay - static_cast<double>(by) * ax);
+    }
+    if ((u < 0.0f || v < 0.0f || w < 0.0f) && (u > 0.0f || v > 0.0f || w > 0.0f)) {
+        MATHS_COUNT_EXIT(kRayTriangle, 0);
+        return false;
+    }
+    const float determinant = u + v + w;
+    if (determinant == 0.0f) {
+        MATHS_COUNT_EXIT(kRayTriangle, 1);
+        return false;
+    }
+
+    const float az = shear_z * va[kz], bz = shear_z * vb[kz], cz = shear_z * vc[kz];
+    const float scaled_distance = u * az + v * bz + w * cz;
+    // Same sign as the determinant and not past max_distance, without dividing
+    const float sign = determinant < 0.0f ? -1.0f : 1.0f;
+    if (scaled_distance * sign <= 0.0f || scaled_distance * sign > max_distance * determinant * sign) {
+        MATHS_COUNT_EXIT(kRayTriangle, 2);
+        return false;
+    }
+    const float inverse_determinant = 1.0f / determinant;
+    hit.distance = scaled_distance * inverse_determinant;
+    hit.u = v * inverse_determinant;
+    hit.v = w * inverse_determinant;
+    return MATHS_COUNT_HIT(kRayTriangle, true);
 }
 
 } // namespace maths
@@ -0,0 +1,483 @@
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "maths/scene_file.h"
+
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace maths {
+
+// Sections are read in place, so the file layout is the memory layout
+static_assert(std::endian::native == std::endian::little, "scene files are mapped without byte swapping");
+static_assert(std::is_trivially_copyable_v<AABB3> && sizeof(AABB3) == 24);
+static_assert(std::is_trivially_copyable_v<Sphere> && sizeof(Sphere) == 16);
+static_assert(std::is_trivially_copyable_v<Plane> && sizeof(Plane) == 16);
+static_assert(std::is_trivially_copyable_v<Matrix4f> && sizeof(Matrix4f) == 64);
+static_assert(std::is_trivially_copyable_v<BvhNode> && sizeof(BvhNode) == 32);
+static_assert(sizeof(SceneFileHeader) == 24 && sizeof(SceneSectionEntry) == 32);
+
+namespace {
+
+constexpr std::size_t kSceneSectionTable = sizeof(SceneFileHeader);
+
+std::uint32_t ElementSize(SceneSectionType type)
+{
+	switch (type) {
+	case SceneSectionType::kAABB3:
+		return sizeof(AABB3);
+	case SceneSectionType::kSphere:
+		return sizeof(Sphere);
+	case SceneSectionType::kPlane:
+		return sizeof(Plane);
+	case SceneSectionType::kMatrix4f:
+		return sizeof(Matrix4f);
+	case SceneSectionType::kBvhNodes:
+		return sizeof(BvhNode);
+	case SceneSectionType::kBvhItems:
+		return sizeof(std::uint32_t);
+	}
+	return 0;
+}
+
+std::size_t ElementAlignment(SceneSectionType type)
+{
+	switch (type) {
+	case SceneSectionType::kAABB3:
+		return alignof(AABB3);
+	case SceneSectionType::kSphere:
+		return alignof(Sphere);
+	case SceneSectionType::kPlane:
+		return alignof(Plane);
+	case SceneSectionType::kMatrix4f:
+		return alignof(Matrix4f);
+	case SceneSectionType::kBvhNodes:
+		return alignof(BvhNode);
+	case SceneSectionType::kBvhItems:
+		return alignof(std::uint32_t);
+	}
+	return 1;
+}
+
+std::span<const SceneSectionEntry> Entries(std::span<const std::byte> data)
+{
+	SceneFileHeader header;
+	std::memcpy(&header, data.data(), sizeof(header));
+	return { reinterpret_cast<const SceneSectionEntry*>(data.data() + kSceneSectionTable), header.section_count };
+}
+
+const SceneSectionEntry* FindEntry(std::span<const std::byte> data, SceneSectionType type, std::uint32_t tag)
+{
+	for (const SceneSectionEntry& entry : Entries(data)) {
+		if (entry.type == type && entry.tag == tag) {
+			return &entry;
+		}
+	}
+	return nullptr;
+}
+
+template<typename T>
+std::span<const T> SectionData(std::span<const std::byte> data, SceneSectionType type, std::uint32_t tag)
+{
+	const SceneSectionEntry* entry = FindEntry(data, type, tag);
+	if (entry == nullptr) {
+		return {};
+	}
+	return { reinterpret_cast<const T*>(data.data() + entry->offset), static_cast<std::size_t>(entry->count) };
+}
+
+SceneFileError ValidateBvh(std::span<const BvhNode> nodes, std::span<const std::uint32_t> items,
+	std::size_t item_limit)
+{
+	// Walk from the root: children may be stored before their parent
+	// (BuildLinear), so traversals cannot loop as long as every reachable
+	// node is reached exactly once. The depth is then bounded by the size.
+	std::vector<std::uint8_t> reached(nodes.size(), 0);
+	std::vector<std::uint32_t> stack;
+	if (!nodes.empty()) {
+		reached[0] = 1;
+		stack.push_back(0);
+	}
+	while (!stack.empty()) {
+		const BvhNode& node = nodes[stack.back()];
+		stack.pop_back();
+		if (node.IsLeaf()) {
+			if (node.first > items.size() || node.count > items.size() - node.first) {
+				return SceneFileError::kBadBvh;
+			}
+			continue;
+		}
+		if (node.first == 0 || node.first >= nodes.size() - 1
+			|| reached[node.first] || reached[node.first + 1]) {
+			return SceneFileError::kBadBvh;
+		}
+		reached[node.first] = reached[node.first + 1] = 1;
+		stack.push_back(node.first);
+		stack.push_back(node.first + 1);
+	}
+	for (std::uint32_t item : items) {
+		if (item >= item_limit) {
+			return SceneFileError::kBadBvh;
+		}
+	}
+	return SceneFileError::kNone;
+}
+
+} // namespace
+
+const char* ToString(SceneFileError error)
+{
+	switch (error) {
+	case SceneFileError::kNone:
+		return "none";
+	case SceneFileError::kOpenFailed:
+		return "open failed";
+	case SceneFileError::kTruncated:
+		return "truncated";
+	case SceneFileError::kBadMagic:
+		return "bad magic";
+	case SceneFileError::kBadVersion:
+		return "bad version";
+	case SceneFileError::kBadEndianness:
+		return "bad endianness";
+	case SceneFileError::kBadSection:
+		return "bad section";
+	case SceneFileError::kMisaligned:
+		return "misaligned";
+	case SceneFileError::kBadBvh:
+		return "bad bvh";
+	case SceneFileError::kBadAABB3:
+		return "bad aabb3";
+	}
+	return "unknown";
+}
+
+SceneFileError ValidateSceneFile(std::span<const std::byte> data, bool validate_contents)
+{
+	SceneFileHeader header;
+	if (data.size() < sizeof(header)) {
+		return SceneFileError::kTruncated;
+	}
+	std::memcpy(&header, data.data(), sizeof(header));
+	if (header.magic != kSceneFileMagic) {
+		return SceneFileError::kBadMagic;
+	}
+	if (header.endian_tag != kSceneEndianTag) {
+		return SceneFileError::kBadEndianness;
+	}
+	if (header.version != kSceneFileVersion) {
+		return SceneFileError::kBadVersion;
+	}
+	if (header.file_size != data.size()
+		|| header.section_count > (data.size() - kSceneSectionTable) / sizeof(SceneSectionEntry)) {
+		return SceneFileError::kTruncated;
+	}
+	if (reinterpret_cast<std::uintptr_t>(data.data()) % alignof(SceneSectionEntry) != 0) {
+		return SceneFileError::kMisaligned;
+	}
+
+	const std::span<const SceneSectionEntry> entries = Entries(data);
+	const std::uint64_t sections_begin = kSceneSectionTable + entries.size_bytes();
+	for (std::size_t i = 0; i < entries.size(); i++) {
+		const SceneSectionEntry& entry = entries[i];
+		const std::uint32_t element_size = ElementSize(entry.type);
+		if (element_size == 0 || entry.element_size != element_size) {
+			return SceneFileError::kBadSection;
+		}
+		for (std::size_t j = 0; j < i; j++) {
+			if (entries[j].type == entry.type && entries[j].tag == entry.tag) {
+				return SceneFileError::kBadSection;
+			}
+		}
+		if (entry.offset < sections_begin || entry.offset > data.size()
+			|| entry.count > (data.size() - entry.offset) / element_size) {
+			return SceneFileError::kTruncated;
+		}
+		if ((reinterpret_cast<std::uintptr_t>(data.data()) + entry.offset) % ElementAlignment(entry.type) != 0) {
+			return SceneFileError::kMisaligned;
+		}
+	}
+	if (!validate_contents) {
+		return SceneFileError::kNone;
+	}
+
+	for (const SceneSectionEntry& entry : entries) {
+		if (entry.type == SceneSectionType::kAABB3) {
+			// Ordered or exactly AABB3::Empty(), no NaN
+			const AABB3 empty = AABB3::Empty();
+			for (const AABB3& aabb : SectionData<AABB3>(data, entry.type, entry.tag)) {
+				const Vector3f min = aabb.bottom_left();
+				const Vector3f max = aabb.top_right();
+				const bool ordered = min.x <= max.x && min.y <= max.y && min.z <= max.z;
+				if (!ordered && std::memcmp(&aabb, &empty, sizeof(AABB3)) != 0) {
+					return SceneFileError::kBadAABB3;
+				}
+			}
+		}
+		if (entry.type == SceneSectionType::kBvhNodes) {
+			// Items index the AABB3 of the same tag when there are some
+			const std::span<const AABB3> aabbs = SectionData<AABB3>(data, SceneSectionType::kAABB3, entry.tag);
+			const SceneFileError error = ValidateBvh(
+				SectionData<BvhNode>(data, entry.type, entry.tag),
+				SectionData<std::uint32_t>(data, SceneSectionType::kBvhItems, entry.tag),
+				FindEntry(data, SceneSectionType::kAABB3, entry.tag) != nullptr
+					? aabbs.size() : std::numeric_limits<std::uint32_t>::max());
+			if (error != SceneFileError::kNone) {
+				return error;
+			}
+		}
+	}
+	return SceneFileError::kNone;
+}
+
+void SceneWriter::AddSection(SceneSectionType type, std::uint32_t tag, std::uint32_t element_size,
+	std::uint64_t count, const void* data)
+{
+	Section section{ type, tag, element_size, count, {} };
+	section.bytes.resize(element_size * count);
+	if (count != 0) {
+		std::memcpy(section.bytes.data(), data, section.bytes.size());
+	}
+	// A later section replaces the one of the same type and tag
+	for (Section& existing : sections_) {
+		if (existing.type == type && existing.tag == tag) {
+			existing = std::move(section);
+			return;
+		}
+	}
+	sections_.push_back(std::move(section));
+}
+
+void SceneWriter::Add(std::span<const AABB3> aabbs, std::uint32_t tag)
+{
+	AddSection(SceneSectionType::kAABB3, tag, sizeof(AABB3), aabbs.size(), aabbs.data());
+}
+
+void SceneWriter::Add(std::span<const Sphere> spheres, std::uint32_t tag)
+{
+	AddSection(SceneSectionType::kSphere, tag, sizeof(Sphere), spheres.size(), spheres.data());
+}
+
+void SceneWriter::Add(std::span<const Plane> planes, std::uint32_t tag)
+{
+	AddSection(SceneSectionType::kPlane, tag, sizeof(Plane), planes.size(), planes.data());
+}
+
+void SceneWriter::Add(std::span<const Matrix4f> matrices, std::uint32_t tag)
+{
+	AddSection(SceneSectionType::kMatrix4f, tag, sizeof(Matrix4f), matrices.size(), matrices.data());
+}
+
+void SceneWriter::Add(const Bvh& bvh, std::uint32_t tag)
+{
+	AddSection(SceneSectionType::kBvhNodes, tag, sizeof(BvhNode), bvh.nodes().size(), bvh.nodes().data());
+	AddSection(SceneSectionType::kBvhItems, tag, sizeof(std::uint32_t), bvh.items().size(), bvh.items().data());
+}
+
+std::vector<std::byte> SceneWriter::Serialize() const
+{
+	auto align = [](std::uint64_t offset) {
+		return (offset + kSceneSectionAlignment - 1) / kSceneSectionAlignment * kSceneSectionAlignment;
+	};
+	std::vector<SceneSectionEntry> entries;
+	std::uint64_t offset = align(kSceneSectionTable + sections_.size() * sizeof(SceneSectionEntry));
+	for (const Section& section : sections_) {
+		entries.push_back({ section.type, section.tag, section.element_size, 0, offset, section.count });
+		offset = align(offset + section.bytes.size());
+	}
+
+	SceneFileHeader header;
+	header.magic = kSceneFileMagic;
+	header.version = kSceneFileVersion;
+	header.endian_tag = kSceneEndianTag;
+	header.section_count = static_cast<std::uint32_t>(sections_.size());
+	header.file_size = offset;
+
+	// Zero padding between the sections
+	std::vector<std::byte> data(offset);
+	std::memcpy(data.data(), &header, sizeof(header));
+	if (!entries.empty()) {
+		std::memcpy(data.data() + kSceneSectionTable, entries.data(), entries.size() * sizeof(SceneSectionEntry));
+	}
+	for (std::size_t i = 0; i < sections_.size(); i++) {
+		if (!sections_[i].bytes.empty()) {
+			std::memcpy(data.data() + entries[i].offset, sections_[i].bytes.data(), sections_[i].bytes.size());
+		}
+	}
+	return data;
+}
+
+bool SceneWriter::Write(const std::string& path) const
+{
+	const std::vector<std::byte> data = Serialize();
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+	return static_cast<bool>(file);
+}
+
+SceneFile::~SceneFile()
+{
+	Close();
+}
+
+SceneFile::SceneFile(SceneFile&& other) noexcept
+	: data_(std::exchange(other.data_, {})), mapping_(std::exchange(other.mapping_, nullptr))
+{
+}
+
+SceneFile& SceneFile::operator=(SceneFile&& other) noexcept
+{
+	if (this != &other) {
+		Close();
+		data_ = std::exchange(other.data_, {});
+		mapping_ = std::exchange(other.mapping_, nullptr);
+	}
+	return *this;
+}
+
+SceneFileError SceneFile::Open(const std::string& path, bool validate_contents)
+{
+	Close();
+	void* mapping = nullptr;
+	std::size_t size = 0;
+#ifdef _WIN32
+	const HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		return SceneFileError::kOpenFailed;
+	}
+	LARGE_INTEGER file_size;
+	if (GetFileSizeEx(file, &file_size) && file_size.QuadPart > 0) {
+		size = static_cast<std::size_t>(file_size.QuadPart);
+		// The view keeps the mapping alive once both handles are closed
+		const HANDLE file_mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (file_mapping != nullptr) {
+			mapping = MapViewOfFile(file_mapping, FILE_MAP_READ, 0, 0, 0);
+			CloseHandle(file_mapping);
+		}
+	}
+	CloseHandle(file);
+#else
+	const int file = open(path.c_str(), O_RDONLY);
+	if (file < 0) {
+		return SceneFileError::kOpenFailed;
+	}
+	struct stat file_stat;
+	if (fstat(file, &file_stat) == 0 && file_stat.st_size > 0) {
+		size = static_cast<std::size_t>(file_stat.st_size);
+		mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+		if (mapping == MAP_FAILED) {
+			mapping = nullptr;
+		}
+	}
+	close(file);
+#endif
+	if (mapping == nullptr) {
+		return size == 0 ? SceneFileError::kTruncated : SceneFileError::kOpenFailed;
+	}
+
+	data_ = { static_cast<const std::byte*>(mapping), size };
+	mapping_ = mapping;
+	const SceneFileError error = ValidateSceneFile(data_, validate_contents);
+	if (error != SceneFileError::kNone) {
+		Close();
+	}
+	return error;
+}
+
+SceneFileError SceneFile::View(std::span<const std::byte> data, bool validate_contents)
+{
+	Close();
+	const SceneFileError error = ValidateSceneFile(data, validate_contents);
+	if (error == SceneFileError::kNone) {
+		data_ = data;
+	}
+	return error;
+}
+
+void SceneFile::Close()
+{
+	if (mapping_ != nullptr) {
+#ifdef _WIN32
+		UnmapViewOfFile(mapping_);
+#else
+		munmap(mapping_, data_.size());
+#endif
+	}
+	mapping_ = nullptr;
+	data_ = {};
+}
+
+template<typename T>
+std::span<const T> SceneFile::Section(SceneSectionType type, std::uint32_t tag) const
+{
+	if (data_.empty()) {
+		return {};
+	}
+	return SectionData<T>(data_, type, tag);
+}
+
+std::span<const AABB3> SceneFile::aabbs(std::uint32_t tag) const
+{
+	return Section<AABB3>(SceneSectionType::kAABB3, tag);
+}
+
+std::span<const Sphere> SceneFile::spheres(std::uint32_t tag) const
+{
+	return Section<Sphere>(SceneSectionType::kSphere, tag);
+}
+
+std::span<const Plane> SceneFile::planes(std::uint32_t tag) const
+{
+	return Section<Plane>(SceneSectionType::kPlane, tag);
+}
+
+std::span<const Matrix4f> SceneFile::matrices(std::uint32_t tag) const
+{
+	return Section<Matrix4f>(SceneSectionType::kMatrix4f, tag);
+}
+
+BvhView SceneFile::bvh(std::uint32_t tag) const
+{
+	return { Section<BvhNode>(SceneSectionType::kBvhNodes, tag),
+		Section<std::uint32_t>(SceneSectionType::kBvhItems, tag) };
+}
+
+} // namespace maths
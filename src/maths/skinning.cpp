@@ -0,0 +1,283 @@
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "maths/skinning.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "maths/simd.h"
+
+namespace maths {
+
+namespace {
+
+static_assert(sizeof(Matrix4f) == 16 * sizeof(float), "palette matrices are loaded as packed floats");
+static_assert(sizeof(DualQuaternion) == 8 * sizeof(float), "dual quaternions are loaded as packed floats");
+
+std::size_t VertexCount(const SkinningInput& input, const SkinningOutput& output)
+{
+	std::size_t count = std::min({ input.influences.size(), input.px.size(), input.py.size(), input.pz.size(),
+		output.px.size(), output.py.size(), output.pz.size() });
+	if (!input.nx.empty()) {
+		count = std::min({ count, input.nx.size(), input.ny.size(), input.nz.size(),
+			output.nx.size(), output.ny.size(), output.nz.size() });
+	}
+	return count;
+}
+
+// Vertices [i, i + lanes) of a stream, the missing lanes repeat the last one
+Float4 LoadLanes(std::span<const float> stream, std::size_t i, std::size_t lanes)
+{
+	if (lanes == 4) {
+		return Float4::Load(stream.data() + i);
+	}
+	float values[4];
+	for (std::size_t k = 0; k < 4; k++) {
+		values[k] = stream[i + std::min(k, lanes - 1)];
+	}
+	return Float4::Load(values);
+}
+
+void StoreLanes(Float4 value, std::span<float> stream, std::size_t i, std::size_t lanes)
+{
+	if (lanes == 4) {
+		value.Store(stream.data() + i);
+		return;
+	}
+	float values[4];
+	value.Store(values);
+	std::copy_n(values, lanes, stream.data() + i);
+}
+
+void StoreNormal(Float4 x, Float4 y, Float4 z, const SkinningOutput& output, std::size_t i, std::size_t lanes)
+{
+	const Float4 length_sq = Float4::Max(x * x + y * y + z * z, Float4(1e-30f));
+	const Float4 inverse_length = Float4(1.0f) / Float4::Sqrt(length_sq);
+	StoreLanes(x * inverse_length, output.nx, i, lanes);
+	StoreLanes(y * inverse_length, output.ny, i, lanes);
+	StoreLanes(z * inverse_length, output.nz, i, lanes);
+}
+
+// Skins vertices [i, i + lanes) with lanes <= 4
+void LinearBlendLanes(const float* palette, const SkinningInput& input, const SkinningOutput& output,
+	std::size_t i, std::size_t lanes)
+{
+	// Blended matrix of every vertex, blended[column][vertex]
+	Float4 blended[4][4];
+	for (std::size_t v = 0; v < 4; v++) {
+		const BoneInfluences& influence = input.influences[i + std::min(v, lanes - 1)];
+		const float* first = palette + 16 * influence.bones[0];
+		const Float4 first_weight(influence.weights[0]);
+		for (int column = 0; column < 4; column++) {
+			blended[column][v] = Float4::Load(first + 4 * column) * first_weight;
+		}
+		for (std::size_t k = 1; k < kMaxBoneInfluences; k++) {
+			const float* bone = palette + 16 * influence.bones[k];
+			const Float4 weight(influence.weights[k]);
+			for (int column = 0; column < 4; column++) {
+				blended[column][v] = Float4::MulAdd(Float4::Load(bone + 4 * column), weight, blended[column][v]);
+			}
+		}
+	}
+	// Now blended[column][row] holds one element of the four matrices
+	for (Float4* column : blended) {
+		Float4::Transpose(column[0], column[1], column[2], column[3]);
+	}
+
+	const Float4 px = LoadLanes(input.px, i, lanes);
+	const Float4 py = LoadLanes(input.py, i, lanes);
+	const Float4 pz = LoadLanes(input.pz, i, lanes);
+	for (int row = 0; row < 3; row++) {
+		const Float4 value = blended[0][row] * px + blended[1][row] * py + blended[2][row] * pz + blended[3][row];
+		StoreLanes(value, row == 0 ? output.px : row == 1 ? output.py : output.pz, i, lanes);
+	}
+	if (input.nx.empty()) {
+		return;
+	}
+	const Float4 nx = LoadLanes(input.nx, i, lanes);
+	const Float4 ny = LoadLanes(input.ny, i, lanes);
+	const Float4 nz = LoadLanes(input.nz, i, lanes);
+	Float4 normal[3];
+	for (int row = 0; row < 3; row++) {
+		normal[row] = blended[0][row] * nx + blended[1][row] * ny + blended[2][row] * nz;
+	}
+	StoreNormal(normal[0], normal[1], normal[2], output, i, lanes);
+}
+
+void DualQuaternionLanes(const float* palette, const SkinningInput& input, const SkinningOutput& output,
+	std::size_t i, std::size_t lanes)
+{
+	Float4 real[4];
+	Float4 dual[4];
+	for (std::size_t v = 0; v < 4; v++) {
+		const BoneInfluences& influence = input.influences[i + std::min(v, lanes - 1)];
+		const float* first = palette + 8 * influence.bones[0];
+		const Float4 first_weight(influence.weights[0]);
+		real[v] = Float4::Load(first) * first_weight;
+		dual[v] = Float4::Load(first + 4) * first_weight;
+		for (std::size_t k = 1; k < kMaxBoneInfluences; k++) {
+			const float* bone = palette + 8 * influence.bones[k];
+			// q and -q are the same rotation, blend in the hemisphere of the
+			// first bone
+			const float dot = bone[0] * first[0] + bone[1] * first[1] + bone[2] * first[2] + bone[3] * first[3];
+			const Float4 weight(dot < 0.0f ? -influence.weights[k] : influence.weights[k]);
+			real[v] = Float4::MulAdd(Float4::Load(bone), weight, real[v]);
+			dual[v] = Float4::MulAdd(Float4::Load(bone + 4), weight, dual[v]);
+		}
+	}
+	Float4::Transpose(real[0], real[1], real[2], real[3]);
+	Float4::Transpose(dual[0], dual[1], dual[2], dual[3]);
+	const Float4 inverse_length = Float4(1.0f)
+		/ Float4::Sqrt(real[0] * real[0] + real[1] * real[1] + real[2] * real[2] + real[3] * real[3]);
+	const Float4 rx = real[0] * inverse_length, ry = real[1] * inverse_length;
+	const Float4 rz = real[2] * inverse_length, rw = real[3] * inverse_length;
+	const Float4 dx = dual[0] * inverse_length, dy = dual[1] * inverse_length;
+	const Float4 dz = dual[2] * inverse_length, dw = dual[3] * inverse_length;
+	const Float4 two(2.0f);
+
+	// Translation 2 * (rw * d - dw * r + r x d), the vector part of
+	// 2 * dual * conjugate(real)
+	const Float4 tx = two * (rw * dx - dw * rx + ry * dz - rz * dy);
+	const Float4 ty = two * (rw * dy - dw * ry + rz * dx - rx * dz);
+	const Float4 tz = two * (rw * dz - dw * rz + rx * dy - ry * dx);
+
+	// Rotation v + 2 * r x (r x v + rw * v)
+	const auto rotate = [&](Float4 x, Float4 y, Float4 z, Float4& out_x, Float4& out_y, Float4& out_z) {
+		const Float4 cx = ry * z - rz * y + rw * x;
+		const Float4 cy = rz * x - rx * z + rw * y;
+		const Float4 cz = rx * y - ry * x + rw * z;
+		out_x = x + two * (ry * cz - rz * cy);
+		out_y = y + two * (rz * cx - rx * cz);
+		out_z = z + two * (rx * cy - ry * cx);
+	};
+
+	Float4 x, y, z;
+	rotate(LoadLanes(input.px, i, lanes), LoadLanes(input.py, i, lanes), LoadLanes(input.pz, i, lanes), x, y, z);
+	StoreLanes(x + tx, output.px, i, lanes);
+	StoreLanes(y + ty, output.py, i, lanes);
+	StoreLanes(z + tz, output.pz, i, lanes);
+	if (input.nx.empty()) {
+		return;
+	}
+	rotate(LoadLanes(input.nx, i, lanes), LoadLanes(input.ny, i, lanes), LoadLanes(input.nz, i, lanes), x, y, z);
+	StoreLanes(x, output.nx, i, lanes);
+	StoreLanes(y, output.ny, i, lanes);
+	StoreLanes(z, output.nz, i, lanes);
+}
+
+template<typename Lanes>
+void SkinRange(const Lanes& lanes_function, std::size_t begin, std::size_t end)
+{
+	for (std::size_t i = begin; i < end; i += 4) {
+		lanes_function(i, std::min<std::size_t>(4, end - i));
+	}
+}
+
+// Chunks are a multiple of four vertices so only the last one has a tail
+template<typename Lanes>
+void SkinParallel(const Lanes& lanes_function, std::size_t count, JobSystem& jobs)
+{
+	const std::size_t grain = (jobs.GrainSize(count, 256) + 3) & ~std::size_t(3);
+	jobs.ParallelFor(0, count, [&](std::size_t begin, std::size_t end) {
+		SkinRange(lanes_function, begin, end);
+	}, grain);
+}
+
+} // namespace
+
+DualQuaternion DualQuaternion::FromRigid(const Quaternion& rotation, const Vector3f& translation)
+{
+	const Quaternion pure(translation.x, translation.y, translation.z, 0.0f);
+	return { rotation, pure * rotation * 0.5f };
+}
+
+DualQuaternion DualQuaternion::FromMatrix(const Matrix4f& matrix)
+{
+	Matrix4f rotation;
+	for (int column = 0; column < 3; column++) {
+		const Vector4f& axis = matrix[column];
+		const float inverse_length = 1.0f / std::sqrt(axis.x * axis.x + axis.y * axis.y + axis.z * axis.z);
+		rotation[column] = Vector4f(axis.x * inverse_length, axis.y * inverse_length, axis.z * inverse_length, 0.0f);
+	}
+	const Vector4f& translation = matrix[3];
+	return FromRigid(Quaternion::FromRotationMatrix(rotation), Vector3f{ translation.x, translation.y, translation.z });
+}
+
+Vector3f DualQuaternion::TransformPoint(const Vector3f& point) const
+{
+	const Quaternion translation = dual * real.Conjugate() * 2.0f;
+	const Vector3f rotated = real.Rotate(point);
+	return { rotated.x + translation.x, rotated.y + translation.y, rotated.z + translation.z };
+}
+
+void BuildSkinningPalette(std::span<const Matrix4f> bone_world, std::span<const Matrix4f> inverse_bind,
+	std::span<Matrix4f> palette)
+{
+	const std::size_t count = std::min({ bone_world.size(), inverse_bind.size(), palette.size() });
+	for (std::size_t b = 0; b < count; b++) {
+		MultiplyMatrix4(reinterpret_cast<const float*>(&bone_world[b]), reinterpret_cast<const float*>(&inverse_bind[b]),
+			reinterpret_cast<float*>(&palette[b]));
+	}
+}
+
+void BuildDualQuaternionPalette(std::span<const Matrix4f> palette, std::span<DualQuaternion> dual_palette)
+{
+	const std::size_t count = std::min(palette.size(), dual_palette.size());
+	for (std::size_t b = 0; b < count; b++) {
+		dual_palette[b] = DualQuaternion::FromMatrix(palette[b]);
+	}
+}
+
+void SkinLinearBlend(std::span<const Matrix4f> palette, const SkinningInput& input, const SkinningOutput& output)
+{
+	const float* data = reinterpret_cast<const float*>(palette.data());
+	SkinRange([&](std::size_t i, std::size_t lanes) { LinearBlendLanes(data, input, output, i, lanes); },
+		0, VertexCount(input, output));
+}
+
+void SkinLinearBlend(std::span<const Matrix4f> palette, const SkinningInput& input, const SkinningOutput& output,
+	JobSystem& jobs)
+{
+	const float* data = reinterpret_cast<const float*>(palette.data());
+	SkinParallel([&](std::size_t i, std::size_t lanes) { LinearBlendLanes(data, input, output, i, lanes); },
+		VertexCount(input, output), jobs);
+}
+
+void SkinDualQuaternion(std::span<const DualQuaternion> palette, const SkinningInput& input,
+	const SkinningOutput& output)
+{
+	const float* data = reinterpret_cast<const float*>(palette.data());
+	SkinRange([&](std::size_t i, std::size_t lanes) { DualQuaternionLanes(data, input, output, i, lanes); },
+		0, VertexCount(input, output));
+}
+
+void SkinDualQuaternion(std::span<const DualQuaternion> palette, const SkinningInput& input,
+	const SkinningOutput& output, JobSystem& jobs)
+{
+	const float* data = reinterpret_cast<const float*>(palette.data());
+	SkinParallel([&](std::size_t i, std::size_t lanes) { DualQuaternionLanes(data, input, output, i, lanes); },
+		VertexCount(input, output), jobs);
+}
+
+} // namespace maths
@@ -0,0 +1,209 @@
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "maths/spatial_sort.h"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <numeric>
+
+#include "maths/morton.h"
+
+namespace maths {
+
+namespace {
+
+constexpr int kRadixBits = 8;
+constexpr std::size_t kBuckets = 1 << kRadixBits;
+// Below this size the scatter is not worth splitting
+constexpr std::size_t kParallelRadixThreshold = 1 << 14;
+
+template<typename Key>
+void RadixSort(std::span<const Key> keys, std::vector<std::uint32_t>& order, JobSystem& jobs)
+{
+	const std::size_t count = keys.size();
+	order.resize(count);
+	std::iota(order.begin(), order.end(), 0u);
+	if (count < 2) {
+		return;
+	}
+
+	const bool parallel = count >= kParallelRadixThreshold && jobs.thread_count() > 1;
+	const std::size_t grain = parallel ? jobs.GrainSize(count, 4096) : count;
+	const std::size_t chunk_count = (count + grain - 1) / grain;
+	std::vector<std::array<std::uint32_t, kBuckets>> histograms(chunk_count);
+
+	std::vector<Key> current(keys.begin(), keys.end());
+	std::vector<Key> next_keys(count);
+	std::vector<std::uint32_t> next_order(count);
+
+	for (int shift = 0; shift < static_cast<int>(sizeof(Key) * 8); shift += kRadixBits) {
+		auto digit = [shift](Key key) { return static_cast<std::size_t>((key >> shift) & (kBuckets - 1)); };
+
+		jobs.ParallelFor(0, count, [&](std::size_t begin, std::size_t end) {
+			std::array<std::uint32_t, kBuckets>& histogram = histograms[begin / grain];
+			histogram.fill(0);
+			for (std::size_t i = begin; i < end; i++) {
+				histogram[digit(current[i])]++;
+			}
+		}, grain);
+
+		// Exclusive prefix over (bucket, chunk) keeps the sort stable
+		std::uint32_t offset = 0;
+		bool single_bucket = false;
+		for (std::size_t bucket = 0; bucket < kBuckets; bucket++) {
+			std::uint32_t bucket_total = 0;
+			for (std::size_t chunk = 0; chunk < chunk_count; chunk++) {
+				const std::uint32_t value = histograms[chunk][bucket];
+				histograms[chunk][bucket] = offset;
+				offset += value;
+				bucket_total += value;
+			}
+			single_bucket |= bucket_total == count;
+		}
+		if (single_bucket) {
+			continue;
+		}
+
+		jobs.ParallelFor(0, count, [&](std::size_t begin, std::size_t end) {
+			std::array<std::uint32_t, kBuckets>& offsets = histograms[begin / grain];
+			for (std::size_t i = begin; i < end; i++) {
+				const std::uint32_t destination = offsets[digit(current[i])]++;
+				next_keys[destination] = current[i];
+				next_order[destination] = order[i];
+			}
+		}, grain);
+		current.swap(next_keys);
+		order.swap(next_order);
+	}
+}
+
+// Gathers the shapes in key order
+template<typename Shape>
+void ApplyKeyOrder(std::span<Shape> shapes, const std::vector<std::uint64_t>& keys,
+	std::vector<std::uint32_t>* order, JobSystem& jobs)
+{
+	std::vector<std::uint32_t> permutation;
+	RadixSortIndices(keys, permutation, jobs);
+	std::vector<Shape> sorted(shapes.size());
+	jobs.ParallelFor(0, shapes.size(), [&](std::size_t begin, std::size_t end) {
+		for (std::size_t i = begin; i < end; i++) {
+			sorted[i] = shapes[permutation[i]];
+		}
+	});
+	std::copy(sorted.begin(), sorted.end(), shapes.begin());
+	if (order != nullptr) {
+		*order = std::move(permutation);
+	}
+}
+
+template<typename Shape, typename CenterOf>
+void Keys3(std::span<const Shape> shapes, SpaceFillingCurve curve,
+	std::vector<std::uint64_t>& keys, CenterOf center_of)
+{
+	constexpr float kInfinity = std::numeric_limits<float>::infinity();
+	Vector3f min{ kInfinity, kInfinity, kInfinity };
+	Vector3f max{ -kInfinity, -kInfinity, -kInfinity };
+	for (const Shape& shape : shapes) {
+		const Vector3f center = center_of(shape);
+		for (int axis = 0; axis < 3; axis++) {
+			min[axis] = std::min(min[axis], center[axis]);
+			max[axis] = std::max(max[axis], center[axis]);
+		}
+	}
+	const AABB3 bounds{ min, max };
+	keys.resize(shapes.size());
+	for (std::size_t i = 0; i < shapes.size(); i++) {
+		const Vector3f center = center_of(shapes[i]);
+		keys[i] = curve == SpaceFillingCurve::kMorton ? Morton64(center, bounds) : Hilbert64(center, bounds);
+	}
+}
+
+} // namespace
+
+void RadixSortIndices(std::span<const std::uint32_t> keys, std::vector<std::uint32_t>& order,
+	JobSystem& jobs)
+{
+	RadixSort(keys, order, jobs);
+}
+
+void RadixSortIndices(std::span<const std::uint64_t> keys, std::vector<std::uint32_t>& order,
+	JobSystem& jobs)
+{
+	RadixSort(keys, order, jobs);
+}
+
+void SpatialKeys(std::span<const AABB3> aabbs, SpaceFillingCurve curve, std::vector<std::uint64_t>& keys)
+{
+	Keys3(aabbs, curve, keys, [](const AABB3& aabb) { return aabb.center(); });
+}
+
+void SpatialKeys(std::span<const Sphere> spheres, SpaceFillingCurve curve, std::vector<std::uint64_t>& keys)
+{
+	Keys3(spheres, curve, keys, [](const Sphere& sphere) { return sphere.center(); });
+}
+
+void SpatialKeys(std::span<const Circle> circles, SpaceFillingCurve curve, std::vector<std::uint64_t>& keys)
+{
+	constexpr float kInfinity = std::numeric_limits<float>::infinity();
+	Vector2f min{ kInfinity, kInfinity };
+	Vector2f max{ -kInfinity, -kInfinity };
+	for (const Circle& circle : circles) {
+		min = Vector2f{ std::min(min.x, circle.center().x), std::min(min.y, circle.center().y) };
+		max = Vector2f{ std::max(max.x, circle.center().x), std::max(max.y, circle.center().y) };
+	}
+	const AABB2 bounds{ min, max };
+	keys.resize(circles.size());
+	for (std::size_t i = 0; i < circles.size(); i++) {
+		keys[i] = curve == SpaceFillingCurve::kMorton ? Morton64(circles[i].center(), bounds)
+			: Hilbert64(circles[i].center(), bounds);
+	}
+}
+
+void SpatialSort(std::span<AABB3> aabbs, SpaceFillingCurve curve,
+	std::vector<std::uint32_t>* order, JobSystem& jobs)
+{
+	std::vector<std::uint64_t> keys;
+	SpatialKeys(std::span<const AABB3>(aabbs), curve, keys);
+	ApplyKeyOrder(aabbs, keys, order, jobs);
+}
+
+void SpatialSort(std::span<Sphere> spheres, SpaceFillingCurve curve,
+	std::vector<std::uint32_t>* order, JobSystem& jobs)
+{
+	std::vector<std::uint64_t> keys;
+	SpatialKeys(std::span<const Sphere>(spheres), curve, keys);
+	ApplyKeyOrder(spheres, keys, order, jobs);
+}
+
+void SpatialSort(std::span<Circle> circles, SpaceFillingCurve curve,
+	std::vector<std::uint32_t>* order, JobSystem& jobs)
+{
+	std::vector<std::uint64_t> keys;
+	SpatialKeys(std::span<const Circle>(circles), curve, keys);
+	ApplyKeyOrder(circles, keys, order, jobs);
+}
+
+} // namespace maths
@@ -0,0 +1,233 @@
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "maths/transform3.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#include "maths/matrix3.h"
+#include "maths/simd.h"
+
+namespace maths {
+
+namespace {
+
+// The batch bake loads every transform as 10 packed floats
+static_assert(sizeof(Transform3) == 10 * sizeof(float), "Transform3 is read as packed floats");
+static_assert(offsetof(Transform3, rotation) == 3 * sizeof(float) && offsetof(Transform3, scale) == 7 * sizeof(float));
+static_assert(sizeof(Matrix4f) == 16 * sizeof(float), "Matrix4f columns are stored as packed floats");
+
+// Relative tolerance on the dot products of the columns before they count
+// as sheared
+constexpr float kShearTolerance = 1e-4f;
+// Squared column lengths below are singular
+constexpr float kSingularLengthSq = 1e-12f;
+// Same for determinants relative to the product of the column lengths,
+// nearly flat matrices
+constexpr float kSingularVolume = 1e-6f;
+
+Matrix4f RotationMatrix(const Vector3f& x_axis, const Vector3f& y_axis, const Vector3f& z_axis) {
+    return {Vector4f(x_axis.x, x_axis.y, x_axis.z, 0.0f), Vector4f(y_axis.x, y_axis.y, y_axis.z, 0.0f),
+            Vector4f(z_axis.x, z_axis.y, z_axis.z, 0.0f), Vector4f(0.0f, 0.0f, 0.0f, 1.0f)};
+}
+
+Vector3f Multiply(const Vector3f& a, const Vector3f& b) {
+    return {a.x * b.x, a.y * b.y, a.z * b.z};
+}
+
+} // namespace
+
+Transform3 Transform3::operator*(const Transform3& child) const {
+    return {TransformPoint(child.translation), rotation * child.rotation, Multiply(scale, child.scale)};
+}
+
+Transform3 Transform3::Inverse() const {
+    const Quaternion inverse_rotation = rotation.Conjugate();
+    const Vector3f inverse_scale{1.0f / scale.x, 1.0f / scale.y, 1.0f / scale.z};
+    const Vector3f rotated = inverse_rotation.Rotate(translation);
+    return {Vector3f{-rotated.x * inverse_scale.x, -rotated.y * inverse_scale.y, -rotated.z * inverse_scale.z},
+            inverse_rotation, inverse_scale};
+}
+
+Vector3f Transform3::TransformPoint(const Vector3f& point) const {
+    const Vector3f rotated = rotation.Rotate(Multiply(scale, point));
+    return {rotated.x + translation.x, rotated.y + translation.y, rotated.z + translation.z};
+}
+
+Vector3f Transform3::TransformDirection(const Vector3f& direction) const {
+    return rotation.Rotate(Multiply(scale, direction));
+}
+
+Matrix4f Transform3::ToMatrix4f() const {
+    Matrix4f matrix;
+    ComposeTrs(rotation, translation, scale, reinterpret_cast<float*>(&matrix));
+    return matrix;
+}
+
+Transform3 Transform3::Lerp(const Transform3& a, const Transform3& b, float t) {
+    return {Vector3f::Lerp(a.translation, b.translation, t), Quaternion::Nlerp(a.rotation, b.rotation, t),
+            Vector3f::Lerp(a.scale, b.scale, t)};
+}
+
+Transform3 Transform3::Slerp(const Transform3& a, const Transform3& b, float t) {
+    return {Vector3f::Lerp(a.translation, b.translation, t), Quaternion::Slerp(a.rotation, b.rotation, t),
+            Vector3f::Lerp(a.scale, b.scale, t)};
+}
+
+DecomposeStatus Decompose(const Matrix4f& matrix, Transform3& transform) {
+    transform.translation = {matrix[3].x, matrix[3].y, matrix[3].z};
+    const Vector3f columns[3] = {{matrix[0].x, matrix[0].y, matrix[0].z},
+                                 {matrix[1].x, matrix[1].y, matrix[1].z},
+                                 {matrix[2].x, matrix[2].y, matrix[2].z}};
+    const Vector3f length_sq{columns[0].Dot(columns[0]), columns[1].Dot(columns[1]), columns[2].Dot(columns[2])};
+    const float determinant = columns[0].Dot(Vector3f::Cross(columns[1], columns[2]));
+    transform.scale = {std::sqrt(length_sq.x), std::sqrt(length_sq.y), std::sqrt(length_sq.z)};
+    if (std::min({length_sq.x, length_sq.y, length_sq.z}) <= kSingularLengthSq
+        || std::abs(determinant) <= kSingularVolume * transform.scale.x * transform.scale.y * transform.scale.z) {
+        transform.rotation = Quaternion::Identity();
+        return DecomposeStatus::kSingular;
+    }
+    // Mirror: flip x so the rest is a proper rotation
+    if (determinant < 0.0f) {
+        transform.scale.x = -transform.scale.x;
+    }
+
+    const float dot_xy = columns[0].Dot(columns[1]);
+    const float dot_xz = columns[0].Dot(columns[2]);
+    const float dot_yz = columns[1].Dot(columns[2]);
+    if (dot_xy * dot_xy <= kShearTolerance * kShearTolerance * length_sq.x * length_sq.y
+        && dot_xz * dot_xz <= kShearTolerance * kShearTolerance * length_sq.x * length_sq.z
+        && dot_yz * dot_yz <= kShearTolerance * kShearTolerance * length_sq.y * length_sq.z) {
+        transform.rotation = Quaternion::FromRotationMatrix(RotationMatrix(
+            columns[0] * (1.0f / transform.scale.x), columns[1] * (1.0f / transform.scale.y),
+            columns[2] * (1.0f / transform.scale.z)));
+        return DecomposeStatus::kExact;
+    }
+
+    Matrix3f rotation;
+    Matrix3f stretch;
+    if (!PolarDecomposition(Matrix3f(columns[0], columns[1], columns[2]), rotation, stretch)) {
+        transform.rotation = Quaternion::Identity();
+        return DecomposeStatus::kSingular;
+    }
+    // rotation * stretch = (rotation * D) * (D * stretch) with D = diag(-1, 1, 1)
+    if (determinant < 0.0f) {
+        rotation[0] = rotation[0] * -1.0f;
+        for (int column = 0; column < 3; column++) {
+            stretch[column][0] = -stretch[column][0];
+        }
+    }
+    transform.rotation = Quaternion::FromRotationMatrix(RotationMatrix(rotation[0], rotation[1], rotation[2]));
+    transform.scale = {stretch[0][0], stretch[1][1], stretch[2][2]};
+    return DecomposeStatus::kSheared;
+}
+
+void DecomposeBatch(std::span<const Matrix4f> matrices, std::span<Transform3> transforms,
+                    std::span<DecomposeStatus> statuses, JobSystem& jobs) {
+    std::size_t count = std::min(matrices.size(), transforms.size());
+    if (!statuses.empty()) {
+        count = std::min(count, statuses.size());
+    }
+    jobs.ParallelFor(0, count, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            const DecomposeStatus status = Decompose(matrices[i], transforms[i]);
+            if (!statuses.empty()) {
+                statuses[i] = status;
+            }
+        }
+    });
+}
+
+void ComposeTrs(const Quaternion& q, const Vector3f& t, const Vector3f& s, float* out) {
+    const float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+    const float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+    const float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+    out[0] = (1.0f - 2.0f * (yy + zz)) * s.x;
+    out[1] = 2.0f * (xy + wz) * s.x;
+    out[2] = 2.0f * (xz - wy) * s.x;
+    out[3] = 0.0f;
+    out[4] = 2.0f * (xy - wz) * s.y;
+    out[5] = (1.0f - 2.0f * (xx + zz)) * s.y;
+    out[6] = 2.0f * (yz + wx) * s.y;
+    out[7] = 0.0f;
+    out[8] = 2.0f * (xz + wy) * s.z;
+    out[9] = 2.0f * (yz - wx) * s.z;
+    out[10] = (1.0f - 2.0f * (xx + yy)) * s.z;
+    out[11] = 0.0f;
+    out[12] = t.x;
+    out[13] = t.y;
+    out[14] = t.z;
+    out[15] = 1.0f;
+}
+
+void ToMatrix4fBatch(std::span<const Transform3> transforms, std::span<Matrix4f> matrices,
+                     JobSystem& jobs) {
+    const std::size_t count = std::min(transforms.size(), matrices.size());
+    jobs.ParallelFor(0, count, [&](std::size_t begin, std::size_t end) {
+        std::size_t i = begin;
+        // Four transforms in structure of arrays, one per lane, the same
+        // formulas as ComposeTrs
+        for (; i + 4 <= end; i += 4) {
+            const float* data[4];
+            for (int k = 0; k < 4; k++) {
+                data[k] = reinterpret_cast<const float*>(&transforms[i + k]);
+            }
+            Float4 tx = Float4::Load(data[0]), ty = Float4::Load(data[1]);
+            Float4 tz = Float4::Load(data[2]), qx = Float4::Load(data[3]);
+            Float4::Transpose(tx, ty, tz, qx);
+            Float4 qy = Float4::Load(data[0] + 4), qz = Float4::Load(data[1] + 4);
+            Float4 qw = Float4::Load(data[2] + 4), sx = Float4::Load(data[3] + 4);
+            Float4::Transpose(qy, qz, qw, sx);
+            const Float4 sy(data[0][8], data[1][8], data[2][8], data[3][8]);
+            const Float4 sz(data[0][9], data[1][9], data[2][9], data[3][9]);
+
+            const Float4 one(1.0f), two(2.0f), zero = Float4::Zero();
+            const Float4 xx = qx * qx, yy = qy * qy, zz = qz * qz;
+            const Float4 xy = qx * qy, xz = qx * qz, yz = qy * qz;
+            const Float4 wx = qw * qx, wy = qw * qy, wz = qw * qz;
+            Float4 columns[4][4] = {
+                {(one - two * (yy + zz)) * sx, two * (xy + wz) * sx, two * (xz - wy) * sx, zero},
+                {two * (xy - wz) * sy, (one - two * (xx + zz)) * sy, two * (yz + wx) * sy, zero},
+                {two * (xz + wy) * sz, two * (yz - wx) * sz, (one - two * (xx + yy)) * sz, zero},
+                {tx, ty, tz, one},
+            };
+            // Back to one column per register for each matrix
+            for (int column = 0; column < 4; column++) {
+                Float4* c = columns[column];
+                Float4::Transpose(c[0], c[1], c[2], c[3]);
+                for (int k = 0; k < 4; k++) {
+                    c[k].Store(reinterpret_cast<float*>(&matrices[i + k]) + 4 * column);
+                }
+            }
+        }
+        for (; i < end; i++) {
+            ComposeTrs(transforms[i].rotation, transforms[i].translation, transforms[i].scale,
+                       reinterpret_cast<float*>(&matrices[i]));
+        }
+    });
+}
+
+} // namespace maths
@@ -24,6 +24,9 @@ SOFTWARE.
 
 #include "maths/vector2.h"
 #include "maths/maths_utils.h"
+#include "maths/simd.h"
+
+#include <algorithm>
 
 namespace maths
 {
@@ -136,6 +139,19 @@ void Vector2f::Normalize() {
     *this = Normalized();
 }
 
+Vector2f Vector2f::NormalizedFast() const {
+    return *this * ReciprocalSqrt(SqrMagnitude());
+}
+
+bool Vector2f::NormalizeSafe() {
+    const float sqr_magnitude = SqrMagnitude();
+    if (sqr_magnitude <= kZeroSqrMagnitude) {
+        return false;
+    }
+    *this = *this * ReciprocalSqrt(sqr_magnitude);
+    return true;
+}
+
 
 // The function Lerp linearly interpolates between two points.
 Vector2f Vector2f::Lerp(const Vector2f v2, const float t) const {
@@ -175,4 +191,29 @@ Vector2f Vector2f::Rotation(const Vector2f v1, const radian_t angle) {
         (v1.x * cos(angle)) + (v1.y * -sin(angle)),
         (v1.x * sin(angle)) + (v1.y * cos(angle)));
 }
+
+void NormalizeBatch(std::span<const Vector2f> in, std::span<Vector2f> out) {
+    static_assert(sizeof(Vector2f) == 2 * sizeof(float));
+    const std::size_t count = std::min(in.size(), out.size());
+    const Float4 zero(kZeroSqrMagnitude);
+    std::size_t i = 0;
+    // Two vectors per register, the pair swap sums x^2 + y^2 in both lanes.
+    for (; i + 4 <= count; i += 4) {
+        const Float4 a = Float4::Load(in[i].coord);
+        const Float4 b = Float4::Load(in[i + 2].coord);
+        const Float4 a_squared = a * a;
+        const Float4 b_squared = b * b;
+        const Float4 a_sqr_magnitude = a_squared + Float4::Shuffle<1, 0, 3, 2>(a_squared);
+        const Float4 b_sqr_magnitude = b_squared + Float4::Shuffle<1, 0, 3, 2>(b_squared);
+        (a * (Float4::Rsqrt(a_sqr_magnitude) & (a_sqr_magnitude > zero))).Store(out[i].coord);
+        (b * (Float4::Rsqrt(b_sqr_magnitude) & (b_sqr_magnitude > zero))).Store(out[i + 2].coord);
+    }
+    for (; i < count; i++) {
+        Vector2f v = in[i];
+        if (!v.NormalizeSafe()) {
+            v = Vector2f(0.0f, 0.0f);
+        }
+        out[i] = v;
+    }
+}
 } // namespace maths
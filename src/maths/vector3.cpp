@@ -25,6 +25,8 @@ SOFTWARE.
 #include "maths/vector3.h"
 #include "maths/angle.h"
 #include "maths/maths_utils.h"
+#include "maths/simd.h"
+#include <algorithm>
 #include <cmath>
 
 namespace maths {
@@ -159,6 +161,19 @@ void Vector3f::Normalize() {
     z /= magnitude;
 }
 
+Vector3f Vector3f::NormalizedFast() const {
+    return *this * ReciprocalSqrt(SqrMagnitude());
+}
+
+bool Vector3f::NormalizeSafe() {
+    const float sqr_magnitude = SqrMagnitude();
+    if (sqr_magnitude <= kZeroSqrMagnitude) {
+        return false;
+    }
+    *this *= ReciprocalSqrt(sqr_magnitude);
+    return true;
+}
+
 // The function Lerp linearly interpolates between two points.
 Vector3f Vector3f::Lerp(const Vector3f& v2, const float t) const {
     return Lerp(*this, v2, t);
@@ -186,4 +201,33 @@ Vector3f Vector3f::Slerp(Vector3f& v2, const float t) const {
         v1 * maths::cos(theta) + relative_vec * maths::sin(theta);
     return new_vec * (magnitude_v1 + (magnitude_v2 - magnitude_v1) * t);
 }
+
+void NormalizeBatch(std::span<const Vector3f> in, std::span<Vector3f> out) {
+    const std::size_t count = std::min(in.size(), out.size());
+    const Float4 zero(kZeroSqrMagnitude);
+    std::size_t i = 0;
+    // One vector per register, transposed squares give four magnitudes at once.
+    for (; i + 4 <= count; i += 4) {
+        Float4 v[4];
+        Float4 squared[4];
+        for (std::size_t k = 0; k < 4; k++) {
+            v[k] = Float4::Load3(in[i + k].coord);
+            squared[k] = v[k] * v[k];
+        }
+        Float4::Transpose(squared[0], squared[1], squared[2], squared[3]);
+        const Float4 sqr_magnitude = squared[0] + squared[1] + squared[2];
+        const Float4 inv = Float4::Rsqrt(sqr_magnitude) & (sqr_magnitude > zero);
+        (v[0] * Float4::Shuffle<0, 0, 0, 0>(inv)).Store3(out[i].coord);
+        (v[1] * Float4::Shuffle<1, 1, 1, 1>(inv)).Store3(out[i + 1].coord);
+        (v[2] * Float4::Shuffle<2, 2, 2, 2>(inv)).Store3(out[i + 2].coord);
+        (v[3] * Float4::Shuffle<3, 3, 3, 3>(inv)).Store3(out[i + 3].coord);
+    }
+    for (; i < count; i++) {
+        Vector3f v = in[i];
+        if (!v.NormalizeSafe()) {
+            v = Vector3f(0.0f, 0.0f, 0.0f);
+        }
+        out[i] = v;
+    }
+}
 } // namespace maths
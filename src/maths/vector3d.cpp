@@ -0,0 +1,83 @@
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "maths/vector3d.h"
+
+#include <cmath>
+
+namespace maths {
+Vector3d Vector3d::operator+(const Vector3d& rhs) const {
+    return {x + rhs.x, y + rhs.y, z + rhs.z};
+}
+
+Vector3d& Vector3d::operator+=(const Vector3d& rhs) {
+    x += rhs.x;
+    y += rhs.y;
+    z += rhs.z;
+    return *this;
+}
+
+Vector3d Vector3d::operator-(const Vector3d& rhs) const {
+    return {x - rhs.x, y - rhs.y, z - rhs.z};
+}
+
+Vector3d& Vector3d::operator-=(const Vector3d& rhs) {
+    x -= rhs.x;
+    y -= rhs.y;
+    z -= rhs.z;
+    return *this;
+}
+
+Vector3d Vector3d::operator*(const double scalar) const {
+    return {x * scalar, y * scalar, z * scalar};
+}
+
+Vector3d Vector3d::operator/(const double scalar) const {
+    return {x / scalar, y / scalar, z / scalar};
+}
+
+bool Vector3d::operator==(const Vector3d& rhs) const {
+    constexpr double kEpsilon = 1e-12;
+    return std::abs(x - rhs.x) < kEpsilon && std::abs(y - rhs.y) < kEpsilon &&
+           std::abs(z - rhs.z) < kEpsilon;
+}
+
+bool Vector3d::operator!=(const Vector3d& rhs) const {
+    return !(*this == rhs);
+}
+
+double Vector3d::Dot(const Vector3d& v1, const Vector3d& v2) {
+    return v1.x * v2.x + v1.y * v2.y + v1.z * v2.z;
+}
+
+// This function calculates the norm.
+double Vector3d::Magnitude() const {
+    return std::sqrt(SqrMagnitude());
+}
+
+// This function calculates the squared length of a vector.
+double Vector3d::SqrMagnitude() const {
+    return x * x + y * y + z * z;
+}
+} // namespace maths
@@ -24,6 +24,9 @@ SOFTWARE.
 
 #include "maths/vector4.h"
 #include "maths/maths_utils.h"
+#include "maths/simd.h"
+
+#include <algorithm>
 
 namespace maths {
 Vector4f::Vector4f(float x, float y, float z, float w)
@@ -143,6 +146,19 @@ void Vector4f::Normalize() {
     w /= magnitude;
 }
 
+Vector4f Vector4f::NormalizedFast() const {
+    return *this * ReciprocalSqrt(SqrMagnitude());
+}
+
+bool Vector4f::NormalizeSafe() {
+    const float sqr_magnitude = SqrMagnitude();
+    if (sqr_magnitude <= kZeroSqrMagnitude) {
+        return false;
+    }
+    *this = *this * ReciprocalSqrt(sqr_magnitude);
+    return true;
+}
+
 // The function Lerp linearly interpolates between two points.
 Vector4f Vector4f::Lerp(const Vector4f& v2, const float t) const {
     return Lerp(*this, v2, t);
@@ -151,4 +167,32 @@ Vector4f Vector4f::Lerp(const Vector4f& v2, const float t) const {
 Vector4f Vector4f::Lerp(const Vector4f& v1, const Vector4f& v2, const float t) {
     return v1 + (v2 - v1) * t;
 }
+
+void NormalizeBatch(std::span<const Vector4f> in, std::span<Vector4f> out) {
+    const std::size_t count = std::min(in.size(), out.size());
+    const Float4 zero(kZeroSqrMagnitude);
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        Float4 v[4];
+        Float4 squared[4];
+        for (std::size_t k = 0; k < 4; k++) {
+            v[k] = Float4::Load(in[i + k].coord);
+            squared[k] = v[k] * v[k];
+        }
+        Float4::Transpose(squared[0], squared[1], squared[2], squared[3]);
+        const Float4 sqr_magnitude = squared[0] + squared[1] + squared[2] + squared[3];
+        const Float4 inv = Float4::Rsqrt(sqr_magnitude) & (sqr_magnitude > zero);
+        (v[0] * Float4::Shuffle<0, 0, 0, 0>(inv)).Store(out[i].coord);
+        (v[1] * Float4::Shuffle<1, 1, 1, 1>(inv)).Store(out[i + 1].coord);
+        (v[2] * Float4::Shuffle<2, 2, 2, 2>(inv)).Store(out[i + 2].coord);
+        (v[3] * Float4::Shuffle<3, 3, 3, 3>(inv)).Store(out[i + 3].coord);
+    }
+    for (; i < count; i++) {
+        Vector4f v = in[i];
+        if (!v.NormalizeSafe()) {
+            v = Vector4f(0.0f, 0.0f, 0.0f, 0.0f);
+        }
+        out[i] = v;
+    }
+}
 } // namespace maths
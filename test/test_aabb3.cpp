@@ -25,6 +25,7 @@ SOFTWARE.
 #include <gtest/gtest.h>
 #include "maths/aabb3.h"
 #include "maths/contact3.h"
+#include "maths/matrix4.h"
 
 namespace maths {
 TEST(Maths, Aabb3_Extent) {
@@ -145,4 +146,57 @@ TEST(Maths, Aabb3_Contain) {
     EXPECT_FALSE(Contain(aabb1, aabb2));
 }
 
+TEST(Maths, Aabb3_UnionExpand) {
+    const AABB3 a(Vector3f{0.0f, 0.0f, 0.0f}, Vector3f{1.0f, 1.0f, 1.0f});
+    const AABB3 b(Vector3f{-1.0f, 0.5f, 2.0f}, Vector3f{0.5f, 3.0f, 4.0f});
+    const AABB3 both = Union(a, b);
+    EXPECT_EQ(both.bottom_left(), (Vector3f{-1.0f, 0.0f, 0.0f}));
+    EXPECT_EQ(both.top_right(), (Vector3f{1.0f, 3.0f, 4.0f}));
+
+    // Empty box is the identity of Union and Expand
+    EXPECT_TRUE(AABB3::Empty().IsEmpty());
+    EXPECT_FALSE(a.IsEmpty());
+    EXPECT_EQ(Union(AABB3::Empty(), a).top_right(), a.top_right());
+    const AABB3 point = Expand(AABB3::Empty(), Vector3f{2.0f, 3.0f, 4.0f});
+    EXPECT_EQ(point.bottom_left(), point.top_right());
+
+    const AABB3 grown = Expand(a, 0.5f);
+    EXPECT_EQ(grown.bottom_left(), (Vector3f{-0.5f, -0.5f, -0.5f}));
+    EXPECT_EQ(grown.top_right(), (Vector3f{1.5f, 1.5f, 1.5f}));
+}
+
+TEST(Maths, Aabb3_Transform) {
+    const AABB3 aabb(Vector3f{-1.0f, -2.0f, -3.0f}, Vector3f{1.0f, 2.0f, 3.0f});
+
+    // Quarter turn around z then translation, translation in column 3
+    const Matrix4f matrix(Vector4f{0.0f, 1.0f, 0.0f, 0.0f}, Vector4f{-1.0f, 0.0f, 0.0f, 0.0f},
+                          Vector4f{0.0f, 0.0f, 1.0f, 0.0f}, Vector4f{10.0f, 20.0f, 30.0f, 1.0f});
+    const AABB3 moved = aabb.Transformed(matrix);
+    EXPECT_FLOAT_EQ(moved.bottom_left().x, 8.0f);
+    EXPECT_FLOAT_EQ(moved.bottom_left().y, 19.0f);
+    EXPECT_FLOAT_EQ(moved.bottom_left().z, 27.0f);
+    EXPECT_FLOAT_EQ(moved.top_right().x, 12.0f);
+    EXPECT_FLOAT_EQ(moved.top_right().y, 21.0f);
+    EXPECT_FLOAT_EQ(moved.top_right().z, 33.0f);
+    EXPECT_TRUE(AABB3::Empty().Transformed(matrix).IsEmpty());
+}
+
+TEST(Maths, Aabb3_TransformedCorners) {
+    // Same bounds as the 8 transformed corners for a sheared matrix
+    const AABB3 aabb(Vector3f{-1.0f, 0.0f, 2.0f}, Vector3f{3.0f, 0.5f, 4.0f});
+    const Matrix4f matrix(Vector4f{0.8f, -0.6f, 0.3f, 0.0f}, Vector4f{0.5f, 1.2f, -0.4f, 0.0f},
+                          Vector4f{-0.2f, 0.1f, 2.0f, 0.0f}, Vector4f{-5.0f, 1.0f, 3.0f, 1.0f});
+    AABB3 expected = AABB3::Empty();
+    for (int corner = 0; corner < 8; corner++) {
+        const Vector4f point = matrix * Vector4f{corner & 1 ? 3.0f : -1.0f, corner & 2 ? 0.5f : 0.0f,
+                                                 corner & 4 ? 4.0f : 2.0f, 1.0f};
+        expected = Expand(expected, Vector3f{point.x, point.y, point.z});
+    }
+    const AABB3 moved = aabb.Transformed(matrix);
+    for (int axis = 0; axis < 3; axis++) {
+        EXPECT_NEAR(moved.bottom_left()[axis], expected.bottom_left()[axis], 1e-5f);
+        EXPECT_NEAR(moved.top_right()[axis], expected.top_right()[axis], 1e-5f);
+    }
+}
+
 }  // namespace maths
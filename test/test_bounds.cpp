@@ -0,0 +1,137 @@
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "maths/bounds.h"
+
+namespace maths {
+
+std::vector<Vector3f> RandomCloud(std::size_t count, unsigned seed)
+{
+	std::mt19937 generator(seed);
+	std::uniform_real_distribution<float> position(-10.0f, 10.0f);
+	std::vector<Vector3f> points;
+	for (std::size_t i = 0; i < count; i++) {
+		points.emplace_back(position(generator), position(generator) * 0.5f + 3.0f, position(generator) * 0.2f);
+	}
+	return points;
+}
+
+TEST(Maths, Bounds_AABB3)
+{
+	EXPECT_TRUE(ComputeAABB3({}).IsEmpty());
+	const std::vector<Vector3f> cloud = RandomCloud(1003, 1);
+	// Every tail length and the SIMD body
+	for (std::size_t count : { 1u, 2u, 3u, 4u, 5u, 7u, 8u, 11u, 1003u }) {
+		const std::span<const Vector3f> points(cloud.data(), count);
+		AABB3 expected = AABB3::Empty();
+		for (const Vector3f& point : points) {
+			expected = Expand(expected, point);
+		}
+		const AABB3 aabb = ComputeAABB3(points);
+		EXPECT_EQ(aabb.bottom_left(), expected.bottom_left());
+		EXPECT_EQ(aabb.top_right(), expected.top_right());
+	}
+}
+
+TEST(Maths, Bounds_Sphere)
+{
+	auto encloses_all = [](const Sphere& sphere, const std::vector<Vector3f>& points) {
+		for (const Vector3f& point : points) {
+			if ((point - sphere.center()).Magnitude() > sphere.radius() * 1.0001f) return false;
+		}
+		return true;
+	};
+
+	const std::vector<Vector3f> cloud = RandomCloud(5000, 2);
+	const Sphere ritter = ComputeRitterSphere(cloud);
+	const Sphere sphere = ComputeBoundingSphere(cloud);
+	EXPECT_TRUE(encloses_all(ritter, cloud));
+	EXPECT_TRUE(encloses_all(sphere, cloud));
+	EXPECT_LE(sphere.radius(), ritter.radius());
+
+	// Points on a unit sphere, the optimal radius is 1
+	std::mt19937 generator(3);
+	std::normal_distribution<float> normal(0.0f, 1.0f);
+	std::vector<Vector3f> shell;
+	for (int i = 0; i < 2000; i++) {
+		shell.push_back(Vector3f{ normal(generator), normal(generator), normal(generator) }.Normalized()
+			+ Vector3f{ 5.0f, -2.0f, 1.0f });
+	}
+	const Sphere shell_sphere = ComputeBoundingSphere(shell);
+	EXPECT_TRUE(encloses_all(shell_sphere, shell));
+	EXPECT_LT(shell_sphere.radius(), 1.05f);
+
+	// Cube corners give the exact sphere
+	std::vector<Vector3f> corners;
+	for (int i = 0; i < 8; i++) {
+		corners.emplace_back(i & 1 ? 1.0f : -1.0f, i & 2 ? 1.0f : -1.0f, i & 4 ? 1.0f : -1.0f);
+	}
+	const Sphere cube_sphere = ComputeBoundingSphere(corners);
+	EXPECT_NEAR(cube_sphere.radius(), std::sqrt(3.0f), 1e-4f);
+	EXPECT_NEAR(cube_sphere.center().Magnitude(), 0.0f, 1e-4f);
+
+	EXPECT_EQ(ComputeBoundingSphere(std::span<const Vector3f>(corners.data(), 1)).radius(), 0.0f);
+	EXPECT_EQ(ComputeBoundingSphere({}).radius(), 0.0f);
+}
+
+TEST(Maths, Bounds_OBB3)
+{
+	// Box of size 10 x 2 x 1 turned around z and x, filled with points
+	const float c = std::cos(0.5f), s = std::sin(0.5f);
+	const Vector3f u = Vector3f{ c, s, 0.0f };
+	const Vector3f v = Vector3f{ -s * c, c * c, s };
+	const Vector3f w = Vector3f::Cross(u, v);
+	const Vector3f origin{ 3.0f, -1.0f, 2.0f };
+	std::mt19937 generator(4);
+	std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+	std::vector<Vector3f> points;
+	for (int i = 0; i < 4000; i++) {
+		points.push_back(origin + u * (5.0f * unit(generator)) + v * unit(generator) + w * (0.5f * unit(generator)));
+	}
+	for (int i = 0; i < 8; i++) {
+		points.push_back(origin + u * (i & 1 ? 5.0f : -5.0f) + v * (i & 2 ? 1.0f : -1.0f) + w * (i & 4 ? 0.5f : -0.5f));
+	}
+
+	const OBB3 obb = ComputeOBB3(points);
+	for (const Vector3f& point : points) {
+		EXPECT_TRUE(obb.Contains(point, 1e-3f));
+	}
+	EXPECT_NEAR(obb.volume(), 20.0f, 1.5f);
+	EXPECT_LT(obb.volume(), OBB3(ComputeAABB3(points)).volume());
+	EXPECT_NEAR(std::abs(obb.axis(0).Dot(u)), 1.0f, 1e-3f);
+	EXPECT_NEAR((obb.center() - origin).Magnitude(), 0.0f, 1e-3f);
+
+	// Axis aligned input keeps the AABB
+	const std::vector<Vector3f> cloud = RandomCloud(500, 5);
+	const OBB3 aligned = ComputeOBB3(cloud);
+	EXPECT_LE(aligned.volume(), OBB3(ComputeAABB3(cloud)).volume());
+}
+
+} // namespace maths
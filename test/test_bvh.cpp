@@ -0,0 +1,351 @@
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "maths/bvh.h"
+
+namespace maths {
+
+std::vector<AABB3> RandomScene(std::size_t count, unsigned seed)
+{
+	std::mt19937 generator(seed);
+	std::uniform_real_distribution<float> position(-60.0f, 60.0f);
+	std::uniform_real_distribution<float> size(0.1f, 3.0f);
+	std::vector<AABB3> aabbs;
+	for (std::size_t i = 0; i < count; i++) {
+		const Vector3f min{ position(generator), position(generator), position(generator) };
+		aabbs.emplace_back(min, min + Vector3f{ size(generator), size(generator), size(generator) });
+	}
+	return aabbs;
+}
+
+Frustum TestFrustum()
+{
+	Vector3f up{ 0.0f, 1.0f, 0.0f };
+	Vector3f direction{ 0.0f, 0.0f, 1.0f };
+	Vector3f right = Vector3f::Cross(up, direction);
+	Frustum frustum;
+	frustum.calculate_frustum(direction, Vector3f{}, right, up, 0.1f, 50.0f,
+		degree_t(45.0f), degree_t(45.0f));
+	return frustum;
+}
+
+// Every node is reached once from the root and bounds its children, every
+// item is in exactly one leaf
+void ExpectValidBvh(const Bvh& bvh, const std::vector<AABB3>& aabbs)
+{
+	auto inside = [](const AABB3& outer, const AABB3& inner) {
+		for (int axis = 0; axis < 3; axis++) {
+			if (inner.bottom_left()[axis] < outer.bottom_left()[axis]) return false;
+			if (inner.top_right()[axis] > outer.top_right()[axis]) return false;
+		}
+		return true;
+	};
+	std::vector<int> reached(bvh.nodes().size(), 0);
+	std::vector<int> item_seen(aabbs.size(), 0);
+	std::vector<std::uint32_t> stack{ 0 };
+	while (!stack.empty()) {
+		const std::uint32_t index = stack.back();
+		stack.pop_back();
+		reached[index]++;
+		const BvhNode& node = bvh.nodes()[index];
+		if (node.IsLeaf()) {
+			for (std::uint32_t i = node.first; i < node.first + node.count; i++) {
+				const std::uint32_t item = bvh.items()[i];
+				item_seen[item]++;
+				EXPECT_TRUE(inside(node.bounds, aabbs[item]));
+			}
+		} else {
+			ASSERT_LT(node.first + 1, bvh.nodes().size());
+			EXPECT_TRUE(inside(node.bounds, bvh.nodes()[node.first].bounds));
+			EXPECT_TRUE(inside(node.bounds, bvh.nodes()[node.first + 1].bounds));
+			stack.push_back(node.first);
+			stack.push_back(node.first + 1);
+		}
+	}
+	EXPECT_TRUE(std::all_of(reached.begin(), reached.end(), [](int count) { return count <= 1; }));
+	EXPECT_TRUE(std::all_of(item_seen.begin(), item_seen.end(), [](int count) { return count == 1; }));
+}
+
+TEST(Maths, Bvh_Build)
+{
+	const std::vector<AABB3> aabbs = RandomScene(1000, 1);
+	Bvh bvh;
+	bvh.Build(aabbs, 4);
+	ASSERT_FALSE(bvh.empty());
+
+	std::vector<std::uint32_t> items = bvh.items();
+	std::sort(items.begin(), items.end());
+	for (std::uint32_t i = 0; i < items.size(); i++) {
+		EXPECT_EQ(items[i], i);
+	}
+
+	// Every node contains its children or its items
+	auto inside = [](const AABB3& outer, const AABB3& inner) {
+		for (int axis = 0; axis < 3; axis++) {
+			if (inner.bottom_left()[axis] < outer.bottom_left()[axis]) return false;
+			if (inner.top_right()[axis] > outer.top_right()[axis]) return false;
+		}
+		return true;
+	};
+	std::size_t leaf_items = 0;
+	for (const BvhNode& node : bvh.nodes()) {
+		if (node.IsLeaf()) {
+			EXPECT_LE(node.count, 4u);
+			leaf_items += node.count;
+			for (std::uint32_t i = node.first; i < node.first + node.count; i++) {
+				EXPECT_TRUE(inside(node.bounds, aabbs[bvh.items()[i]]));
+			}
+		} else {
+			EXPECT_TRUE(inside(node.bounds, bvh.nodes()[node.first].bounds));
+			EXPECT_TRUE(inside(node.bounds, bvh.nodes()[node.first + 1].bounds));
+		}
+	}
+	EXPECT_EQ(leaf_items, aabbs.size());
+
+	// Degenerate input with every box at the same place still terminates
+	const std::vector<AABB3> same(100, AABB3{ Vector3f{}, Vector3f{ 1.0f, 1.0f, 1.0f } });
+	bvh.Build(same, 2);
+	EXPECT_EQ(bvh.items().size(), same.size());
+
+	// Centers a denormal apart would overflow the bin scale
+	std::vector<AABB3> denormal;
+	for (int i = 0; i < 100; i++) {
+		const float x = (i % 2) * std::numeric_limits<float>::denorm_min();
+		denormal.emplace_back(Vector3f{ x, 0.0f, 0.0f }, Vector3f{ x, 1.0f, 1.0f });
+	}
+	bvh.Build(denormal, 2);
+	EXPECT_EQ(bvh.items().size(), denormal.size());
+}
+
+TEST(Maths, Bvh_CullFrustum)
+{
+	const std::vector<AABB3> aabbs = RandomScene(5000, 2);
+	const Frustum frustum = TestFrustum();
+	Bvh bvh;
+	bvh.Build(aabbs, 1);
+
+	std::vector<std::uint32_t> expected;
+	for (std::uint32_t i = 0; i < aabbs.size(); i++) {
+		if (frustum.contains(aabbs[i])) expected.push_back(i);
+	}
+	ASSERT_FALSE(expected.empty());
+	ASSERT_LT(expected.size(), aabbs.size());
+
+	BvhCullCache cache;
+	for (int frame = 0; frame < 2; frame++) {
+		std::vector<std::uint32_t> visible;
+		bvh.CullFrustum(frustum, cache, visible);
+		std::sort(visible.begin(), visible.end());
+		EXPECT_EQ(visible, expected);
+	}
+	EXPECT_EQ(cache.last_plane.size(), bvh.nodes().size());
+	EXPECT_TRUE(std::any_of(cache.last_plane.begin(), cache.last_plane.end(),
+		[](std::uint8_t plane) { return plane != Frustum::kNoPlane; }));
+}
+
+TEST(Maths, Bvh_BuildLinear)
+{
+	const std::vector<AABB3> aabbs = RandomScene(20000, 3);
+	Bvh bvh;
+	JobSystem jobs(4);
+	bvh.BuildLinear(aabbs, jobs);
+	ASSERT_EQ(bvh.nodes().size(), 2 * aabbs.size() - 1);
+
+	ExpectValidBvh(bvh, aabbs);
+	for (const BvhNode& node : bvh.nodes()) {
+		EXPECT_LE(node.count, 1u);
+	}
+
+	// Same tree whatever the thread count
+	Bvh single;
+	JobSystem one_thread(1);
+	single.BuildLinear(aabbs, one_thread);
+	EXPECT_EQ(single.items(), bvh.items());
+	for (std::size_t i = 0; i < bvh.nodes().size(); i++) {
+		EXPECT_EQ(single.nodes()[i].first, bvh.nodes()[i].first);
+		EXPECT_EQ(single.nodes()[i].bounds.center(), bvh.nodes()[i].bounds.center());
+	}
+
+	// Duplicated centroids and tiny inputs
+	const std::vector<AABB3> same(100, AABB3{ Vector3f{}, Vector3f{ 1.0f, 1.0f, 1.0f } });
+	bvh.BuildLinear(same, jobs);
+	EXPECT_EQ(bvh.nodes().size(), 2 * same.size() - 1);
+	EXPECT_EQ(bvh.nodes()[0].bounds.top_right(), (Vector3f{ 1.0f, 1.0f, 1.0f }));
+	bvh.BuildLinear(std::span<const AABB3>(aabbs.data(), 1), jobs);
+	EXPECT_EQ(bvh.nodes().size(), 1u);
+	bvh.BuildLinear({}, jobs);
+	EXPECT_TRUE(bvh.empty());
+}
+
+TEST(Maths, Bvh_Queries)
+{
+	const std::vector<AABB3> aabbs = RandomScene(5000, 4);
+	const Frustum frustum = TestFrustum();
+	const Sphere sphere{ 10.0f, Vector3f{ 5.0f, -3.0f, 20.0f } };
+	Vector3f origin{ -70.0f, -2.0f, -65.0f };
+	Vector3f direction{ 1.0f, 0.05f, 0.9f };
+	const Ray3 ray{ origin, direction };
+
+	std::vector<std::uint32_t> expected_sphere, expected_frustum;
+	float expected_distance = std::numeric_limits<float>::infinity();
+	const SlabRay slab_ray(ray);
+	for (std::uint32_t i = 0; i < aabbs.size(); i++) {
+		if (AABBOverlapSphere(aabbs[i], sphere)) expected_sphere.push_back(i);
+		if (frustum.contains(aabbs[i])) expected_frustum.push_back(i);
+		float distance;
+		if (slab_ray.Intersect(aabbs[i], expected_distance, distance)) {
+			expected_distance = std::min(expected_distance, distance);
+		}
+	}
+	ASSERT_FALSE(expected_sphere.empty());
+	ASSERT_LT(expected_distance, std::numeric_limits<float>::infinity());
+
+	Bvh sah, linear;
+	sah.Build(aabbs, 4);
+	linear.BuildLinear(aabbs);
+	for (const Bvh* bvh : { &sah, &linear }) {
+		std::vector<std::uint32_t> result;
+		bvh->QuerySphere(aabbs, sphere, result);
+		std::sort(result.begin(), result.end());
+		EXPECT_EQ(result, expected_sphere);
+
+		float distance;
+		const std::uint32_t hit = bvh->Raycast(aabbs, ray, distance);
+		ASSERT_NE(hit, Bvh::kInvalidItem);
+		EXPECT_FLOAT_EQ(distance, expected_distance);
+		EXPECT_EQ(bvh->Raycast(aabbs, ray, distance, expected_distance * 0.5f), Bvh::kInvalidItem);
+	}
+
+	BvhCullCache cache;
+	std::vector<std::uint32_t> visible;
+	linear.CullFrustum(frustum, cache, visible);
+	std::sort(visible.begin(), visible.end());
+	EXPECT_EQ(visible, expected_frustum);
+}
+
+TEST(Maths, Bvh_Refit)
+{
+	std::vector<AABB3> aabbs = RandomScene(5000, 5);
+	Bvh bvh;
+	bvh.Build(aabbs, 4);
+	const float built_cost = bvh.SahCost();
+	const std::size_t node_count = bvh.nodes().size();
+
+	// Rigid motion keeps the tree quality, nothing is rebuilt
+	const Vector3f offset{ 3.0f, -1.0f, 0.5f };
+	for (AABB3& aabb : aabbs) {
+		aabb = AABB3{ aabb.bottom_left() + offset, aabb.top_right() + offset };
+	}
+	JobSystem jobs(4);
+	EXPECT_EQ(bvh.RefitAndRebuild(aabbs, 1.5f, jobs), 0u);
+	EXPECT_EQ(bvh.nodes().size(), node_count);
+	EXPECT_NEAR(bvh.SahCost(), built_cost, built_cost * 0.01f);
+	ExpectValidBvh(bvh, aabbs);
+
+	const Sphere sphere{ 12.0f, Vector3f{ 0.0f, 5.0f, -10.0f } };
+	std::vector<std::uint32_t> expected, result;
+	for (std::uint32_t i = 0; i < aabbs.size(); i++) {
+		if (AABBOverlapSphere(aabbs[i], sphere)) expected.push_back(i);
+	}
+	bvh.QuerySphere(aabbs, sphere, result);
+	std::sort(result.begin(), result.end());
+	EXPECT_EQ(result, expected);
+}
+
+TEST(Maths, Bvh_RefitRebuild)
+{
+	std::vector<AABB3> aabbs = RandomScene(5000, 6);
+	Bvh bvh, refit_only;
+	bvh.BuildLinear(aabbs);
+	refit_only.BuildLinear(aabbs);
+
+	// Items of one region scatter over the scene
+	std::mt19937 generator(7);
+	std::uniform_real_distribution<float> position(-60.0f, 60.0f);
+	for (AABB3& aabb : aabbs) {
+		if (aabb.bottom_left().x < -30.0f) {
+			const Vector3f size = aabb.top_right() - aabb.bottom_left();
+			const Vector3f min{ position(generator), position(generator), position(generator) };
+			aabb = AABB3{ min, min + size };
+		}
+	}
+	refit_only.Refit(aabbs);
+	ExpectValidBvh(refit_only, aabbs);
+	const std::uint32_t rebuilt = bvh.RefitAndRebuild(aabbs, 1.5f);
+	EXPECT_GT(rebuilt, 0u);
+	EXPECT_LT(rebuilt, 64u);
+	EXPECT_LT(bvh.SahCost(), refit_only.SahCost());
+	ExpectValidBvh(bvh, aabbs);
+
+	// The rebuilt subtrees are kept as the new reference
+	EXPECT_EQ(bvh.RefitAndRebuild(aabbs, 1.5f), 0u);
+
+	float distance;
+	Vector3f origin{ -70.0f, 0.0f, 0.0f };
+	Vector3f direction{ 1.0f, 0.01f, 0.02f };
+	const Ray3 ray{ origin, direction };
+	float expected_distance = std::numeric_limits<float>::infinity();
+	const SlabRay slab_ray(ray);
+	for (const AABB3& aabb : aabbs) {
+		float item_distance;
+		if (slab_ray.Intersect(aabb, expected_distance, item_distance)) {
+			expected_distance = std::min(expected_distance, item_distance);
+		}
+	}
+	ASSERT_NE(bvh.Raycast(aabbs, ray, distance), Bvh::kInvalidItem);
+	EXPECT_FLOAT_EQ(distance, expected_distance);
+}
+
+TEST(Maths, Frustum_ClassifyAABB)
+{
+	const Frustum frustum = TestFrustum();
+	const std::vector<AABB3> aabbs = RandomScene(500, 3);
+	for (const AABB3& aabb : aabbs) {
+		Frustum::PlaneMask mask = Frustum::kAllPlanes;
+		std::uint8_t last_plane = Frustum::kNoPlane;
+		EXPECT_EQ(frustum.ClassifyAABB(aabb, mask, last_plane), frustum.contains(aabb));
+	}
+
+	// A small box right in front of the camera is inside every plane
+	const AABB3 small{ Vector3f{ -0.1f, -0.1f, -5.1f }, Vector3f{ 0.1f, 0.1f, -4.9f } };
+	Frustum::PlaneMask mask = Frustum::kAllPlanes;
+	std::uint8_t last_plane = Frustum::kNoPlane;
+	EXPECT_TRUE(frustum.ClassifyAABB(small, mask, last_plane));
+	EXPECT_EQ(mask, 0);
+
+	// Rejected boxes remember the rejecting plane
+	const AABB3 behind{ Vector3f{ -0.1f, -0.1f, 4.9f }, Vector3f{ 0.1f, 0.1f, 5.1f } };
+	mask = Frustum::kAllPlanes;
+	EXPECT_FALSE(frustum.ClassifyAABB(behind, mask, last_plane));
+	EXPECT_NE(last_plane, Frustum::kNoPlane);
+}
+
+} // namespace maths
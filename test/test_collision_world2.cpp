@@ -0,0 +1,230 @@
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "maths/collision_world2.h"
+
+namespace maths {
+
+TEST(Maths, CollisionWorld2_Events)
+{
+	CollisionWorld2 world;
+	const auto a = world.Add(AABB2({ 0.0f, 0.0f }, { 1.0f, 1.0f }));
+	const auto b = world.Add(AABB2({ 3.0f, 0.0f }, { 4.0f, 1.0f }));
+	world.Step();
+	EXPECT_TRUE(world.overlaps().empty());
+	EXPECT_TRUE(world.begin_events().empty());
+
+	// Touching edges count
+	world.Move(b, AABB2({ 1.0f, 0.5f }, { 2.0f, 1.5f }));
+	world.Step();
+	ASSERT_EQ(world.begin_events().size(), 1u);
+	EXPECT_EQ(world.begin_events()[0].a, a);
+	EXPECT_EQ(world.begin_events()[0].b, b);
+	EXPECT_TRUE(world.end_events().empty());
+	EXPECT_EQ(world.overlaps().size(), 1u);
+
+	// Still touching: no event
+	world.Move(b, AABB2({ 0.5f, 0.5f }, { 1.5f, 1.5f }));
+	world.Step();
+	EXPECT_TRUE(world.begin_events().empty());
+	EXPECT_TRUE(world.end_events().empty());
+	EXPECT_EQ(world.overlaps().size(), 1u);
+
+	// Contained still touches, although Overlap alone says no
+	world.Move(b, AABB2({ 0.25f, 0.25f }, { 0.75f, 0.75f }));
+	world.Step();
+	EXPECT_EQ(world.overlaps().size(), 1u);
+	EXPECT_TRUE(world.end_events().empty());
+
+	// Apart on y only
+	world.Move(b, AABB2({ 0.25f, 2.0f }, { 0.75f, 3.0f }));
+	world.Step();
+	ASSERT_EQ(world.end_events().size(), 1u);
+	EXPECT_EQ(world.end_events()[0].a, a);
+	EXPECT_EQ(world.end_events()[0].b, b);
+	EXPECT_TRUE(world.overlaps().empty());
+}
+
+TEST(Maths, CollisionWorld2_ExactShapes)
+{
+	CollisionWorld2 world;
+	// The circle bounds overlap the box corner but the circle does not
+	const auto box = world.Add(AABB2({ 0.0f, 0.0f }, { 1.0f, 1.0f }));
+	const auto circle = world.Add(Circle(1.0f, { 1.8f, 1.8f }));
+	world.Step();
+	EXPECT_TRUE(world.overlaps().empty());
+
+	world.Move(circle, Circle(1.0f, { 1.5f, 1.5f }));
+	world.Step();
+	ASSERT_EQ(world.begin_events().size(), 1u);
+	EXPECT_EQ(world.begin_events()[0].a, box);
+
+	// Circles: overlapping bounds, apart in distance, then one inside the other
+	const auto c1 = world.Add(Circle(1.0f, { 10.0f, 10.0f }));
+	const auto c2 = world.Add(Circle(1.0f, { 11.6f, 11.6f }));
+	world.Step();
+	EXPECT_EQ(world.overlaps().size(), 1u);
+	world.Move(c2, Circle(0.25f, { 10.1f, 10.0f }));
+	world.Step();
+	ASSERT_EQ(world.begin_events().size(), 1u);
+	EXPECT_EQ(world.begin_events()[0].a, c1);
+	EXPECT_EQ(world.begin_events()[0].b, c2);
+
+	// A proxy can change kind when it moves
+	world.Move(c2, AABB2({ 10.8f, 10.8f }, { 11.5f, 11.5f }));
+	world.Step();
+	ASSERT_EQ(world.end_events().size(), 1u);
+	EXPECT_EQ(world.end_events()[0].b, c2);
+}
+
+TEST(Maths, CollisionWorld2_RemoveAndReuse)
+{
+	CollisionWorld2 world;
+	const auto a = world.Add(Circle(1.0f, { 0.0f, 0.0f }));
+	const auto b = world.Add(Circle(1.0f, { 1.0f, 0.0f }));
+	world.Step();
+	EXPECT_EQ(world.overlaps().size(), 1u);
+
+	// The handle stays reserved until its end event was reported
+	world.Remove(b);
+	EXPECT_FALSE(world.valid(b));
+	const auto c = world.Add(AABB2({ 5.0f, 5.0f }, { 6.0f, 6.0f }));
+	EXPECT_NE(c, b);
+	world.Step();
+	ASSERT_EQ(world.end_events().size(), 1u);
+	EXPECT_EQ(world.end_events()[0].a, a);
+	EXPECT_EQ(world.end_events()[0].b, b);
+	EXPECT_EQ(world.size(), 2u);
+
+	// Then it is reused, and a new pair on it is a begin event
+	const auto d = world.Add(Circle(1.0f, { 1.0f, 0.0f }));
+	EXPECT_EQ(d, b);
+	world.Step();
+	EXPECT_EQ(world.begin_events().size(), 1u);
+	EXPECT_TRUE(world.end_events().empty());
+
+	// Invalid handles are ignored
+	world.Remove(CollisionWorld2::kInvalidHandle);
+	world.Move(CollisionWorld2::kInvalidHandle, Circle(1.0f, { 0.0f, 0.0f }));
+	world.Remove(a);
+	world.Remove(a);
+	EXPECT_EQ(world.size(), 2u);
+}
+
+TEST(Maths, CollisionWorld2_MatchesBruteForce)
+{
+	constexpr std::size_t kProxies = 300;
+	std::mt19937 generator(50);
+	std::uniform_real_distribution<float> position(-40.0f, 40.0f);
+	std::uniform_real_distribution<float> size(0.2f, 3.0f);
+	std::uniform_real_distribution<float> step(-0.5f, 0.5f);
+
+	struct Shape {
+		bool circle;
+		Vector2f center;
+		Vector2f half;
+	};
+	std::vector<Shape> shapes;
+	for (std::size_t i = 0; i < kProxies; i++) {
+		shapes.push_back({ i % 3 == 0, { position(generator), position(generator) }, { size(generator), size(generator) } });
+	}
+	auto to_aabb = [](const Shape& shape) { return AABB2(shape.center - shape.half, shape.center + shape.half); };
+	auto to_circle = [](const Shape& shape) { return Circle(shape.half.x, shape.center); };
+
+	CollisionWorld2 world;
+	std::vector<CollisionWorld2::Handle> handles;
+	for (const Shape& shape : shapes) {
+		handles.push_back(shape.circle ? world.Add(to_circle(shape)) : world.Add(to_aabb(shape)));
+	}
+
+	std::vector<std::pair<std::uint32_t, std::uint32_t>> previous;
+	std::size_t memory_after_warmup = 0;
+	for (int frame = 0; frame < 40; frame++) {
+		for (std::size_t i = 0; i < kProxies; i++) {
+			shapes[i].center += Vector2f(step(generator), step(generator));
+			if (shapes[i].circle) {
+				world.Move(handles[i], to_circle(shapes[i]));
+			} else {
+				world.Move(handles[i], to_aabb(shapes[i]));
+			}
+		}
+		world.Step();
+
+		std::vector<std::pair<std::uint32_t, std::uint32_t>> expected;
+		for (std::size_t i = 0; i < kProxies; i++) {
+			for (std::size_t j = i + 1; j < kProxies; j++) {
+				const Shape& a = shapes[i];
+				const Shape& b = shapes[j];
+				bool touch;
+				if (!a.circle && !b.circle) {
+					touch = Overlap(to_aabb(a), to_aabb(b)) || Contain(to_aabb(a), to_aabb(b))
+						|| Contain(to_aabb(b), to_aabb(a));
+				} else if (a.circle && b.circle) {
+					touch = OverlapCircle(to_circle(a), to_circle(b)) || ContainCircle(to_circle(a), to_circle(b))
+						|| ContainCircle(to_circle(b), to_circle(a));
+				} else {
+					touch = a.circle ? AABBOverlapCircle(to_aabb(b), to_circle(a)) : AABBOverlapCircle(to_aabb(a), to_circle(b));
+				}
+				if (touch) {
+					expected.emplace_back(handles[i], handles[j]);
+				}
+			}
+		}
+		std::sort(expected.begin(), expected.end());
+
+		std::vector<std::pair<std::uint32_t, std::uint32_t>> overlaps;
+		for (const CollisionPair2& pair : world.overlaps()) {
+			overlaps.emplace_back(pair.a, pair.b);
+		}
+		ASSERT_EQ(overlaps, expected) << frame;
+
+		std::vector<std::pair<std::uint32_t, std::uint32_t>> began;
+		std::vector<std::pair<std::uint32_t, std::uint32_t>> ended;
+		std::set_difference(expected.begin(), expected.end(), previous.begin(), previous.end(), std::back_inserter(began));
+		std::set_difference(previous.begin(), previous.end(), expected.begin(), expected.end(), std::back_inserter(ended));
+		ASSERT_EQ(world.begin_events().size(), began.size());
+		ASSERT_EQ(world.end_events().size(), ended.size());
+		for (std::size_t k = 0; k < began.size(); k++) {
+			EXPECT_EQ(world.begin_events()[k].a, began[k].first);
+			EXPECT_EQ(world.begin_events()[k].b, began[k].second);
+		}
+		previous = expected;
+
+		// Buffers stop growing once the pair count settles
+		if (frame == 0) {
+			world.Reserve(kProxies, 4 * expected.size());
+			memory_after_warmup = world.memory_usage();
+		} else {
+			EXPECT_EQ(world.memory_usage(), memory_after_warmup);
+		}
+	}
+}
+
+} // namespace maths
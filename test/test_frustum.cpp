@@ -2,8 +2,11 @@
 #include <gtest/gtest.h>
 
 #include "maths/frustum.h"
+#include "maths/projection.h"
 #include "maths/angle.h"
 
+#include <vector>
+
 namespace maths {
 
 TEST(Maths, Frustum_Contain_Point)
@@ -98,7 +101,113 @@ TEST(Maths, Frustum_Contain_Sphere)
     center = Vector3f{ 10.0f,10.0f,-10.0f };
     sphere = Sphere{ radius,center };
     EXPECT_FALSE(frustum.contains(sphere));
-	
+
+    // Straddling the near plane but far outside the right one
+    const Frustum perspective = PerspectiveFrustum(radian_t(1.5707963f), 1.0f, 1.0f, 100.0f);
+    const Sphere straddling{ 1.0f, Vector3f{ 500.0f, 0.0f, -1.0f } };
+    EXPECT_FALSE(perspective.contains(straddling));
+    std::vector<std::uint8_t> result(1);
+    perspective.ContainsBatch(std::span<const Sphere>(&straddling, 1), result);
+    EXPECT_EQ(result[0], 0);
+    EXPECT_TRUE(perspective.contains(Sphere{ 1.0f, Vector3f{ 0.0f, 0.0f, -1.0f } }));
 }
 
-}
\ No newline at end of file
+TEST(Maths, Frustum_FromMatrix)
+{
+    // OpenGL perspective, 90 degrees fov, near 1, far 100, looking down -z
+    const float n = 1.0f;
+    const float f = 100.0f;
+    const Matrix4f projection(Vector4f(1.0f, 0.0f, 0.0f, 0.0f),
+                              Vector4f(0.0f, 1.0f, 0.0f, 0.0f),
+                              Vector4f(0.0f, 0.0f, (f + n) / (n - f), -1.0f),
+                              Vector4f(0.0f, 0.0f, 2.0f * f * n / (n - f), 0.0f));
+    const Frustum frustum(projection);
+
+    for (int i = 0; i < 6; i++) {
+        EXPECT_NEAR(frustum.plane(i).normal().Magnitude(), 1.0f, 1e-5f);
+    }
+    EXPECT_TRUE(frustum.contains(Vector3f{ 0.0f, 0.0f, -10.0f }));
+    EXPECT_TRUE(frustum.contains(Vector3f{ 9.0f, -9.0f, -10.0f }));
+    EXPECT_FALSE(frustum.contains(Vector3f{ 0.0f, 0.0f, 10.0f }));
+    EXPECT_FALSE(frustum.contains(Vector3f{ 11.0f, 0.0f, -10.0f }));
+    EXPECT_FALSE(frustum.contains(Vector3f{ 0.0f, 0.0f, -0.5f }));
+    EXPECT_FALSE(frustum.contains(Vector3f{ 0.0f, 0.0f, -150.0f }));
+    // Distances are in world units once the planes are normalized
+    EXPECT_NEAR(frustum.plane(0).Distance(Vector3f{ 0.0f, 0.0f, -3.0f }), 2.0f, 1e-4f);
+
+    // Direct3D depth range gives the same volume
+    const Matrix4f projection_d3d(Vector4f(1.0f, 0.0f, 0.0f, 0.0f),
+                                  Vector4f(0.0f, 1.0f, 0.0f, 0.0f),
+                                  Vector4f(0.0f, 0.0f, f / (n - f), -1.0f),
+                                  Vector4f(0.0f, 0.0f, f * n / (n - f), 0.0f));
+    const Frustum frustum_d3d(projection_d3d, ClipDepth::kZeroToOne);
+    EXPECT_NEAR(frustum_d3d.plane(0).Distance(Vector3f{ 0.0f, 0.0f, -3.0f }), 2.0f, 1e-4f);
+    EXPECT_FALSE(frustum_d3d.contains(Vector3f{ 0.0f, 0.0f, -0.5f }));
+    EXPECT_TRUE(frustum_d3d.contains(Vector3f{ 0.0f, 0.0f, -99.0f }));
+}
+
+TEST(Maths, Frustum_FromReverseZMatrix)
+{
+    // The [0, 1] near row of an infinite reverse Z projection has a zero
+    // normal, the plane must neither accept nor reject spheres
+    const Frustum frustum(PerspectiveReverseZ(radian_t(1.5707963f), 1.0f, 0.1f), ClipDepth::kZeroToOne);
+    const std::vector<Sphere> spheres{
+        Sphere{ 1.0f, Vector3f{ 0.0f, 0.0f, -10.0f } },
+        Sphere{ 1.0f, Vector3f{ 0.0f, 0.0f, -1e6f } },
+        Sphere{ 1.0f, Vector3f{ 10.5f, 0.0f, -10.0f } },
+        Sphere{ 1.0f, Vector3f{ 0.0f, 0.0f, 5.0f } },
+        Sphere{ 1.0f, Vector3f{ 1000.0f, 0.0f, -10.0f } },
+        Sphere{ 1.0f, Vector3f{ 0.0f, -1000.0f, -10.0f } } };
+    EXPECT_TRUE(frustum.contains(spheres[0]));
+    EXPECT_TRUE(frustum.contains(spheres[1]));
+    EXPECT_TRUE(frustum.contains(spheres[2]));
+    EXPECT_FALSE(frustum.contains(spheres[3]));
+    EXPECT_FALSE(frustum.contains(spheres[4]));
+    EXPECT_FALSE(frustum.contains(spheres[5]));
+
+    std::vector<std::uint8_t> result(spheres.size());
+    frustum.ContainsBatch(spheres, result);
+    for (std::size_t i = 0; i < spheres.size(); i++) {
+        EXPECT_EQ(result[i], frustum.contains(spheres[i]));
+    }
+}
+
+TEST(Maths, Frustum_ContainsBatch)
+{
+    const float n = 1.0f;
+    const float f = 100.0f;
+    const Matrix4f projection(Vector4f(1.0f, 0.0f, 0.0f, 0.0f),
+                              Vector4f(0.0f, 1.0f, 0.0f, 0.0f),
+                              Vector4f(0.0f, 0.0f, (f + n) / (n - f), -1.0f),
+                              Vector4f(0.0f, 0.0f, 2.0f * f * n / (n - f), 0.0f));
+    const Frustum frustum(projection);
+    EXPECT_EQ(frustum.planes_soa().d[6], 1.0f);
+
+    std::vector<Sphere> spheres;
+    std::vector<AABB3> aabbs;
+    for (int i = 0; i < 200; i++) {
+        const Vector3f center{ (i % 13) * 3.0f - 18.0f, (i % 7) * 4.0f - 12.0f, (i % 11) * -15.0f + 20.0f };
+        spheres.emplace_back(1.5f, center);
+        aabbs.emplace_back(center - Vector3f{ 1.0f, 2.0f, 1.0f }, center + Vector3f{ 1.0f, 2.0f, 1.0f });
+    }
+    std::vector<std::uint8_t> sphere_result(spheres.size());
+    std::vector<std::uint8_t> aabb_result(aabbs.size());
+    frustum.ContainsBatch(spheres, sphere_result);
+    frustum.ContainsBatch(aabbs, aabb_result);
+
+    int visible = 0;
+    for (std::size_t i = 0; i < spheres.size(); i++) {
+        bool inside = true;
+        for (int p = 0; p < 6; p++) {
+            inside &= frustum.plane(p).Distance(spheres[i].center()) >= -spheres[i].radius();
+        }
+        EXPECT_EQ(sphere_result[i], inside);
+        EXPECT_EQ(frustum.contains(spheres[i]), inside);
+        EXPECT_EQ(aabb_result[i], frustum.contains(aabbs[i]));
+        visible += inside;
+    }
+    EXPECT_GT(visible, 0);
+    EXPECT_LT(visible, 200);
+}
+
+}
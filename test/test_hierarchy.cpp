@@ -0,0 +1,194 @@
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+#include "maths/hierarchy.h"
+
+namespace maths {
+
+// Random forest with parents before children
+std::vector<std::uint32_t> RandomHierarchy(std::size_t count, unsigned seed)
+{
+	std::mt19937 generator(seed);
+	std::vector<std::uint32_t> parents(count);
+	for (std::size_t i = 0; i < count; i++) {
+		parents[i] = i == 0 || generator() % 16 == 0
+			? kNoParent : static_cast<std::uint32_t>(generator() % i);
+	}
+	return parents;
+}
+
+Matrix4f MultiplyReference(const Matrix4f& a, const Matrix4f& b)
+{
+	Matrix4f result;
+	for (int column = 0; column < 4; column++) {
+		for (int row = 0; row < 4; row++) {
+			float sum = 0.0f;
+			for (int k = 0; k < 4; k++) {
+				sum += a[k][row] * b[column][k];
+			}
+			result[column][row] = sum;
+		}
+	}
+	return result;
+}
+
+void ExpectMatrixNear(const Matrix4f& a, const Matrix4f& b, float tolerance)
+{
+	for (int column = 0; column < 4; column++) {
+		for (int row = 0; row < 4; row++) {
+			EXPECT_NEAR(a[column][row], b[column][row], tolerance) << column << " " << row;
+		}
+	}
+}
+
+TEST(Maths, Hierarchy_UpdateMatrices)
+{
+	const std::vector<std::uint32_t> parents = RandomHierarchy(2000, 1);
+	std::mt19937 generator(2);
+	std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+	std::vector<Matrix4f> local(parents.size());
+	for (Matrix4f& matrix : local) {
+		matrix = Matrix4f(Vector4f(1.0f + 0.1f * value(generator), 0.1f * value(generator), 0.1f * value(generator), 0.0f),
+			Vector4f(0.1f * value(generator), 1.0f + 0.1f * value(generator), 0.1f * value(generator), 0.0f),
+			Vector4f(0.1f * value(generator), 0.1f * value(generator), 1.0f + 0.1f * value(generator), 0.0f),
+			Vector4f(value(generator), value(generator), value(generator), 1.0f));
+	}
+
+	std::vector<Matrix4f> expected(parents.size());
+	for (std::size_t i = 0; i < parents.size(); i++) {
+		expected[i] = parents[i] == kNoParent ? local[i] : MultiplyReference(expected[parents[i]], local[i]);
+	}
+
+	std::vector<Matrix4f> world(parents.size());
+	UpdateHierarchy(parents, local, world);
+	for (std::size_t i = 0; i < parents.size(); i++) {
+		ExpectMatrixNear(world[i], expected[i], 1e-4f);
+	}
+
+	// Levels hold every node once, deeper than its parent's level
+	HierarchyLevels levels;
+	levels.Build(parents);
+	std::vector<int> node_level(parents.size(), -1);
+	for (std::size_t l = 0; l < levels.level_count(); l++) {
+		for (std::uint32_t node : levels.level(l)) {
+			ASSERT_EQ(node_level[node], -1);
+			node_level[node] = static_cast<int>(l);
+			EXPECT_EQ(parents[node] == kNoParent ? 0 : node_level[parents[node]] + 1, static_cast<int>(l));
+		}
+	}
+
+	JobSystem jobs(4);
+	std::vector<Matrix4f> parallel(parents.size());
+	UpdateHierarchy(levels, parents, local, parallel, jobs);
+	for (std::size_t i = 0; i < parents.size(); i++) {
+		for (int column = 0; column < 4; column++) {
+			EXPECT_EQ(parallel[i][column], world[i][column]);
+		}
+	}
+
+	// A short world span is not overrun, the last element is a guard
+	const std::size_t kShort = 1000;
+	const Vector4f guard(7.0f, 7.0f, 7.0f, 7.0f);
+	for (int run = 0; run < 2; run++) {
+		std::vector<Matrix4f> short_world(kShort + 1, Matrix4f(guard, guard, guard, guard));
+		const std::span<Matrix4f> destination = std::span(short_world).first(kShort);
+		if (run == 0) {
+			UpdateHierarchy(parents, local, destination);
+		} else {
+			UpdateHierarchy(levels, parents, local, destination, jobs);
+		}
+		for (std::size_t i = 0; i < kShort; i++) {
+			EXPECT_EQ(short_world[i][3], world[i][3]);
+		}
+		EXPECT_EQ(short_world[kShort][0], guard);
+	}
+}
+
+TEST(Maths, Hierarchy_UpdateTrs)
+{
+	const std::vector<std::uint32_t> parents = RandomHierarchy(500, 3);
+	std::mt19937 generator(4);
+	std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+	std::vector<Quaternion> rotations(parents.size());
+	std::vector<Vector3f> translations(parents.size());
+	std::vector<Vector3f> scales(parents.size());
+	for (std::size_t i = 0; i < parents.size(); i++) {
+		rotations[i] = Quaternion(value(generator), value(generator), value(generator), value(generator)).Normalized();
+		translations[i] = Vector3f(value(generator), value(generator), value(generator));
+		scales[i] = Vector3f(1.0f + 0.5f * value(generator), 1.0f + 0.5f * value(generator), 1.0f + 0.5f * value(generator));
+	}
+
+	std::vector<Matrix4f> world(parents.size());
+	UpdateHierarchy(parents, rotations, translations, scales, world);
+
+	// A point goes through every local transform up to the root
+	const Vector3f point{ 0.5f, -0.25f, 1.0f };
+	for (std::size_t i = 0; i < parents.size(); i += 7) {
+		Vector3f expected = point;
+		for (std::uint32_t node = static_cast<std::uint32_t>(i); node != kNoParent; node = parents[node]) {
+			const Vector3f scaled{ expected.x * scales[node].x, expected.y * scales[node].y, expected.z * scales[node].z };
+			expected = rotations[node].Rotate(scaled) + translations[node];
+		}
+		const Vector4f transformed = world[i] * Vector4f(point.x, point.y, point.z, 1.0f);
+		EXPECT_NEAR(transformed.x, expected.x, 1e-3f);
+		EXPECT_NEAR(transformed.y, expected.y, 1e-3f);
+		EXPECT_NEAR(transformed.z, expected.z, 1e-3f);
+		EXPECT_NEAR(transformed.w, 1.0f, 1e-6f);
+	}
+
+	HierarchyLevels levels;
+	levels.Build(parents);
+	std::vector<Matrix4f> parallel(parents.size());
+	UpdateHierarchy(levels, parents, rotations, translations, scales, parallel);
+	for (std::size_t i = 0; i < parents.size(); i++) {
+		for (int column = 0; column < 4; column++) {
+			EXPECT_EQ(parallel[i][column], world[i][column]);
+		}
+	}
+
+	// Only the common size is updated when an input is short
+	const std::size_t kShort = 300;
+	const std::span<const Vector3f> short_scales = std::span(scales).first(kShort);
+	for (int run = 0; run < 2; run++) {
+		std::vector<Matrix4f> partial(parents.size(), Matrix4f::identity());
+		if (run == 0) {
+			UpdateHierarchy(parents, rotations, translations, short_scales, partial);
+		} else {
+			UpdateHierarchy(levels, parents, rotations, translations, short_scales, partial);
+		}
+		for (std::size_t i = 0; i < parents.size(); i++) {
+			const Matrix4f& expected = i < kShort ? world[i] : Matrix4f::identity();
+			for (int column = 0; column < 4; column++) {
+				EXPECT_EQ(partial[i][column], expected[column]);
+			}
+		}
+	}
+}
+
+} // namespace maths
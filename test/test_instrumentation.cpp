@@ -0,0 +1,105 @@
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include "maths/frustum.h"
+#include "maths/instrumentation.h"
+#include "maths/ray3.h"
+
+namespace maths {
+
+TEST(Maths, Instrumentation_Threads)
+{
+	// Counters of every thread are summed, including exited ones
+	ResetInstrumentation();
+	std::vector<std::thread> threads;
+	for (int t = 0; t < 4; t++) {
+		threads.emplace_back([] {
+			for (std::uint32_t i = 0; i < 1000; i++) {
+				InstrumentCount(InstrumentCounter::kOverlapAABB2);
+				InstrumentHit(InstrumentCounter::kOverlapAABB2, i % 4 == 0);
+				InstrumentExit(InstrumentCounter::kOverlapAABB2, i % 10);
+			}
+			const ScopedTimer timer("Instrumentation_Threads");
+		});
+	}
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+	InstrumentCount(InstrumentCounter::kOverlapAABB2);
+
+	const InstrumentationSnapshot snapshot = TakeInstrumentationSnapshot();
+	const CounterStats& stats = snapshot[InstrumentCounter::kOverlapAABB2];
+	EXPECT_EQ(stats.calls, 4001u);
+	EXPECT_EQ(stats.hits, 1000u);
+	EXPECT_EQ(stats.exits[0], 400u);
+	// Steps 7, 8 and 9 share the last bucket
+	EXPECT_EQ(stats.exits[kInstrumentExitBuckets - 1], 1200u);
+	ASSERT_EQ(snapshot.timers.size(), 1u);
+	EXPECT_EQ(snapshot.timers[0].name, "Instrumentation_Threads");
+	EXPECT_EQ(snapshot.timers[0].calls, 4u);
+	EXPECT_NE(InstrumentationReport().find("Overlap(AABB2)"), std::string::npos);
+
+	ResetInstrumentation();
+	EXPECT_EQ(TakeInstrumentationSnapshot()[InstrumentCounter::kOverlapAABB2].calls, 0u);
+	EXPECT_TRUE(InstrumentationReport().empty());
+}
+
+TEST(Maths, Instrumentation_HotPaths)
+{
+	// Looking down -z, near 1, far 100
+	const Frustum frustum(Matrix4f(Vector4f(1.0f, 0.0f, 0.0f, 0.0f), Vector4f(0.0f, 1.0f, 0.0f, 0.0f),
+		Vector4f(0.0f, 0.0f, -101.0f / 99.0f, -1.0f), Vector4f(0.0f, 0.0f, -200.0f / 99.0f, 0.0f)));
+	Vector3f origin{ 0.0f, 0.0f, -5.0f };
+	Vector3f direction{ 0.0f, 0.0f, 1.0f };
+	Ray3 ray(origin, direction);
+
+	ResetInstrumentation();
+	EXPECT_TRUE(frustum.contains(Vector3f{ 0.0f, 0.0f, -10.0f }));
+	EXPECT_FALSE(frustum.contains(Vector3f{ 0.0f, 0.0f, 10.0f }));
+	EXPECT_TRUE(ray.IntersectSphere(Sphere{ 1.0f, Vector3f{} }));
+	EXPECT_FALSE(ray.IntersectSphere(Sphere{ 1.0f, Vector3f{ 0.0f, 0.0f, -10.0f } }));
+
+	const InstrumentationSnapshot snapshot = TakeInstrumentationSnapshot();
+#ifdef MATHS_INSTRUMENTATION
+	EXPECT_EQ(snapshot[InstrumentCounter::kFrustumPoint].calls, 2u);
+	EXPECT_EQ(snapshot[InstrumentCounter::kFrustumPoint].hits, 1u);
+	EXPECT_EQ(snapshot[InstrumentCounter::kFrustumPoint].exits[6], 1u);
+	EXPECT_GE(snapshot[InstrumentCounter::kFrustumPlane].calls, 7u);
+	EXPECT_EQ(snapshot[InstrumentCounter::kRaySphere].calls, 2u);
+	EXPECT_EQ(snapshot[InstrumentCounter::kRaySphere].hits, 1u);
+	EXPECT_EQ(snapshot[InstrumentCounter::kRaySphere].exits[0], 1u);
+#else
+	// Compiled out
+	for (const CounterStats& stats : snapshot.counters) {
+		EXPECT_EQ(stats.calls, 0u);
+	}
+#endif
+}
+
+} // namespace maths
@@ -0,0 +1,234 @@
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "maths/batch.h"
+#include "maths/job_system.h"
+
+namespace maths {
+
+TEST(Maths, JobSystem_ParallelFor)
+{
+	JobSystem jobs(4);
+	EXPECT_EQ(jobs.thread_count(), 4);
+
+	std::vector<int> values(10000, 0);
+	jobs.ParallelFor(0, values.size(), [&values](std::size_t begin, std::size_t end) {
+		for (std::size_t i = begin; i < end; i++) {
+			values[i] += static_cast<int>(i);
+		}
+	}, 37);
+	for (std::size_t i = 0; i < values.size(); i++) {
+		EXPECT_EQ(values[i], static_cast<int>(i));
+	}
+
+	// Empty range does nothing
+	bool called = false;
+	jobs.ParallelFor(5, 5, [&called](std::size_t, std::size_t) { called = true; });
+	EXPECT_FALSE(called);
+}
+
+TEST(Maths, JobSystem_Nested)
+{
+	JobSystem jobs(3);
+	std::atomic<int> sum = 0;
+	jobs.ParallelFor(0, 8, [&](std::size_t begin, std::size_t end) {
+		for (std::size_t i = begin; i < end; i++) {
+			jobs.ParallelFor(0, 100, [&sum](std::size_t b, std::size_t e) {
+				sum += static_cast<int>(e - b);
+			}, 10);
+		}
+	}, 1);
+	EXPECT_EQ(sum.load(), 800);
+}
+
+TEST(Maths, JobSystem_GrainSize)
+{
+	JobSystem jobs(2);
+	// Never split below the minimal grain
+	EXPECT_EQ(jobs.GrainSize(10), JobSystem::kMinGrainSize);
+	// Big ranges get a few chunks per thread
+	EXPECT_EQ(jobs.GrainSize(80000), 80000 / (2 * JobSystem::kChunksPerThread));
+}
+
+TEST(Maths, JobSystem_ParallelCollectOrder)
+{
+	std::vector<std::size_t> single;
+	std::vector<std::size_t> multi;
+	auto even = [](std::size_t begin, std::size_t end, std::vector<std::size_t>& local) {
+		for (std::size_t i = begin; i < end; i++) {
+			if (i % 2 == 0) local.push_back(i);
+		}
+	};
+	JobSystem one(1);
+	JobSystem four(4);
+	one.ParallelCollect(5000, single, even);
+	four.ParallelCollect(5000, multi, even, 16);
+	EXPECT_EQ(single.size(), 2500);
+	EXPECT_EQ(single, multi);
+	EXPECT_TRUE(std::is_sorted(multi.begin(), multi.end()));
+}
+
+TEST(Maths, Batch_Cull)
+{
+	Vector3f up{ 0.0f, 1.0f, 0.0f };
+	Vector3f direction{ 0.0f, 0.0f, 1.0f };
+	Vector3f right = Vector3f::Cross(up, direction);
+	Frustum frustum;
+	frustum.calculate_frustum(direction, Vector3f{}, right, up, 0.1f, 100.0f,
+		degree_t(45.0f), degree_t(45.0f));
+
+	std::vector<AABB3> aabbs;
+	for (int i = 0; i < 1000; i++) {
+		const float offset = static_cast<float>(i % 40) - 20.0f;
+		aabbs.emplace_back(Vector3f{ offset, offset, offset * 3.0f },
+			Vector3f{ offset + 1.0f, offset + 1.0f, offset * 3.0f + 1.0f });
+	}
+	JobSystem jobs(4);
+	std::vector<std::uint32_t> visible;
+	CullBatch(frustum, aabbs, visible, jobs);
+
+	std::vector<std::uint32_t> expected;
+	for (std::uint32_t i = 0; i < aabbs.size(); i++) {
+		if (frustum.contains(aabbs[i])) expected.push_back(i);
+	}
+	EXPECT_EQ(visible, expected);
+
+	// Spheres are culled against all six planes, the last one straddles the
+	// near plane but is far outside a side plane
+	std::vector<Sphere> spheres;
+	for (int i = 0; i < 1000; i++) {
+		const float offset = static_cast<float>(i % 40) - 20.0f;
+		spheres.emplace_back(1.5f, Vector3f{ offset, offset * 0.5f, offset * 3.0f });
+	}
+	spheres.emplace_back(1.0f, Vector3f{ 500.0f, 0.0f, 0.0f });
+	std::vector<std::uint8_t> inside(spheres.size());
+	frustum.ContainsBatch(spheres, inside);
+	visible.clear();
+	CullBatch(frustum, spheres, visible, jobs);
+	expected.clear();
+	for (std::uint32_t i = 0; i < spheres.size(); i++) {
+		if (inside[i]) expected.push_back(i);
+	}
+	EXPECT_EQ(visible, expected);
+	EXPECT_FALSE(expected.empty());
+	EXPECT_NE(expected.back(), spheres.size() - 1);
+}
+
+TEST(Maths, Batch_IntersectAndTransform)
+{
+	const std::vector<AABB3> aabbs{ AABB3{ Vector3f{ -0.5f, -0.5f, -0.5f }, Vector3f{ 0.5f, 0.5f, 0.5f } } };
+	const std::vector<Sphere> spheres{ Sphere{ 1.0f, Vector3f{} } };
+	Vector3f direction{ 1.0f, 1.0f, 1.0f };
+	Vector3f hit_origin{ -1.0f, -1.0f, -1.0f };
+	Vector3f miss_origin{ -0.5f, -2.0f, -2.0f };
+	const std::vector<Ray3> rays{ Ray3{ hit_origin, direction }, Ray3{ miss_origin, direction } };
+	std::vector<std::uint8_t> hits(rays.size());
+	JobSystem jobs(2);
+	IntersectBatch(rays, aabbs, hits, jobs);
+	EXPECT_EQ(hits[0], 1);
+	EXPECT_EQ(hits[1], 0);
+	IntersectBatch(rays, spheres, hits, jobs);
+	EXPECT_EQ(hits[0], 1);
+
+	const std::vector<Vector4f> points(300, Vector4f{ 1.0f, 2.0f, 3.0f, 1.0f });
+	std::vector<Vector4f> transformed(points.size());
+	TransformBatch(Matrix4f::scalingMatrix(Vector3f{ 2.0f, 3.0f, 4.0f }), points, transformed, jobs);
+	for (const Vector4f& v : transformed) {
+		EXPECT_EQ(v, Vector4f(2.0f, 6.0f, 12.0f, 1.0f));
+	}
+}
+
+TEST(Maths, Batch_TransformAABB3)
+{
+	std::mt19937 generator(8);
+	std::uniform_real_distribution<float> value(-2.0f, 2.0f);
+	std::vector<Matrix4f> matrices;
+	std::vector<AABB3> local;
+	for (int i = 0; i < 500; i++) {
+		matrices.emplace_back(Vector4f{ value(generator), value(generator), value(generator), 0.0f },
+			Vector4f{ value(generator), value(generator), value(generator), 0.0f },
+			Vector4f{ value(generator), value(generator), value(generator), 0.0f },
+			Vector4f{ value(generator), value(generator), value(generator), 1.0f });
+		const Vector3f min{ value(generator), value(generator), value(generator) };
+		local.emplace_back(min, min + Vector3f{ 1.0f, 0.5f, 2.0f });
+	}
+	local[7] = AABB3::Empty();
+
+	JobSystem jobs(3);
+	std::vector<AABB3> world(local.size());
+	TransformBatch(matrices, local, world, jobs);
+	for (std::size_t i = 0; i < local.size(); i++) {
+		if (i == 7) {
+			continue;
+		}
+		const AABB3 expected = local[i].Transformed(matrices[i]);
+		for (int axis = 0; axis < 3; axis++) {
+			EXPECT_NEAR(world[i].bottom_left()[axis], expected.bottom_left()[axis], 1e-5f);
+			EXPECT_NEAR(world[i].top_right()[axis], expected.top_right()[axis], 1e-5f);
+		}
+	}
+	EXPECT_TRUE(world[7].IsEmpty());
+
+	TransformBatch(matrices[0], local, world, jobs);
+	const AABB3 expected = local[3].Transformed(matrices[0]);
+	EXPECT_NEAR(world[3].top_right().y, expected.top_right().y, 1e-5f);
+}
+
+TEST(Maths, Batch_FindOverlappingPairs)
+{
+	std::vector<AABB3> aabbs;
+	for (int i = 0; i < 300; i++) {
+		const Vector3f min{ static_cast<float>(i % 17) * 0.7f, static_cast<float>(i % 5), static_cast<float>(i % 3) };
+		aabbs.emplace_back(min, min + Vector3f{ 1.0f, 1.0f, 1.0f });
+	}
+	// Fully contained box is still a pair
+	aabbs.emplace_back(Vector3f{ 0.1f, 0.1f, 0.1f }, Vector3f{ 0.2f, 0.2f, 0.2f });
+
+	std::vector<std::pair<std::uint32_t, std::uint32_t>> expected;
+	for (std::uint32_t i = 0; i < aabbs.size(); i++) {
+		for (std::uint32_t j = i + 1; j < aabbs.size(); j++) {
+			const AABB3& a = aabbs[i];
+			const AABB3& b = aabbs[j];
+			if (a.bottom_left().x <= b.top_right().x && b.bottom_left().x <= a.top_right().x &&
+				a.bottom_left().y <= b.top_right().y && b.bottom_left().y <= a.top_right().y &&
+				a.bottom_left().z <= b.top_right().z && b.bottom_left().z <= a.top_right().z) {
+				expected.emplace_back(i, j);
+			}
+		}
+	}
+	JobSystem jobs(4);
+	std::vector<std::pair<std::uint32_t, std::uint32_t>> pairs;
+	FindOverlappingPairs(aabbs, pairs, jobs);
+	EXPECT_EQ(pairs, expected);
+	EXPECT_FALSE(pairs.empty());
+}
+
+} // namespace maths
@@ -0,0 +1,126 @@
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "maths/frustum.h"
+#include "maths/large_world.h"
+#include "maths/ray3.h"
+
+namespace maths {
+
+TEST(Maths, LargeWorld_RelativeTo)
+{
+	// 30 km away from the origin a float cannot hold a millimetre anymore
+	const Vector3d camera{ 30000.0, 100.0, -30000.0 };
+	const Vector3d point{ 30000.001, 100.002, -30000.003 };
+
+	const Vector3f lossy = point.ToVector3f() - camera.ToVector3f();
+	const Vector3f local = point.RelativeTo(camera);
+	EXPECT_NEAR(local.x, 0.001f, 1e-6f);
+	EXPECT_NEAR(local.y, 0.002f, 1e-6f);
+	EXPECT_NEAR(local.z, -0.003f, 1e-6f);
+	EXPECT_GT(std::abs(lossy.x - 0.001f), 1e-4f);
+}
+
+TEST(Maths, LargeWorld_RebaseBatch)
+{
+	const Vector3d origin{ 1e6, -2e6, 5e5 };
+	std::vector<Vector3d> world;
+	for (int i = 0; i < 37; i++) {
+		world.emplace_back(1e6 + i * 0.25, -2e6 - i * 0.5, 5e5 + i);
+	}
+	std::vector<Vector3f> local(world.size());
+	RebaseToOrigin(world, origin, local);
+
+	std::vector<double> x, y, z;
+	for (const Vector3d& v : world) {
+		x.push_back(v.x);
+		y.push_back(v.y);
+		z.push_back(v.z);
+	}
+	std::vector<float> lx(world.size()), ly(world.size()), lz(world.size());
+	RebaseToOrigin(Vector3dSoA{ x, y, z }, origin, Vector3fSoA{ lx, ly, lz });
+
+	for (std::size_t i = 0; i < world.size(); i++) {
+		EXPECT_FLOAT_EQ(local[i].x, i * 0.25f);
+		EXPECT_FLOAT_EQ(local[i].y, -(i * 0.5f));
+		EXPECT_FLOAT_EQ(local[i].z, static_cast<float>(i));
+		EXPECT_EQ(local[i].x, lx[i]);
+		EXPECT_EQ(local[i].y, ly[i]);
+		EXPECT_EQ(local[i].z, lz[i]);
+	}
+
+	const std::vector<AABB3d> boxes{ AABB3d{ origin, origin + Vector3d{ 1.0, 2.0, 3.0 } } };
+	std::vector<AABB3> local_boxes(1);
+	RebaseToOrigin(boxes, origin, local_boxes);
+	EXPECT_EQ(local_boxes[0].bottom_left(), Vector3f(0.0f, 0.0f, 0.0f));
+	EXPECT_EQ(local_boxes[0].top_right(), Vector3f(1.0f, 2.0f, 3.0f));
+}
+
+TEST(Maths, LargeWorld_FrustumOriginShift)
+{
+	const float near_distance = 0.1f;
+	const float far_distance = 100.0f;
+	Vector3f up{ 0.0f, 1.0f, 0.0f };
+	const degree_t fov = degree_t(45.0f);
+
+	Vector3f direction{ 0.0f, 0.0f, 1.0f };
+	const Vector3f right = Vector3f::Cross(up, direction).Normalized();
+	up = Vector3f::Cross(direction, right).Normalized();
+
+	Frustum frustum{};
+	frustum.calculate_frustum(direction, Vector3f{}, right, up, near_distance,
+		far_distance, fov, fov);
+
+	// Same test done at the origin and far from it
+	const Vector3d camera{ 40000.0, 0.0, 40000.0 };
+	const Sphered sphere{ 0.5f, camera + Vector3d{ 0.0, 0.5, 0.0 } };
+	EXPECT_EQ(frustum.contains(sphere.RelativeTo(camera)), frustum.contains(sphere, camera));
+	// Straddling the near plane, outside a side plane
+	const Sphered straddling{ 1.0f, camera + Vector3d{ 500.0, 0.0, 0.0 } };
+	EXPECT_FALSE(frustum.contains(straddling, camera));
+	const Vector3d point{ camera + Vector3d{ 5.0, 4.0, 4.0 } };
+	EXPECT_EQ(frustum.contains(Vector3f{ 5.0f, 4.0f, 4.0f }), frustum.contains(point, camera));
+}
+
+TEST(Maths, LargeWorld_RayOriginShift)
+{
+	const Vector3d shift{ -25000.0, 0.0, 25000.0 };
+	const Vector3d origin{ shift + Vector3d{ -1.0, -1.0, -1.0 } };
+	const Vector3f direction{ 1.0f, 1.0f, 1.0f };
+	Ray3 ray{ origin, direction, shift };
+	EXPECT_EQ(ray.origin(), Vector3f(-1.0f, -1.0f, -1.0f));
+
+	const AABB3d aabb{ shift + Vector3d{ -0.5, -0.5, -0.5 }, shift + Vector3d{ 0.5, 0.5, 0.5 } };
+	EXPECT_TRUE(ray.IntersectAABB3(aabb, shift));
+	const Sphered sphere{ 1.0f, shift };
+	EXPECT_TRUE(ray.IntersectSphere(sphere, shift));
+	const Sphered far_sphere{ 1.0f, shift + Vector3d{ 10.0, -10.0, 0.0 } };
+	EXPECT_FALSE(ray.IntersectSphere(far_sphere, shift));
+}
+
+} // namespace maths
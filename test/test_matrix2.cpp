@@ -23,6 +23,7 @@ SOFTWARE.
 */
 
 #include <gtest/gtest.h>
+#include <vector>
 #include "maths/vector2.h"
 #include "maths/vector3.h"
 #include "maths/vector4.h"
@@ -134,6 +135,49 @@ TEST(Maths, Matrix2f_Inverse) {
 	EXPECT_EQ(inverseA[1][0], -2);
 	EXPECT_EQ(inverseA[1][1], 1);
 }
+TEST(Maths, Matrix2f_InverseBatch) {
+
+	std::vector<Matrix2f> matrices;
+	for (int i = 0; i < 11; i++) {
+
+		const float kValue = static_cast<float>(i);
+		//Every fourth matrix has proportional columns
+		matrices.emplace_back(Vector2f(kValue + 1, 2), i % 4 == 1 ? Vector2f(2 * kValue + 2, 4) : Vector2f(-1, kValue));
+	}
+	std::vector<Matrix2f> inverses(matrices.size());
+	std::vector<std::uint8_t> invertible(matrices.size());
+	EXPECT_FALSE(InverseBatch(matrices, inverses, invertible));
+	const Matrix2f product = matrices[2] * inverses[2];
+	EXPECT_FLOAT_EQ(product[0][0], 1);
+	EXPECT_NEAR(product[0][1], 0, 1e-6f);
+	EXPECT_NEAR(product[1][0], 0, 1e-6f);
+	EXPECT_FLOAT_EQ(product[1][1], 1);
+
+	for (std::size_t i = 0; i < matrices.size(); i++) {
+
+		Matrix2f expected;
+		EXPECT_EQ(invertible[i], matrices[i].TryInverse(expected));
+		if (!invertible[i]) {
+
+			expected = matrices[i];
+		}
+		EXPECT_FLOAT_EQ(inverses[i][0][0], expected[0][0]);
+		EXPECT_FLOAT_EQ(inverses[i][0][1], expected[0][1]);
+		EXPECT_FLOAT_EQ(inverses[i][1][0], expected[1][0]);
+		EXPECT_FLOAT_EQ(inverses[i][1][1], expected[1][1]);
+	}
+
+	//A uniform scale does not change which matrices are invertible
+	for (Matrix2f& matrix : matrices) {
+
+		matrix *= 0.0001f;
+	}
+	std::vector<std::uint8_t> scaled_invertible(matrices.size());
+	InverseBatch(matrices, inverses, scaled_invertible);
+	EXPECT_EQ(scaled_invertible, invertible);
+	Matrix2f inverse;
+	EXPECT_TRUE(matrices[2].TryInverse(inverse));
+}
 TEST(Maths, Matrix2f_Transpose) {
 	
 	Matrix2f a = Matrix2f(maths::Vector2f(3, -1), maths::Vector2f(-2, 1));
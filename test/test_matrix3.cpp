@@ -23,6 +23,8 @@ SOFTWARE.
 */
 
 #include <gtest/gtest.h>
+#include <random>
+#include <vector>
 #include "maths/vector2.h"
 #include "maths/vector3.h"
 #include "maths/vector4.h"
@@ -194,6 +196,94 @@ TEST(Maths, Matrix3f_Inverse) {
 	EXPECT_EQ(tmp_inverse[2][1], -1);
 	EXPECT_EQ(tmp_inverse[2][2], -4);
 }
+TEST(Maths, Matrix3f_TryInverse) {
+
+	const Matrix3f a = Matrix3f(Vector3f(3, 2, 1),
+								Vector3f(1, -2, 2),
+								Vector3f(-1, 0, -1));
+	Matrix3f inverse;
+	EXPECT_TRUE(a.TryInverse(inverse));
+	const Matrix3f product = a * inverse;
+	for (int i = 0; i < 3; i++) {
+
+		for (int j = 0; j < 3; j++) {
+
+			EXPECT_EQ(product[i][j], i == j ? 1.0f : 0.0f);
+		}
+	}
+
+	//The third column is the sum of the others
+	const Matrix3f singular = Matrix3f(Vector3f(1, 2, 3), Vector3f(0, 1, 1), Vector3f(1, 3, 4));
+	EXPECT_FALSE(singular.TryInverse(inverse));
+	EXPECT_EQ(singular.Inverse()[2][2], 4);
+
+	//Small scales stay invertible, the determinant 1e-9 is below the default epsilon of Equal
+	Matrix3f small = a;
+	small *= 0.001f;
+	ASSERT_TRUE(small.TryInverse(inverse));
+	const Matrix3f small_product = small * inverse;
+	for (int i = 0; i < 3; i++) {
+
+		for (int j = 0; j < 3; j++) {
+
+			EXPECT_NEAR(small_product[i][j], i == j ? 1.0f : 0.0f, 1e-5f);
+		}
+	}
+	Matrix3f small_singular = singular;
+	small_singular *= 0.001f;
+	EXPECT_FALSE(small_singular.TryInverse(inverse));
+	Matrix3f tiny = Matrix3f::identity();
+	tiny *= 1e-20f;
+	EXPECT_FALSE(tiny.TryInverse(inverse));
+}
+TEST(Maths, Matrix3f_InverseBatch) {
+
+	std::mt19937 generator(12);
+	std::uniform_real_distribution<float> value(-2.0f, 2.0f);
+	std::vector<Matrix3f> matrices;
+	for (int i = 0; i < 103; i++) {
+
+		const Vector3f c0(value(generator), value(generator), value(generator));
+		const Vector3f c1(value(generator), value(generator), value(generator));
+		matrices.emplace_back(c0, c1, i % 10 == 3 ? c0 * 2.0f : Vector3f(value(generator), value(generator), value(generator)));
+	}
+	std::vector<Matrix3f> inverses(matrices.size());
+	std::vector<std::uint8_t> invertible(matrices.size());
+	EXPECT_FALSE(InverseBatch(matrices, inverses, invertible));
+
+	for (std::size_t i = 0; i < matrices.size(); i++) {
+
+		Matrix3f expected;
+		const bool kExpected = matrices[i].TryInverse(expected);
+		EXPECT_EQ(invertible[i], kExpected);
+		if (!kExpected) {
+
+			expected = matrices[i];
+		}
+		for (int column = 0; column < 3; column++) {
+
+			for (int row = 0; row < 3; row++) {
+
+				EXPECT_NEAR(inverses[i][column][row], expected[column][row], 1e-4f * std::abs(expected[column][row]) + 1e-5f);
+			}
+		}
+	}
+
+	//A uniform scale does not change which matrices are invertible
+	std::vector<Matrix3f> scaled = matrices;
+	for (Matrix3f& matrix : scaled) {
+
+		matrix *= 0.001f;
+	}
+	std::vector<std::uint8_t> scaled_invertible(scaled.size());
+	InverseBatch(scaled, inverses, scaled_invertible);
+	EXPECT_EQ(scaled_invertible, invertible);
+
+	//In place
+	matrices.resize(8);
+	matrices[3] = Matrix3f::identity();
+	EXPECT_TRUE(InverseBatch(matrices, matrices));
+}
 TEST(Maths, Matrix3f_Transpose) {
 	
 	const Matrix3f a = Matrix3f(Vector3f(0, 1, 2),
@@ -304,4 +394,76 @@ TEST(Maths, Matrix3f_TranslationMatrix) {
 	EXPECT_EQ(a[2][2], 1);
 }
 
+TEST(Maths, Matrix3f_SymmetricEigen) {
+
+	// A = R * diag(5, 2, 1) * R^T with R a rotation around z
+	const float c = std::cos(0.3f), s = std::sin(0.3f);
+	const Matrix3f r(Vector3f(c, s, 0), Vector3f(-s, c, 0), Vector3f(0, 0, 1));
+	const Matrix3f d(Vector3f(5, 0, 0), Vector3f(0, 2, 0), Vector3f(0, 0, 1));
+	const Matrix3f a = r * d * r.Transpose();
+
+	Vector3f values;
+	Matrix3f vectors;
+	SymmetricEigen(a, values, vectors);
+	EXPECT_NEAR(values[0], 5.0f, 1e-5f);
+	EXPECT_NEAR(values[1], 2.0f, 1e-5f);
+	EXPECT_NEAR(values[2], 1.0f, 1e-5f);
+	for (int i = 0; i < 3; i++) {
+
+		//Test A * v = lambda * v
+		const Vector3f av = a * vectors[i];
+		for (int j = 0; j < 3; j++) {
+
+			EXPECT_NEAR(av[j], vectors[i][j] * values[i], 1e-5f);
+		}
+		EXPECT_NEAR(vectors[i].Magnitude(), 1.0f, 1e-5f);
+	}
+	EXPECT_NEAR(vectors.determinant(), 1.0f, 1e-5f);
+}
+
+TEST(Maths, Matrix3f_PolarDecomposition) {
+
+	//Strong shear and a mirror
+	const Matrix3f a = Matrix3f(Vector3f(2, 0.5f, 0), Vector3f(1.5f, 1, 0.2f), Vector3f(0.3f, -0.4f, -3));
+	Matrix3f rotation;
+	Matrix3f stretch;
+	ASSERT_TRUE(PolarDecomposition(a, rotation, stretch));
+
+	const Matrix3f orthogonality = rotation.Transpose() * rotation;
+	const Matrix3f product = rotation * stretch;
+	for (int i = 0; i < 3; i++) {
+
+		for (int j = 0; j < 3; j++) {
+
+			EXPECT_NEAR(orthogonality[i][j], i == j ? 1.0f : 0.0f, 1e-5f);
+			EXPECT_NEAR(product[i][j], a[i][j], 1e-4f);
+			EXPECT_EQ(stretch[i][j], stretch[j][i]);
+		}
+	}
+	EXPECT_NEAR(rotation.determinant(), -1.0f, 1e-5f);
+
+	const Matrix3f singular = Matrix3f(Vector3f(1, 2, 3), Vector3f(2, 4, 6), Vector3f(0, 0, 1));
+	EXPECT_FALSE(PolarDecomposition(singular, rotation, stretch));
+
+	//A small sheared matrix, as in files in millimeters, has the rotation of the unit one
+	const Matrix3f shear = Matrix3f(Vector3f(1, 0, 0), Vector3f(0.5f, 1, 0), Vector3f(0, 0, 1));
+	Matrix3f unit_rotation;
+	ASSERT_TRUE(PolarDecomposition(shear, unit_rotation, stretch));
+	for (const float kScale : { 0.004f, 0.001f }) {
+
+		Matrix3f small = shear;
+		small *= kScale;
+		Matrix3f small_stretch;
+		ASSERT_TRUE(PolarDecomposition(small, rotation, small_stretch));
+		for (int i = 0; i < 3; i++) {
+
+			for (int j = 0; j < 3; j++) {
+
+				EXPECT_NEAR(rotation[i][j], unit_rotation[i][j], 1e-5f);
+				EXPECT_NEAR(small_stretch[i][j], kScale * stretch[i][j], kScale * 1e-5f);
+			}
+		}
+	}
+}
+
 }//naemspace maths
\ No newline at end of file
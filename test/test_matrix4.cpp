@@ -23,12 +23,15 @@ SOFTWARE.
 */
 
 #include <gtest/gtest.h>
+#include <random>
+#include <vector>
 #include "maths/vector2.h"
 #include "maths/vector3.h"
 #include "maths/vector4.h"
 #include "maths/matrix2.h"
 #include "maths/matrix3.h"
 #include "maths/matrix4.h"
+#include "maths/transform3.h"
 
 namespace maths {
 
@@ -475,4 +478,96 @@ TEST(Maths, Matrix4f_TranslationMatrix) {
 	EXPECT_EQ(a[3][3], 1);
 }
 
+//Transpose of the inverse of the upper 3x3, the reference normal matrix
+Matrix3f ReferenceNormalMatrix(const Matrix4f& world)
+{
+	const Matrix3f upper(Vector3f(world[0].x, world[0].y, world[0].z), Vector3f(world[1].x, world[1].y, world[1].z),
+						 Vector3f(world[2].x, world[2].y, world[2].z));
+	Matrix3f inverse;
+	EXPECT_TRUE(upper.TryInverse(inverse));
+	return inverse.Transpose();
+}
+
+void ExpectMatrix3Near(const Matrix3f& a, const Matrix3f& b)
+{
+	for (int column = 0; column < 3; column++) {
+
+		for (int row = 0; row < 3; row++) {
+
+			EXPECT_NEAR(a[column][row], b[column][row], 1e-4f);
+		}
+	}
+}
+
+TEST(Maths, Matrix4f_NormalMatrix)
+{
+	const Quaternion rotation = Quaternion(0.3f, -0.5f, 0.2f, 0.8f).Normalized();
+	const Matrix4f uniform = Transform3(Vector3f(1, 2, 3), rotation, Vector3f(2, 2, 2)).ToMatrix4f();
+	Matrix3f normal;
+	EXPECT_EQ(NormalMatrix(uniform, normal), NormalMatrixKind::kUniformScale);
+	ExpectMatrix3Near(normal, ReferenceNormalMatrix(uniform));
+
+	const Matrix4f stretched = Transform3(Vector3f(1, 2, 3), rotation, Vector3f(0.5f, 2, 3)).ToMatrix4f();
+	EXPECT_EQ(NormalMatrix(stretched, normal), NormalMatrixKind::kGeneral);
+	ExpectMatrix3Near(normal, ReferenceNormalMatrix(stretched));
+
+	//Flattened along z: the cofactors still send the z axis to the plane normal
+	const Matrix4f flat(Vector4f(2, 0, 0, 0), Vector4f(0, 3, 0, 0), Vector4f(0, 0, 0, 0), Vector4f(1, 1, 1, 1));
+	EXPECT_EQ(NormalMatrix(flat, normal), NormalMatrixKind::kSingular);
+	const Vector3f flat_normal = normal * Vector3f(0, 0, 1);
+	EXPECT_EQ(flat_normal.x, 0);
+	EXPECT_EQ(flat_normal.y, 0);
+	EXPECT_GT(flat_normal.z, 0);
+
+	//Small sheared matrices, as in files in millimeters, are not singular, on both paths
+	std::vector<Matrix4f> small;
+	for (const float kScale : { 0.004f, 0.001f, 0.004f, 0.001f }) {
+
+		small.emplace_back(Vector4f(kScale, 0, 0, 0), Vector4f(0.5f * kScale, kScale, 0, 0), Vector4f(0, 0, kScale, 0),
+						   Vector4f(0, 0, 0, 1));
+	}
+	std::vector<Matrix3f> normals(small.size());
+	std::vector<NormalMatrixKind> kinds(small.size());
+	EXPECT_TRUE(NormalMatrixBatch(small, normals, kinds));
+	for (std::size_t i = 0; i < small.size(); i++) {
+
+		EXPECT_EQ(NormalMatrix(small[i], normal), NormalMatrixKind::kGeneral);
+		EXPECT_EQ(kinds[i], NormalMatrixKind::kGeneral);
+		Matrix3f expected = ReferenceNormalMatrix(small[i]);
+		expected *= small[i][0].x;
+		normal *= small[i][0].x;
+		normals[i] *= small[i][0].x;
+		ExpectMatrix3Near(normal, expected);
+		ExpectMatrix3Near(normals[i], expected);
+	}
+}
+
+TEST(Maths, Matrix4f_NormalMatrixBatch)
+{
+	std::mt19937 generator(5);
+	std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+	std::vector<Matrix4f> world;
+	for (int i = 0; i < 103; i++) {
+
+		const float kScale = 1.5f + value(generator);
+		const Vector3f scale = i % 3 == 0 ? Vector3f(kScale, kScale, kScale)
+			: Vector3f(kScale, 1.0f + 0.5f * value(generator), i % 7 == 1 ? 0.0f : 1.0f);
+		const Quaternion rotation = Quaternion(value(generator), value(generator), value(generator), value(generator)).Normalized();
+		world.push_back(Transform3(Vector3f(value(generator), value(generator), value(generator)), rotation, scale).ToMatrix4f());
+	}
+	std::vector<Matrix3f> normals(world.size());
+	std::vector<NormalMatrixKind> kinds(world.size());
+	EXPECT_FALSE(NormalMatrixBatch(world, normals, kinds));
+
+	int uniform_count = 0;
+	for (std::size_t i = 0; i < world.size(); i++) {
+
+		Matrix3f expected;
+		EXPECT_EQ(kinds[i], NormalMatrix(world[i], expected));
+		ExpectMatrix3Near(normals[i], expected);
+		uniform_count += kinds[i] == NormalMatrixKind::kUniformScale;
+	}
+	EXPECT_EQ(uniform_count, 35);
+}
+
 }//namespace maths
\ No newline at end of file
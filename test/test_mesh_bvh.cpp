@@ -0,0 +1,121 @@
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "maths/mesh_bvh.h"
+
+namespace maths {
+
+// Latitude-longitude sphere of radius 10 around the origin
+void SphereMesh(int rings, int sectors, std::vector<Vector3f>& vertices, std::vector<std::uint32_t>& indices)
+{
+	vertices.clear();
+	indices.clear();
+	for (int ring = 0; ring <= rings; ring++) {
+		const float theta = 3.14159265f * static_cast<float>(ring) / static_cast<float>(rings);
+		for (int sector = 0; sector <= sectors; sector++) {
+			const float phi = 6.28318531f * static_cast<float>(sector) / static_cast<float>(sectors);
+			vertices.emplace_back(10.0f * std::sin(theta) * std::cos(phi), 10.0f * std::cos(theta),
+				10.0f * std::sin(theta) * std::sin(phi));
+		}
+	}
+	for (int ring = 0; ring < rings; ring++) {
+		for (int sector = 0; sector < sectors; sector++) {
+			const std::uint32_t first = ring * (sectors + 1) + sector;
+			const std::uint32_t below = first + sectors + 1;
+			indices.insert(indices.end(), { first, below, first + 1, first + 1, below, below + 1 });
+		}
+	}
+}
+
+TEST(Maths, MeshBvh_ClosestHit)
+{
+	std::vector<Vector3f> vertices;
+	std::vector<std::uint32_t> indices;
+	SphereMesh(24, 48, vertices, indices);
+	MeshBvh mesh;
+	for (std::uint32_t leaf_size : { 1u, 4u, 8u }) {
+		mesh.Build(vertices, indices, leaf_size);
+		ASSERT_EQ(mesh.triangle_count(), indices.size() / 3);
+
+		std::mt19937 generator(5);
+		std::uniform_real_distribution<float> coordinate(-12.0f, 12.0f);
+		int hits = 0;
+		for (int i = 0; i < 500; i++) {
+			Vector3f origin{ coordinate(generator), coordinate(generator), 30.0f };
+			Vector3f direction = Vector3f(coordinate(generator), coordinate(generator), 0.0f) - origin;
+			const Ray3 ray(origin, direction);
+
+			// Brute force over every triangle
+			float expected_distance = std::numeric_limits<float>::infinity();
+			std::uint32_t expected_triangle = MeshBvh::kInvalidTriangle;
+			for (std::uint32_t t = 0; t < mesh.triangle_count(); t++) {
+				TriangleHit hit;
+				if (ray.IntersectTriangle(vertices[indices[3 * t]], vertices[indices[3 * t + 1]],
+					vertices[indices[3 * t + 2]], hit) && hit.distance < expected_distance) {
+					expected_distance = hit.distance;
+					expected_triangle = t;
+				}
+			}
+
+			MeshHit hit;
+			const bool found = mesh.ClosestHit(ray, hit);
+			ASSERT_EQ(found, expected_triangle != MeshBvh::kInvalidTriangle);
+			ASSERT_EQ(mesh.AnyHit(ray), found);
+			if (!found) {
+				continue;
+			}
+			hits++;
+			EXPECT_NEAR(hit.distance, expected_distance, 1e-5f);
+			// The hit point from the barycentrics is on the ray
+			const Vector3f& a = vertices[indices[3 * hit.triangle]];
+			const Vector3f& b = vertices[indices[3 * hit.triangle + 1]];
+			const Vector3f& c = vertices[indices[3 * hit.triangle + 2]];
+			const Vector3f point = a * (1.0f - hit.u - hit.v) + b * hit.u + c * hit.v;
+			const Vector3f expected_point = ray.PointInRay(hit.distance);
+			EXPECT_NEAR(point.x, expected_point.x, 1e-3f);
+			EXPECT_NEAR(point.y, expected_point.y, 1e-3f);
+			EXPECT_NEAR(point.z, expected_point.z, 1e-3f);
+
+			// Nothing before the closest hit
+			EXPECT_FALSE(mesh.AnyHit(ray, hit.distance * 0.99f));
+			EXPECT_FALSE(mesh.ClosestHit(ray, hit, hit.distance * 0.99f));
+		}
+		EXPECT_GT(hits, 100);
+	}
+
+	mesh.Build(vertices, {}, 4);
+	MeshHit hit;
+	Vector3f origin{ 0.0f, 0.0f, 30.0f };
+	Vector3f direction{ 0.0f, 0.0f, -1.0f };
+	EXPECT_FALSE(mesh.ClosestHit(Ray3(origin, direction), hit));
+	EXPECT_FALSE(mesh.AnyHit(Ray3(origin, direction)));
+}
+
+} // namespace maths
@@ -0,0 +1,193 @@
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "maths/morton.h"
+#include "maths/spatial_sort.h"
+
+namespace maths {
+
+TEST(Maths, Morton_Encode)
+{
+	EXPECT_EQ(MortonEncode32(1u, 0u), 1u);
+	EXPECT_EQ(MortonEncode32(0u, 1u), 2u);
+	EXPECT_EQ(MortonEncode32(3u, 3u), 15u);
+	EXPECT_EQ(MortonEncode32(1u, 0u, 0u), 1u);
+	EXPECT_EQ(MortonEncode32(0u, 1u, 0u), 2u);
+	EXPECT_EQ(MortonEncode32(0u, 0u, 1u), 4u);
+	EXPECT_EQ(MortonEncode32(1023u, 1023u, 1023u), 0x3FFFFFFFu);
+	EXPECT_EQ(MortonEncode64(0xFFFFFFFFu, 0u), 0x5555555555555555u);
+	EXPECT_EQ(MortonEncode64(0x1FFFFFu, 0x1FFFFFu, 0x1FFFFFu), 0x7FFFFFFFFFFFFFFFu);
+
+	std::mt19937 generator(1);
+	for (int i = 0; i < 1000; i++) {
+		const std::uint32_t x = generator() & 0x1FFFFF, y = generator() & 0x1FFFFF, z = generator() & 0x1FFFFF;
+		std::uint32_t dx, dy, dz;
+		MortonDecode64(MortonEncode64(x, y, z), dx, dy, dz);
+		EXPECT_EQ(dx, x);
+		EXPECT_EQ(dy, y);
+		EXPECT_EQ(dz, z);
+		MortonDecode32(MortonEncode32(x & 0x3FF, y & 0x3FF, z & 0x3FF), dx, dy, dz);
+		EXPECT_EQ(dx, x & 0x3FF);
+		EXPECT_EQ(dy, y & 0x3FF);
+		EXPECT_EQ(dz, z & 0x3FF);
+	}
+}
+
+TEST(Maths, Hilbert_Adjacency)
+{
+	// Consecutive indices of a Hilbert curve are neighbour cells
+	constexpr int kBits = 3;
+	constexpr std::uint32_t kSide = 1 << kBits;
+	std::vector<std::array<std::uint32_t, 3>> cells(kSide * kSide * kSide, { kSide, kSide, kSide });
+	for (std::uint32_t x = 0; x < kSide; x++) {
+		for (std::uint32_t y = 0; y < kSide; y++) {
+			for (std::uint32_t z = 0; z < kSide; z++) {
+				const std::uint64_t index = HilbertEncode(x, y, z, kBits);
+				ASSERT_LT(index, cells.size());
+				EXPECT_EQ(cells[index][0], kSide);
+				cells[index] = { x, y, z };
+			}
+		}
+	}
+	for (std::size_t i = 1; i < cells.size(); i++) {
+		int distance = 0;
+		for (int axis = 0; axis < 3; axis++) {
+			distance += std::abs(static_cast<int>(cells[i][axis]) - static_cast<int>(cells[i - 1][axis]));
+		}
+		EXPECT_EQ(distance, 1);
+	}
+
+	std::vector<std::array<std::uint32_t, 2>> cells2(kSide * kSide);
+	for (std::uint32_t x = 0; x < kSide; x++) {
+		for (std::uint32_t y = 0; y < kSide; y++) {
+			cells2[HilbertEncode(x, y, kBits)] = { x, y };
+		}
+	}
+	for (std::size_t i = 1; i < cells2.size(); i++) {
+		const int distance = std::abs(static_cast<int>(cells2[i][0]) - static_cast<int>(cells2[i - 1][0]))
+			+ std::abs(static_cast<int>(cells2[i][1]) - static_cast<int>(cells2[i - 1][1]));
+		EXPECT_EQ(distance, 1);
+	}
+
+	// Out of range bit counts are clamped
+	EXPECT_EQ(HilbertEncode(5u, 6u, 0), HilbertEncode(5u, 6u, 1));
+	EXPECT_EQ(HilbertEncode(5u, 6u, -3), HilbertEncode(5u, 6u, 1));
+	EXPECT_EQ(HilbertEncode(0xFFFFFFFFu, 6u, 40), HilbertEncode(0xFFFFFFFFu, 6u, 32));
+	EXPECT_EQ(HilbertEncode(5u, 6u, 7u, 0), HilbertEncode(5u, 6u, 7u, 1));
+	EXPECT_EQ(HilbertEncode(0x1FFFFFu, 6u, 7u, 30), HilbertEncode(0x1FFFFFu, 6u, 7u, 21));
+	EXPECT_LT(HilbertEncode(0xFFFFFFFFu, 0xFFFFFFFFu, 0xFFFFFFFFu, 64), 1ull << 63);
+}
+
+TEST(Maths, Morton_Quantize)
+{
+	const AABB3 bounds{ Vector3f{ -1.0f, -1.0f, -1.0f }, Vector3f{ 1.0f, 1.0f, 1.0f } };
+	EXPECT_EQ(Morton32(Vector3f{ -1.0f, -1.0f, -1.0f }, bounds), 0u);
+	EXPECT_EQ(Morton32(Vector3f{ 1.0f, 1.0f, 1.0f }, bounds), 0x3FFFFFFFu);
+	// Clamped outside the bounds
+	EXPECT_EQ(Morton32(Vector3f{ 5.0f, 5.0f, 5.0f }, bounds), 0x3FFFFFFFu);
+	EXPECT_EQ(Morton64(Vector3f{ 1.0f, 1.0f, 1.0f }, bounds), 0x7FFFFFFFFFFFFFFFu);
+	const AABB2 bounds2{ Vector2f{ 0.0f, 0.0f }, Vector2f{ 1.0f, 1.0f } };
+	EXPECT_EQ(Morton32(Vector2f{ 1.0f, 1.0f }, bounds2), 0xFFFFFFFFu);
+	EXPECT_EQ(Hilbert32(Vector2f{ 0.0f, 0.0f }, bounds2), 0u);
+	EXPECT_LT(Hilbert64(Vector3f{ 0.5f, 0.5f, 0.5f }, bounds), 1ull << 63);
+}
+
+TEST(Maths, RadixSort_Stable)
+{
+	std::mt19937 generator(2);
+	for (std::size_t count : { 0u, 1u, 100u, 50000u }) {
+		std::vector<std::uint64_t> keys(count);
+		for (std::uint64_t& key : keys) {
+			key = (static_cast<std::uint64_t>(generator()) << 20) ^ (generator() & 0xFF);
+		}
+		std::vector<std::uint32_t> order;
+		JobSystem jobs(4);
+		RadixSortIndices(keys, order, jobs);
+
+		std::vector<std::uint32_t> expected(count);
+		std::iota(expected.begin(), expected.end(), 0u);
+		std::stable_sort(expected.begin(), expected.end(),
+			[&keys](std::uint32_t a, std::uint32_t b) { return keys[a] < keys[b]; });
+		EXPECT_EQ(order, expected);
+	}
+
+	std::vector<std::uint32_t> small_keys{ 5, 3, 5, 1, 3 };
+	std::vector<std::uint32_t> order;
+	RadixSortIndices(small_keys, order);
+	EXPECT_EQ(order, (std::vector<std::uint32_t>{ 3, 1, 4, 0, 2 }));
+}
+
+TEST(Maths, SpatialSort_Shapes)
+{
+	std::mt19937 generator(3);
+	std::uniform_real_distribution<float> position(-50.0f, 50.0f);
+	std::vector<Sphere> spheres;
+	std::vector<Circle> circles;
+	std::vector<AABB3> aabbs;
+	for (int i = 0; i < 3000; i++) {
+		const Vector3f center{ position(generator), position(generator), position(generator) };
+		spheres.emplace_back(1.0f, center);
+		circles.emplace_back(1.0f, Vector2f{ center.x, center.y });
+		aabbs.emplace_back(center, center + Vector3f{ 1.0f, 1.0f, 1.0f });
+	}
+	const std::vector<Sphere> original = spheres;
+
+	// Mean distance between neighbours in memory drops after the sort
+	auto mean_step = [](const std::vector<Sphere>& values) {
+		float total = 0.0f;
+		for (std::size_t i = 1; i < values.size(); i++) {
+			total += (values[i].center() - values[i - 1].center()).Magnitude();
+		}
+		return total / (values.size() - 1);
+	};
+	std::vector<std::uint32_t> order;
+	SpatialSort(std::span<Sphere>(spheres), SpaceFillingCurve::kMorton, &order);
+	EXPECT_LT(mean_step(spheres), mean_step(original) / 4.0f);
+	for (std::size_t i = 0; i < spheres.size(); i++) {
+		EXPECT_EQ(spheres[i].center(), original[order[i]].center());
+	}
+
+	std::vector<Sphere> hilbert = original;
+	SpatialSort(std::span<Sphere>(hilbert), SpaceFillingCurve::kHilbert);
+	EXPECT_LT(mean_step(hilbert), mean_step(original) / 4.0f);
+
+	SpatialSort(std::span<Circle>(circles), SpaceFillingCurve::kHilbert);
+	SpatialSort(std::span<AABB3>(aabbs));
+	std::vector<std::uint64_t> keys;
+	SpatialKeys(std::span<const AABB3>(aabbs), SpaceFillingCurve::kMorton, keys);
+	EXPECT_TRUE(std::is_sorted(keys.begin(), keys.end()));
+	SpatialKeys(std::span<const Circle>(circles), SpaceFillingCurve::kHilbert, keys);
+	EXPECT_TRUE(std::is_sorted(keys.begin(), keys.end()));
+}
+
+} // namespace maths
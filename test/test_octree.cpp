@@ -0,0 +1,195 @@
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "maths/octree.h"
+
+namespace maths {
+
+namespace {
+
+AABB3 RandomBox(std::mt19937& generator)
+{
+	std::uniform_real_distribution<float> position(-95.0f, 90.0f);
+	std::uniform_real_distribution<float> size(0.1f, 5.0f);
+	const Vector3f min{ position(generator), position(generator), position(generator) };
+	return { min, min + Vector3f{ size(generator), size(generator), size(generator) } };
+}
+
+// Reference slab test along Ray3::direction()
+bool RayDistance(const Ray3& ray, const AABB3& aabb, float& distance)
+{
+	float t_min = 0.0f;
+	float t_max = std::numeric_limits<float>::infinity();
+	for (int axis = 0; axis < 3; axis++) {
+		const float inverse = 1.0f / ray.direction()[axis];
+		const float t1 = (aabb.bottom_left()[axis] - ray.origin()[axis]) * inverse;
+		const float t2 = (aabb.top_right()[axis] - ray.origin()[axis]) * inverse;
+		t_min = std::max(t_min, std::min(t1, t2));
+		t_max = std::min(t_max, std::max(t1, t2));
+	}
+	distance = t_min;
+	return t_min <= t_max;
+}
+
+} // namespace
+
+class OctreeTest : public ::testing::Test {
+protected:
+	void SetUp() override
+	{
+		std::mt19937 generator(11);
+		for (int i = 0; i < 2000; i++) {
+			boxes_.push_back(RandomBox(generator));
+			handles_.push_back(octree_.Insert(boxes_.back()));
+		}
+		// A few objects outside the world bounds
+		boxes_.emplace_back(Vector3f{ 150.0f, 0.0f, 0.0f }, Vector3f{ 151.0f, 1.0f, 1.0f });
+		handles_.push_back(octree_.Insert(boxes_.back()));
+	}
+
+	std::vector<Octree::Handle> Expected(bool (*predicate)(const AABB3&, const void*), const void* data) const
+	{
+		std::vector<Octree::Handle> expected;
+		for (std::size_t i = 0; i < boxes_.size(); i++) {
+			if (handles_[i] != Octree::kInvalidHandle && predicate(boxes_[i], data)) {
+				expected.push_back(handles_[i]);
+			}
+		}
+		std::sort(expected.begin(), expected.end());
+		return expected;
+	}
+
+	Octree octree_{ AABB3{ Vector3f{ -100.0f, -100.0f, -100.0f }, Vector3f{ 100.0f, 100.0f, 100.0f } } };
+	std::vector<AABB3> boxes_;
+	std::vector<Octree::Handle> handles_;
+};
+
+TEST_F(OctreeTest, Octree_QuerySphere)
+{
+	const Sphere sphere{ 20.0f, Vector3f{ 10.0f, -5.0f, 3.0f } };
+	std::vector<Octree::Handle> result;
+	octree_.QuerySphere(sphere, result);
+	std::sort(result.begin(), result.end());
+	const auto expected = Expected([](const AABB3& box, const void* data) {
+		return AABBOverlapSphere(box, *static_cast<const Sphere*>(data));
+	}, &sphere);
+	EXPECT_FALSE(expected.empty());
+	EXPECT_EQ(result, expected);
+
+	// Objects outside the world are still found
+	result.clear();
+	octree_.QuerySphere(Sphere{ 2.0f, Vector3f{ 150.0f, 0.0f, 0.0f } }, result);
+	ASSERT_EQ(result.size(), 1u);
+	EXPECT_EQ(result[0], handles_.back());
+}
+
+TEST_F(OctreeTest, Octree_QueryFrustum)
+{
+	Vector3f up{ 0.0f, 1.0f, 0.0f };
+	Vector3f direction{ 0.0f, 0.0f, 1.0f };
+	Vector3f right = Vector3f::Cross(up, direction);
+	Frustum frustum;
+	frustum.calculate_frustum(direction, Vector3f{}, right, up, 0.1f, 80.0f,
+		degree_t(60.0f), degree_t(60.0f));
+
+	std::vector<Octree::Handle> result;
+	octree_.QueryFrustum(frustum, result);
+	std::sort(result.begin(), result.end());
+	const auto expected = Expected([](const AABB3& box, const void* data) {
+		return static_cast<const Frustum*>(data)->contains(box);
+	}, &frustum);
+	EXPECT_FALSE(expected.empty());
+	EXPECT_EQ(result, expected);
+}
+
+TEST_F(OctreeTest, Octree_Raycast)
+{
+	std::mt19937 generator(3);
+	std::uniform_real_distribution<float> coordinate(-1.0f, 1.0f);
+	for (int r = 0; r < 50; r++) {
+		Vector3f origin{ coordinate(generator) * 50.0f, coordinate(generator) * 50.0f, coordinate(generator) * 50.0f };
+		Vector3f direction{ coordinate(generator), coordinate(generator), coordinate(generator) };
+		const Ray3 ray{ origin, direction };
+
+		float best = std::numeric_limits<float>::infinity();
+		std::size_t hit_count = 0;
+		for (const AABB3& box : boxes_) {
+			float distance;
+			if (RayDistance(ray, box, distance)) {
+				best = std::min(best, distance);
+				hit_count++;
+			}
+		}
+		float distance;
+		const Octree::Handle hit = octree_.Raycast(ray, distance);
+		if (hit_count == 0) {
+			EXPECT_EQ(hit, Octree::kInvalidHandle);
+		} else {
+			ASSERT_NE(hit, Octree::kInvalidHandle);
+			EXPECT_FLOAT_EQ(distance, best);
+		}
+
+		std::vector<std::pair<Octree::Handle, float>> hits;
+		octree_.QueryRay(ray, hits);
+		EXPECT_EQ(hits.size(), hit_count);
+		EXPECT_TRUE(std::is_sorted(hits.begin(), hits.end(),
+			[](const auto& a, const auto& b) { return a.second < b.second; }));
+	}
+}
+
+TEST_F(OctreeTest, Octree_MoveRemove)
+{
+	std::mt19937 generator(5);
+	for (std::size_t i = 0; i < boxes_.size(); i += 3) {
+		boxes_[i] = RandomBox(generator);
+		octree_.Move(handles_[i], boxes_[i]);
+	}
+	for (std::size_t i = 1; i < boxes_.size(); i += 4) {
+		octree_.Remove(handles_[i]);
+		handles_[i] = Octree::kInvalidHandle;
+	}
+	const Sphere sphere{ 40.0f, Vector3f{ -20.0f, 10.0f, 0.0f } };
+	std::vector<Octree::Handle> result;
+	octree_.QuerySphere(sphere, result);
+	std::sort(result.begin(), result.end());
+	const auto expected = Expected([](const AABB3& box, const void* data) {
+		return AABBOverlapSphere(box, *static_cast<const Sphere*>(data));
+	}, &sphere);
+	EXPECT_EQ(result, expected);
+
+	for (Octree::Handle handle : handles_) {
+		octree_.Remove(handle);
+	}
+	EXPECT_EQ(octree_.size(), 0u);
+	EXPECT_EQ(octree_.node_count(), 1u);
+}
+
+} // namespace maths
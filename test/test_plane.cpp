@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 
+#include <vector>
+
 #include "maths/plane.h"
 #include "maths/vector3.h"
 #include "maths/vector2.h"
@@ -35,5 +37,57 @@ namespace maths
 		EXPECT_EQ(h.z, t.z);
 	}
 
+	TEST(Maths, Plane_NormalOffset)
+	{
+		const Vector3f normal{ 0.0f, 1.0f, 0.0f };
+		const Plane from_point{ Vector3f{ 5.0f, 2.0f, -3.0f }, normal };
+		const Plane from_offset{ normal, -2.0f };
+		EXPECT_FLOAT_EQ(from_point.d(), -2.0f);
+		EXPECT_FLOAT_EQ(from_point.Distance(Vector3f{ 1.0f, 5.0f, 1.0f }), 3.0f);
+		EXPECT_FLOAT_EQ(from_offset.Distance(Vector3f{ 1.0f, -1.0f, 1.0f }), -3.0f);
+		EXPECT_EQ(from_offset.point(), Vector3f(0.0f, 2.0f, 0.0f));
+	}
+
+	TEST(Maths, Plane_Classify)
+	{
+		const Plane plane{ Vector3f{ 1.0f, 0.0f, 0.0f }, -1.0f };
+		EXPECT_EQ(plane.Classify(Vector3f{ 2.0f, 0.0f, 0.0f }), PlaneSide::kFront);
+		EXPECT_EQ(plane.Classify(Vector3f{ 0.0f, 0.0f, 0.0f }), PlaneSide::kBack);
+		EXPECT_EQ(plane.Classify(Vector3f{ 1.001f, 0.0f, 0.0f }, 0.01f), PlaneSide::kStraddle);
+
+		EXPECT_EQ(plane.Classify(AABB3{ Vector3f{ 1.5f, -1.0f, -1.0f }, Vector3f{ 3.0f, 1.0f, 1.0f } }), PlaneSide::kFront);
+		EXPECT_EQ(plane.Classify(AABB3{ Vector3f{ -3.0f, -1.0f, -1.0f }, Vector3f{ 0.5f, 1.0f, 1.0f } }), PlaneSide::kBack);
+		EXPECT_EQ(plane.Classify(AABB3{ Vector3f{ 0.5f, -1.0f, -1.0f }, Vector3f{ 1.5f, 1.0f, 1.0f } }), PlaneSide::kStraddle);
+
+		EXPECT_EQ(plane.Classify(Sphere{ 0.5f, Vector3f{ 2.0f, 0.0f, 0.0f } }), PlaneSide::kFront);
+		EXPECT_EQ(plane.Classify(Sphere{ 0.5f, Vector3f{ 0.0f, 3.0f, 0.0f } }), PlaneSide::kBack);
+		EXPECT_EQ(plane.Classify(Sphere{ 1.5f, Vector3f{ 2.0f, 0.0f, 0.0f } }), PlaneSide::kStraddle);
+	}
+
+	TEST(Maths, Plane_Batch)
+	{
+		const Plane plane{ Vector3f{ 1.0f, 2.0f, -2.0f }, Vector3f{ 0.0f, 0.6f, 0.8f } };
+		std::vector<float> x, y, z;
+		for (int i = 0; i < 11; i++) {
+			x.push_back(i * 0.5f);
+			y.push_back(i * -0.25f + 1.0f);
+			z.push_back(i * 0.75f - 3.0f);
+		}
+		std::vector<float> distances(x.size());
+		plane.DistanceBatch(x, y, z, distances);
+		std::vector<PlaneSide> sides(x.size());
+		EXPECT_EQ(plane.ClassifyBatch(x, y, z, sides), PlaneSide::kStraddle);
+		for (std::size_t i = 0; i < x.size(); i++) {
+			const Vector3f p{ x[i], y[i], z[i] };
+			EXPECT_NEAR(distances[i], plane.Distance(p), 1e-5f);
+			EXPECT_EQ(sides[i], plane.Classify(p));
+		}
+
+		// Whole set on one side
+		const std::vector<float> ones(6, 10.0f);
+		sides.resize(ones.size());
+		EXPECT_EQ(plane.ClassifyBatch(ones, ones, ones, sides), PlaneSide::kFront);
+	}
+
 } // namespace maths
 
@@ -0,0 +1,158 @@
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+#include "maths/projection.h"
+#include "maths/simd.h"
+
+namespace maths {
+
+Vector4f ProjectPoint(const Matrix4f& matrix, const Vector3f& point)
+{
+	return matrix * Vector4f(point.x, point.y, point.z, 1.0f);
+}
+
+// inverse * (matrix * p) gives back p for points inside the volume
+void ExpectRoundTrip(const Matrix4f& matrix, const Matrix4f& inverse, float near_plane, float far_plane)
+{
+	std::mt19937 generator(3);
+	std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+	std::uniform_real_distribution<float> depth(near_plane, far_plane);
+	for (int i = 0; i < 100; i++) {
+		const Vector3f point{ value(generator), value(generator), -depth(generator) };
+		const Vector4f clip = ProjectPoint(matrix, point);
+		const Vector4f back = inverse * clip;
+		EXPECT_NEAR(back.x / back.w, point.x, 1e-4f);
+		EXPECT_NEAR(back.y / back.w, point.y, 1e-4f);
+		EXPECT_NEAR(back.z / back.w, point.z, 1e-3f * -point.z);
+	}
+}
+
+void ExpectSamePlanes(const Frustum& a, const Frustum& b)
+{
+	for (std::size_t i = 0; i < 6; i++) {
+		EXPECT_NEAR(a.plane(i).normal().x, b.plane(i).normal().x, 1e-5f);
+		EXPECT_NEAR(a.plane(i).normal().y, b.plane(i).normal().y, 1e-5f);
+		EXPECT_NEAR(a.plane(i).normal().z, b.plane(i).normal().z, 1e-5f);
+		EXPECT_NEAR(a.plane(i).d(), b.plane(i).d(), 1e-3f);
+	}
+}
+
+TEST(Maths, Projection_Perspective)
+{
+	const radian_t fov(1.5707963f);
+	const float n = 1.0f;
+	const float f = 100.0f;
+	// Same matrix as the hand written one of Frustum_FromMatrix
+	const Matrix4f projection = Perspective(fov, 1.0f, n, f);
+	EXPECT_NEAR(projection[0][0], 1.0f, 1e-6f);
+	EXPECT_NEAR(projection[2][2], (f + n) / (n - f), 1e-6f);
+	EXPECT_EQ(projection[2][3], -1.0f);
+	EXPECT_NEAR(projection[3][2], 2.0f * f * n / (n - f), 1e-5f);
+
+	for (ClipDepth depth : { ClipDepth::kNegativeOneToOne, ClipDepth::kZeroToOne }) {
+		const Matrix4f matrix = Perspective(fov, 1.5f, n, f, depth);
+		const Vector4f near_point = ProjectPoint(matrix, Vector3f{ 0.0f, 0.0f, -n });
+		const Vector4f far_point = ProjectPoint(matrix, Vector3f{ 0.0f, 0.0f, -f });
+		EXPECT_NEAR(near_point.z / near_point.w, depth == ClipDepth::kZeroToOne ? 0.0f : -1.0f, 1e-5f);
+		EXPECT_NEAR(far_point.z / far_point.w, 1.0f, 1e-5f);
+		ExpectRoundTrip(matrix, PerspectiveInverse(fov, 1.5f, n, f, depth), n, f);
+		ExpectSamePlanes(PerspectiveFrustum(fov, 1.5f, n, f), Frustum(matrix, depth));
+	}
+
+	// Reverse Z: depth 1 on the near plane, towards 0 far away
+	const Matrix4f reverse = PerspectiveReverseZ(fov, 1.5f, 0.1f);
+	const Vector4f near_point = ProjectPoint(reverse, Vector3f{ 0.0f, 0.0f, -0.1f });
+	const Vector4f far_point = ProjectPoint(reverse, Vector3f{ 0.0f, 0.0f, -1e6f });
+	EXPECT_NEAR(near_point.z / near_point.w, 1.0f, 1e-6f);
+	EXPECT_GT(far_point.z / far_point.w, 0.0f);
+	EXPECT_LT(far_point.z / far_point.w, 1e-6f);
+	ExpectRoundTrip(reverse, PerspectiveReverseZInverse(fov, 1.5f, 0.1f), 0.1f, 1000.0f);
+
+	const Frustum reverse_frustum = PerspectiveReverseZFrustum(fov, 1.5f, 0.1f);
+	EXPECT_TRUE(reverse_frustum.contains(Vector3f{ 0.0f, 0.0f, -1e6f }));
+	EXPECT_TRUE(reverse_frustum.contains(Vector3f{ 1.4f, 0.9f, -1.0f }));
+	EXPECT_FALSE(reverse_frustum.contains(Vector3f{ 1.6f, 0.0f, -1.0f }));
+	EXPECT_FALSE(reverse_frustum.contains(Vector3f{ 0.0f, 0.0f, -0.05f }));
+	// The missing far plane decides nothing, the side planes still reject
+	EXPECT_TRUE(reverse_frustum.contains(Sphere{ 1.0f, Vector3f{ 0.0f, 0.0f, -1e6f } }));
+	EXPECT_FALSE(reverse_frustum.contains(Sphere{ 1.0f, Vector3f{ 1000.0f, 0.0f, -10.0f } }));
+	EXPECT_FALSE(reverse_frustum.contains(Sphere{ 1.0f, Vector3f{ 0.0f, 1000.0f, -10.0f } }));
+	EXPECT_FALSE(reverse_frustum.contains(Sphere{ 1.0f, Vector3f{ 0.0f, 0.0f, 5.0f } }));
+}
+
+TEST(Maths, Projection_Orthographic)
+{
+	for (ClipDepth depth : { ClipDepth::kNegativeOneToOne, ClipDepth::kZeroToOne }) {
+		const Matrix4f matrix = Orthographic(-4.0f, 2.0f, -1.0f, 3.0f, 0.5f, 50.0f, depth);
+		const Vector4f low = ProjectPoint(matrix, Vector3f{ -4.0f, -1.0f, -0.5f });
+		const Vector4f high = ProjectPoint(matrix, Vector3f{ 2.0f, 3.0f, -50.0f });
+		EXPECT_NEAR(low.x, -1.0f, 1e-6f);
+		EXPECT_NEAR(low.y, -1.0f, 1e-6f);
+		EXPECT_NEAR(low.z, depth == ClipDepth::kZeroToOne ? 0.0f : -1.0f, 1e-6f);
+		EXPECT_NEAR(high.x, 1.0f, 1e-6f);
+		EXPECT_NEAR(high.y, 1.0f, 1e-6f);
+		EXPECT_NEAR(high.z, 1.0f, 1e-6f);
+		ExpectRoundTrip(matrix, OrthographicInverse(-4.0f, 2.0f, -1.0f, 3.0f, 0.5f, 50.0f, depth), 0.5f, 50.0f);
+		ExpectSamePlanes(OrthographicFrustum(-4.0f, 2.0f, -1.0f, 3.0f, 0.5f, 50.0f), Frustum(matrix, depth));
+	}
+}
+
+TEST(Maths, Projection_LookAt)
+{
+	const Vector3f eye{ 3.0f, 2.0f, -5.0f };
+	const Vector3f target{ -1.0f, 4.0f, 2.0f };
+	const Vector3f up{ 0.0f, 1.0f, 0.0f };
+	const Matrix4f view = LookAt(eye, target, up);
+	const Vector4f eye_view = ProjectPoint(view, eye);
+	const Vector4f target_view = ProjectPoint(view, target);
+	EXPECT_NEAR(eye_view.x, 0.0f, 1e-5f);
+	EXPECT_NEAR(eye_view.z, 0.0f, 1e-5f);
+	EXPECT_NEAR(target_view.x, 0.0f, 1e-5f);
+	EXPECT_NEAR(target_view.y, 0.0f, 1e-5f);
+	EXPECT_NEAR(target_view.z, -(target - eye).Magnitude(), 1e-5f);
+
+	const Matrix4f camera = LookAtInverse(eye, target, up);
+	const Vector4f back = camera * target_view;
+	EXPECT_NEAR(back.x, target.x, 1e-5f);
+	EXPECT_NEAR(back.y, target.y, 1e-5f);
+	EXPECT_NEAR(back.z, target.z, 1e-5f);
+
+	// World space frustum built directly against the one extracted from the
+	// view-projection product
+	const radian_t fov(1.0f);
+	Matrix4f view_projection;
+	const Matrix4f projection = Perspective(fov, 1.25f, 0.5f, 30.0f);
+	MultiplyMatrix4(reinterpret_cast<const float*>(&projection), reinterpret_cast<const float*>(&view),
+		reinterpret_cast<float*>(&view_projection));
+	const Frustum world = PerspectiveFrustum(fov, 1.25f, 0.5f, 30.0f).Transformed(camera);
+	ExpectSamePlanes(world, Frustum(view_projection));
+	EXPECT_TRUE(world.contains(target));
+	EXPECT_FALSE(world.contains(eye));
+}
+
+} // namespace maths
@@ -0,0 +1,86 @@
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "maths/quaternion.h"
+
+namespace maths {
+
+TEST(Maths, Quaternion_Rotate)
+{
+	const Vector3f z_axis{ 0.0f, 0.0f, 1.0f };
+	const Quaternion quarter = Quaternion::FromAxisAngle(z_axis, radian_t(1.5707963f));
+	EXPECT_NEAR(quarter.Magnitude(), 1.0f, 1e-6f);
+
+	// Quarter turn around z sends x to y
+	const Vector3f rotated = quarter.Rotate(Vector3f{ 1.0f, 0.0f, 0.0f });
+	EXPECT_NEAR(rotated.x, 0.0f, 1e-6f);
+	EXPECT_NEAR(rotated.y, 1.0f, 1e-6f);
+	EXPECT_NEAR(rotated.z, 0.0f, 1e-6f);
+
+	// Products apply the right hand side first
+	const Quaternion around_x = Quaternion::FromAxisAngle(Vector3f{ 1.0f, 0.0f, 0.0f }, radian_t(1.5707963f));
+	const Vector3f v{ 0.3f, -1.2f, 2.0f };
+	const Vector3f composed = (around_x * quarter).Rotate(v);
+	const Vector3f sequence = around_x.Rotate(quarter.Rotate(v));
+	EXPECT_NEAR(composed.x, sequence.x, 1e-5f);
+	EXPECT_NEAR(composed.y, sequence.y, 1e-5f);
+	EXPECT_NEAR(composed.z, sequence.z, 1e-5f);
+
+	// The conjugate undoes the rotation
+	const Vector3f back = quarter.Conjugate().Rotate(quarter.Rotate(v));
+	EXPECT_NEAR(back.x, v.x, 1e-5f);
+	EXPECT_NEAR(back.y, v.y, 1e-5f);
+	EXPECT_NEAR(back.z, v.z, 1e-5f);
+
+	EXPECT_EQ(Quaternion::Identity() * quarter, quarter);
+	EXPECT_NEAR((quarter * 3.0f).Normalized().Dot(quarter), 1.0f, 1e-6f);
+}
+
+TEST(Maths, Quaternion_FromRotationMatrix)
+{
+	// Half turns around each axis take the branches without a positive trace
+	const Quaternion rotations[] = {
+		Quaternion::FromAxisAngle(Vector3f{ 0.0f, 0.6f, 0.8f }, radian_t(0.7f)),
+		Quaternion::FromAxisAngle(Vector3f{ 1.0f, 0.0f, 0.0f }, radian_t(3.1f)),
+		Quaternion::FromAxisAngle(Vector3f{ 0.0f, 1.0f, 0.0f }, radian_t(3.1f)),
+		Quaternion::FromAxisAngle(Vector3f{ 0.0f, 0.0f, 1.0f }, radian_t(3.1f)),
+	};
+	for (const Quaternion& rotation : rotations) {
+		Matrix4f matrix;
+		for (int column = 0; column < 3; column++) {
+			Vector3f axis{ 0.0f, 0.0f, 0.0f };
+			axis[column] = 1.0f;
+			const Vector3f rotated = rotation.Rotate(axis);
+			matrix[column] = Vector4f(rotated.x, rotated.y, rotated.z, 0.0f);
+		}
+		// Either sign is the same rotation
+		EXPECT_NEAR(std::abs(Quaternion::FromRotationMatrix(matrix).Dot(rotation)), 1.0f, 1e-5f);
+	}
+}
+
+} // namespace maths
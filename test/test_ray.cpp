@@ -22,6 +22,11 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 #include "maths/ray2.h"
@@ -173,5 +178,210 @@ TEST(Maths, Ray_intersectSphere)
 	ASSERT_FALSE(ray.IntersectSphere(sphere));
 }
 
-} // namespace maths
+TEST(Maths, Ray_IntersectTriangle)
+{
+	const Vector3f a{ 0.0f, 0.0f, 0.0f };
+	const Vector3f b{ 1.0f, 0.0f, 0.0f };
+	const Vector3f c{ 0.0f, 1.0f, 0.0f };
+	Vector3f origin{ 0.25f, 0.5f, 2.0f };
+	Vector3f direction{ 0.0f, 0.0f, -1.0f };
+	Ray3 ray{ origin, direction };
+
+	// Barycentrics are the weights of b and c, both windings hit
+	TriangleHit hit;
+	ASSERT_TRUE(ray.IntersectTriangle(a, b, c, hit));
+	EXPECT_FLOAT_EQ(hit.distance, 2.0f);
+	EXPECT_FLOAT_EQ(hit.u, 0.25f);
+	EXPECT_FLOAT_EQ(hit.v, 0.5f);
+	ASSERT_TRUE(ray.IntersectTriangle(a, c, b, hit));
+	EXPECT_FLOAT_EQ(hit.u, 0.5f);
+	EXPECT_FLOAT_EQ(hit.v, 0.25f);
+
+	// Outside, behind the origin and past max distance
+	origin = Vector3f(0.75f, 0.75f, 2.0f);
+	ASSERT_FALSE(Ray3(origin, direction).IntersectTriangle(a, b, c, hit));
+	origin = Vector3f(0.25f, 0.25f, -1.0f);
+	ASSERT_FALSE(Ray3(origin, direction).IntersectTriangle(a, b, c, hit));
+	ASSERT_FALSE(WatertightRay(ray).Intersect(a, b, c, 1.5f, hit));
+	ASSERT_TRUE(WatertightRay(ray).Intersect(a, b, c, 2.0f, hit));
+}
 
+TEST(Maths, Ray_IntersectTriangleWatertight)
+{
+	// Rays through the shared edges and vertices of a triangulated grid
+	// must hit at least one triangle
+	constexpr int kSize = 8;
+	auto vertex = [](int x, int y) {
+		return Vector3f(static_cast<float>(x) * 0.37f, static_cast<float>(y) * 0.37f, 0.1f * static_cast<float>(x * y));
+	};
+	for (int y = 1; y < kSize; y++) {
+		for (int x = 1; x < kSize; x++) {
+			for (int edge = 0; edge < 3; edge++) {
+				// The vertex, the middle of the diagonal or of the horizontal edge
+				const Vector3f p0 = vertex(x, y);
+				const Vector3f p1 = edge == 1 ? vertex(x + 1, y + 1) : edge == 2 ? vertex(x + 1, y) : p0;
+				Vector3f target = (p0 + p1) * 0.5f;
+				Vector3f origin = target + Vector3f(0.3f, -0.2f, 5.0f);
+				Vector3f direction = target - origin;
+				const WatertightRay ray(Ray3(origin, direction));
+				bool found = false;
+				TriangleHit hit;
+				for (int j = y - 1; j <= y && !found; j++) {
+					for (int i = x - 1; i <= x && !found; i++) {
+						found = ray.Intersect(vertex(i, j), vertex(i + 1, j), vertex(i + 1, j + 1), 2.0f, hit)
+							|| ray.Intersect(vertex(i, j), vertex(i + 1, j + 1), vertex(i, j + 1), 2.0f, hit);
+					}
+				}
+				EXPECT_TRUE(found) << x << " " << y << " " << edge;
+			}
+		}
+	}
+}
+
+TEST(Maths, Ray_IntersectNearestCircles)
+{
+	// Circles 1 and 2 are the same, 3 is behind and 4 contains nothing of the ray
+	const std::vector<float> x{ 9.0f, 3.0f, 3.0f, -4.0f, 1.0f, 8.0f };
+	const std::vector<float> y{ 0.0f, 0.0f, 0.0f, 0.0f, 3.0f, 0.5f };
+	const std::vector<float> radius{ 1.0f, 1.0f, 1.0f, 1.0f, 0.5f, 1.0f };
+	Vector2f origin{ -1.0f, 0.0f };
+	Vector2f direction{ 2.0f, 0.0f };
+	const Ray2 ray{ origin, direction };
+
+	// Equal distances return the lowest index, t is in units of direction
+	Ray2Hit hit = IntersectNearest(ray, CircleSoA{ x, y, radius });
+	EXPECT_EQ(hit.index, 1u);
+	EXPECT_FLOAT_EQ(hit.t, 1.5f);
+
+	// Hits at max_t or further are ignored
+	hit = IntersectNearest(ray, CircleSoA{ x, y, radius }, 1.5f);
+	EXPECT_EQ(hit.index, kNoRay2Hit);
+	EXPECT_EQ(hit.t, 1.5f);
+
+	// Origin inside a circle
+	origin = Vector2f{ 3.5f, 0.0f };
+	hit = IntersectNearest(Ray2{ origin, direction }, CircleSoA{ x, y, radius });
+	EXPECT_EQ(hit.index, 1u);
+	EXPECT_EQ(hit.t, 0.0f);
+
+	// Circles behind the origin only
+	origin = Vector2f{ 20.0f, 0.0f };
+	hit = IntersectNearest(Ray2{ origin, direction }, CircleSoA{ x, y, radius });
+	EXPECT_EQ(hit.index, kNoRay2Hit);
+}
+
+TEST(Maths, Ray_IntersectNearestAABB2s)
+{
+	const std::vector<float> min_x{ 4.0f, 2.0f, -3.0f, 0.0f, 2.0f };
+	const std::vector<float> min_y{ -1.0f, 1.0f, -1.0f, -0.5f, -2.0f };
+	const std::vector<float> max_x{ 5.0f, 3.0f, -2.0f, 1.0f, 3.0f };
+	const std::vector<float> max_y{ 1.0f, 2.0f, 1.0f, 0.5f, -1.0f };
+	Vector2f origin{ -1.0f, 0.0f };
+	Vector2f direction{ 1.0f, 0.0f };
+	Ray2Hit hit = IntersectNearest(Ray2{ origin, direction }, AABB2SoA{ min_x, min_y, max_x, max_y });
+	EXPECT_EQ(hit.index, 3u);
+	EXPECT_FLOAT_EQ(hit.t, 1.0f);
+
+	// Axis aligned direction with a zero component, and a start inside a box
+	origin = Vector2f{ 0.5f, 0.0f };
+	hit = IntersectNearest(Ray2{ origin, direction }, AABB2SoA{ min_x, min_y, max_x, max_y });
+	EXPECT_EQ(hit.index, 3u);
+	EXPECT_EQ(hit.t, 0.0f);
+
+	// The common size of the spans only
+	hit = IntersectNearest(Ray2{ origin, direction },
+		AABB2SoA{ min_x, min_y, max_x, std::span(max_y).first(3) });
+	EXPECT_EQ(hit.index, 0u);
+	EXPECT_FLOAT_EQ(hit.t, 3.5f);
+}
+
+TEST(Maths, Ray_IntersectNearestBatch)
+{
+	// More obstacles than one tile and rays spread over several chunks
+	constexpr std::size_t kObstacles = 601;
+	constexpr std::size_t kRays = 203;
+	std::mt19937 generator(49);
+	std::uniform_real_distribution<float> position(-50.0f, 50.0f);
+	std::uniform_real_distribution<float> size(0.1f, 2.0f);
+	std::vector<float> center_x, center_y, radius, min_x, min_y, max_x, max_y;
+	for (std::size_t i = 0; i < kObstacles; i++) {
+		center_x.push_back(position(generator));
+		center_y.push_back(position(generator));
+		radius.push_back(size(generator));
+		min_x.push_back(center_x.back() - size(generator));
+		min_y.push_back(center_y.back() - size(generator));
+		max_x.push_back(center_x.back() + size(generator));
+		max_y.push_back(center_y.back() + size(generator));
+	}
+	std::vector<Ray2> rays;
+	for (std::size_t i = 0; i < kRays; i++) {
+		Vector2f origin{ position(generator), position(generator) };
+		Vector2f direction{ position(generator), position(generator) };
+		rays.emplace_back(origin, direction);
+	}
+
+	// Reference in double, one obstacle at a time
+	auto circle_t = [&](const Ray2& ray, std::size_t i) {
+		const double mx = double(ray.origin().x) - center_x[i];
+		const double my = double(ray.origin().y) - center_y[i];
+		const double dx = ray.direction().x;
+		const double dy = ray.direction().y;
+		const double a = dx * dx + dy * dy;
+		const double b = mx * dx + my * dy;
+		const double c = mx * mx + my * my - double(radius[i]) * radius[i];
+		const double discriminant = b * b - a * c;
+		if (discriminant < 0.0 || (c > 0.0 && b >= 0.0)) {
+			return -1.0;
+		}
+		return std::max(0.0, (-b - std::sqrt(discriminant)) / a);
+	};
+	auto aabb_t = [&](const Ray2& ray, std::size_t i) {
+		const double ox = ray.origin().x;
+		const double oy = ray.origin().y;
+		const double t1x = (min_x[i] - ox) / ray.direction().x;
+		const double t2x = (max_x[i] - ox) / ray.direction().x;
+		const double t1y = (min_y[i] - oy) / ray.direction().y;
+		const double t2y = (max_y[i] - oy) / ray.direction().y;
+		const double t_min = std::max({ std::min(t1x, t2x), std::min(t1y, t2y), 0.0 });
+		const double t_max = std::min(std::max(t1x, t2x), std::max(t1y, t2y));
+		return t_min <= t_max ? t_min : -1.0;
+	};
+
+	JobSystem jobs(4);
+	const CircleSoA circles{ center_x, center_y, radius };
+	const AABB2SoA aabbs{ min_x, min_y, max_x, max_y };
+	for (const float max_t : { 1e6f, 0.5f }) {
+		std::vector<Ray2Hit> circle_hits(kRays);
+		std::vector<Ray2Hit> aabb_hits(kRays);
+		IntersectNearestBatch(rays, circles, circle_hits, max_t, jobs);
+		IntersectNearestBatch(rays, aabbs, aabb_hits, max_t, jobs);
+		std::size_t hit_count = 0;
+		for (std::size_t r = 0; r < kRays; r++) {
+			double circle_best = max_t;
+			double aabb_best = max_t;
+			for (std::size_t i = 0; i < kObstacles; i++) {
+				const double t = circle_t(rays[r], i);
+				if (t >= 0.0 && t < circle_best) circle_best = t;
+				const double u = aabb_t(rays[r], i);
+				if (u >= 0.0 && u < aabb_best) aabb_best = u;
+			}
+			EXPECT_NEAR(circle_hits[r].t, circle_best, 1e-4 * (1.0 + circle_best));
+			EXPECT_NEAR(aabb_hits[r].t, aabb_best, 1e-4 * (1.0 + aabb_best));
+			if (circle_hits[r].index != kNoRay2Hit) {
+				hit_count++;
+				EXPECT_NEAR(circle_t(rays[r], circle_hits[r].index), circle_best, 1e-4 * (1.0 + circle_best));
+			}
+			if (aabb_hits[r].index != kNoRay2Hit) {
+				EXPECT_NEAR(aabb_t(rays[r], aabb_hits[r].index), aabb_best, 1e-4 * (1.0 + aabb_best));
+			}
+
+			// The batch matches the single ray query exactly
+			const Ray2Hit single = IntersectNearest(rays[r], circles, max_t);
+			EXPECT_EQ(single.index, circle_hits[r].index);
+			EXPECT_EQ(single.t, circle_hits[r].t);
+		}
+		EXPECT_GT(hit_count, 0u);
+	}
+}
+
+} // namespace maths
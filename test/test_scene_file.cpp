@@ -0,0 +1,195 @@
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <vector>
+
+#include "maths/scene_file.h"
+
+namespace maths {
+
+std::vector<AABB3> SceneFileBoxes(std::size_t count)
+{
+	std::mt19937 generator(7);
+	std::uniform_real_distribution<float> position(-50.0f, 50.0f);
+	std::uniform_real_distribution<float> size(0.1f, 3.0f);
+	std::vector<AABB3> aabbs;
+	for (std::size_t i = 0; i < count; i++) {
+		const Vector3f min{ position(generator), position(generator), position(generator) };
+		aabbs.emplace_back(min, min + Vector3f{ size(generator), size(generator), size(generator) });
+	}
+	return aabbs;
+}
+
+TEST(Maths, SceneFile_RoundTrip)
+{
+	const std::vector<AABB3> aabbs = SceneFileBoxes(2000);
+	Bvh bvh;
+	bvh.Build(aabbs);
+	const std::vector<Sphere> spheres{ Sphere{ 1.0f, Vector3f{ 1.0f, 2.0f, 3.0f } }, Sphere{ 4.0f, Vector3f{} } };
+	const std::vector<Plane> planes{ Plane{ Vector3f{ 0.0f, 1.0f, 0.0f }, -2.0f } };
+	const std::vector<Matrix4f> matrices{ Matrix4f(Vector4f(1.0f, 2.0f, 3.0f, 4.0f), Vector4f(5.0f, 6.0f, 7.0f, 8.0f),
+		Vector4f(9.0f, 10.0f, 11.0f, 12.0f), Vector4f(13.0f, 14.0f, 15.0f, 16.0f)) };
+
+	SceneWriter writer;
+	writer.Add(aabbs);
+	writer.Add(bvh);
+	writer.Add(spheres, 3);
+	writer.Add(planes);
+	writer.Add(matrices);
+	const std::string path = (std::filesystem::temp_directory_path() / "test_scene_file.bin").string();
+	ASSERT_TRUE(writer.Write(path));
+
+	SceneFile scene;
+	ASSERT_EQ(scene.Open(path, true), SceneFileError::kNone);
+	std::filesystem::remove(path);
+	ASSERT_EQ(scene.aabbs().size(), aabbs.size());
+	EXPECT_EQ(std::memcmp(scene.aabbs().data(), aabbs.data(), aabbs.size() * sizeof(AABB3)), 0);
+	ASSERT_EQ(scene.spheres(3).size(), 2u);
+	EXPECT_TRUE(scene.spheres().empty());
+	EXPECT_EQ(scene.spheres(3)[0].radius(), 1.0f);
+	EXPECT_EQ(scene.spheres(3)[0].center().z, 3.0f);
+	ASSERT_EQ(scene.planes().size(), 1u);
+	EXPECT_EQ(scene.planes()[0].d(), -2.0f);
+	ASSERT_EQ(scene.matrices().size(), 1u);
+	EXPECT_EQ(scene.matrices()[0][3].w, 16.0f);
+
+	// Queries run in the mapping and match the tree they were written from
+	const BvhView view = scene.bvh();
+	ASSERT_EQ(view.nodes().size(), bvh.nodes().size());
+	std::mt19937 generator(8);
+	std::uniform_real_distribution<float> position(-50.0f, 50.0f);
+	for (int i = 0; i < 50; i++) {
+		const Sphere sphere{ 5.0f, Vector3f{ position(generator), position(generator), position(generator) } };
+		std::vector<std::uint32_t> expected, result;
+		bvh.QuerySphere(aabbs, sphere, expected);
+		view.QuerySphere(scene.aabbs(), sphere, result);
+		EXPECT_EQ(result, expected);
+
+		Vector3f origin{ position(generator), position(generator), -60.0f };
+		Vector3f direction{ 0.0f, 0.0f, 1.0f };
+		float expected_distance = 0.0f, distance = 0.0f;
+		EXPECT_EQ(view.Raycast(scene.aabbs(), Ray3(origin, direction), distance),
+			bvh.Raycast(aabbs, Ray3(origin, direction), expected_distance));
+		EXPECT_EQ(distance, expected_distance);
+	}
+
+	// Moving keeps the mapping alive, Close releases it
+	SceneFile moved = std::move(scene);
+	EXPECT_FALSE(scene.is_open());
+	EXPECT_EQ(moved.aabbs().size(), aabbs.size());
+	moved.Close();
+	EXPECT_TRUE(moved.aabbs().empty());
+	EXPECT_EQ(moved.Open(path), SceneFileError::kOpenFailed);
+}
+
+TEST(Maths, SceneFile_Validate)
+{
+	const std::vector<AABB3> aabbs = SceneFileBoxes(100);
+	Bvh bvh;
+	bvh.Build(aabbs);
+	SceneWriter writer;
+	writer.Add(aabbs);
+	writer.Add(bvh);
+	const std::vector<std::byte> data = writer.Serialize();
+	ASSERT_EQ(ValidateSceneFile(data, true), SceneFileError::kNone);
+	EXPECT_EQ(ValidateSceneFile(SceneWriter().Serialize(), true), SceneFileError::kNone);
+	SceneWriter empty_writer;
+	const AABB3 empty_aabbs[1] = { AABB3::Empty() };
+	empty_writer.Add(empty_aabbs);
+	EXPECT_EQ(ValidateSceneFile(empty_writer.Serialize(), true), SceneFileError::kNone);
+
+	auto corrupt = [&data](std::size_t offset, std::uint32_t value) {
+		std::vector<std::byte> copy = data;
+		std::memcpy(copy.data() + offset, &value, sizeof(value));
+		return copy;
+	};
+	EXPECT_EQ(ValidateSceneFile(std::span(data).first(10)), SceneFileError::kTruncated);
+	EXPECT_EQ(ValidateSceneFile(std::span(data).first(data.size() - 1)), SceneFileError::kTruncated);
+	EXPECT_EQ(ValidateSceneFile(corrupt(0, 0)), SceneFileError::kBadMagic);
+	EXPECT_EQ(ValidateSceneFile(corrupt(4, kSceneFileVersion + 1)), SceneFileError::kBadVersion);
+	EXPECT_EQ(ValidateSceneFile(corrupt(8, 0x04030201)), SceneFileError::kBadEndianness);
+
+	// First section entry: type, tag, element_size, reserved, offset, count
+	const std::size_t entry = sizeof(SceneFileHeader);
+	EXPECT_EQ(ValidateSceneFile(corrupt(entry, 42)), SceneFileError::kBadSection);
+	EXPECT_EQ(ValidateSceneFile(corrupt(entry + 8, 12)), SceneFileError::kBadSection);
+	EXPECT_EQ(ValidateSceneFile(corrupt(entry + 24, 1000000)), SceneFileError::kTruncated);
+	EXPECT_EQ(ValidateSceneFile(corrupt(entry + 16, static_cast<std::uint32_t>(data.size() - 2))),
+		SceneFileError::kTruncated);
+
+	// Contents are only checked on demand
+	SceneFile scene;
+	ASSERT_EQ(scene.View(data), SceneFileError::kNone);
+	const std::size_t nodes_offset = reinterpret_cast<const std::byte*>(scene.bvh().nodes().data()) - data.data();
+	const std::size_t aabbs_offset = reinterpret_cast<const std::byte*>(scene.aabbs().data()) - data.data();
+	// Root pointing to itself
+	const std::vector<std::byte> cycle = corrupt(nodes_offset + offsetof(BvhNode, first), 0);
+	EXPECT_EQ(ValidateSceneFile(cycle), SceneFileError::kNone);
+	EXPECT_EQ(ValidateSceneFile(cycle, true), SceneFileError::kBadBvh);
+	EXPECT_EQ(scene.View(cycle, true), SceneFileError::kBadBvh);
+	EXPECT_FALSE(scene.is_open());
+	// Min x of the first box past its max x
+	EXPECT_EQ(ValidateSceneFile(corrupt(aabbs_offset, 0x7F000000), true), SceneFileError::kBadAABB3);
+}
+
+TEST(Maths, SceneFile_ValidateLinearBvh)
+{
+	// BuildLinear stores many children before their parent
+	const std::vector<AABB3> aabbs = SceneFileBoxes(1000);
+	Bvh bvh;
+	bvh.BuildLinear(aabbs);
+	std::size_t backward_links = 0;
+	for (std::size_t i = 0; i < bvh.nodes().size(); i++) {
+		const BvhNode& node = bvh.nodes()[i];
+		backward_links += !node.IsLeaf() && node.first < i;
+	}
+	EXPECT_GT(backward_links, 0u);
+
+	SceneWriter writer;
+	writer.Add(aabbs);
+	writer.Add(bvh);
+	const std::vector<std::byte> data = writer.Serialize();
+	ASSERT_EQ(ValidateSceneFile(data, true), SceneFileError::kNone);
+	SceneFile scene;
+	ASSERT_EQ(scene.View(data, true), SceneFileError::kNone);
+	EXPECT_EQ(scene.bvh().nodes().size(), bvh.nodes().size());
+
+	// Two inner nodes sharing their children are still rejected
+	const std::size_t nodes_offset = reinterpret_cast<const std::byte*>(scene.bvh().nodes().data()) - data.data();
+	const BvhNode& root = bvh.nodes()[0];
+	const std::uint32_t inner = bvh.nodes()[root.first].IsLeaf() ? root.first + 1 : root.first;
+	ASSERT_FALSE(bvh.nodes()[inner].IsLeaf());
+	std::vector<std::byte> shared = data;
+	const std::uint32_t root_children = root.first;
+	std::memcpy(shared.data() + nodes_offset + inner * sizeof(BvhNode) + offsetof(BvhNode, first),
+		&root_children, sizeof(root_children));
+	EXPECT_EQ(ValidateSceneFile(shared, true), SceneFileError::kBadBvh);
+}
+
+} // namespace maths
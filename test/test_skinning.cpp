@@ -0,0 +1,213 @@
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "maths/skinning.h"
+#include "maths/transform3.h"
+
+namespace maths {
+
+// Vertex streams with random influences over bone_count bones
+struct SkinnedMesh {
+	std::vector<float> px, py, pz, nx, ny, nz;
+	std::vector<BoneInfluences> influences;
+
+	SkinningInput input() const { return { px, py, pz, nx, ny, nz, influences }; }
+};
+
+struct SkinnedStreams {
+	explicit SkinnedStreams(std::size_t count) : px(count), py(count), pz(count), nx(count), ny(count), nz(count) {}
+
+	std::vector<float> px, py, pz, nx, ny, nz;
+
+	SkinningOutput output() { return { px, py, pz, nx, ny, nz }; }
+	Vector3f position(std::size_t i) const { return { px[i], py[i], pz[i] }; }
+	Vector3f normal(std::size_t i) const { return { nx[i], ny[i], nz[i] }; }
+};
+
+SkinnedMesh RandomSkinnedMesh(std::mt19937& generator, std::size_t count, std::size_t bone_count)
+{
+	std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+	std::uniform_int_distribution<int> bone(0, static_cast<int>(bone_count) - 1);
+	SkinnedMesh mesh;
+	for (std::size_t i = 0; i < count; i++) {
+		mesh.px.push_back(value(generator));
+		mesh.py.push_back(value(generator));
+		mesh.pz.push_back(value(generator));
+		const Vector3f normal = Vector3f{ value(generator), value(generator), 0.5f }.Normalized();
+		mesh.nx.push_back(normal.x);
+		mesh.ny.push_back(normal.y);
+		mesh.nz.push_back(normal.z);
+		BoneInfluences influence;
+		float total = 0.0f;
+		for (std::size_t k = 0; k < kMaxBoneInfluences; k++) {
+			influence.bones[k] = static_cast<std::uint16_t>(bone(generator));
+			// Some vertices use fewer than four bones
+			influence.weights[k] = k > 0 && i % 3 == 0 ? 0.0f : 0.5f + 0.5f * value(generator);
+			total += influence.weights[k];
+		}
+		for (float& weight : influence.weights) {
+			weight /= total;
+		}
+		mesh.influences.push_back(influence);
+	}
+	return mesh;
+}
+
+Transform3 RandomBoneTransform(std::mt19937& generator, float scale)
+{
+	std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+	return { Vector3f{ value(generator), value(generator), value(generator) },
+		Quaternion(value(generator), value(generator), value(generator), value(generator)).Normalized(),
+		Vector3f{ scale, scale, scale } };
+}
+
+void ExpectSkinnedNear(const Vector3f& a, const Vector3f& b)
+{
+	EXPECT_NEAR(a.x, b.x, 1e-4f);
+	EXPECT_NEAR(a.y, b.y, 1e-4f);
+	EXPECT_NEAR(a.z, b.z, 1e-4f);
+}
+
+TEST(Maths, Skinning_LinearBlend)
+{
+	std::mt19937 generator(42);
+	constexpr std::size_t kBones = 12;
+	// Not a multiple of four to cover the tail
+	constexpr std::size_t kVertices = 1003;
+	std::vector<Transform3> bones;
+	std::vector<Matrix4f> bone_world, inverse_bind;
+	for (std::size_t b = 0; b < kBones; b++) {
+		bones.push_back(RandomBoneTransform(generator, 1.0f + 0.1f * static_cast<float>(b)));
+		bone_world.push_back(bones.back().ToMatrix4f());
+		inverse_bind.push_back(Matrix4f::identity());
+	}
+	std::vector<Matrix4f> palette(kBones);
+	BuildSkinningPalette(bone_world, inverse_bind, palette);
+	for (std::size_t b = 0; b < kBones; b++) {
+		for (int column = 0; column < 4; column++) {
+			EXPECT_EQ(palette[b][column], bone_world[b][column]);
+		}
+	}
+
+	const SkinnedMesh mesh = RandomSkinnedMesh(generator, kVertices, kBones);
+	SkinnedStreams skinned(kVertices);
+	SkinLinearBlend(palette, mesh.input(), skinned.output());
+	for (std::size_t i = 0; i < kVertices; i++) {
+		const Vector3f position{ mesh.px[i], mesh.py[i], mesh.pz[i] };
+		const Vector3f normal{ mesh.nx[i], mesh.ny[i], mesh.nz[i] };
+		Vector3f expected_position{ 0.0f, 0.0f, 0.0f };
+		Vector3f expected_normal{ 0.0f, 0.0f, 0.0f };
+		for (std::size_t k = 0; k < kMaxBoneInfluences; k++) {
+			const Transform3& bone = bones[mesh.influences[i].bones[k]];
+			expected_position += bone.TransformPoint(position) * mesh.influences[i].weights[k];
+			expected_normal += bone.TransformDirection(normal) * mesh.influences[i].weights[k];
+		}
+		ExpectSkinnedNear(skinned.position(i), expected_position);
+		ExpectSkinnedNear(skinned.normal(i), expected_normal.Normalized());
+	}
+
+	// The parallel variant only changes the chunking
+	JobSystem jobs(4);
+	SkinnedStreams parallel(kVertices);
+	SkinLinearBlend(palette, mesh.input(), parallel.output(), jobs);
+	EXPECT_EQ(parallel.px, skinned.px);
+	EXPECT_EQ(parallel.nz, skinned.nz);
+
+	// Bind pose bones leave the mesh in place
+	for (std::size_t b = 0; b < kBones; b++) {
+		inverse_bind[b] = bones[b].Inverse().ToMatrix4f();
+	}
+	BuildSkinningPalette(bone_world, inverse_bind, palette);
+	SkinningInput positions_only = mesh.input();
+	positions_only.nx = {};
+	SkinLinearBlend(palette, positions_only, skinned.output());
+	for (std::size_t i = 0; i < kVertices; i++) {
+		ExpectSkinnedNear(skinned.position(i), Vector3f{ mesh.px[i], mesh.py[i], mesh.pz[i] });
+	}
+}
+
+TEST(Maths, Skinning_DualQuaternion)
+{
+	std::mt19937 generator(7);
+	constexpr std::size_t kBones = 8;
+	constexpr std::size_t kVertices = 501;
+	std::vector<Transform3> bones;
+	std::vector<Matrix4f> palette;
+	for (std::size_t b = 0; b < kBones; b++) {
+		bones.push_back(RandomBoneTransform(generator, 1.0f));
+		palette.push_back(bones.back().ToMatrix4f());
+	}
+	std::vector<DualQuaternion> dual_palette(kBones);
+	BuildDualQuaternionPalette(palette, dual_palette);
+	const Vector3f point{ 0.3f, -0.7f, 1.1f };
+	for (std::size_t b = 0; b < kBones; b++) {
+		ExpectSkinnedNear(dual_palette[b].TransformPoint(point), bones[b].TransformPoint(point));
+	}
+
+	// A single bone per vertex is the rigid transform itself
+	SkinnedMesh mesh = RandomSkinnedMesh(generator, kVertices, kBones);
+	for (BoneInfluences& influence : mesh.influences) {
+		influence.weights[0] = 1.0f;
+		influence.weights[1] = influence.weights[2] = influence.weights[3] = 0.0f;
+	}
+	SkinnedStreams skinned(kVertices);
+	SkinDualQuaternion(dual_palette, mesh.input(), skinned.output());
+	for (std::size_t i = 0; i < kVertices; i++) {
+		const Transform3& bone = bones[mesh.influences[i].bones[0]];
+		ExpectSkinnedNear(skinned.position(i), bone.TransformPoint(Vector3f{ mesh.px[i], mesh.py[i], mesh.pz[i] }));
+		ExpectSkinnedNear(skinned.normal(i), bone.TransformDirection(Vector3f{ mesh.nx[i], mesh.ny[i], mesh.nz[i] }));
+	}
+
+	// Half way between a bone and its half turn twist around x, with the
+	// second quaternion flipped: linear blend collapses the vertex onto the
+	// axis while dual quaternions keep its distance to it
+	const Quaternion twist = Quaternion::FromAxisAngle(Vector3f{ 1.0f, 0.0f, 0.0f }, radian_t(3.0f));
+	const DualQuaternion twist_palette[] = {
+		DualQuaternion::FromRigid(Quaternion::Identity(), Vector3f{ 0.0f, 0.0f, 0.0f }),
+		DualQuaternion::FromRigid(-twist, Vector3f{ 0.0f, 0.0f, 0.0f }),
+	};
+	BoneInfluences half;
+	half.bones[1] = 1;
+	half.weights[0] = half.weights[1] = 0.5f;
+	const float px[] = { 0.5f }, py[] = { 0.0f }, pz[] = { 1.0f };
+	float out_x[1], out_y[1], out_z[1];
+	const BoneInfluences influences[] = { half };
+	SkinDualQuaternion(twist_palette, { px, py, pz, {}, {}, {}, influences }, { out_x, out_y, out_z, {}, {}, {} });
+	EXPECT_NEAR(out_x[0], 0.5f, 1e-5f);
+	EXPECT_NEAR(std::sqrt(out_y[0] * out_y[0] + out_z[0] * out_z[0]), 1.0f, 1e-5f);
+
+	JobSystem jobs(4);
+	SkinnedStreams parallel(kVertices);
+	SkinDualQuaternion(dual_palette, mesh.input(), parallel.output(), jobs);
+	EXPECT_EQ(parallel.py, skinned.py);
+	EXPECT_EQ(parallel.nx, skinned.nx);
+}
+
+} // namespace maths
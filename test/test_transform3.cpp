@@ -0,0 +1,201 @@
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+#include "maths/transform3.h"
+
+namespace maths {
+
+void ExpectVector3Near(const Vector3f& a, const Vector3f& b, float tolerance)
+{
+	EXPECT_NEAR(a.x, b.x, tolerance);
+	EXPECT_NEAR(a.y, b.y, tolerance);
+	EXPECT_NEAR(a.z, b.z, tolerance);
+}
+
+Transform3 RandomTransform3(std::mt19937& generator, bool uniform_scale)
+{
+	std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+	const float scale = 1.0f + 0.5f * value(generator);
+	return { Vector3f{ 3.0f * value(generator), 3.0f * value(generator), 3.0f * value(generator) },
+		Quaternion(value(generator), value(generator), value(generator), value(generator)).Normalized(),
+		uniform_scale ? Vector3f{ scale, scale, scale }
+			: Vector3f{ scale, 1.0f + 0.5f * value(generator), 1.0f + 0.5f * value(generator) } };
+}
+
+TEST(Maths, Transform3_Apply)
+{
+	std::mt19937 generator(1);
+	const Vector3f point{ 0.5f, -1.5f, 2.0f };
+	for (int i = 0; i < 100; i++) {
+		const Transform3 transform = RandomTransform3(generator, false);
+		const Matrix4f matrix = transform.ToMatrix4f();
+		const Vector4f expected_point = matrix * Vector4f(point.x, point.y, point.z, 1.0f);
+		const Vector4f expected_direction = matrix * Vector4f(point.x, point.y, point.z, 0.0f);
+		ExpectVector3Near(transform.TransformPoint(point), Vector3f{ expected_point.x, expected_point.y, expected_point.z }, 1e-4f);
+		ExpectVector3Near(transform.TransformDirection(point),
+			Vector3f{ expected_direction.x, expected_direction.y, expected_direction.z }, 1e-4f);
+		EXPECT_EQ(expected_point.w, 1.0f);
+
+		// Composition applies the child first, exact with uniform scales
+		const Transform3 parent = RandomTransform3(generator, true);
+		ExpectVector3Near((parent * transform).TransformPoint(point),
+			parent.TransformPoint(transform.TransformPoint(point)), 1e-4f);
+		const Transform3 inverse = parent.Inverse();
+		ExpectVector3Near(inverse.TransformPoint(parent.TransformPoint(point)), point, 1e-4f);
+		ExpectVector3Near((parent * inverse).TransformPoint(point), point, 1e-4f);
+	}
+	ExpectVector3Near(Transform3::Identity().TransformPoint(point), point, 0.0f);
+}
+
+TEST(Maths, Transform3_Interpolate)
+{
+	const Vector3f y_axis{ 0.0f, 1.0f, 0.0f };
+	const Transform3 a{ Vector3f{ 0.0f, 0.0f, 0.0f }, Quaternion::Identity(), Vector3f{ 1.0f, 1.0f, 1.0f } };
+	const Transform3 b{ Vector3f{ 2.0f, 4.0f, 0.0f }, Quaternion::FromAxisAngle(y_axis, radian_t(1.5f)),
+		Vector3f{ 3.0f, 3.0f, 3.0f } };
+
+	// Slerp turns at constant speed, Nlerp only matches it at the ends
+	const Transform3 slerp = Transform3::Slerp(a, b, 0.25f);
+	const Transform3 lerp = Transform3::Lerp(a, b, 0.25f);
+	ExpectVector3Near(slerp.translation, Vector3f{ 0.5f, 1.0f, 0.0f }, 1e-6f);
+	ExpectVector3Near(slerp.scale, Vector3f{ 1.5f, 1.5f, 1.5f }, 1e-6f);
+	const Quaternion expected = Quaternion::FromAxisAngle(y_axis, radian_t(0.375f));
+	EXPECT_NEAR(std::abs(slerp.rotation.Dot(expected)), 1.0f, 1e-6f);
+	EXPECT_NEAR(lerp.rotation.Magnitude(), 1.0f, 1e-6f);
+	EXPECT_NEAR(std::abs(lerp.rotation.Dot(expected)), 1.0f, 1e-3f);
+	EXPECT_NEAR(std::abs(Transform3::Lerp(a, b, 1.0f).rotation.Dot(b.rotation)), 1.0f, 1e-6f);
+
+	// The shortest arc is taken when the quaternions have opposite signs
+	const Transform3 flipped{ b.translation, -b.rotation, b.scale };
+	EXPECT_NEAR(std::abs(Transform3::Slerp(a, flipped, 0.25f).rotation.Dot(expected)), 1.0f, 1e-6f);
+}
+
+TEST(Maths, Transform3_ToMatrix4fBatch)
+{
+	std::mt19937 generator(2);
+	std::vector<Transform3> transforms;
+	for (int i = 0; i < 103; i++) {
+		transforms.push_back(RandomTransform3(generator, i % 2 == 0));
+	}
+	std::vector<Matrix4f> matrices(transforms.size());
+	ToMatrix4fBatch(transforms, matrices);
+	for (std::size_t i = 0; i < transforms.size(); i++) {
+		const Matrix4f expected = transforms[i].ToMatrix4f();
+		for (int column = 0; column < 4; column++) {
+			for (int row = 0; row < 4; row++) {
+				EXPECT_NEAR(matrices[i][column][row], expected[column][row], 1e-6f) << i;
+			}
+		}
+	}
+}
+
+void ExpectMatrix4Near(const Matrix4f& a, const Matrix4f& b, float tolerance)
+{
+	for (int column = 0; column < 4; column++) {
+		for (int row = 0; row < 4; row++) {
+			EXPECT_NEAR(a[column][row], b[column][row], tolerance);
+		}
+	}
+}
+
+TEST(Maths, Transform3_Decompose)
+{
+	std::mt19937 generator(4);
+	std::vector<Matrix4f> matrices;
+	for (int i = 0; i < 50; i++) {
+		Transform3 source = RandomTransform3(generator, false);
+		// Mirrors on every axis end up as a negative x scale
+		if (i % 5 == 1) {
+			source.scale.y = -source.scale.y;
+		}
+		const Matrix4f matrix = source.ToMatrix4f();
+		Transform3 transform;
+		EXPECT_EQ(Decompose(matrix, transform), DecomposeStatus::kExact);
+		ExpectMatrix4Near(transform.ToMatrix4f(), matrix, 1e-4f);
+		ExpectVector3Near(transform.translation, source.translation, 0.0f);
+		if (i % 5 != 1) {
+			ExpectVector3Near(transform.scale, source.scale, 1e-5f);
+			EXPECT_NEAR(std::abs(transform.rotation.Dot(source.rotation)), 1.0f, 1e-5f);
+		} else {
+			EXPECT_LT(transform.scale.x, 0.0f);
+		}
+		matrices.push_back(matrix);
+	}
+
+	// Rotation times a shear: the polar rotation is kept
+	const Quaternion rotation = Quaternion(0.2f, 0.4f, -0.1f, 0.9f).Normalized();
+	Matrix4f sheared = Transform3(Vector3f{ 1.0f, 2.0f, 3.0f }, rotation, Vector3f{ 1.0f, 1.0f, 1.0f }).ToMatrix4f();
+	const Vector3f rotated_x = rotation.Rotate(Vector3f{ 1.0f, 0.0f, 0.0f });
+	sheared[1] += Vector4f(rotated_x.x, rotated_x.y, rotated_x.z, 0.0f) * 0.3f;
+	Transform3 transform;
+	EXPECT_EQ(Decompose(sheared, transform), DecomposeStatus::kSheared);
+	EXPECT_NEAR(transform.rotation.Magnitude(), 1.0f, 1e-5f);
+	const Matrix4f rebuilt = transform.ToMatrix4f();
+	for (int column = 0; column < 3; column++) {
+		// Columns keep their direction up to the shear
+		const Vector3f a{ rebuilt[column].x, rebuilt[column].y, rebuilt[column].z };
+		const Vector3f b{ sheared[column].x, sheared[column].y, sheared[column].z };
+		EXPECT_GT(a.Dot(b) / (a.Magnitude() * b.Magnitude()), 0.98f);
+	}
+	matrices.push_back(sheared);
+
+	const Matrix4f flat = Transform3(Vector3f{ 1.0f, 2.0f, 3.0f }, rotation, Vector3f{ 1.0f, 0.0f, 1.0f }).ToMatrix4f();
+	EXPECT_EQ(Decompose(flat, transform), DecomposeStatus::kSingular);
+	EXPECT_EQ(transform.rotation, Quaternion::Identity());
+	matrices.push_back(flat);
+
+	// Small sheared matrices, as in files in millimeters, keep the rotation of
+	// the unit one
+	const Matrix4f unit_shear{ Vector4f(1.0f, 0.0f, 0.0f, 0.0f), Vector4f(0.5f, 1.0f, 0.0f, 0.0f),
+		Vector4f(0.0f, 0.0f, 1.0f, 0.0f), Vector4f(0.0f, 0.0f, 0.0f, 1.0f) };
+	Transform3 unit_transform;
+	ASSERT_EQ(Decompose(unit_shear, unit_transform), DecomposeStatus::kSheared);
+	for (const float scale : { 0.004f, 0.001f }) {
+		Matrix4f small_shear = unit_shear;
+		for (int column = 0; column < 3; column++) {
+			small_shear[column] = small_shear[column] * scale;
+		}
+		EXPECT_EQ(Decompose(small_shear, transform), DecomposeStatus::kSheared);
+		EXPECT_NEAR(std::abs(transform.rotation.Dot(unit_transform.rotation)), 1.0f, 1e-5f);
+		ExpectVector3Near(transform.scale, unit_transform.scale * scale, scale * 1e-4f);
+		matrices.push_back(small_shear);
+	}
+
+	std::vector<Transform3> transforms(matrices.size());
+	std::vector<DecomposeStatus> statuses(matrices.size());
+	DecomposeBatch(matrices, transforms, statuses);
+	for (std::size_t i = 0; i < matrices.size(); i++) {
+		Transform3 expected;
+		EXPECT_EQ(statuses[i], Decompose(matrices[i], expected));
+		EXPECT_EQ(transforms[i].rotation, expected.rotation);
+		ExpectVector3Near(transforms[i].scale, expected.scale, 0.0f);
+	}
+}
+
+} // namespace maths
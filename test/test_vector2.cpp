@@ -196,6 +196,36 @@ TEST(Maths, Vector2f_Normalize) {
     EXPECT_EQ(c.Magnitude(), 1.0f);
 }
 
+TEST(Maths, Vector2f_NormalizeFastAndSafe) {
+    const Vector2f a{3.0f, -4.0f};
+
+    //Test .NormalizedFast().
+    const Vector2f b = a.NormalizedFast();
+    EXPECT_NEAR(b.x, 0.6f, 6e-7f);
+    EXPECT_NEAR(b.y, -0.8f, 6e-7f);
+
+    //Test .NormalizeSafe().
+    Vector2f c = a;
+    EXPECT_TRUE(c.NormalizeSafe());
+    EXPECT_NEAR(c.Magnitude(), 1.0f, 1e-6f);
+    Vector2f zero{0.0f, 0.0f};
+    EXPECT_FALSE(zero.NormalizeSafe());
+    EXPECT_EQ(zero.x, 0.0f);
+    EXPECT_EQ(zero.y, 0.0f);
+
+    //Test NormalizeBatch() with a scalar tail and a zero vector.
+    const Vector2f in[] = {{3.0f, 4.0f}, {0.0f, 0.0f}, {0.0f, -2.0f}, {1.0f, 1.0f}, {-5.0f, 0.0f}};
+    Vector2f out[5];
+    NormalizeBatch(in, out);
+    for (std::size_t i = 0; i < 5; i++) {
+        const Vector2f expected = in[i].Normalized();
+        EXPECT_NEAR(out[i].x, expected.x, 6e-7f);
+        EXPECT_NEAR(out[i].y, expected.y, 6e-7f);
+    }
+    EXPECT_EQ(out[1].x, 0.0f);
+    EXPECT_EQ(out[1].y, 0.0f);
+}
+
 TEST(Maths, Vector2f_Lerp) {
     const Vector2f a{2.0f, 3.0f};
     const Vector2f b{1.0f, 4.0f};
@@ -22,6 +22,10 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 
+#include <cmath>
+#include <random>
+#include <vector>
+
 #include <gtest/gtest.h>
 #include "maths/vector3.h"
 
@@ -209,6 +213,67 @@ TEST(Maths, Vector3f_Normalize) {
     EXPECT_EQ(c.Magnitude(), 1.0f);
 }
 
+TEST(Maths, Vector3f_NormalizedFast) {
+    // Documented bound 2^-21 relative error, plus rounding of the products.
+    const float tolerance = 6e-7f;
+    std::mt19937 generator(48);
+    std::uniform_real_distribution<float> component(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> exponent(-15.0f, 15.0f);
+    for (int i = 0; i < 10000; i++) {
+        const float scale = std::pow(10.0f, exponent(generator));
+        const maths::Vector3f a =
+            maths::Vector3f{component(generator), component(generator), component(generator)} * scale;
+        const maths::Vector3f fast = a.NormalizedFast();
+        // Normalized flushes magnitudes below 1e-7 to zero, compare in double.
+        const double magnitude = std::sqrt(double(a.x) * a.x + double(a.y) * a.y + double(a.z) * a.z);
+        EXPECT_NEAR(fast.x, a.x / magnitude, tolerance);
+        EXPECT_NEAR(fast.y, a.y / magnitude, tolerance);
+        EXPECT_NEAR(fast.z, a.z / magnitude, tolerance);
+    }
+
+    // Test .NormalizeSafe().
+    maths::Vector3f b{0.0f, 3.0f, 4.0f};
+    EXPECT_TRUE(b.NormalizeSafe());
+    EXPECT_NEAR(b.y, 0.6f, tolerance);
+    EXPECT_NEAR(b.z, 0.8f, tolerance);
+    maths::Vector3f zero{0.0f, 0.0f, 0.0f};
+    EXPECT_FALSE(zero.NormalizeSafe());
+    EXPECT_EQ(zero, maths::Vector3f(0.0f, 0.0f, 0.0f));
+    maths::Vector3f tiny{1e-8f, 0.0f, 0.0f};
+    EXPECT_FALSE(tiny.NormalizeSafe());
+    EXPECT_EQ(tiny.x, 1e-8f);
+}
+
+TEST(Maths, Vector3f_NormalizeBatch) {
+    std::mt19937 generator(480);
+    std::uniform_real_distribution<float> component(-10.0f, 10.0f);
+    std::vector<maths::Vector3f> in;
+    for (int i = 0; i < 23; i++) {
+        in.emplace_back(component(generator), component(generator), component(generator));
+    }
+    in[5] = maths::Vector3f(0.0f, 0.0f, 0.0f);
+    in[21] = maths::Vector3f(0.0f, 0.0f, 0.0f);
+
+    // Only the common size is written.
+    std::vector<maths::Vector3f> out(in.size() - 1, maths::Vector3f(9.0f, 9.0f, 9.0f));
+    maths::NormalizeBatch(in, out);
+    for (std::size_t i = 0; i < out.size(); i++) {
+        const maths::Vector3f expected = in[i].Normalized();
+        EXPECT_NEAR(out[i].x, expected.x, 6e-7f);
+        EXPECT_NEAR(out[i].y, expected.y, 6e-7f);
+        EXPECT_NEAR(out[i].z, expected.z, 6e-7f);
+    }
+    EXPECT_EQ(out[5], maths::Vector3f(0.0f, 0.0f, 0.0f));
+    EXPECT_EQ(out[21], maths::Vector3f(0.0f, 0.0f, 0.0f));
+
+    // In place.
+    std::vector<maths::Vector3f> in_place = in;
+    maths::NormalizeBatch(in_place, in_place);
+    for (std::size_t i = 0; i < out.size(); i++) {
+        EXPECT_EQ(in_place[i], out[i]);
+    }
+}
+
 TEST(Maths, Vector3f_Lerp) {
     const maths::Vector3f a{2.0f, 3.0f, 1.0f};
     const maths::Vector3f b{1.0f, 4.0f, 3.0f};
@@ -0,0 +1,107 @@
+/*
+MIT License
+
+Copyright (c) 2021 SAE Institute Geneva
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <random>
+
+#include <gtest/gtest.h>
+#include "maths/vector3a.h"
+
+namespace maths {
+TEST(Maths, Vector3fA_Conversion) {
+    const maths::Vector3f a{2.0f, 3.0f, 1.0f};
+    const maths::Vector3fA b{a};
+    EXPECT_EQ(b.x(), a.x);
+    EXPECT_EQ(b.y(), a.y);
+    EXPECT_EQ(b.z(), a.z);
+    EXPECT_EQ(b.ToVector3f(), a);
+    EXPECT_EQ(b, maths::Vector3fA(2.0f, 3.0f, 1.0f));
+    EXPECT_NE(b, maths::Vector3fA(2.0f, 3.0f, 0.0f));
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(&b) % 16, 0u);
+}
+
+TEST(Maths, Vector3fA_Operators) {
+    const maths::Vector3f a{2.0f, 3.0f, 1.0f};
+    const maths::Vector3f b{1.0f, -4.0f, 3.0f};
+    const maths::Vector3fA aa{a};
+    const maths::Vector3fA ba{b};
+
+    EXPECT_EQ((aa + ba).ToVector3f(), a + b);
+    EXPECT_EQ((aa - ba).ToVector3f(), a - b);
+    EXPECT_EQ((aa * 4.0f).ToVector3f(), a * 4.0f);
+    EXPECT_EQ((aa / 4.0f).ToVector3f(), a / 4.0f);
+    EXPECT_EQ((-aa).ToVector3f(), a * -1.0f);
+
+    maths::Vector3fA c = aa;
+    c += ba;
+    c -= aa;
+    c *= 2.0f;
+    c /= 2.0f;
+    EXPECT_EQ(c, ba);
+
+    // The w lane is ignored by comparisons and products.
+    const maths::Vector3fA padded{maths::Float4(2.0f, 3.0f, 1.0f, 7.0f)};
+    EXPECT_EQ(padded, aa);
+    EXPECT_EQ(padded.Dot(ba), a.Dot(b));
+    EXPECT_EQ(padded.Cross(ba).ToVector3f(), a.Cross(b));
+
+    EXPECT_EQ(maths::Vector3fA::Min(aa, ba), maths::Vector3fA(1.0f, -4.0f, 1.0f));
+    EXPECT_EQ(maths::Vector3fA::Max(aa, ba), maths::Vector3fA(2.0f, 3.0f, 3.0f));
+    EXPECT_EQ(maths::Vector3fA::Lerp(aa, ba, 0.5f).ToVector3f(), maths::Vector3f::Lerp(a, b, 0.5f));
+}
+
+TEST(Maths, Vector3fA_MatchesVector3f) {
+    std::mt19937 generator(47);
+    std::uniform_real_distribution<float> distribution(-100.0f, 100.0f);
+    for (int i = 0; i < 1000; i++) {
+        const maths::Vector3f a{distribution(generator), distribution(generator), distribution(generator)};
+        const maths::Vector3f b{distribution(generator), distribution(generator), distribution(generator)};
+        const maths::Vector3fA aa{a};
+        const maths::Vector3fA ba{b};
+
+        const float tolerance = 1e-5f * a.Magnitude() * b.Magnitude();
+        EXPECT_NEAR(aa.Dot(ba), a.Dot(b), tolerance);
+        EXPECT_NEAR(aa.SqrMagnitude(), a.SqrMagnitude(), 1e-5f * a.SqrMagnitude());
+        EXPECT_NEAR(aa.Magnitude(), a.Magnitude(), 1e-5f * a.Magnitude());
+
+        const maths::Vector3f cross = maths::Vector3fA::Cross(aa, ba).ToVector3f();
+        const maths::Vector3f expected_cross = a.Cross(b);
+        for (std::size_t k = 0; k < 3; k++) {
+            EXPECT_NEAR(cross[k], expected_cross[k], tolerance);
+        }
+
+        const maths::Vector3f normalized = aa.Normalized().ToVector3f();
+        const maths::Vector3f expected_normalized = a.Normalized();
+        for (std::size_t k = 0; k < 3; k++) {
+            EXPECT_NEAR(normalized[k], expected_normalized[k], 1e-6f);
+        }
+    }
+}
+
+TEST(Maths, Vector3fA_Normalize) {
+    maths::Vector3fA a{2.0f, 3.0f, 1.0f};
+    a.Normalize();
+    EXPECT_NEAR(a.Magnitude(), 1.0f, 1e-6f);
+    EXPECT_NEAR(a.SqrMagnitude(), 1.0f, 2e-6f);
+}
+} // namespace maths
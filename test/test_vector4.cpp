@@ -196,6 +196,34 @@ TEST(Maths, Vector4f_Normalize) {
     EXPECT_FLOAT_EQ(c.Magnitude(), 1.0f);
 }
 
+TEST(Maths, Vector4f_NormalizeFastAndSafe) {
+    const maths::Vector4f a{0.0f, 3.0f, 2.0f, 1.0f};
+
+    //Test .NormalizedFast().
+    const maths::Vector4f b = a.NormalizedFast();
+    const maths::Vector4f expected = a.Normalized();
+    for (std::size_t i = 0; i < 4; i++) {
+        EXPECT_NEAR(b[i], expected[i], 6e-7f);
+    }
+
+    //Test .NormalizeSafe().
+    maths::Vector4f zero{0.0f, 0.0f, 0.0f, 0.0f};
+    EXPECT_FALSE(zero.NormalizeSafe());
+    EXPECT_EQ(zero.w, 0.0f);
+
+    //Test NormalizeBatch() with a scalar tail and a zero vector.
+    const maths::Vector4f in[] = {{1.0f, 2.0f, 3.0f, 4.0f}, {0.0f, 0.0f, 0.0f, 0.0f},
+        {0.0f, -2.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f, 1.0f}, {-5.0f, 0.0f, 1.0f, 0.0f}};
+    maths::Vector4f out[5];
+    maths::NormalizeBatch(in, out);
+    for (std::size_t i = 0; i < 5; i++) {
+        const maths::Vector4f normalized = in[i].Normalized();
+        for (std::size_t k = 0; k < 4; k++) {
+            EXPECT_NEAR(out[i][k], normalized[k], 6e-7f);
+        }
+    }
+}
+
 TEST(Maths, Vector4f_Lerp) {
     const maths::Vector4f a{2.0f, 3.0f, 1.0f, 0.0f};
     const maths::Vector4f b{1.0f, 4.0f, 3.0f, 2.0f};